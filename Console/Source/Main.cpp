@@ -0,0 +1,485 @@
+/*
+  ==============================================================================
+
+    Headless entry point for running the unit tests and the benchmark suites, analysing
+    the chain and rendering files through it outside of a host.
+
+    Usage: mrJuceFxChainPlusConsole <command>
+
+      test      runs all unit tests and prints the results
+      bench     runs all benchmarks and prints the results
+      analyse   measures the chain and prints a JSON or CSV report, see printUsage()
+      render    streams an audio file through the chain into another file
+      grid      renders an audio file for every combination of a parameter grid
+      load      runs many plugin instances from several threads and prints how it scales
+
+  ==============================================================================
+*/
+
+#include <iostream>
+
+#include <JuceHeader.h>
+#include "../../Source/JuceFxChainWrapper.h"
+#include "../../Source/MrChainAnalyser.h"
+#include "../../Source/MrChainParameters.h"
+#include "../../Source/MrLoadTest.h"
+#include "../../Source/MrParameterGrid.h"
+#include "../../Source/MrSignal.h"
+#include "../../Source/MrStreamingRenderer.h"
+#include "../../Source/PluginProcessor.h"
+
+#include "../../Source/MrUnitTestRunner.h"
+
+/* add more benchmark files down here*/
+#include "../../Source/JuceFxChainWrapperBenchmarks.h"
+#include "../../Source/MrDelayBenchmarks.h"
+#include "../../Source/MrFilterBenchmarks.h"
+#include "../../Source/MrIrCacheBenchmarks.h"
+#include "../../Source/MrLinearPhaseFilterBenchmarks.h"
+#include "../../Source/MrReblockerBenchmarks.h"
+#include "../../Source/MrSignalBenchmarks.h"
+#include "../../Source/PluginProcessorBenchmarks.h"
+
+//==============================================================================
+/** Prints all messages of the tests to the console. */
+class MrConsoleTestRunner : public juce::UnitTestRunner
+{
+public:
+
+    void logMessage(const juce::String& message) override
+    {
+        std::cout << message << std::endl;
+    }
+
+    int getNumFailures() const
+    {
+        int numFailures = 0;
+        for (int i = 0; i < getNumResults(); ++i)
+            numFailures += getResult(i)->failures;
+
+        return numFailures;
+    }
+};
+
+/** Runs every test outside the benchmark category. */
+static int runUnitTests()
+{
+    juce::Array<juce::UnitTest*> tests;
+    for (auto* test : juce::UnitTest::getAllTests())
+        if (test->getCategory() != MrBenchmark::BENCHMARK_CATEGORY)
+            tests.add(test);
+
+    MrConsoleTestRunner runner;
+    runner.runTests(tests);
+
+    std::cout << tests.size() << " tests, " << runner.getNumFailures() << " failures" << std::endl;
+
+    return runner.getNumFailures() > 0 ? 1 : 0;
+}
+
+static int runBenchmarks()
+{
+    MrConsoleTestRunner runner;
+    runner.runTestsInCategory(MrBenchmark::BENCHMARK_CATEGORY);
+
+    return runner.getNumFailures() > 0 ? 1 : 0;
+}
+
+/** Checks the parameter IDs before any work is done, the chain applies the values once it is prepared. */
+static bool areParametersKnown(IJuceFxChainWrapper& chain, const MrChainParameters::Values& parameters)
+{
+    for (auto& parameter : parameters)
+    {
+        if (!MrChainParameters::set(chain, parameter.first, parameter.second))
+        {
+            std::cerr << "unknown parameter " << parameter.first << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+    Runs the chain analysis, the arguments are options followed by parameters given as
+    <parameter ID>=<value> with the IDs the plugin exposes to the host.
+*/
+static int runAnalysis(const juce::StringArray& args)
+{
+    MrChainAnalyser::Settings settings;
+    MrChainAnalyser::Parameters parameters;
+    bool isCsv = false;
+    juce::File outputFile;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--samplerate" && hasValue)
+            settings.sampleRate = args[++i].getDoubleValue();
+        else if (arg == "--blocksize" && hasValue)
+            settings.blockSize = args[++i].getIntValue();
+        else if (arg == "--channels" && hasValue)
+            settings.numChnls = args[++i].getIntValue();
+        else if (arg == "--tail" && hasValue)
+            settings.maxTailInSeconds = args[++i].getDoubleValue();
+        else if (arg == "--out" && hasValue)
+            outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--sweep")
+            settings.stimulus = MrChainAnalyser::Stimulus::logSweep;
+        else if (arg == "--csv")
+            isCsv = true;
+        else if (!MrChainParameters::parse(arg, parameters))
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (settings.sampleRate <= 0.0 || settings.blockSize <= 0 || settings.numChnls <= 0 || settings.maxTailInSeconds <= 0.0)
+    {
+        std::cerr << "sample rate, block size, channels and tail must be positive" << std::endl;
+        return 1;
+    }
+
+    JuceFxChainWrapper chain;
+
+    if (!areParametersKnown(chain, parameters))
+        return 1;
+
+    auto report = MrChainAnalyser::analyse(chain, settings, parameters);
+    auto text = isCsv ? MrChainAnalyser::toCsv(report) : MrChainAnalyser::toJson(report);
+
+    if (outputFile == juce::File())
+        std::cout << text << std::endl;
+    else if (!outputFile.replaceWithText(text))
+    {
+        std::cerr << "could not write " << outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+    Renders a file through the chain, the arguments are the input and output file followed by
+    options and parameters like for the analysis.
+*/
+static int runRender(const juce::StringArray& args)
+{
+    if (args.size() < 2)
+    {
+        std::cerr << "input and output file are missing" << std::endl;
+        return 1;
+    }
+
+    auto inputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[0]);
+    auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[1]);
+
+    MrStreamingRenderer::Settings settings;
+    MrChainParameters::Values parameters;
+
+    for (int i = 2; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--blocksize" && hasValue)
+            settings.blockSize = args[++i].getIntValue();
+        else if (arg == "--blocks" && hasValue)
+            settings.numBlocksInFlight = args[++i].getIntValue();
+        else if (arg == "--bits" && hasValue)
+            settings.bitsPerSample = args[++i].getIntValue();
+        else if (!MrChainParameters::parse(arg, parameters))
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (settings.blockSize <= 0 || settings.numBlocksInFlight < 2)
+    {
+        std::cerr << "block size must be positive and at least 2 blocks must be in flight" << std::endl;
+        return 1;
+    }
+
+    JuceFxChainWrapper chain;
+
+    if (!areParametersKnown(chain, parameters))
+        return 1;
+
+    auto result = MrStreamingRenderer::renderFile(inputFile, outputFile, chain, parameters, settings);
+
+    if (!result.wasSuccessful)
+    {
+        std::cerr << result.errorMessage << std::endl;
+        return 1;
+    }
+
+    std::cout << "rendered " << result.numSamples << " samples in " << result.secondsTotal << " s"
+              << (result.wasMemoryMapped ? " (memory mapped)" : "") << std::endl
+              << "  reading    " << result.secondsReading << " s" << std::endl
+              << "  processing " << result.secondsProcessing << " s" << std::endl
+              << "  writing    " << result.secondsWriting << " s" << std::endl;
+
+    return 0;
+}
+
+/**
+    Renders a file for every combination of the parameter axes, the arguments are the input
+    file followed by options and axes given as <parameter ID>=<value>,<value>,... or
+    <parameter ID>=<from>:<to>:<number of steps>.
+*/
+static int runGrid(const juce::StringArray& args)
+{
+    if (args.isEmpty())
+    {
+        std::cerr << "input file is missing" << std::endl;
+        return 1;
+    }
+
+    auto inputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[0]);
+
+    MrParameterGrid::Settings settings;
+    std::vector<MrParameterGrid::Axis> axes;
+    bool isCsv = false;
+    juce::File outputDirectory;
+    juce::File summaryFile;
+
+    for (int i = 1; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+        MrParameterGrid::Axis axis;
+
+        if (arg == "--blocksize" && hasValue)
+            settings.blockSize = args[++i].getIntValue();
+        else if (arg == "--threads" && hasValue)
+            settings.numThreads = args[++i].getIntValue();
+        else if (arg == "--tail" && hasValue)
+            settings.maxTailInSeconds = args[++i].getDoubleValue();
+        else if (arg == "--bits" && hasValue)
+            settings.bitsPerSample = args[++i].getIntValue();
+        else if (arg == "--out" && hasValue)
+            outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--summary" && hasValue)
+            summaryFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--csv")
+            isCsv = true;
+        else if (MrParameterGrid::parseAxis(arg, axis))
+            axes.push_back(axis);
+        else
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (settings.blockSize <= 0 || settings.maxTailInSeconds < 0.0)
+    {
+        std::cerr << "block size must be positive and the tail must not be negative" << std::endl;
+        return 1;
+    }
+
+    auto combinations = MrParameterGrid::expand(axes);
+
+    JuceFxChainWrapper chain;
+
+    if (!areParametersKnown(chain, combinations.front()))
+        return 1;
+
+    auto createChain = [] { return std::unique_ptr<IJuceFxChainWrapper>(new JuceFxChainWrapper()); };
+
+    auto report = MrParameterGrid::renderFile(inputFile, outputDirectory, combinations, createChain, settings);
+
+    if (!report.wasSuccessful)
+    {
+        std::cerr << report.errorMessage << std::endl;
+        return 1;
+    }
+
+    auto text = isCsv ? MrParameterGrid::toCsv(report) : MrParameterGrid::toJson(report);
+
+    if (summaryFile == juce::File())
+        std::cout << text << std::endl;
+    else if (!summaryFile.replaceWithText(text))
+    {
+        std::cerr << "could not write " << summaryFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+static void printLoadResult(const MrLoadTest::Result& result, double secondsPerBlock)
+{
+    auto toMs = [](double seconds) { return juce::String(1000.0 * seconds, 3) + " ms"; };
+
+    std::cout << result.numThreads << " threads: " << juce::String(result.callbacksPerSecond, 0) << " callbacks/s, "
+              << juce::String(result.numInstances * result.callbacksPerSecond * secondsPerBlock, 0) << " instances in real time, "
+              << "median " << toMs(result.median) << ", p99 " << toMs(result.p99) << ", p99.9 " << toMs(result.p999)
+              << ", max " << toMs(result.max) << ", " << result.numDeadlineMisses << " deadline misses, "
+              << "scaling efficiency " << juce::String(100.0 * result.scalingEfficiency, 0) << " %" << std::endl;
+}
+
+/**
+    Processes many plugin instances the way a DAW does, all instances once per callback
+    spread over the threads, and prints the throughput and the callback times against the
+    deadline of a block.
+*/
+static int runLoad(const juce::StringArray& args)
+{
+    int numInstances = 64;
+    int blockSize = 128;
+    double sampleRate = 48000.0;
+    bool isScaling = false;
+    MrLoadTest::Settings settings;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--instances" && hasValue)
+            numInstances = args[++i].getIntValue();
+        else if (arg == "--threads" && hasValue)
+            settings.numThreads = args[++i].getIntValue();
+        else if (arg == "--blocksize" && hasValue)
+            blockSize = args[++i].getIntValue();
+        else if (arg == "--samplerate" && hasValue)
+            sampleRate = args[++i].getDoubleValue();
+        else if (arg == "--callbacks" && hasValue)
+            settings.numCallbacks = args[++i].getIntValue();
+        else if (arg == "--scaling")
+            isScaling = true;
+        else
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (numInstances <= 0 || blockSize <= 0 || sampleRate <= 0.0 || settings.numCallbacks <= 0)
+    {
+        std::cerr << "instances, block size, sample rate and callbacks must be positive" << std::endl;
+        return 1;
+    }
+
+    settings.secondsPerCallback = blockSize / sampleRate;
+
+    // each instance on its own buffers, like the tracks of a DAW
+    std::vector<std::unique_ptr<MrJuceFxChainPlusAudioProcessor>> processors;
+    std::vector<juce::AudioBuffer<float>> buffers;
+    std::vector<juce::MidiBuffer> midiBuffers((size_t)numInstances);
+
+    for (int i = 0; i < numInstances; ++i)
+    {
+        processors.push_back(std::make_unique<MrJuceFxChainPlusAudioProcessor>());
+        processors.back()->prepareToPlay(sampleRate, blockSize);
+
+        buffers.emplace_back(processors.back()->getTotalNumOutputChannels(), blockSize);
+        juce::dsp::AudioBlock<float> block(buffers.back());
+        MrSignal::whiteNoise(block, 0.5f);
+    }
+
+    auto process = [&](int instanceIdx)
+    {
+        processors[(size_t)instanceIdx]->processBlock(buffers[(size_t)instanceIdx], midiBuffers[(size_t)instanceIdx]);
+    };
+
+    std::cout << numInstances << " instances, " << blockSize << " samples at " << sampleRate << " Hz, deadline "
+              << juce::String(1000.0 * settings.secondsPerCallback, 3) << " ms" << std::endl;
+
+    if (isScaling)
+    {
+        for (auto& result : MrLoadTest::runScaling(numInstances, process, settings, MrLoadTest::getThreadCountsUpToCores()))
+            printLoadResult(result, settings.secondsPerCallback);
+    }
+    else
+        printLoadResult(MrLoadTest::run(numInstances, process, settings), settings.secondsPerCallback);
+
+    return 0;
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: mrJuceFxChainPlusConsole <command>" << std::endl
+              << std::endl
+              << "  test      runs all unit tests and prints the results, returns 1 if any fails" << std::endl
+              << "  bench     runs all benchmarks and prints the results" << std::endl
+              << "  analyse   [options] [<parameter ID>=<value> ...]" << std::endl
+              << "            measures impulse, frequency and phase response, group delay, tail," << std::endl
+              << "            latency and CPU load of the chain and prints them as JSON" << std::endl
+              << std::endl
+              << "            --samplerate <Hz>      default 48000" << std::endl
+              << "            --blocksize <samples>  default 512" << std::endl
+              << "            --channels <number>    default 2" << std::endl
+              << "            --tail <seconds>       length of the recorded response, default 10" << std::endl
+              << "            --sweep                measures with a log sweep instead of an impulse" << std::endl
+              << "            --csv                  prints CSV instead of JSON" << std::endl
+              << "            --out <file>           writes the report to a file" << std::endl
+              << std::endl
+              << "  render    <input file> <output file> [options] [<parameter ID>=<value> ...]" << std::endl
+              << "            streams the input through the chain into the output, reading, processing" << std::endl
+              << "            and writing run on separate threads" << std::endl
+              << std::endl
+              << "            --blocksize <samples>  default 4096" << std::endl
+              << "            --blocks <number>      blocks in flight between the stages, default 8" << std::endl
+              << "            --bits <number>        bits per sample of the output, default 24" << std::endl
+              << std::endl
+              << "  grid      <input file> [options] [<parameter ID>=<value>,<value>,... ...]" << std::endl
+              << "            renders the input for every combination of the parameter values on all" << std::endl
+              << "            cores and prints peak, RMS level and tail length of each render as JSON," << std::endl
+              << "            values may also be given as <from>:<to>:<number of steps>" << std::endl
+              << std::endl
+              << "            --out <directory>      writes the renders as WAV files" << std::endl
+              << "            --summary <file>       writes the summary to a file" << std::endl
+              << "            --csv                  prints CSV instead of JSON" << std::endl
+              << "            --threads <number>     default one per core" << std::endl
+              << "            --blocksize <samples>  default 512" << std::endl
+              << "            --tail <seconds>       silence appended to the input, default 10" << std::endl
+              << "            --bits <number>        bits per sample of the renders, default 24" << std::endl
+              << std::endl
+              << "  load      [options]" << std::endl
+              << "            processes many plugin instances from several threads like a DAW and prints" << std::endl
+              << "            throughput, callback time percentiles against the deadline of a block and" << std::endl
+              << "            the scaling efficiency" << std::endl
+              << std::endl
+              << "            --instances <number>   default 64" << std::endl
+              << "            --threads <number>     default one per core" << std::endl
+              << "            --blocksize <samples>  default 128" << std::endl
+              << "            --samplerate <Hz>      default 48000" << std::endl
+              << "            --callbacks <number>   default 1000" << std::endl
+              << "            --scaling              runs 1, 2, 4, ... threads up to the number of cores" << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args(argv + 1, argc - 1);
+    auto command = args.isEmpty() ? juce::String() : args[0];
+
+    if (command == "test")
+        return runUnitTests();
+
+    if (command == "bench")
+        return runBenchmarks();
+
+    if (command == "analyse")
+        return runAnalysis(juce::StringArray(args.begin() + 1, args.size() - 1));
+
+    if (command == "render")
+        return runRender(juce::StringArray(args.begin() + 1, args.size() - 1));
+
+    if (command == "grid")
+        return runGrid(juce::StringArray(args.begin() + 1, args.size() - 1));
+
+    if (command == "load")
+        return runLoad(juce::StringArray(args.begin() + 1, args.size() - 1));
+
+    printUsage();
+    return command.isEmpty() ? 0 : 1;
+}
@@ -18,15 +18,100 @@ public:
 
 	virtual void process(juce::dsp::ProcessContextReplacing<float> context) = 0;
 
+	virtual void setSubBlockSize(int subBlockSize) = 0;
+	virtual int getSubBlockSize() = 0;
+
+	virtual void setFrameSize(int frameSize) = 0;
+	virtual int getFrameSize() = 0;
+
+	virtual void setPipelined(bool isPipelined) = 0;
+	virtual bool isPipelined() = 0;
+
+	virtual void setNonRealtime(bool isNonRealtime) = 0;
+	virtual bool isNonRealtime() = 0;
+
+	virtual void setLinearPhase(bool isLinearPhase) = 0;
+	virtual bool isLinearPhase() = 0;
+
+	virtual void setAsyncPrepare(bool isAsyncPrepare) = 0;
+	virtual bool isAsyncPrepare() = 0;
+
+	virtual void setChannelMode(int channelMode) = 0;
+	virtual int getChannelMode() = 0;
+
+	virtual void setQuality(int quality) = 0;
+	virtual int getQuality() = 0;
+
+	virtual void setAdaptiveQuality(bool isAdaptiveQuality) = 0;
+	virtual bool isAdaptiveQuality() = 0;
+
+	virtual int getQualityInUse() = 0;
+
+	virtual int getLatencyInSmpls() = 0;
+
 	virtual void setDelayInMs(double delayInMs) = 0;
 	virtual double getDelayInMs() = 0;
 
 	virtual void setFeedback(float feedback) = 0;
 	virtual float getFeedback() = 0;
 
+	virtual void setFeedbackMode(int feedbackMode) = 0;
+	virtual int getFeedbackMode() = 0;
+
+	virtual void setCrossFeed(float crossFeed) = 0;
+	virtual float getCrossFeed() = 0;
+
+	virtual void setDampingLowPassInHz(float dampingLowPassInHz) = 0;
+	virtual float getDampingLowPassInHz() = 0;
+
+	virtual void setDampingHighPassInHz(float dampingHighPassInHz) = 0;
+	virtual float getDampingHighPassInHz() = 0;
+
+	virtual void setSaturationDrive(float saturationDrive) = 0;
+	virtual float getSaturationDrive() = 0;
+
+	virtual void setModulationDepthInMs(float modulationDepthInMs) = 0;
+	virtual float getModulationDepthInMs() = 0;
+
+	virtual void setModulationRateInHz(float modulationRateInHz) = 0;
+	virtual float getModulationRateInHz() = 0;
+
+	virtual void setModulationNumVoices(int modulationNumVoices) = 0;
+	virtual int getModulationNumVoices() = 0;
+
+	virtual void setModulationStereoPhase(float modulationStereoPhase) = 0;
+	virtual float getModulationStereoPhase() = 0;
+
 	virtual void setCutOffInHz(float cutOffInHz) = 0;
 	virtual float getCutOffInHz() = 0;
 
+	virtual void setFilterMode(int filterMode) = 0;
+	virtual int getFilterMode() = 0;
+
+	virtual void setFilterSlope(int filterSlope) = 0;
+	virtual int getFilterSlope() = 0;
+
+	virtual void setResonance(float resonance) = 0;
+	virtual float getResonance() = 0;
+
+	virtual void setFilterGainInDb(float filterGainInDb) = 0;
+	virtual float getFilterGainInDb() = 0;
+
 	virtual void setRoomSize(float roomSize) = 0;
 	virtual float getRoomSize() = 0;
+
+	virtual void setFilterMix(float filterMix) = 0;
+	virtual float getFilterMix() = 0;
+
+	virtual void setDelayMix(float delayMix) = 0;
+	virtual float getDelayMix() = 0;
+
+	virtual void setReverbMix(float reverbMix) = 0;
+	virtual float getReverbMix() = 0;
+
+	virtual void setMix(float mix) = 0;
+	virtual float getMix() = 0;
+
+	virtual void setMixLaw(int mixLaw) = 0;
+	virtual int getMixLaw() = 0;
 };
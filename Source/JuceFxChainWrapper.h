@@ -2,44 +2,111 @@
 
 #include <JuceHeader.h>
 #include "IJuceFxChainWrapper.h"
+#include "MrCacheLine.h"
 #include "MrDelay.h"
+#include "MrDryLine.h"
+#include "MrDryWet.h"
+#include "MrDualMonoDetector.h"
+#include "MrDspTableCache.h"
+#include "MrFilter.h"
+#include "MrLinearPhaseFilter.h"
+#include "MrQuality.h"
+#include "MrQualityGovernor.h"
+#include "MrReblocker.h"
+#include "MrResourceBuilder.h"
+#include "MrReverb.h"
+#include "MrStagePipeline.h"
 
-class JuceFxChainWrapper : public IJuceFxChainWrapper {
+class JuceFxChainWrapper final : public IJuceFxChainWrapper {
 
 public:
     
-    using Filter = juce::dsp::IIR::Filter<float>;
-    using FilterCoefs = juce::dsp::IIR::Coefficients<float>;
-    using FxChain = juce::dsp::ProcessorChain<juce::dsp::ProcessorDuplicator<Filter, FilterCoefs>, 
+    using FxChain = juce::dsp::ProcessorChain<MrFilter, 
                                                 MrDelay<float>,                                                
-                                                    juce::dsp::Reverb>;
+                                                    MrReverb>;
+
+    /** How the filter and the delay treat the channels of a stereo block, see setChannelMode(). */
+    enum class ChannelMode
+    {
+        stereo,     /**< both channels in full */
+        dualMono,   /**< once while both channels carry the same signal */
+        midSide     /**< on the mid signal only, the side passes */
+    };
+
     ///delay
     const double DELAY_IN_MS = 750;
+    const float DELAY_MAX_IN_MS = 60000.0f;
     const float FEEDBACK = 0.5f;
+    const int FEEDBACK_MODE = (int)MrDelay<float>::FeedbackMode::parallel;
+    const float CROSS_FEED = 0.0f;
+    const float DAMPING_LOW_PASS_IN_HZ = 0.0f;
+    const float DAMPING_HIGH_PASS_IN_HZ = 0.0f;
+    const float SATURATION_DRIVE = 0.0f;
+    const float MODULATION_DEPTH_IN_MS = 0.0f;
+    const float MODULATION_RATE_IN_HZ = 0.5f;
+    const int MODULATION_NUM_VOICES = 1;
+    const float MODULATION_STEREO_PHASE = 0.25f;
 
     ///filter
     const float CUT_OFF_IN_HZ = 500.0f;
+    const int FILTER_MODE = (int)MrFilter::Mode::lowPass;
+    const int FILTER_SLOPE = (int)MrFilter::Slope::db12;
+    const float RESONANCE = MrDspTableCache::LOW_PASS_Q;
+    const float FILTER_GAIN_IN_DB = 0.0f;
 
     ///reverb
     const float ROOMSIZE = 0.3f;
 
-    JuceFxChainWrapper()
-    {
-        _pJuceFxChain = std::shared_ptr<FxChain>(new FxChain());                
-    }
+    ///mix, see MrDryWet, the stage defaults sound as the stages did before they had one
+    const float FILTER_MIX = 1.0f;
+    const float DELAY_MIX = 0.5f;
+    const float REVERB_MIX = 0.5f;
+    const float MIX = 1.0f;
+    const int MIX_LAW = (int)MrDryWet::Law::balance;
+
+    ///processing, 0 processes the whole host block stage by stage
+    const int SUB_BLOCK_SIZE = 0;
+    const int FRAME_SIZE = 0;
+    const bool IS_PIPELINED = false;
+    const bool IS_LINEAR_PHASE = false;
+    const bool IS_ASYNC_PREPARE = false;
+    const int CHANNEL_MODE = (int)ChannelMode::stereo;
+
+    ///quality, see MrQuality
+    const int QUALITY = (int)MrQuality::Tier::normal;
+    const bool IS_ADAPTIVE_QUALITY = false;
+    const double LOAD_BUDGET = MrQualityGovernor::BUDGET_DEFAULT;
+
+    /** Creates no chain yet, the first setup or prepare() does, so instances a host only queries stay light. */
+    JuceFxChainWrapper() {}
 
     ~JuceFxChainWrapper(){}
     
     void setupFilter(juce::dsp::ProcessSpec& spec)
     {
+        stopPipeline();
+
         _sampleRate = spec.sampleRate;
 
         setCutOffInHz(CUT_OFF_IN_HZ);
+        setFilterMode(FILTER_MODE);
+        setFilterSlope(FILTER_SLOPE);
+        setResonance(RESONANCE);
+        setFilterGainInDb(FILTER_GAIN_IN_DB);
+        setFilterMix(FILTER_MIX);
+
+        // shared by all instances, built in the background, until then the coefficients are computed
+        _lowPassTable = _dspTableCache->getTable(MrDspTableCache::TableType::lowPassCoefs, _sampleRate);
+
+        // prepared asynchronously, prepare() builds the whole chain
+        if (isPreparingAsync())
+            return;
+
+        createChain();
         
         auto& filter = _pJuceFxChain->template get<idxFilter>();
-        *filter.state = *FilterCoefs::makeLowPass(_sampleRate, _cutOffInHz, 5.0);
-
         filter.prepare(spec);
+        applyFilter(getStageParameters());
         filter.reset();      
 
         //_pJuceFxChain->template setBypassed<idxFilter>(true);
@@ -47,31 +114,367 @@ public:
 
     void setupDelay(juce::dsp::ProcessSpec& spec)
     {
+        stopPipeline();
+
         setDelayInMs(DELAY_IN_MS);
         setFeedback(FEEDBACK);
+        setFeedbackMode(FEEDBACK_MODE);
+        setCrossFeed(CROSS_FEED);
+        setDampingLowPassInHz(DAMPING_LOW_PASS_IN_HZ);
+        setDampingHighPassInHz(DAMPING_HIGH_PASS_IN_HZ);
+        setSaturationDrive(SATURATION_DRIVE);
+        setModulationDepthInMs(MODULATION_DEPTH_IN_MS);
+        setModulationRateInHz(MODULATION_RATE_IN_HZ);
+        setModulationNumVoices(MODULATION_NUM_VOICES);
+        setModulationStereoPhase(MODULATION_STEREO_PHASE);
+        setDelayMix(DELAY_MIX);
+
+        _isSecondChnlStale = false;
+
+        if (isPreparingAsync())
+            return;
+
+        createChain();
 
         auto& delay = _pJuceFxChain->template get<idxDelay>();
+        delay.setMaxDelayInMs(DELAY_MAX_IN_MS);
         delay.setDelayInMs(DELAY_IN_MS); 
         delay.prepare(spec);
         
         delay.setFeedback(FEEDBACK);
+        delay.setFeedbackMode((MrDelay<float>::FeedbackMode)FEEDBACK_MODE);
+        delay.setCrossFeed(CROSS_FEED);
+        delay.setDampingLowPassInHz(DAMPING_LOW_PASS_IN_HZ);
+        delay.setDampingHighPassInHz(DAMPING_HIGH_PASS_IN_HZ);
+        delay.setSaturationDrive(SATURATION_DRIVE);
+        delay.setModulationDepthInMs(MODULATION_DEPTH_IN_MS);
+        delay.setModulationRateInHz(MODULATION_RATE_IN_HZ);
+        delay.setModulationNumVoices(MODULATION_NUM_VOICES);
+        delay.setModulationStereoPhase(MODULATION_STEREO_PHASE);
+        delay.setMix(DELAY_MIX);
+        delay.setMixLaw(MrDryWet::toLaw(_mixLaw));
     }
     
     void setupReverb()
     {
+        stopPipeline();
+
         setRoomSize(ROOMSIZE);
+        setReverbMix(REVERB_MIX);
 
         //_pJuceFxChain->template setBypassed<idxReverb>(true);
     }
 
     void prepare(juce::dsp::ProcessSpec& spec)
     {
-        _pJuceFxChain->prepare(spec);
+        createChain();
+
+        // prepared again without the setups, the workers may still run the stages
+        stopPipeline();
+
+        // in frames the chain never sees another block size
+        auto chainSpec = spec;
+        _isReblocking = _frameSize > 0;
+        if (_isReblocking)
+        {
+            _reblocker.prepare((int)spec.numChannels, _frameSize);
+            chainSpec.maximumBlockSize = (juce::uint32)_reblocker.getFrameSize();
+        }
+
+        if (isPreparingAsync())
+        {
+            prepareChainAsync(chainSpec);
+        }
+        else
+        {
+            _chainBuilder.cancel();
+            _pJuceFxChain->prepare(chainSpec);
+            _chainSpec = chainSpec;
+            _isChainStale = false;
+        }
+
+        _dualMonoDetector.reset();
+
+        _qualityGovernor.setMaxTier(MrQuality::toTier(_quality));
+        _qualityGovernor.setBudget(_loadBudget);
+        _qualityGovernor.reset();
+
+        // the filter stage stays in the chain, bypassed while the linear phase filter runs in its place
+        _isLinearPhaseRunning = _isLinearPhase;
+        _pJuceFxChain->template setBypassed<idxFilter>(_isLinearPhase);
+
+        if (_isLinearPhase)
+        {
+            applyFilter(getStageParameters());
+            _linearPhaseFilter.prepare(chainSpec);
+        }
+        else
+        {
+            _linearPhaseFilter.stop();
+        }
+
+        if (_isPipelined)
+            startPipeline(chainSpec);
+
+        // in host blocks, before the frames
+        _dryWet.prepare(spec.sampleRate);
+        _dryLine.prepare((int)spec.numChannels, (int)spec.maximumBlockSize, getLatencyInSmpls());
+        _isDryLineInUse = false;
     }
     
+    /** 
+        Processes the whole block stage by stage or, if a sub block size is set, walks
+        the block in sub blocks through all stages so the data stays in cache. In the latter
+        case pending parameter updates are applied at each sub block boundary.
+
+        Pipelined, the block is passed to the stage pipeline together with the current
+        parameters, which the stages apply when the block reaches them. The channel mode
+        is not used then.
+
+        With adaptive quality the time the block took is passed to the quality governor,
+        which picks the tier for the next block.
+
+        With a frame size set, the host blocks are cut into frames of that size first, see
+        setFrameSize().
+
+        Prepared asynchronously, a new chain is taken over as soon as it is ready, see
+        setAsyncPrepare().
+
+        With a mix below 1 the block is kept in the dry line first, and the dry signal lined
+        up with the output of the chain is mixed in last, see setMix().
+    */
     void process(juce::dsp::ProcessContextReplacing<float> context)
     {
-        _pJuceFxChain->process(context);
+        if (_chainBuilder.swap(_pJuceFxChain))
+            takeOverChain();
+
+        auto block = context.getOutputBlock();
+
+        const bool isMixed = !_dryWet.isWetOnly() && !context.isBypassed;
+        if (isMixed)
+        {
+            if (!_isDryLineInUse)
+                _dryLine.clear();
+
+            _dryLine.write(block);
+        }
+        _isDryLineInUse = isMixed;
+
+        if (_isChainStale)
+        {
+            _isChainStale = _pJuceFxChain == nullptr || !_chainBuilder.isUpToDate();
+            if (_isChainStale)
+                return;
+        }
+
+        if (!_isReblocking)
+        {
+            processMeasured(context);
+        }
+        else
+        {
+            _reblocker.process(block, [this, &context](juce::dsp::AudioBlock<float>& frame)
+            {
+                juce::dsp::ProcessContextReplacing<float> frameContext(frame);
+                frameContext.isBypassed = context.isBypassed;
+
+                processMeasured(frameContext);
+            });
+        }
+
+        if (isMixed)
+            _dryLine.mixInto(block, _dryWet.advance((int)block.getNumSamples()));
+    }
+
+    /**
+        From the next prepare() on, passes the chain frames of this size whatever the size of
+        the host blocks, through MrReblocker. Rounded up to a power of two, 0 passes the host
+        blocks on. Adds a latency of one frame, the chain is prepared for the frame size.
+    */
+    void setFrameSize(int frameSize)
+    {
+        _frameSize = (frameSize > 0) ? MrReblocker::toFrameSize(frameSize) : 0;
+    }
+
+    int getFrameSize()
+    {
+        return _frameSize;
+    }
+
+    /** Sets the size of the sub blocks the host block is split into, 0 processes the whole block per stage. */
+    void setSubBlockSize(int subBlockSize)
+    {
+        _subBlockSize = std::max(0, subBlockSize);
+    }
+
+    int getSubBlockSize()
+    {
+        return _subBlockSize;
+    }
+
+    /**
+        From the next prepare() on, runs the filter and the delay on threads of their own and
+        the reverb on the calling thread, each on a different block, for chains too heavy for
+        one thread. This adds a latency of three blocks of the prepared size, the sub block
+        size is not used then.
+    */
+    void setPipelined(bool isPipelined)
+    {
+        _isPipelined = isPipelined;
+    }
+
+    bool isPipelined()
+    {
+        return _isPipelined;
+    }
+
+    /**
+        In real time, when the pipeline workers fall behind, a block is dropped and silence put
+        out rather than block the calling thread. Non real time, e.g. when rendering offline,
+        waits for them instead.
+    */
+    void setNonRealtime(bool isNonRealtime)
+    {
+        _pipeline.setNonRealtime(isNonRealtime);
+    }
+
+    bool isNonRealtime()
+    {
+        return _pipeline.isNonRealtime();
+    }
+
+    /** Returns the number of blocks the pipeline dropped since prepare(), as its workers had fallen behind. */
+    int getNumPipelineUnderruns()
+    {
+        return _pipeline.getNumUnderruns();
+    }
+
+    /**
+        From the next prepare() on, runs the linear phase version of the filter in its place,
+        an FIR with the magnitude of the filter settings, see MrLinearPhaseFilter. This adds a
+        latency of about one and a half kernel sizes, the quality tiers leave it alone.
+    */
+    void setLinearPhase(bool isLinearPhase)
+    {
+        _isLinearPhase = isLinearPhase;
+    }
+
+    bool isLinearPhase()
+    {
+        return _isLinearPhase;
+    }
+
+    /**
+        From the next setupFilter() on, leaves building and preparing a new chain to a
+        background thread, so setting up and preparing return without allocating the delay
+        buffer or preparing the stages, see MrResourceBuilder. process() takes the new chain
+        over once it is ready. Until then the current chain keeps running if it was prepared
+        for the same spec, otherwise the blocks pass unprocessed. Pipelined the chain is
+        prepared on the calling thread, as the workers hold the stages.
+    */
+    void setAsyncPrepare(bool isAsyncPrepare)
+    {
+        _isAsyncPrepare = isAsyncPrepare;
+    }
+
+    bool isAsyncPrepare()
+    {
+        return _isAsyncPrepare;
+    }
+
+    /** Returns true once the chain of the last prepare() is in use, for the thread calling process(). */
+    bool isChainUpToDate()
+    {
+        return !_isChainStale && _chainBuilder.isUpToDate();
+    }
+
+    /**
+        Selects how the filter and the delay treat the channels of stereo blocks, one of
+        ChannelMode. In dualMono they run once and their output is copied to the second
+        channel while both channels carry the same signal and the delay settings keep them
+        alike. In midSide they run on the mid signal only. The reverb keeps processing
+        both channels in all modes.
+    */
+    void setChannelMode(int channelMode)
+    {
+        _channelMode = juce::jlimit((int)ChannelMode::stereo, (int)ChannelMode::midSide, channelMode);
+    }
+
+    int getChannelMode()
+    {
+        return _channelMode;
+    }
+
+    /** Returns true if the last block was processed as dual mono. */
+    bool isDualMono()
+    {
+        return _dualMonoDetector.isDualMono();
+    }
+
+    /**
+        Selects the quality tier of all stages, one of MrQuality::Tier. With adaptive quality
+        it is the highest tier the governor may pick. The stages crossfade to a new tier.
+    */
+    void setQuality(int quality)
+    {
+        _quality = (int)MrQuality::toTier(quality);
+        _qualityGovernor.setMaxTier(MrQuality::toTier(_quality));
+    }
+
+    int getQuality()
+    {
+        return _quality;
+    }
+
+    /**
+        Lets the quality governor lower the tier while the blocks take too long against their
+        deadline and raise it again, up to the selected tier, once there is headroom.
+    */
+    void setAdaptiveQuality(bool isAdaptiveQuality)
+    {
+        if (isAdaptiveQuality && !_isAdaptiveQuality)
+            _qualityGovernor.reset();
+
+        _isAdaptiveQuality = isAdaptiveQuality;
+    }
+
+    bool isAdaptiveQuality()
+    {
+        return _isAdaptiveQuality;
+    }
+
+    /** Returns the tier the stages run at, the one of the governor with adaptive quality. */
+    int getQualityInUse()
+    {
+        return _isAdaptiveQuality ? (int)_qualityGovernor.getTier() : _quality;
+    }
+
+    /** Sets the share of the block deadline the chain may use before the governor lowers the tier. */
+    void setLoadBudget(double loadBudget)
+    {
+        _loadBudget = loadBudget;
+        _qualityGovernor.setBudget(loadBudget);
+    }
+
+    double getLoadBudget()
+    {
+        return _loadBudget;
+    }
+
+    /** Returns the load the governor measured, 1 being the whole budget, 0 without adaptive quality. */
+    double getLoad()
+    {
+        return _isAdaptiveQuality ? _qualityGovernor.getLoad() : 0.0;
+    }
+
+    /** Returns the latency the chain adds, the sum of its stages: the frame adapter, the pipeline and the linear phase filter add latency. */
+    int getLatencyInSmpls()
+    {
+        const int frameLatency = _isReblocking ? _reblocker.getLatencyInSmpls() : 0;
+        const int pipelineLatency = _isPipelineRunning ? _pipeline.getLatencyInSmpls() : 0;
+        const int filterLatency = _isLinearPhaseRunning ? _linearPhaseFilter.getLatencyInSmpls() : 0;
+
+        return frameLatency + pipelineLatency + filterLatency;
     }
 
     void setCutOffInHz(float cutOffInHz)
@@ -85,6 +488,54 @@ public:
         return _cutOffInHz;
     }
 
+    /** Selects the filter response, one of MrFilter::Mode. Changing it crossfades to the new response. */
+    void setFilterMode(int filterMode)
+    {
+        _filterMode = (int)MrFilter::toMode(filterMode);
+        _updateFilterFlag = true;
+    }
+
+    int getFilterMode()
+    {
+        return _filterMode;
+    }
+
+    /** Selects the filter slope, one of MrFilter::Slope from 12 to 48 dB/oct. */
+    void setFilterSlope(int filterSlope)
+    {
+        _filterSlope = (int)MrFilter::toSlope(filterSlope);
+        _updateFilterFlag = true;
+    }
+
+    int getFilterSlope()
+    {
+        return _filterSlope;
+    }
+
+    /** Sets the Q of the filter, the resonance of low and high pass and the width of the other modes. */
+    void setResonance(float resonance)
+    {
+        _resonance = resonance;
+        _updateFilterFlag = true;
+    }
+
+    float getResonance()
+    {
+        return _resonance;
+    }
+
+    /** Sets the gain of the shelf and peak modes. */
+    void setFilterGainInDb(float filterGainInDb)
+    {
+        _filterGainInDb = filterGainInDb;
+        _updateFilterFlag = true;
+    }
+
+    float getFilterGainInDb()
+    {
+        return _filterGainInDb;
+    }
+
     void setDelayInMs(double delayInMs)
     {
         _delayInMs = delayInMs;
@@ -107,6 +558,105 @@ public:
         return _feedback;
     }
 
+    void setFeedbackMode(int feedbackMode)
+    {
+        _feedbackMode = feedbackMode;
+        _updateDelayFlag = true;
+    }
+
+    int getFeedbackMode()
+    {
+        return _feedbackMode;
+    }
+
+    void setCrossFeed(float crossFeed)
+    {
+        _crossFeed = crossFeed;
+        _updateDelayFlag = true;
+    }
+
+    float getCrossFeed()
+    {
+        return _crossFeed;
+    }
+
+    void setDampingLowPassInHz(float dampingLowPassInHz)
+    {
+        _dampingLowPassInHz = dampingLowPassInHz;
+        _updateDelayFlag = true;
+    }
+
+    float getDampingLowPassInHz()
+    {
+        return _dampingLowPassInHz;
+    }
+
+    void setDampingHighPassInHz(float dampingHighPassInHz)
+    {
+        _dampingHighPassInHz = dampingHighPassInHz;
+        _updateDelayFlag = true;
+    }
+
+    float getDampingHighPassInHz()
+    {
+        return _dampingHighPassInHz;
+    }
+
+    void setSaturationDrive(float saturationDrive)
+    {
+        _saturationDrive = saturationDrive;
+        _updateDelayFlag = true;
+    }
+
+    float getSaturationDrive()
+    {
+        return _saturationDrive;
+    }
+
+    void setModulationDepthInMs(float modulationDepthInMs)
+    {
+        _modulationDepthInMs = modulationDepthInMs;
+        _updateDelayFlag = true;
+    }
+
+    float getModulationDepthInMs()
+    {
+        return _modulationDepthInMs;
+    }
+
+    void setModulationRateInHz(float modulationRateInHz)
+    {
+        _modulationRateInHz = modulationRateInHz;
+        _updateDelayFlag = true;
+    }
+
+    float getModulationRateInHz()
+    {
+        return _modulationRateInHz;
+    }
+
+    void setModulationNumVoices(int modulationNumVoices)
+    {
+        _modulationNumVoices = modulationNumVoices;
+        _updateDelayFlag = true;
+    }
+
+    int getModulationNumVoices()
+    {
+        return _modulationNumVoices;
+    }
+
+    void setModulationStereoPhase(float modulationStereoPhase)
+    {
+        _modulationStereoPhase = modulationStereoPhase;
+        _updateDelayFlag = true;
+    }
+
+    float getModulationStereoPhase()
+    {
+        return _modulationStereoPhase;
+    }
+
     void setRoomSize(float roomSize)
     {
         _roomSize = roomSize;
@@ -118,42 +668,95 @@ public:
         return _roomSize;
     }
 
+    /** Sets the mix of the filter input and the filtered signal, see MrDryWet. */
+    void setFilterMix(float filterMix)
+    {
+        _filterMix = filterMix;
+        _updateFilterFlag = true;
+    }
+
+    float getFilterMix()
+    {
+        return _filterMix;
+    }
+
+    /** Sets the mix of the delay input and the delayed signal, the feedback is the same at any mix. */
+    void setDelayMix(float delayMix)
+    {
+        _delayMix = delayMix;
+        _updateDelayFlag = true;
+    }
+
+    float getDelayMix()
+    {
+        return _delayMix;
+    }
+
+    /** Sets the mix of the reverb input and the reverb, on top of its dry and wet levels. */
+    void setReverbMix(float reverbMix)
+    {
+        _reverbMix = reverbMix;
+        _updateReverbFlag = true;
+    }
+
+    float getReverbMix()
+    {
+        return _reverbMix;
+    }
+
+    /**
+        Sets the mix of the chain input and output, 1 is the output only. The input is
+        delayed by the latency of the chain to line up with the output, in a buffer
+        prepare() allocates. Unlike the stage mixes, not reset by the setups.
+    */
+    void setMix(float mix)
+    {
+        _dryWet.setMix(mix);
+    }
+
+    float getMix()
+    {
+        return _dryWet.getMix();
+    }
+
+    /** Selects the law of all mixes, one of MrDryWet::Law. */
+    void setMixLaw(int mixLaw)
+    {
+        _mixLaw = (int)MrDryWet::toLaw(mixLaw);
+        _dryWet.setLaw(MrDryWet::toLaw(_mixLaw));
+        _updateFilterFlag = _updateDelayFlag = _updateReverbFlag = true;
+    }
+
+    int getMixLaw()
+    {
+        return _mixLaw;
+    }
+
+    /** Pipelined, the updates are left to the stages, see process(). A stale chain gets them once it is taken over. */
     void updateFilter()
     {
-        if (!_updateFilterFlag)
+        if (!_updateFilterFlag || _isPipelineRunning || _isChainStale)
             return;
 
-        auto& filter = _pJuceFxChain->template get<idxFilter>();
-        *filter.state = *FilterCoefs::makeLowPass(_sampleRate, _cutOffInHz, 5.0);
-
+        applyFilter(getStageParameters());
         _updateFilterFlag = false;
-
-        
     }
 
     void updateDelay()
     {
-        if (!_updateDelayFlag)
+        if (!_updateDelayFlag || _isPipelineRunning || _isChainStale)
             return;
 
-        auto& delay = _pJuceFxChain->template get<idxDelay>();
-        delay.setDelayInMs(_delayInMs);
-        delay.setFeedback(_feedback);
-
+        applyDelay(getStageParameters());
         _updateDelayFlag = false;
     }
 
     void updateReverb()
     {
-        if (!_updateReverbFlag)
+        if (!_updateReverbFlag || _isPipelineRunning || _isChainStale)
             return;
 
-        auto& reverb = _pJuceFxChain->template get<idxReverb>();
-        auto params = reverb.getParameters();
-
-        params.roomSize = _roomSize;
-        reverb.setParameters(params);
-
+        applyReverb(getStageParameters());
         _updateReverbFlag = false;
     }
 
@@ -166,16 +769,542 @@ private:
         idxReverb
     };
 
-    std::shared_ptr<FxChain> _pJuceFxChain;
+    /** The parameters passed along with each block through the pipeline, a version counts the changes of a stage. */
+    struct StageParameters
+    {
+        float cutOffInHz = 0.0f;
+        int filterMode = 0;
+        int filterSlope = 0;
+        float resonance = 0.0f;
+        float filterGainInDb = 0.0f;
+        float filterMix = 0.0f;
+        juce::uint32 filterVersion = 0;
+
+        double delayInMs = 0.0;
+        float feedback = 0.0f;
+        int feedbackMode = 0;
+        float crossFeed = 0.0f;
+        float dampingLowPassInHz = 0.0f;
+        float dampingHighPassInHz = 0.0f;
+        float saturationDrive = 0.0f;
+        float modulationDepthInMs = 0.0f;
+        float modulationRateInHz = 0.0f;
+        int modulationNumVoices = 1;
+        float modulationStereoPhase = 0.0f;
+        float delayMix = 0.0f;
+        juce::uint32 delayVersion = 0;
+
+        float roomSize = 0.0f;
+        float reverbMix = 0.0f;
+        juce::uint32 reverbVersion = 0;
+
+        int mixLaw = 0;
+
+        int quality = 0;
+    };
+
+    /** Processes a block or a frame, with adaptive quality passing the time it took to the quality governor. */
+    void processMeasured(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        if (!_isAdaptiveQuality)
+        {
+            processBlock(context);
+            return;
+        }
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        processBlock(context);
+
+        const double secondsUsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        _qualityGovernor.process(secondsUsed, (double)context.getOutputBlock().getNumSamples() / _sampleRate);
+    }
+
+    /** Processes a block as process() describes, without measuring it. */
+    void processBlock(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        if (_isPipelineRunning)
+        {
+            if (_updateFilterFlag) { ++_filterVersion; _updateFilterFlag = false; }
+            if (_updateDelayFlag) { ++_delayVersion; _updateDelayFlag = false; }
+            if (_updateReverbFlag) { ++_reverbVersion; _updateReverbFlag = false; }
+
+            _pipeline.process(context.getOutputBlock(), getStageParameters());
+            return;
+        }
+
+        applyQuality(getQualityInUse());
+
+        if (_subBlockSize <= 0)
+        {
+            processChain(context);
+            return;
+        }
+
+        auto& block = context.getOutputBlock();
+        auto numSamples = block.getNumSamples();
+        auto subBlockSize = (size_t)_subBlockSize;
+
+        for (size_t offset = 0; offset < numSamples; offset += subBlockSize)
+        {
+            updateFilter();
+            updateDelay();
+            updateReverb();
+
+            auto subBlock = block.getSubBlock(offset, std::min(subBlockSize, numSamples - offset));
+            juce::dsp::ProcessContextReplacing<float> subContext(subBlock);
+            subContext.isBypassed = context.isBypassed;
+
+            processChain(subContext);
+        }
+    }
+
+    /** Runs the chain on a block, the filter and the delay as the channel mode says. */
+    void processChain(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        auto& block = context.getOutputBlock();
+
+        if (_channelMode == (int)ChannelMode::stereo || block.getNumChannels() != 2 || context.isBypassed)
+        {
+            processChainStereo(context);
+            return;
+        }
+
+        auto& delay = _pJuceFxChain->template get<idxDelay>();
+        auto first = block.getSingleChannelBlock(0);
+        juce::dsp::ProcessContextReplacing<float> firstContext(first);
+
+        if (_channelMode == (int)ChannelMode::dualMono)
+        {
+            const bool isDualMono = _dualMonoDetector.process(block.getChannelPointer(0), block.getChannelPointer(1), (int)block.getNumSamples());
+
+            if (!isDualMono || !delay.isChannelSymmetric())
+            {
+                processChainStereo(context);
+                return;
+            }
+
+            processFilter(firstContext);
+            delay.process(firstContext);
+            block.getSingleChannelBlock(1).copyFrom(first);
+        }
+        else
+        {
+            encodeMidSide(block);
+            processFilter(firstContext);
+            delay.process(firstContext);
+            decodeMidSide(block);
+        }
+
+        _isSecondChnlStale = true;
+        _pJuceFxChain->template get<idxReverb>().process(context);
+    }
+
+    /** Runs the chain on all channels, first bringing the filter and the delay of the second channel up to date if it was left out. */
+    void processChainStereo(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        if (_isSecondChnlStale)
+        {
+            _pJuceFxChain->template get<idxFilter>().copyChannel(0, 1);
+            _pJuceFxChain->template get<idxDelay>().copyChannel(0, 1);
+            _linearPhaseFilter.copyChannel(0, 1);
+            _isSecondChnlStale = false;
+        }
+
+        if (_isLinearPhaseRunning)
+            _linearPhaseFilter.process(context);
+
+        _pJuceFxChain->process(context);
+    }
+
+    /** Runs the filter stage on its own, the linear phase filter if it runs in its place. */
+    void processFilter(const juce::dsp::ProcessContextReplacing<float>& context)
+    {
+        if (_isLinearPhaseRunning)
+            _linearPhaseFilter.process(context);
+        else
+            _pJuceFxChain->template get<idxFilter>().process(context);
+    }
+
+    static void encodeMidSide(juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        auto* left = block.getChannelPointer(0);
+        auto* right = block.getChannelPointer(1);
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            const float mid = 0.5f * (left[i] + right[i]);
+            const float side = 0.5f * (left[i] - right[i]);
+
+            left[i] = mid;
+            right[i] = side;
+        }
+    }
+
+    static void decodeMidSide(juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        auto* mid = block.getChannelPointer(0);
+        auto* side = block.getChannelPointer(1);
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            const float left = mid[i] + side[i];
+            const float right = mid[i] - side[i];
+
+            mid[i] = left;
+            side[i] = right;
+        }
+    }
+
+    StageParameters getStageParameters()
+    {
+        StageParameters params;
+
+        params.cutOffInHz = _cutOffInHz;
+        params.filterMode = _filterMode;
+        params.filterSlope = _filterSlope;
+        params.resonance = _resonance;
+        params.filterGainInDb = _filterGainInDb;
+        params.filterMix = _filterMix;
+        params.filterVersion = _filterVersion;
+
+        params.delayInMs = _delayInMs;
+        params.feedback = _feedback;
+        params.feedbackMode = _feedbackMode;
+        params.crossFeed = _crossFeed;
+        params.dampingLowPassInHz = _dampingLowPassInHz;
+        params.dampingHighPassInHz = _dampingHighPassInHz;
+        params.saturationDrive = _saturationDrive;
+        params.modulationDepthInMs = _modulationDepthInMs;
+        params.modulationRateInHz = _modulationRateInHz;
+        params.modulationNumVoices = _modulationNumVoices;
+        params.modulationStereoPhase = _modulationStereoPhase;
+        params.delayMix = _delayMix;
+        params.delayVersion = _delayVersion;
+
+        params.roomSize = _roomSize;
+        params.reverbMix = _reverbMix;
+        params.reverbVersion = _reverbVersion;
+
+        params.mixLaw = _mixLaw;
+
+        params.quality = getQualityInUse();
+
+        return params;
+    }
+
+    /**
+        Designs the filter on the calling thread, the filter takes the coefficients over at its
+        next block. The linear phase filter gets the parameters passed on to its designer.
+    */
+    void applyFilter(const StageParameters& params)
+    {
+        if (_isLinearPhaseRunning)
+        {
+            _linearPhaseFilter.setParameters(toFilterParameters(params));
+            _linearPhaseFilter.setMix(params.filterMix);
+            _linearPhaseFilter.setMixLaw(MrDryWet::toLaw(params.mixLaw));
+        }
+
+        applyFilter(_pJuceFxChain->template get<idxFilter>(), params, _lowPassTable);
+    }
+
+    void applyDelay(const StageParameters& params)
+    {
+        applyDelay(_pJuceFxChain->template get<idxDelay>(), params);
+    }
+
+    void applyReverb(const StageParameters& params)
+    {
+        applyReverb(_pJuceFxChain->template get<idxReverb>(), params);
+    }
+
+    static MrFilter::Parameters toFilterParameters(const StageParameters& params)
+    {
+        MrFilter::Parameters filterParams;
+        filterParams.mode = MrFilter::toMode(params.filterMode);
+        filterParams.slope = MrFilter::toSlope(params.filterSlope);
+        filterParams.cutOffInHz = params.cutOffInHz;
+        filterParams.q = params.resonance;
+        filterParams.gainInDb = params.filterGainInDb;
+
+        return filterParams;
+    }
+
+    static void applyFilter(MrFilter& filter, const StageParameters& params, const MrDspTableCache::Table::Ptr& lowPassTable)
+    {
+        const auto filterParams = toFilterParameters(params);
+
+        // the table only holds the resonant low pass section of the default Q
+        const float* table = (lowPassTable != nullptr) ? lowPassTable->getData() : nullptr;
+        if (table != nullptr && params.resonance == MrDspTableCache::LOW_PASS_Q)
+        {
+            float coefs[MrDspTableCache::NUM_BIQUAD_COEFS];
+            MrDspTableCache::lookUpLowPassCoefs(table, params.cutOffInHz, coefs);
+            filter.setParameters(filterParams, coefs);
+        }
+        else
+        {
+            filter.setParameters(filterParams);
+        }
+
+        filter.setMix(params.filterMix);
+        filter.setMixLaw(MrDryWet::toLaw(params.mixLaw));
+    }
+
+    static void applyDelay(MrDelay<float>& delay, const StageParameters& params)
+    {
+        // changing the delay time resets the delay buffer, so it is only done if it actually changed
+        if (delay.msToSmpls((float)params.delayInMs) != delay.getDelayInSmpls())
+            delay.setDelayInMs(params.delayInMs);
+
+        delay.setFeedback(params.feedback);
+        delay.setFeedbackMode((MrDelay<float>::FeedbackMode)params.feedbackMode);
+        delay.setCrossFeed(params.crossFeed);
+        delay.setDampingLowPassInHz(params.dampingLowPassInHz);
+        delay.setDampingHighPassInHz(params.dampingHighPassInHz);
+        delay.setSaturationDrive(params.saturationDrive);
+        delay.setModulationDepthInMs(params.modulationDepthInMs);
+        delay.setModulationRateInHz(params.modulationRateInHz);
+        delay.setModulationNumVoices(params.modulationNumVoices);
+        delay.setModulationStereoPhase(params.modulationStereoPhase);
+        delay.setMix(params.delayMix);
+        delay.setMixLaw(MrDryWet::toLaw(params.mixLaw));
+    }
+
+    static void applyReverb(MrReverb& reverb, const StageParameters& params)
+    {
+        auto reverbParams = reverb.getParameters();
+
+        reverbParams.roomSize = params.roomSize;
+        reverb.setParameters(reverbParams);
+        reverb.setMix(params.reverbMix);
+        reverb.setMixLaw(MrDryWet::toLaw(params.mixLaw));
+    }
+
+    /** Switching to the tier in use is a no-op for stages already there. */
+    void applyQuality(int quality)
+    {
+        const auto tier = MrQuality::toTier(quality);
+
+        _pJuceFxChain->template get<idxFilter>().setQuality(tier);
+        _pJuceFxChain->template get<idxDelay>().setQuality(tier);
+        _pJuceFxChain->template get<idxReverb>().setQuality(tier);
+    }
+
+    void createChain()
+    {
+        if (_pJuceFxChain == nullptr)
+            _pJuceFxChain = std::unique_ptr<FxChain>(new FxChain());
+    }
+
+    bool isPreparingAsync()
+    {
+        return _isAsyncPrepare && !_isPipelined;
+    }
+
+    static bool isSameSpec(const juce::dsp::ProcessSpec& spec1, const juce::dsp::ProcessSpec& spec2)
+    {
+        return spec1.sampleRate == spec2.sampleRate && spec1.maximumBlockSize == spec2.maximumBlockSize && spec1.numChannels == spec2.numChannels;
+    }
+
+    /**
+        Sets up and prepares a new chain on the builder thread as setupFilter(), setupDelay(),
+        setupReverb() and prepare() would, with the parameters as they are now. The chain in
+        use is only stale if it was prepared for another spec.
+    */
+    void prepareChainAsync(const juce::dsp::ProcessSpec& chainSpec)
+    {
+        _isChainStale = _isChainStale || !isSameSpec(chainSpec, _chainSpec);
+        _chainSpec = chainSpec;
+
+        const auto params = getStageParameters();
+        const auto lowPassTable = _lowPassTable;
+        const float maxDelayInMs = DELAY_MAX_IN_MS;
+        const bool isFilterBypassed = _isLinearPhase;
+
+        _chainBuilder.build([chainSpec, params, lowPassTable, maxDelayInMs, isFilterBypassed]
+        {
+            auto chain = std::unique_ptr<FxChain>(new FxChain());
+
+            auto& filter = chain->template get<idxFilter>();
+            filter.prepare(chainSpec);
+            applyFilter(filter, params, lowPassTable);
+            filter.reset();
+
+            auto& delay = chain->template get<idxDelay>();
+            delay.setMaxDelayInMs(maxDelayInMs);
+            delay.setDelayInMs(params.delayInMs);
+            delay.prepare(chainSpec);
+            applyDelay(delay, params);
+
+            applyReverb(chain->template get<idxReverb>(), params);
+
+            chain->prepare(chainSpec);
+            chain->template setBypassed<idxFilter>(isFilterBypassed);
+
+            return chain;
+        });
+    }
+
+    /** Brings a chain taken over from the builder up to date with the parameters set while it was built. */
+    void takeOverChain()
+    {
+        const auto params = getStageParameters();
+
+        applyFilter(params);
+        applyDelay(params);
+        applyReverb(params);
+
+        _updateFilterFlag = _updateDelayFlag = _updateReverbFlag = false;
+        _isSecondChnlStale = false;
+        _isChainStale = !_chainBuilder.isUpToDate();
+    }
+
+    /** One pipeline stage per chain stage, each applying its parameters if they changed since its last block. */
+    void startPipeline(juce::dsp::ProcessSpec& spec)
+    {
+        _filterVersionApplied = _filterVersion;
+        _delayVersionApplied = _delayVersion;
+        _reverbVersionApplied = _reverbVersion;
+        _filterQualityApplied = _delayQualityApplied = _reverbQualityApplied = -1;
+
+        _pipeline.prepare((int)spec.numChannels, (int)spec.maximumBlockSize,
+        {
+            [this](juce::dsp::AudioBlock<float>& block, const StageParameters& params)
+            {
+                if (params.filterVersion != _filterVersionApplied)
+                {
+                    applyFilter(params);
+                    _filterVersionApplied = params.filterVersion;
+                }
+
+                if (params.quality != _filterQualityApplied)
+                {
+                    _pJuceFxChain->template get<idxFilter>().setQuality(MrQuality::toTier(params.quality));
+                    _filterQualityApplied = params.quality;
+                }
+
+                processFilter(juce::dsp::ProcessContextReplacing<float>(block));
+            },
+            [this](juce::dsp::AudioBlock<float>& block, const StageParameters& params)
+            {
+                if (params.delayVersion != _delayVersionApplied)
+                {
+                    applyDelay(params);
+                    _delayVersionApplied = params.delayVersion;
+                }
+
+                if (params.quality != _delayQualityApplied)
+                {
+                    _pJuceFxChain->template get<idxDelay>().setQuality(MrQuality::toTier(params.quality));
+                    _delayQualityApplied = params.quality;
+                }
+
+                _pJuceFxChain->template get<idxDelay>().process(juce::dsp::ProcessContextReplacing<float>(block));
+            },
+            [this](juce::dsp::AudioBlock<float>& block, const StageParameters& params)
+            {
+                if (params.reverbVersion != _reverbVersionApplied)
+                {
+                    applyReverb(params);
+                    _reverbVersionApplied = params.reverbVersion;
+                }
+
+                if (params.quality != _reverbQualityApplied)
+                {
+                    _pJuceFxChain->template get<idxReverb>().setQuality(MrQuality::toTier(params.quality));
+                    _reverbQualityApplied = params.quality;
+                }
+
+                _pJuceFxChain->template get<idxReverb>().process(juce::dsp::ProcessContextReplacing<float>(block));
+            }
+        },
+        getStageParameters());
+
+        _isPipelineRunning = true;
+    }
+
+    /** The setup touches the stages, so the workers must be stopped before. */
+    void stopPipeline()
+    {
+        _pipeline.stop();
+        _isPipelineRunning = false;
+    }
+
+    /* keeps the flags and versions written every block off the cache lines of neighbouring instances */
+    MrCacheLine::Padding _padBefore;
+
+    std::unique_ptr<FxChain> _pJuceFxChain;
     double _sampleRate;
+
+    bool _isAsyncPrepare = IS_ASYNC_PREPARE;
+    bool _isChainStale = true;  /* until the chain is created and prepared */
+    juce::dsp::ProcessSpec _chainSpec{};
+    MrResourceBuilder<FxChain> _chainBuilder;
+
+    juce::SharedResourcePointer<MrDspTableCache> _dspTableCache;
+    MrDspTableCache::Table::Ptr _lowPassTable;
+
+    int _subBlockSize = SUB_BLOCK_SIZE;
+    int _frameSize = FRAME_SIZE;
+    bool _isReblocking = false;
+    MrReblocker _reblocker;
+    bool _isPipelined = IS_PIPELINED;
+    bool _isPipelineRunning = false;
+    bool _isLinearPhase = IS_LINEAR_PHASE;
+    bool _isLinearPhaseRunning = false;
+
+    int _channelMode = CHANNEL_MODE;
+    MrDualMonoDetector _dualMonoDetector;
+    bool _isSecondChnlStale = false;
+
+    int _quality = QUALITY;
+    bool _isAdaptiveQuality = IS_ADAPTIVE_QUALITY;
+    double _loadBudget = LOAD_BUDGET;
+    MrQualityGovernor _qualityGovernor;
     
     bool _updateFilterFlag = false;
     float _cutOffInHz;
+    int _filterMode;
+    int _filterSlope;
+    float _resonance;
+    float _filterGainInDb;
+
+    float _filterMix;
 
     bool _updateReverbFlag = false;
     float _roomSize;
+    float _reverbMix;
 
     bool _updateDelayFlag = false;
     double _delayInMs;
     float _feedback;
+    int _feedbackMode;
+    float _crossFeed;
+    float _dampingLowPassInHz;
+    float _dampingHighPassInHz;
+    float _saturationDrive;
+    float _modulationDepthInMs;
+    float _modulationRateInHz;
+    int _modulationNumVoices;
+    float _modulationStereoPhase;
+    float _delayMix;
+
+    int _mixLaw = MIX_LAW;
+    MrDryWet _dryWet{ MIX };
+    MrDryLine _dryLine;
+    bool _isDryLineInUse = false;
+
+    /* counted up on the calling thread, the applied ones are only touched by the stage of their own */
+    juce::uint32 _filterVersion = 0, _delayVersion = 0, _reverbVersion = 0;
+    juce::uint32 _filterVersionApplied = 0, _delayVersionApplied = 0, _reverbVersionApplied = 0;
+    int _filterQualityApplied = -1, _delayQualityApplied = -1, _reverbQualityApplied = -1;
+
+    MrLinearPhaseFilter _linearPhaseFilter;
+
+    // declared after the chain, so its workers are stopped before the chain goes
+    MrStagePipeline<StageParameters> _pipeline;
+
+    MrCacheLine::Padding _padAfter;
 };
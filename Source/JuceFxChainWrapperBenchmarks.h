@@ -0,0 +1,393 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrSignal.h"
+#include "MrParameterEvents.h"
+#include "JuceFxChainWrapper.h"
+#include "PluginProcessor.h"
+
+class JuceFxChainWrapperBenchmarks : public juce::UnitTest
+{
+public:
+
+    JuceFxChainWrapperBenchmarks() : juce::UnitTest("JuceFxChainWrapper benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        beginTest("Full block vs. fused sub block execution");
+        {
+            const int numChnls = 2;
+            const int numRuns = 200;
+            const int blockSizes[] = { 512, 2048, 4096 };
+            const int subBlockSizes[] = { 0, 64, 128, 256 };
+
+            for (auto blockSize : blockSizes)
+            {
+                juce::AudioBuffer<float> buffer(numChnls, blockSize);
+
+                for (auto subBlockSize : subBlockSizes)
+                {
+                    auto wrapper = createPreparedWrapper(numChnls, blockSize);
+                    wrapper->setSubBlockSize(subBlockSize);
+
+                    juce::AudioSourceChannelInfo audioSrcChnlInfo(buffer);
+                    MrSignal::ramp(audioSrcChnlInfo);
+
+                    auto result = MrBenchmark::run([&]
+                        {
+                            juce::dsp::AudioBlock<float> block(buffer);
+                            wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+                        }, numRuns);
+
+                    auto name = "block " + juce::String(blockSize)
+                        + (subBlockSize > 0 ? ", sub block " + juce::String(subBlockSize) : juce::String(", full block"));
+
+                    logMessage(MrBenchmark::format(name, result, blockSize));
+                }
+            }
+        }
+
+        beginTest("Cost vs. number of parameter change events per block");
+        {
+            const int numChnls = 2;
+            const int blockSize = 1024;
+            const int numRuns = 200;
+            const int numEventsPerBlock[] = { 0, 1, 4, 16, 64 };
+
+            juce::AudioBuffer<float> buffer(numChnls, blockSize);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(buffer);
+
+            for (auto numEvents : numEventsPerBlock)
+            {
+                auto wrapper = createPreparedWrapper(numChnls, blockSize);
+                MrParameterEvents events;
+                MrSignal::ramp(audioSrcChnlInfo);
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        for (int i = 0; i < numEvents; ++i)
+                            events.add((i * blockSize) / numEvents, i % 2, (i % 4 < 2) ? 0.4f : 0.6f);
+
+                        juce::dsp::AudioBlock<float> block(buffer);
+
+                        events.process(blockSize,
+                            [&](const MrParameterEvents::Event& event)
+                            {
+                                if (event.paramIdx == 0)
+                                    wrapper->setCutOffInHz(1000.0f * event.value);
+                                else
+                                    wrapper->setFeedback(event.value);
+                            },
+                            [&](int startSample, int numSamples)
+                            {
+                                wrapper->updateFilter();
+                                wrapper->updateDelay();
+                                wrapper->updateReverb();
+
+                                auto subBlock = block.getSubBlock((size_t)startSample, (size_t)numSamples);
+                                wrapper->process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+                            });
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format("block " + juce::String(blockSize) + ", "
+                    + juce::String(numEvents) + " events", result, blockSize));
+            }
+        }
+
+        beginTest("Achievable channel count, direct vs. pipelined");
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 512;
+            const int numRuns = 200;
+            const int numChnlsToTry[] = { 2, 8, 16, 32, 64, 128 };
+            const double secondsPerBlock = blockSize / sampleRate;
+
+            for (auto isPipelined : { false, true })
+            {
+                int numChnlsAchievable = 0;
+
+                for (auto numChnls : numChnlsToTry)
+                {
+                    auto wrapper = createPreparedWrapper(numChnls, blockSize, isPipelined);
+
+                    juce::AudioBuffer<float> buffer(numChnls, blockSize);
+                    juce::dsp::AudioBlock<float> block(buffer);
+                    MrSignal::whiteNoise(block, 0.5f);
+
+                    // pipelined, a call takes as long as the slowest stage, the others run meanwhile,
+                    // called back to back it has to wait for them rather than drop blocks
+                    wrapper->setNonRealtime(true);
+
+                    auto result = MrBenchmark::run([&]
+                        {
+                            wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+                        }, numRuns);
+
+                    const bool isInTime = result.p99 < secondsPerBlock;
+                    if (isInTime)
+                        numChnlsAchievable = numChnls;
+
+                    juce::String underruns;
+                    if (isPipelined)
+                        underruns = ", " + juce::String(countUnderrunsInRealTime(*wrapper, block, numRuns, secondsPerBlock))
+                            + " of " + juce::String(numRuns) + " blocks dropped in real time";
+
+                    logMessage(MrBenchmark::format(juce::String(isPipelined ? "pipelined, " : "direct, ") + juce::String(numChnls)
+                        + " channels", result, blockSize * numChnls)
+                        + ", load " + juce::String(100.0 * result.median / secondsPerBlock, 1) + " %"
+                        + (isInTime ? "" : " (misses the deadline)") + underruns);
+                }
+
+                logMessage(juce::String(isPipelined ? "pipelined" : "direct") + ": up to " + juce::String(numChnlsAchievable)
+                    + " channels in real time at " + juce::String(blockSize) + " samples, latency "
+                    + juce::String(createPreparedWrapper(2, blockSize, isPipelined)->getLatencyInSmpls()) + " samples");
+            }
+        }
+
+        beginTest("Channel modes, stereo vs. dual mono vs. mid/side");
+        {
+            const int blockSize = 512;
+            const int numRuns = 500;
+
+            using ChannelMode = JuceFxChainWrapper::ChannelMode;
+
+            struct Case
+            {
+                const char* name;
+                ChannelMode channelMode;
+                bool isInputDualMono;
+            };
+
+            const Case cases[] = {
+                { "stereo", ChannelMode::stereo, true },
+                { "dual mono, dual mono input", ChannelMode::dualMono, true },
+                { "dual mono, stereo input", ChannelMode::dualMono, false },
+                { "mid/side", ChannelMode::midSide, false }
+            };
+
+            for (auto& c : cases)
+            {
+                auto wrapper = createPreparedWrapper(2, blockSize);
+                wrapper->setChannelMode((int)c.channelMode);
+
+                juce::AudioBuffer<float> input(2, blockSize);
+                juce::dsp::AudioBlock<float> inputBlock(input);
+                MrSignal::whiteNoise(inputBlock, 0.5f);
+
+                if (!c.isInputDualMono)
+                    MrSignal::whiteNoise(inputBlock.getSingleChannelBlock(1), 0.5f, 7);
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::dsp::AudioBlock<float> block(buffer);
+
+                // the chain runs in place, so every run starts from the same input
+                auto result = MrBenchmark::run([&]
+                    {
+                        block.copyFrom(inputBlock);
+                        wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(c.name, result, blockSize));
+            }
+        }
+
+        beginTest("Quality tiers, eco vs. normal vs. high, with a modulated delay");
+        {
+            const int blockSize = 512;
+            const int numRuns = 500;
+
+            for (int quality = 0; quality < MrQuality::NUM_TIERS; ++quality)
+            {
+                auto wrapper = createPreparedWrapper(2, blockSize);
+                wrapper->setModulationDepthInMs(3.0f);
+                wrapper->setModulationNumVoices(4);
+                wrapper->setQuality(quality);
+                wrapper->updateDelay();
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::dsp::AudioBlock<float> block(buffer);
+                MrSignal::whiteNoise(block, 0.5f);
+
+                auto result = MrBenchmark::run([&] { wrapper->process(juce::dsp::ProcessContextReplacing<float>(block)); }, numRuns);
+
+                logMessage(MrBenchmark::format(MrQuality::getName(MrQuality::toTier(quality)), result, blockSize));
+            }
+        }
+
+        beginTest("First prepare, on the calling thread vs. asynchronously, and until the chain is in use");
+        {
+            const int blockSize = 512;
+            const int numRuns = 20;
+            const int channelCounts[] = { 2, 8 };
+
+            juce::AudioBuffer<float> buffer(8, 0);
+            juce::dsp::AudioBlock<float> emptyBlock(buffer);
+
+            for (auto numChnls : channelCounts)
+            {
+                juce::dsp::ProcessSpec spec;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = blockSize;
+                spec.numChannels = (juce::uint32)numChnls;
+
+                auto emptyBlockChannels = emptyBlock.getSubsetChannelBlock(0, (size_t)numChnls);
+
+                for (auto isAsyncPrepare : { false, true })
+                {
+                    // a wrapper per run, as a host loading the plugin or changing the sample rate makes the chain allocate anew
+                    std::vector<std::unique_ptr<JuceFxChainWrapper>> wrappers;
+                    for (int i = 0; i < 2 * numRuns + 4; ++i)
+                    {
+                        wrappers.push_back(std::make_unique<JuceFxChainWrapper>());
+                        wrappers.back()->setAsyncPrepare(isAsyncPrepare);
+                    }
+
+                    size_t idx = 0;
+                    auto prepare = [&]
+                    {
+                        auto& wrapper = *wrappers[idx++];
+
+                        wrapper.setupFilter(spec);
+                        wrapper.setupDelay(spec);
+                        wrapper.setupReverb();
+                        wrapper.prepare(spec);
+
+                        return &wrapper;
+                    };
+
+                    auto prepareAndWait = [&]
+                    {
+                        auto* wrapper = prepare();
+                        while (!wrapper->isChainUpToDate())
+                            wrapper->process(juce::dsp::ProcessContextReplacing<float>(emptyBlockChannels));
+                    };
+
+                    // building asynchronously also constructs the chain, which the wrapper preparing on the calling thread did when it was created
+                    const juce::String name = juce::String(numChnls) + " channels, " + (isAsyncPrepare ? "asynchronously" : "on the calling thread");
+
+                    auto result = MrBenchmark::run([&] { prepare(); }, numRuns, 2);
+                    logMessage(MrBenchmark::format(name + ", prepare", result, 0));
+
+                    result = MrBenchmark::run(prepareAndWait, numRuns, 2);
+                    logMessage(MrBenchmark::format(name + ", until in use", result, 0));
+                }
+            }
+        }
+
+        beginTest("Small blocks, chain behind the interface vs. embedded");
+        {
+            const int numInstances = 32;
+            const int numRuns = 500;
+            const int blockSizes[] = { 16, 32 };
+
+            for (auto blockSize : blockSizes)
+            {
+                // as the processor held its chain before, through a shared pointer to the interface, and as it holds it now, by value
+                std::vector<std::shared_ptr<IJuceFxChainWrapper>> wrappersBehindInterface;
+                std::vector<std::unique_ptr<MrJuceFxChainPlusAudioProcessor>> processors;
+                std::vector<juce::AudioBuffer<float>> buffers;
+
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    wrappersBehindInterface.push_back(createPreparedWrapper(2, blockSize));
+
+                    processors.push_back(std::make_unique<MrJuceFxChainPlusAudioProcessor>());
+                    prepareWrapper(processors.back()->getChainWrapper(), 2, blockSize);
+
+                    buffers.emplace_back(2, blockSize);
+                    juce::dsp::AudioBlock<float> block(buffers.back());
+                    MrSignal::whiteNoise(block, 0.5f, (juce::uint32)(i + 1));
+                }
+
+                auto resultBehindInterface = MrBenchmark::run([&]
+                    {
+                        for (int i = 0; i < numInstances; ++i)
+                            processBlock(*wrappersBehindInterface[(size_t)i], buffers[(size_t)i]);
+                    }, numRuns);
+
+                auto resultEmbedded = MrBenchmark::run([&]
+                    {
+                        for (int i = 0; i < numInstances; ++i)
+                            processBlock(processors[(size_t)i]->getChainWrapper(), buffers[(size_t)i]);
+                    }, numRuns);
+
+                const auto name = "block " + juce::String(blockSize) + ", " + juce::String(numInstances) + " instances, ";
+
+                logMessage(MrBenchmark::format(name + "behind the interface", resultBehindInterface, blockSize * numInstances));
+                logMessage(MrBenchmark::format(name + "embedded", resultEmbedded, blockSize * numInstances));
+            }
+        }
+    }
+
+private:
+
+    /** Calls on the chain what the processor calls for every block, virtually for the interface and directly for the wrapper. */
+    template <typename ChainWrapper>
+    static void processBlock(ChainWrapper& wrapper, juce::AudioBuffer<float>& buffer)
+    {
+        wrapper.updateFilter();
+        wrapper.updateReverb();
+        wrapper.updateDelay();
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    /** Calls the wrapper in real time once per block period, like an audio callback, and returns the blocks the pipeline dropped. */
+    static int countUnderrunsInRealTime(JuceFxChainWrapper& wrapper, juce::dsp::AudioBlock<float>& block, int numBlocks, double secondsPerBlock)
+    {
+        wrapper.setNonRealtime(false);
+        const int numUnderrunsBefore = wrapper.getNumPipelineUnderruns();
+
+        const double msPerBlock = 1000.0 * secondsPerBlock;
+        double msNextBlock = juce::Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+            msNextBlock += msPerBlock;
+            const int msToSleep = (int)(msNextBlock - juce::Time::getMillisecondCounterHiRes());
+            if (msToSleep > 0)
+                juce::Thread::sleep(msToSleep);
+        }
+
+        return wrapper.getNumPipelineUnderruns() - numUnderrunsBefore;
+    }
+
+    std::unique_ptr<JuceFxChainWrapper> createPreparedWrapper(int numChnls, int numSamples, bool isPipelined = false)
+    {
+        auto wrapper = std::make_unique<JuceFxChainWrapper>();
+        prepareWrapper(*wrapper, numChnls, numSamples, isPipelined);
+
+        return wrapper;
+    }
+
+    /** Prepares a wrapper wherever it lives, on its own or inside a processor. */
+    static void prepareWrapper(JuceFxChainWrapper& wrapper, int numChnls, int numSamples, bool isPipelined = false)
+    {
+        wrapper.setPipelined(isPipelined);
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = 48000;
+        spec.maximumBlockSize = numSamples;
+        spec.numChannels = numChnls;
+
+        wrapper.setupFilter(spec);
+        wrapper.setupDelay(spec);
+        wrapper.setupReverb();
+        wrapper.prepare(spec);
+
+        wrapper.updateFilter();
+        wrapper.updateDelay();
+        wrapper.updateReverb();
+    }
+};
+
+static JuceFxChainWrapperBenchmarks juceFxChainWrapperBenchmarks;
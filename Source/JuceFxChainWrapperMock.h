@@ -35,12 +35,99 @@ public:
 	void updateDelay() { _log.push_back(__func__); }
 
 	void process(juce::dsp::ProcessContextReplacing<float> context) { _log.push_back(__func__); }
+
+	void setSubBlockSize(int subBlockSize) { _log.push_back(__func__); };
+	int getSubBlockSize() { _log.push_back(__func__); return 0; };
+	void setFrameSize(int frameSize) { _log.push_back(__func__); };
+	int getFrameSize() { _log.push_back(__func__); return 0; };
+
+	void setPipelined(bool isPipelined) { _log.push_back(__func__); };
+	bool isPipelined() { _log.push_back(__func__); return false; };
+	void setNonRealtime(bool isNonRealtime) { _log.push_back(__func__); };
+	bool isNonRealtime() { _log.push_back(__func__); return false; };
+	void setLinearPhase(bool isLinearPhase) { _log.push_back(__func__); };
+	bool isLinearPhase() { _log.push_back(__func__); return false; };
+	void setAsyncPrepare(bool isAsyncPrepare) { _log.push_back(__func__); };
+	bool isAsyncPrepare() { _log.push_back(__func__); return false; };
+
+	void setChannelMode(int channelMode) { _log.push_back(__func__); };
+	int getChannelMode() { _log.push_back(__func__); return 0; };
+
+	void setQuality(int quality) { _log.push_back(__func__); };
+	int getQuality() { _log.push_back(__func__); return 0; };
+
+	void setAdaptiveQuality(bool isAdaptiveQuality) { _log.push_back(__func__); };
+	bool isAdaptiveQuality() { _log.push_back(__func__); return false; };
+
+	int getQualityInUse() { _log.push_back(__func__); return 0; };
+
+	int getLatencyInSmpls() { _log.push_back(__func__); return 0; };
 	void setDelayInMs(double delayInMs) { _log.push_back(__func__); };
 	double getDelayInMs() { _log.push_back(__func__); return 0.0f; };
 
 	void setFeedback(float feedback) { _log.push_back(__func__); };
 	float getFeedback() { _log.push_back(__func__); return 0.0f; };
 
+	void setFeedbackMode(int feedbackMode) { _log.push_back(__func__); };
+	int getFeedbackMode() { _log.push_back(__func__); return 0; };
+
+	void setCrossFeed(float crossFeed) { _log.push_back(__func__); };
+	float getCrossFeed() { _log.push_back(__func__); return 0.0f; };
+
+	void setDampingLowPassInHz(float dampingLowPassInHz) { _log.push_back(__func__); };
+	float getDampingLowPassInHz() { _log.push_back(__func__); return 0.0f; };
+
+	void setDampingHighPassInHz(float dampingHighPassInHz) { _log.push_back(__func__); };
+	float getDampingHighPassInHz() { _log.push_back(__func__); return 0.0f; };
+
+	void setSaturationDrive(float saturationDrive) { _log.push_back(__func__); };
+	float getSaturationDrive() { _log.push_back(__func__); return 0.0f; };
+
+	void setModulationDepthInMs(float modulationDepthInMs) { _log.push_back(__func__); };
+	float getModulationDepthInMs() { _log.push_back(__func__); return 0.0f; };
+
+	void setModulationRateInHz(float modulationRateInHz) { _log.push_back(__func__); };
+	float getModulationRateInHz() { _log.push_back(__func__); return 0.0f; };
+
+	void setModulationNumVoices(int modulationNumVoices) { _log.push_back(__func__); };
+	int getModulationNumVoices() { _log.push_back(__func__); return 0; };
+
+	void setModulationStereoPhase(float modulationStereoPhase) { _log.push_back(__func__); };
+	float getModulationStereoPhase() { _log.push_back(__func__); return 0.0f; };
+
+	void setCutOffInHz(float cutOffInHz) { _log.push_back(__func__); };
+	float getCutOffInHz() { _log.push_back(__func__); return 0.0f; };
+
+	void setFilterMode(int filterMode) { _log.push_back(__func__); };
+	int getFilterMode() { _log.push_back(__func__); return 0; };
+
+	void setFilterSlope(int filterSlope) { _log.push_back(__func__); };
+	int getFilterSlope() { _log.push_back(__func__); return 0; };
+
+	void setResonance(float resonance) { _log.push_back(__func__); };
+	float getResonance() { _log.push_back(__func__); return 0.0f; };
+
+	void setFilterGainInDb(float filterGainInDb) { _log.push_back(__func__); };
+	float getFilterGainInDb() { _log.push_back(__func__); return 0.0f; };
+
+	void setRoomSize(float roomSize) { _log.push_back(__func__); };
+	float getRoomSize() { _log.push_back(__func__); return 0.0f; };
+
+	void setFilterMix(float filterMix) { _log.push_back(__func__); };
+	float getFilterMix() { _log.push_back(__func__); return 0.0f; };
+
+	void setDelayMix(float delayMix) { _log.push_back(__func__); };
+	float getDelayMix() { _log.push_back(__func__); return 0.0f; };
+
+	void setReverbMix(float reverbMix) { _log.push_back(__func__); };
+	float getReverbMix() { _log.push_back(__func__); return 0.0f; };
+
+	void setMix(float mix) { _log.push_back(__func__); };
+	float getMix() { _log.push_back(__func__); return 0.0f; };
+
+	void setMixLaw(int mixLaw) { _log.push_back(__func__); };
+	int getMixLaw() { _log.push_back(__func__); return 0; };
+
 	bool atLeastOneCallToFunction(char *cfunc)
 	{
 		std::string func(cfunc);
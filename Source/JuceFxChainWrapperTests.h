@@ -1,14 +1,736 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MrSignal.h"
+#include "JuceFxChainWrapper.h"
 
-class MrDelayTests : public juce::UnitTest
+class JuceFxChainWrapperTests : public juce::UnitTest
 {
 public:
 
-    MrDelayTests() : juce::UnitTest("mrDelay testing") {}
+    JuceFxChainWrapperTests() : juce::UnitTest("JuceFxChainWrapper testing") {}
 
     void runTest() override
     {
+        beginTest("When processing in sub blocks then the output equals processing the whole block.");
+        {
+            const int numChnls = 2;
+            const int numSamples = 4096;
+            const int subBlockSize = 128;
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferFull(numChnls, numSamples);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(bufferFull);
+            MrSignal::impulse(audioSrcChnlInfo, 1.0f);
+
+            juce::AudioBuffer<float> bufferFused;
+            bufferFused.makeCopyOf(bufferFull);
+
+            /// execute...
+            auto wrapperFull = createPreparedWrapper(numChnls, numSamples);
+            auto wrapperFused = createPreparedWrapper(numChnls, numSamples);
+            wrapperFused->setSubBlockSize(subBlockSize);
+
+            juce::dsp::AudioBlock<float> blockFull(bufferFull);
+            wrapperFull->process(juce::dsp::ProcessContextReplacing<float>(blockFull));
+
+            juce::dsp::AudioBlock<float> blockFused(bufferFused);
+            wrapperFused->process(juce::dsp::ProcessContextReplacing<float>(blockFused));
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    expect(abs(bufferFull.getSample(channel, i) - bufferFused.getSample(channel, i)) < deltaExpected);
+        }
+
+        beginTest("When pipelined then the output equals the direct output delayed by the reported latency.");
+        {
+            const int numChnls = 2;
+            const int blockSize = 256;
+            const int numSamples = 8192;
+            const int hostBlockSizes[] = { 256, 100, 37, 256, 1, 200 };
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferDirect(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> blockDirect(bufferDirect);
+            MrSignal::whiteNoise(blockDirect, 0.5f);
+
+            juce::AudioBuffer<float> bufferPipelined;
+            bufferPipelined.makeCopyOf(bufferDirect);
+            juce::dsp::AudioBlock<float> blockPipelined(bufferPipelined);
+
+            auto wrapperDirect = createPreparedWrapper(numChnls, blockSize);
+            auto wrapperPipelined = createPreparedWrapper(numChnls, blockSize, true);
+            const int latency = wrapperPipelined->getLatencyInSmpls();
+
+            /// execute...
+            for (int pos = 0, n = 0; pos < numSamples; ++n)
+            {
+                const int num = std::min(numSamples - pos, hostBlockSizes[n % 6]);
+
+                auto subBlockDirect = blockDirect.getSubBlock((size_t)pos, (size_t)num);
+                wrapperDirect->process(juce::dsp::ProcessContextReplacing<float>(subBlockDirect));
+
+                auto subBlockPipelined = blockPipelined.getSubBlock((size_t)pos, (size_t)num);
+                wrapperPipelined->process(juce::dsp::ProcessContextReplacing<float>(subBlockPipelined));
+
+                pos += num;
+            }
+
+            /// evaluate...
+            expectEquals(latency, 3 * blockSize);
+            expectEquals(createPreparedWrapper(numChnls, blockSize)->getLatencyInSmpls(), 0);
+
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                for (int i = 0; i < latency; ++i)
+                    expectEquals(bufferPipelined.getSample(channel, i), 0.0f);
+
+                for (int i = latency; i < numSamples; ++i)
+                    expect(abs(bufferPipelined.getSample(channel, i) - bufferDirect.getSample(channel, i - latency)) < deltaExpected);
+            }
+        }
+
+        beginTest("When pipelined then an impulse comes out of the chain the reported latency after it went in.");
+        {
+            const int numChnls = 2;
+            const int blockSize = 256;
+            const int numSamples = 4096;
+            const int impulsePos = 1000;
+            const int hostBlockSizes[] = { 100, 37, 256, 1, 200 };
+
+            for (auto isPipelined : { false, true })
+            {
+                /// prepare...
+                juce::AudioBuffer<float> buffer(numChnls, numSamples);
+                juce::dsp::AudioBlock<float> block(buffer);
+                block.clear();
+                MrSignal::impulse(block.getSubBlock((size_t)impulsePos), 1.0f);
+
+                auto wrapper = createPreparedWrapper(numChnls, blockSize, isPipelined);
+                const int latency = wrapper->getLatencyInSmpls();
+
+                /// execute...
+                for (int pos = 0, n = 0; pos < numSamples; ++n)
+                {
+                    const int num = std::min(numSamples - pos, hostBlockSizes[n % 5]);
+
+                    auto subBlock = block.getSubBlock((size_t)pos, (size_t)num);
+                    wrapper->process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+
+                    pos += num;
+                }
+
+                /// evaluate...
+                for (int channel = 0; channel < numChnls; ++channel)
+                {
+                    int posFirst = 0;
+                    while (posFirst < numSamples && buffer.getSample(channel, posFirst) == 0.0f)
+                        ++posFirst;
+
+                    expectEquals(posFirst, impulsePos + latency);
+                }
+            }
+        }
+
+        beginTest("When pipelined and prepared again then the stages keep the tier and the parameters set, the output equals the direct output delayed by the reported latency.");
+        {
+            const int numChnls = 2;
+            const int blockSize = 256;
+            const int numSamples = 8192;
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferDirect(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> blockDirect(bufferDirect);
+            MrSignal::whiteNoise(blockDirect, 0.5f);
+
+            juce::AudioBuffer<float> bufferPipelined;
+            bufferPipelined.makeCopyOf(bufferDirect);
+            juce::dsp::AudioBlock<float> blockPipelined(bufferPipelined);
+
+            auto wrapperDirect = createPreparedWrapper(numChnls, blockSize);
+            auto wrapperPipelined = createPreparedWrapper(numChnls, blockSize, true);
+
+            juce::AudioBuffer<float> bufferSilent(numChnls, blockSize);
+            juce::dsp::AudioBlock<float> blockSilent(bufferSilent);
+
+            for (auto* wrapper : { wrapperDirect.get(), wrapperPipelined.get() })
+            {
+                wrapper->setQuality((int)MrQuality::Tier::high);
+                wrapper->setRoomSize(0.7f);
+                // wet only, a mix of 0 on the blocks priming the pipeline would ramp the dry signal back in
+                wrapper->setReverbMix(1.0f);
+                wrapper->updateReverb();
+
+                // silent blocks until the stages have crossfaded to the high tier
+                for (int i = 0; i < 8; ++i)
+                {
+                    blockSilent.clear();
+                    wrapper->process(juce::dsp::ProcessContextReplacing<float>(blockSilent));
+                }
+            }
+
+            // prepared again the pipeline starts over, with the versions counted up already
+            juce::dsp::ProcessSpec spec;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = (juce::uint32)blockSize;
+            spec.numChannels = (juce::uint32)numChnls;
+
+            wrapperDirect->prepare(spec);
+            wrapperPipelined->prepare(spec);
+            const int latency = wrapperPipelined->getLatencyInSmpls();
+
+            /// execute...
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                auto subBlockDirect = blockDirect.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperDirect->process(juce::dsp::ProcessContextReplacing<float>(subBlockDirect));
+
+                auto subBlockPipelined = blockPipelined.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperPipelined->process(juce::dsp::ProcessContextReplacing<float>(subBlockPipelined));
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+                for (int i = latency; i < numSamples; ++i)
+                    expect(abs(bufferPipelined.getSample(channel, i) - bufferDirect.getSample(channel, i - latency)) < deltaExpected);
+        }
+
+        beginTest("When in frames then the output equals processing the frames directly, delayed by the reported latency.");
+        {
+            const int numChnls = 2;
+            const int frameSize = 128;
+            const int numSamples = 8192;
+            const int hostBlockSizes[] = { 256, 100, 37, 700, 1, 200 };
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferDirect(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> blockDirect(bufferDirect);
+            MrSignal::whiteNoise(blockDirect, 0.5f);
+
+            juce::AudioBuffer<float> bufferFramed;
+            bufferFramed.makeCopyOf(bufferDirect);
+            juce::dsp::AudioBlock<float> blockFramed(bufferFramed);
+
+            auto wrapperDirect = createPreparedWrapper(numChnls, frameSize);
+            auto wrapperFramed = std::make_unique<JuceFxChainWrapper>();
+            wrapperFramed->setFrameSize(frameSize - 1);
+
+            // prepared for a smaller block size than the host sends
+            juce::dsp::ProcessSpec spec;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = 64;
+            spec.numChannels = numChnls;
+
+            wrapperFramed->setupFilter(spec);
+            wrapperFramed->setupDelay(spec);
+            wrapperFramed->setupReverb();
+            wrapperFramed->prepare(spec);
+            wrapperFramed->updateFilter();
+            wrapperFramed->updateDelay();
+            wrapperFramed->updateReverb();
+
+            const int latency = wrapperFramed->getLatencyInSmpls();
+
+            /// execute...
+            for (int pos = 0; pos < numSamples; pos += frameSize)
+            {
+                auto frame = blockDirect.getSubBlock((size_t)pos, (size_t)frameSize);
+                wrapperDirect->process(juce::dsp::ProcessContextReplacing<float>(frame));
+            }
+
+            for (int pos = 0, n = 0; pos < numSamples; ++n)
+            {
+                const int num = std::min(numSamples - pos, hostBlockSizes[n % 6]);
+
+                auto subBlock = blockFramed.getSubBlock((size_t)pos, (size_t)num);
+                wrapperFramed->process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+
+                pos += num;
+            }
+
+            /// evaluate...
+            expectEquals(wrapperFramed->getFrameSize(), frameSize);
+            expectEquals(latency, frameSize);
+            expectEquals(spec.maximumBlockSize, (juce::uint32)64);
+
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                for (int i = 0; i < latency; ++i)
+                    expectEquals(bufferFramed.getSample(channel, i), 0.0f);
+
+                for (int i = latency; i < numSamples; ++i)
+                    expect(abs(bufferFramed.getSample(channel, i) - bufferDirect.getSample(channel, i - latency)) < deltaExpected);
+            }
+        }
+
+        beginTest("When linear phase then the filter is delayed by the reported latency, and flat as a flat filter is.");
+        {
+            const int numChnls = 2;
+            const int blockSize = 256;
+            const int numSamples = 8192;
+            const int hostBlockSizes[] = { 256, 100, 37, 256, 1, 200 };
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferDirect(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> blockDirect(bufferDirect);
+            MrSignal::whiteNoise(blockDirect, 0.5f);
+
+            juce::AudioBuffer<float> bufferLinearPhase;
+            bufferLinearPhase.makeCopyOf(bufferDirect);
+            juce::dsp::AudioBlock<float> blockLinearPhase(bufferLinearPhase);
+
+            // a peak without gain passes the signal unchanged, so the FIR is a delay
+            auto createFlatWrapper = [&](bool isLinearPhase)
+            {
+                juce::dsp::ProcessSpec spec;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = blockSize;
+                spec.numChannels = numChnls;
+
+                auto wrapper = std::make_unique<JuceFxChainWrapper>();
+                wrapper->setupFilter(spec);
+                wrapper->setupDelay(spec);
+                wrapper->setupReverb();
+                wrapper->setFilterMode((int)MrFilter::Mode::peak);
+                wrapper->setLinearPhase(isLinearPhase);
+                wrapper->prepare(spec);
+
+                wrapper->updateFilter();
+                wrapper->updateDelay();
+                wrapper->updateReverb();
+
+                return wrapper;
+            };
+
+            auto wrapperDirect = createFlatWrapper(false);
+            auto wrapperLinearPhase = createFlatWrapper(true);
+            const int latency = wrapperLinearPhase->getLatencyInSmpls();
+
+            /// execute...
+            for (int pos = 0, n = 0; pos < numSamples; ++n)
+            {
+                const int num = std::min(numSamples - pos, hostBlockSizes[n % 6]);
+
+                auto subBlockDirect = blockDirect.getSubBlock((size_t)pos, (size_t)num);
+                wrapperDirect->process(juce::dsp::ProcessContextReplacing<float>(subBlockDirect));
+
+                auto subBlockLinearPhase = blockLinearPhase.getSubBlock((size_t)pos, (size_t)num);
+                wrapperLinearPhase->process(juce::dsp::ProcessContextReplacing<float>(subBlockLinearPhase));
+
+                pos += num;
+            }
+
+            /// evaluate...
+            expectEquals(latency, MrLinearPhaseFilter::KERNEL_SIZE_DEFAULT + 1 + MrLinearPhaseFilter::KERNEL_SIZE_DEFAULT / 2);
+            expectEquals(wrapperDirect->getLatencyInSmpls(), 0);
+
+            float errorMax = 0.0f;
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                for (int i = 0; i < latency; ++i)
+                    errorMax = std::max(errorMax, std::abs(bufferLinearPhase.getSample(channel, i)));
+
+                for (int i = latency; i < numSamples; ++i)
+                    errorMax = std::max(errorMax, std::abs(bufferLinearPhase.getSample(channel, i) - bufferDirect.getSample(channel, i - latency)));
+            }
+
+            expect(errorMax < deltaExpected, "error " + juce::String(errorMax));
+        }
+
+        beginTest("When the mix is set then the input is delayed by the reported latency and mixed with the output of the chain.");
+        {
+            const int numChnls = 2;
+            const int blockSize = 256;
+            const int numSamples = 8192;
+            const int hostBlockSizes[] = { 256, 100, 37, 256, 1, 200 };
+            const float mix = 0.3f;
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferInput(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+            MrSignal::whiteNoise(blockInput, 0.5f);
+
+            juce::AudioBuffer<float> bufferWet, bufferMixed;
+            bufferWet.makeCopyOf(bufferInput);
+            bufferMixed.makeCopyOf(bufferInput);
+            juce::dsp::AudioBlock<float> blockWet(bufferWet), blockMixed(bufferMixed);
+
+            // linear phase, so the dry signal has to wait for the latency to line up
+            auto createWrapper = [&](float mixToSet)
+            {
+                juce::dsp::ProcessSpec spec;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = blockSize;
+                spec.numChannels = numChnls;
+
+                auto wrapper = std::make_unique<JuceFxChainWrapper>();
+                wrapper->setupFilter(spec);
+                wrapper->setupDelay(spec);
+                wrapper->setupReverb();
+                wrapper->setLinearPhase(true);
+                wrapper->setMix(mixToSet);
+                wrapper->setMixLaw((int)MrDryWet::Law::linear);
+                wrapper->prepare(spec);
+
+                wrapper->updateFilter();
+                wrapper->updateDelay();
+                wrapper->updateReverb();
+
+                return wrapper;
+            };
+
+            auto wrapperWet = createWrapper(1.0f);
+            auto wrapperMixed = createWrapper(mix);
+            const int latency = wrapperMixed->getLatencyInSmpls();
+
+            /// execute...
+            for (int pos = 0, n = 0; pos < numSamples; ++n)
+            {
+                const int num = std::min(numSamples - pos, hostBlockSizes[n % 6]);
+
+                auto subBlockWet = blockWet.getSubBlock((size_t)pos, (size_t)num);
+                wrapperWet->process(juce::dsp::ProcessContextReplacing<float>(subBlockWet));
+
+                auto subBlockMixed = blockMixed.getSubBlock((size_t)pos, (size_t)num);
+                wrapperMixed->process(juce::dsp::ProcessContextReplacing<float>(subBlockMixed));
+
+                pos += num;
+            }
+
+            /// evaluate...
+            expect(latency > 0);
+
+            float errorMax = 0.0f;
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float dry = (i >= latency) ? bufferInput.getSample(channel, i - latency) : 0.0f;
+                    const float expected = (1.0f - mix) * dry + mix * bufferWet.getSample(channel, i);
+
+                    errorMax = std::max(errorMax, std::abs(bufferMixed.getSample(channel, i) - expected));
+                }
+            }
+
+            expect(errorMax < deltaExpected, "error " + juce::String(errorMax));
+        }
+
+        beginTest("When the input turns from dual mono to stereo then the dual mono mode equals processing both channels in full.");
+        {
+            const int numSamples = 32768;
+            const int blockSize = 256;
+            const int numSamplesDualMono = 16384;
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferStereo(2, numSamples);
+            juce::dsp::AudioBlock<float> blockStereo(bufferStereo);
+            MrSignal::whiteNoise(blockStereo, 0.5f);
+            MrSignal::whiteNoise(blockStereo.getSingleChannelBlock(1).getSubBlock((size_t)numSamplesDualMono), 0.5f, 7);
+
+            juce::AudioBuffer<float> bufferDualMono;
+            bufferDualMono.makeCopyOf(bufferStereo);
+            juce::dsp::AudioBlock<float> blockDualMono(bufferDualMono);
+
+            auto wrapperStereo = createPreparedWrapper(2, blockSize);
+            auto wrapperDualMono = createPreparedWrapper(2, blockSize);
+            wrapperDualMono->setChannelMode((int)JuceFxChainWrapper::ChannelMode::dualMono);
+
+            for (auto* wrapper : { wrapperStereo.get(), wrapperDualMono.get() })
+            {
+                wrapper->setDelayInMs(50.0);
+                wrapper->updateDelay();
+            }
+
+            /// execute...
+            bool wasDualMono = false;
+
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                auto subBlockStereo = blockStereo.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperStereo->process(juce::dsp::ProcessContextReplacing<float>(subBlockStereo));
+
+                auto subBlockDualMono = blockDualMono.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperDualMono->process(juce::dsp::ProcessContextReplacing<float>(subBlockDualMono));
+
+                wasDualMono |= wrapperDualMono->isDualMono();
+            }
+
+            /// evaluate...
+            expect(wasDualMono);
+            expect(!wrapperDualMono->isDualMono());
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    expect(abs(bufferDualMono.getSample(channel, i) - bufferStereo.getSample(channel, i)) < deltaExpected);
+        }
+
+        beginTest("When in mid/side mode then the mid passes the chain and the side only the reverb.");
+        {
+            const int numSamples = 16384;
+            const int blockSize = 256;
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferMid(2, numSamples);
+            juce::dsp::AudioBlock<float> blockMid(bufferMid);
+            MrSignal::whiteNoise(blockMid, 0.25f);
+
+            juce::AudioBuffer<float> bufferSide(2, numSamples);
+            juce::dsp::AudioBlock<float> blockSide(bufferSide);
+            MrSignal::whiteNoise(blockSide, 0.25f, 7);
+            bufferSide.copyFrom(1, 0, bufferSide.getReadPointer(0), numSamples, -1.0f);
+
+            juce::AudioBuffer<float> bufferMidSide;
+            bufferMidSide.makeCopyOf(bufferMid);
+            for (int channel = 0; channel < 2; ++channel)
+                bufferMidSide.addFrom(channel, 0, bufferSide, channel, 0, numSamples);
+            juce::dsp::AudioBlock<float> blockMidSide(bufferMidSide);
+
+            auto wrapperMid = createPreparedWrapper(2, blockSize);
+            auto wrapperSide = createPreparedWrapper(2, blockSize);
+            auto wrapperMidSide = createPreparedWrapper(2, blockSize);
+            wrapperSide->setChannelMode((int)JuceFxChainWrapper::ChannelMode::midSide);
+            wrapperMidSide->setChannelMode((int)JuceFxChainWrapper::ChannelMode::midSide);
+
+            /// execute...
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                auto subBlockMid = blockMid.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperMid->process(juce::dsp::ProcessContextReplacing<float>(subBlockMid));
+
+                auto subBlockSide = blockSide.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperSide->process(juce::dsp::ProcessContextReplacing<float>(subBlockSide));
+
+                auto subBlockMidSide = blockMidSide.getSubBlock((size_t)pos, (size_t)blockSize);
+                wrapperMidSide->process(juce::dsp::ProcessContextReplacing<float>(subBlockMidSide));
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    expect(abs(bufferMidSide.getSample(channel, i) - bufferMid.getSample(channel, i) - bufferSide.getSample(channel, i)) < deltaExpected);
+        }
+
+        beginTest("When the quality is adaptive and the blocks exceed the budget then the tier steps down to eco, and up again without.");
+        {
+            const int blockSize = 256;
+            const int numBlocks = 100;
+
+            /// prepare...
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            auto wrapper = createPreparedWrapper(2, blockSize);
+            wrapper->setQuality((int)MrQuality::Tier::high);
+            wrapper->setLoadBudget(0.0);
+            wrapper->setAdaptiveQuality(true);
+
+            /// execute...
+            const int qualityBefore = wrapper->getQualityInUse();
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                MrSignal::whiteNoise(block, 0.5f, 7, (int64_t)i * blockSize);
+                wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+            }
+
+            const int qualityAdapted = wrapper->getQualityInUse();
+            wrapper->setAdaptiveQuality(false);
+
+            /// evaluate...
+            expect(qualityBefore == (int)MrQuality::Tier::high);
+            expect(qualityAdapted == (int)MrQuality::Tier::eco);
+            expect(wrapper->getQuality() == (int)MrQuality::Tier::high);
+            expect(wrapper->getQualityInUse() == (int)MrQuality::Tier::high);
+        }
+
+        beginTest("When prepared asynchronously then the blocks pass unprocessed until the new chain is in use, which then processes like one prepared right away.");
+        {
+            const int blockSize = 256;
+            const int numBlocks = 50;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferInput(2, blockSize);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+
+            juce::AudioBuffer<float> bufferSync(2, blockSize), bufferAsync(2, blockSize);
+            juce::dsp::AudioBlock<float> blockSync(bufferSync), blockAsync(bufferAsync);
+
+            auto wrapperSync = createPreparedWrapper(2, blockSize);
+            auto wrapperAsync = createPreparedWrapper(2, blockSize, false, true);
+
+            /// execute...
+            MrSignal::whiteNoise(blockInput, 0.5f);
+            blockAsync.copyFrom(blockInput);
+            wrapperAsync->process(juce::dsp::ProcessContextReplacing<float>(blockAsync));
+
+            // if the chain was ready for the first block already, both have to process it
+            const bool isFirstBlockDry = !wrapperAsync->isChainUpToDate();
+            const bool isFirstBlockUnchanged = isEqual(blockAsync, blockInput);
+            if (!isFirstBlockDry)
+            {
+                blockSync.copyFrom(blockInput);
+                wrapperSync->process(juce::dsp::ProcessContextReplacing<float>(blockSync));
+            }
+
+            const bool isTakenOver = waitUntilChainUpToDate(*wrapperAsync);
+            bool isEachBlockEqual = true;
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                MrSignal::whiteNoise(blockInput, 0.5f, 7, (int64_t)i * blockSize);
+                blockSync.copyFrom(blockInput);
+                blockAsync.copyFrom(blockInput);
+
+                wrapperSync->process(juce::dsp::ProcessContextReplacing<float>(blockSync));
+                wrapperAsync->process(juce::dsp::ProcessContextReplacing<float>(blockAsync));
+
+                isEachBlockEqual = isEachBlockEqual && isEqual(blockSync, blockAsync);
+            }
+
+            /// evaluate...
+            expect(!isFirstBlockDry || isFirstBlockUnchanged);
+            expect(isTakenOver);
+            expect(isEachBlockEqual);
+        }
+
+        beginTest("When prepared asynchronously again then the chain in use keeps processing if the spec is the same, otherwise the blocks pass unprocessed.");
+        {
+            const int blockSize = 256;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferInput(2, blockSize);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+            MrSignal::whiteNoise(blockInput, 0.5f);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            auto wrapper = createPreparedWrapper(2, blockSize, false, true);
+            waitUntilChainUpToDate(*wrapper);
+
+            auto prepareAgain = [&wrapper](int maxBlockSize)
+            {
+                juce::dsp::ProcessSpec spec;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = (juce::uint32)maxBlockSize;
+                spec.numChannels = 2;
+
+                wrapper->setupFilter(spec);
+                wrapper->setupDelay(spec);
+                wrapper->setupReverb();
+                wrapper->prepare(spec);
+            };
+
+            /// execute...
+            prepareAgain(blockSize);
+            block.copyFrom(blockInput);
+            wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+            const bool isSameSpecProcessed = !isEqual(block, blockInput);
+            const bool isSameSpecTakenOver = waitUntilChainUpToDate(*wrapper);
+
+            prepareAgain(2 * blockSize);
+            block.copyFrom(blockInput);
+            wrapper->process(juce::dsp::ProcessContextReplacing<float>(block));
+            const bool isOtherSpecDry = !wrapper->isChainUpToDate();
+            const bool isOtherSpecUnchanged = isEqual(block, blockInput);
+            const bool isOtherSpecTakenOver = waitUntilChainUpToDate(*wrapper);
+
+            /// evaluate...
+            expect(isSameSpecProcessed);
+            expect(isSameSpecTakenOver);
+            expect(!isOtherSpecDry || isOtherSpecUnchanged);
+            expect(isOtherSpecTakenOver);
+        }
+
+        beginTest("When the wrapper has not been prepared then it has no chain up to date and the blocks pass unprocessed.");
+        {
+            /// prepare...
+            juce::AudioBuffer<float> bufferInput(2, 256);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+            MrSignal::whiteNoise(blockInput, 0.5f);
+
+            juce::AudioBuffer<float> buffer(2, 256);
+            juce::dsp::AudioBlock<float> block(buffer);
+            block.copyFrom(blockInput);
+
+            JuceFxChainWrapper wrapper;
+
+            /// execute...
+            wrapper.setCutOffInHz(1000.0f);
+            wrapper.setFeedback(0.3f);
+            wrapper.setRoomSize(0.7f);
+            wrapper.updateFilter();
+            wrapper.updateDelay();
+            wrapper.updateReverb();
+            wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+            /// evaluate...
+            expect(!wrapper.isChainUpToDate());
+            expect(isEqual(block, blockInput));
+        }
     }
-};
\ No newline at end of file
+
+private:
+
+    std::unique_ptr<JuceFxChainWrapper> createPreparedWrapper(int numChnls, int numSamples, bool isPipelined = false, bool isAsyncPrepare = false)
+    {
+        auto wrapper = std::make_unique<JuceFxChainWrapper>();
+        wrapper->setPipelined(isPipelined);
+        wrapper->setAsyncPrepare(isAsyncPrepare);
+
+        // the outputs are compared sample by sample, the pipeline may not drop a block
+        wrapper->setNonRealtime(true);
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = 48000;
+        spec.maximumBlockSize = numSamples;
+        spec.numChannels = numChnls;
+
+        wrapper->setupFilter(spec);
+        wrapper->setupDelay(spec);
+        wrapper->setupReverb();
+        wrapper->prepare(spec);
+
+        wrapper->updateFilter();
+        wrapper->updateDelay();
+        wrapper->updateReverb();
+
+        return wrapper;
+    }
+
+    /** Passes empty blocks, which leave the chain as it is, until the chain prepared asynchronously is taken over. */
+    static bool waitUntilChainUpToDate(JuceFxChainWrapper& wrapper)
+    {
+        juce::AudioBuffer<float> buffer(2, 0);
+        juce::dsp::AudioBlock<float> block(buffer);
+
+        for (int i = 0; i < 5000 && !wrapper.isChainUpToDate(); ++i)
+        {
+            wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+            juce::Thread::sleep(1);
+        }
+
+        return wrapper.isChainUpToDate();
+    }
+
+    static bool isEqual(const juce::dsp::AudioBlock<float>& block1, const juce::dsp::AudioBlock<float>& block2)
+    {
+        for (size_t channel = 0; channel < block1.getNumChannels(); ++channel)
+            for (size_t i = 0; i < block1.getNumSamples(); ++i)
+                if (block1.getSample((int)channel, (int)i) != block2.getSample((int)channel, (int)i))
+                    return false;
+
+        return true;
+    }
+};
+
+static JuceFxChainWrapperTests juceFxChainWrapperTests;
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Small helpers to time code in the benchmark suites.
+
+	Benchmarks are juce::UnitTests in the category BENCHMARK_CATEGORY, they are only
+	compiled into the console target and never run together with the unit tests.
+	Cache miss rates are not measured here, run the console target under a profiler,
+	e.g. "perf stat -e L1-dcache-load-misses,LLC-load-misses", for those.
+*/
+class MrBenchmark
+{
+public:
+
+	static constexpr const char* BENCHMARK_CATEGORY = "Benchmarks";
+
+	/** Result of timing a function a number of times. */
+	struct Result
+	{
+		double median = 0.0;	/**< seconds per run */
+		double p99 = 0.0;		/**< seconds per run */
+		double min = 0.0;		/**< seconds per run */
+	};
+
+	/** Runs fn numWarmUps times untimed and then numRuns times timed. */
+	template <typename Fn>
+	static Result run(Fn&& fn, int numRuns, int numWarmUps = 10)
+	{
+		for (int i = 0; i < numWarmUps; ++i)
+			fn();
+
+		std::vector<double> times((size_t)std::max(1, numRuns));
+		for (auto& time : times)
+		{
+			auto start = juce::Time::getHighResolutionTicks();
+			fn();
+			time = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+		}
+
+		std::sort(times.begin(), times.end());
+
+		Result result;
+		result.min = times.front();
+		result.median = times[times.size() / 2];
+		result.p99 = times[std::min(times.size() - 1, (times.size() * 99) / 100)];
+
+		return result;
+	}
+
+	/** Formats a result as time per run and, if numSamplesPerRun is given, nanoseconds per processed sample (per channel). */
+	static juce::String format(const juce::String& name, const Result& result, int numSamplesPerRun)
+	{
+		auto text = name
+			+ ": median " + juce::String(result.median * 1.0e6, 2) + " us"
+			+ ", p99 " + juce::String(result.p99 * 1.0e6, 2) + " us";
+
+		if (numSamplesPerRun > 0)
+			text += ", " + juce::String(result.median * 1.0e9 / numSamplesPerRun, 3) + " ns/smpl";
+
+		return text;
+	}
+};
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cstddef>
+
+#include <JuceHeader.h>
+
+/**
+	Keeps state written on the audio thread off the cache lines of other objects.
+
+	When instances are processed on different cores, a cache line holding the end of one
+	instance and the start of the next bounces between the cores on every write (false
+	sharing). A Padding placed first and last among the members of a class keeps the
+	members in between on cache lines no other object touches. Padding is used instead of
+	alignas, because aligned new is only guaranteed from C++17 on and the plugin is also
+	built as C++14.
+*/
+struct MrCacheLine
+{
+#if JUCE_MAC && JUCE_ARM
+	static constexpr size_t SIZE = 128;
+#else
+	static constexpr size_t SIZE = 64;
+#endif
+
+	struct Padding
+	{
+		char bytes[SIZE];
+	};
+};
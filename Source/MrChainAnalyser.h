@@ -0,0 +1,415 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "IJuceFxChainWrapper.h"
+#include "MrBenchmark.h"
+#include "MrChainParameters.h"
+#include "MrSignal.h"
+
+/**
+	Offline measurement of a chain, for validating builds and presets without a host.
+
+	The chain is prepared with the given parameters and driven with an impulse or a log
+	sweep, block by block as a host would. From the impulse response of each output channel
+	(deconvolved from the sweep if one was used) the magnitude, phase and group delay are
+	computed at log spaced frequencies, along with the tail length and the measured latency,
+	which is compared with the latency the chain reports. Finally the CPU time per block is
+	timed on noise. The report is written as JSON or CSV.
+
+	Stimulus and response are processed through the same code path the plugin uses, so
+	the sub block size and parameter smoothing are part of the measurement.
+*/
+class MrChainAnalyser
+{
+public:
+
+	enum class Stimulus
+	{
+		impulse,	/**< a single impulse, exact for linear chains */
+		logSweep	/**< an exponential sweep, deconvolved, better signal to noise for chains with saturation */
+	};
+
+	using Parameters = MrChainParameters::Values;
+
+	struct Settings
+	{
+		double sampleRate = 48000.0;
+		int blockSize = 512;
+		int numChnls = 2;
+		Stimulus stimulus = Stimulus::impulse;
+		float stimulusLevel = 0.5f;				/**< peak of the stimulus, the response is normalised to it */
+		double sweepLengthInSeconds = 2.0;
+		double maxTailInSeconds = 10.0;			/**< length of the impulse response that is recorded */
+		float tailThresholdInDb = -60.0f;		/**< relative to the peak of the impulse response */
+		double minFrequencyInHz = 10.0;
+		int numFrequencyPoints = 200;
+		int numImpulseResponseSmplsInReport = 1024;
+		int numCpuRuns = 200;
+	};
+
+	/** Response of one output channel. */
+	struct ChannelReport
+	{
+		std::vector<float> impulseResponse;
+		std::vector<double> frequenciesInHz;
+		std::vector<double> magnitudesInDb;
+		std::vector<double> phasesInRad;
+		std::vector<double> groupDelaysInMs;
+
+		int peakInSmpls = 0;			/**< position of the largest magnitude */
+		int onsetInSmpls = 0;			/**< first sample above the tail threshold */
+		int tailLengthInSmpls = 0;		/**< last sample above the tail threshold plus one */
+		bool isTailTruncated = false;	/**< the response was still above the threshold when recording ended */
+	};
+
+	struct Report
+	{
+		Settings settings;
+		Parameters parameters;
+		std::vector<ChannelReport> channels;
+
+		int latencyReportedInSmpls = 0;
+		int latencyMeasuredInSmpls = 0;	/**< the earliest peak over all channels */
+
+		MrBenchmark::Result cpuPerBlock;
+		double cpuLoadInPercent = 0.0;	/**< median time per block relative to the duration of a block */
+	};
+
+	//==============================================================================
+	/** Measures the chain, prepares it again for each measurement. Not for the audio thread. */
+	static Report analyse(IJuceFxChainWrapper& wrapper, const Settings& settings, const Parameters& parameters = {})
+	{
+		Report report;
+		report.settings = settings;
+		report.parameters = parameters;
+
+		MrChainParameters::prepare(wrapper, createSpec(settings), parameters);
+		report.latencyReportedInSmpls = wrapper.getLatencyInSmpls();
+
+		auto impulseResponses = measureImpulseResponses(wrapper, settings);
+
+		report.latencyMeasuredInSmpls = std::numeric_limits<int>::max();
+
+		for (auto& impulseResponse : impulseResponses)
+		{
+			report.channels.push_back(analyseImpulseResponse(impulseResponse, settings));
+			report.latencyMeasuredInSmpls = std::min(report.latencyMeasuredInSmpls, report.channels.back().peakInSmpls);
+		}
+
+		if (report.channels.empty())
+			report.latencyMeasuredInSmpls = 0;
+
+		MrChainParameters::prepare(wrapper, createSpec(settings), parameters);
+		report.cpuPerBlock = measureCpu(wrapper, settings);
+		report.cpuLoadInPercent = 100.0 * report.cpuPerBlock.median * settings.sampleRate / settings.blockSize;
+
+		return report;
+	}
+
+	//==============================================================================
+	/** Computes the frequency response, peak, onset and tail of an impulse response. */
+	static ChannelReport analyseImpulseResponse(const std::vector<float>& impulseResponse, const Settings& settings)
+	{
+		ChannelReport report;
+
+		const int numSamples = (int)impulseResponse.size();
+		if (numSamples == 0)
+			return report;
+
+		/// time domain
+		int peak = 0;
+		for (int i = 1; i < numSamples; ++i)
+			if (std::abs(impulseResponse[(size_t)i]) > std::abs(impulseResponse[(size_t)peak]))
+				peak = i;
+
+		const float threshold = std::abs(impulseResponse[(size_t)peak]) * juce::Decibels::decibelsToGain(settings.tailThresholdInDb, -1000.0f);
+
+		int onset = 0;
+		while (onset < peak && std::abs(impulseResponse[(size_t)onset]) < threshold)
+			++onset;
+
+		int last = numSamples - 1;
+		while (last > peak && std::abs(impulseResponse[(size_t)last]) < threshold)
+			--last;
+
+		report.peakInSmpls = peak;
+		report.onsetInSmpls = onset;
+		report.tailLengthInSmpls = last + 1;
+		report.isTailTruncated = (last >= numSamples - std::max(1, settings.blockSize));
+
+		const int numInReport = std::min(numSamples, settings.numImpulseResponseSmplsInReport);
+		report.impulseResponse.assign(impulseResponse.begin(), impulseResponse.begin() + numInReport);
+
+		/// frequency domain, the group delay is Re(FFT(n * h) / FFT(h)) which needs no phase unwrapping
+		const int fftOrder = getFftOrder(numSamples);
+		const int fftSize = 1 << fftOrder;
+		juce::dsp::FFT fft(fftOrder);
+
+		std::vector<float> spectrum((size_t)(2 * fftSize), 0.0f);
+		std::vector<float> spectrumRamped((size_t)(2 * fftSize), 0.0f);
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			spectrum[(size_t)i] = impulseResponse[(size_t)i];
+			spectrumRamped[(size_t)i] = (float)i * impulseResponse[(size_t)i];
+		}
+
+		fft.performRealOnlyForwardTransform(spectrum.data());
+		fft.performRealOnlyForwardTransform(spectrumRamped.data());
+
+		const double nyquist = 0.5 * settings.sampleRate;
+		const double minFrequency = juce::jlimit(1.0, nyquist, settings.minFrequencyInHz);
+		const int numPoints = std::max(2, settings.numFrequencyPoints);
+
+		for (int p = 0; p < numPoints; ++p)
+		{
+			const double frequency = minFrequency * std::pow(nyquist / minFrequency, (double)p / (numPoints - 1));
+			const int bin = juce::jlimit(0, fftSize / 2, juce::roundToInt(frequency / settings.sampleRate * fftSize));
+
+			const std::complex<double> h(spectrum[(size_t)(2 * bin)], spectrum[(size_t)(2 * bin + 1)]);
+			const std::complex<double> hRamped(spectrumRamped[(size_t)(2 * bin)], spectrumRamped[(size_t)(2 * bin + 1)]);
+
+			const double magnitude = std::abs(h);
+			const double groupDelay = (magnitude > 1.0e-9) ? (hRamped / h).real() : 0.0;
+
+			report.frequenciesInHz.push_back(frequency);
+			report.magnitudesInDb.push_back(juce::Decibels::gainToDecibels(magnitude, -200.0));
+			report.phasesInRad.push_back(std::arg(h));
+			report.groupDelaysInMs.push_back(1000.0 * groupDelay / settings.sampleRate);
+		}
+
+		return report;
+	}
+
+	//==============================================================================
+	static juce::String toJson(const Report& report)
+	{
+		auto toVar = [](const auto& values)
+		{
+			juce::Array<juce::var> array;
+			for (auto value : values)
+				array.add(value);
+
+			return juce::var(array);
+		};
+
+		juce::DynamicObject::Ptr root = new juce::DynamicObject();
+		root->setProperty("sampleRate", report.settings.sampleRate);
+		root->setProperty("blockSize", report.settings.blockSize);
+		root->setProperty("numChannels", report.settings.numChnls);
+		root->setProperty("stimulus", report.settings.stimulus == Stimulus::impulse ? "impulse" : "logSweep");
+
+		juce::DynamicObject::Ptr parameters = new juce::DynamicObject();
+		for (auto& parameter : report.parameters)
+			parameters->setProperty(parameter.first, parameter.second);
+		root->setProperty("parameters", parameters.get());
+
+		juce::DynamicObject::Ptr latency = new juce::DynamicObject();
+		latency->setProperty("reportedInSmpls", report.latencyReportedInSmpls);
+		latency->setProperty("measuredInSmpls", report.latencyMeasuredInSmpls);
+		root->setProperty("latency", latency.get());
+
+		juce::DynamicObject::Ptr cpu = new juce::DynamicObject();
+		cpu->setProperty("medianPerBlockInUs", report.cpuPerBlock.median * 1.0e6);
+		cpu->setProperty("p99PerBlockInUs", report.cpuPerBlock.p99 * 1.0e6);
+		cpu->setProperty("nsPerSmpl", report.cpuPerBlock.median * 1.0e9 / report.settings.blockSize);
+		cpu->setProperty("loadInPercent", report.cpuLoadInPercent);
+		root->setProperty("cpu", cpu.get());
+
+		juce::Array<juce::var> channels;
+		for (auto& channel : report.channels)
+		{
+			juce::DynamicObject::Ptr object = new juce::DynamicObject();
+			object->setProperty("peakInSmpls", channel.peakInSmpls);
+			object->setProperty("onsetInSmpls", channel.onsetInSmpls);
+			object->setProperty("tailLengthInSmpls", channel.tailLengthInSmpls);
+			object->setProperty("tailLengthInMs", 1000.0 * channel.tailLengthInSmpls / report.settings.sampleRate);
+			object->setProperty("isTailTruncated", channel.isTailTruncated);
+			object->setProperty("frequenciesInHz", toVar(channel.frequenciesInHz));
+			object->setProperty("magnitudesInDb", toVar(channel.magnitudesInDb));
+			object->setProperty("phasesInRad", toVar(channel.phasesInRad));
+			object->setProperty("groupDelaysInMs", toVar(channel.groupDelaysInMs));
+			object->setProperty("impulseResponse", toVar(channel.impulseResponse));
+			channels.add(object.get());
+		}
+		root->setProperty("channels", channels);
+
+		return juce::JSON::toString(root.get());
+	}
+
+	/** Writes the scalar results as comment lines followed by one row per channel and frequency. */
+	static juce::String toCsv(const Report& report)
+	{
+		juce::String csv;
+
+		csv << "# sampleRate," << report.settings.sampleRate << "\n"
+			<< "# blockSize," << report.settings.blockSize << "\n"
+			<< "# latencyReportedInSmpls," << report.latencyReportedInSmpls << "\n"
+			<< "# latencyMeasuredInSmpls," << report.latencyMeasuredInSmpls << "\n"
+			<< "# cpuMedianPerBlockInUs," << report.cpuPerBlock.median * 1.0e6 << "\n"
+			<< "# cpuLoadInPercent," << report.cpuLoadInPercent << "\n";
+
+		for (auto& parameter : report.parameters)
+			csv << "# " << parameter.first << "," << parameter.second << "\n";
+
+		for (size_t c = 0; c < report.channels.size(); ++c)
+			csv << "# channel" << (int)c << "TailLengthInSmpls," << report.channels[c].tailLengthInSmpls
+				<< (report.channels[c].isTailTruncated ? " (truncated)" : "") << "\n";
+
+		csv << "channel,frequencyInHz,magnitudeInDb,phaseInRad,groupDelayInMs\n";
+
+		for (size_t c = 0; c < report.channels.size(); ++c)
+		{
+			auto& channel = report.channels[c];
+
+			for (size_t p = 0; p < channel.frequenciesInHz.size(); ++p)
+				csv << (int)c << "," << channel.frequenciesInHz[p] << "," << channel.magnitudesInDb[p] << ","
+					<< channel.phasesInRad[p] << "," << channel.groupDelaysInMs[p] << "\n";
+		}
+
+		return csv;
+	}
+
+private:
+
+	static juce::dsp::ProcessSpec createSpec(const Settings& settings)
+	{
+		juce::dsp::ProcessSpec spec;
+		spec.sampleRate = settings.sampleRate;
+		spec.maximumBlockSize = (juce::uint32)settings.blockSize;
+		spec.numChannels = (juce::uint32)settings.numChnls;
+
+		return spec;
+	}
+
+	static int getFftOrder(int numSamples)
+	{
+		int order = 1;
+		while ((1 << order) < numSamples)
+			++order;
+
+		return order;
+	}
+
+	/** Records the response of all output channels to the stimulus fed to all inputs, normalised to the stimulus level. */
+	static std::vector<std::vector<float>> measureImpulseResponses(IJuceFxChainWrapper& wrapper, const Settings& settings)
+	{
+		const auto numTailSmpls = (int)std::ceil(settings.maxTailInSeconds * settings.sampleRate);
+		const auto numSweepSmpls = (settings.stimulus == Stimulus::logSweep) ? (int)std::ceil(settings.sweepLengthInSeconds * settings.sampleRate) : 0;
+		const int numRecordSmpls = numTailSmpls + numSweepSmpls;
+
+		const double sweepStartInHz = settings.minFrequencyInHz;
+		const double sweepEndInHz = 0.45 * settings.sampleRate;
+
+		juce::AudioBuffer<float> recording(settings.numChnls, numRecordSmpls);
+		juce::dsp::AudioBlock<float> recordingBlock(recording);
+
+		auto generate = [&](const juce::dsp::AudioBlock<float>& block, int64_t startSample)
+		{
+			if (settings.stimulus == Stimulus::logSweep)
+				MrSignal::logSweep(block, sweepStartInHz, sweepEndInHz, numSweepSmpls, settings.sampleRate, settings.stimulusLevel, startSample);
+			else if (startSample == 0)
+				MrSignal::impulse(block, settings.stimulusLevel);
+			else
+				MrSignal::silence(block);
+		};
+
+		for (int start = 0; start < numRecordSmpls; start += settings.blockSize)
+		{
+			auto block = recordingBlock.getSubBlock((size_t)start, (size_t)std::min(settings.blockSize, numRecordSmpls - start));
+
+			generate(block, start);
+			wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+		}
+
+		std::vector<std::vector<float>> impulseResponses((size_t)settings.numChnls, std::vector<float>((size_t)numTailSmpls));
+
+		if (settings.stimulus == Stimulus::impulse)
+		{
+			for (int c = 0; c < settings.numChnls; ++c)
+				for (int i = 0; i < numTailSmpls; ++i)
+					impulseResponses[(size_t)c][(size_t)i] = recording.getSample(c, i) / settings.stimulusLevel;
+
+			return impulseResponses;
+		}
+
+		/// deconvolution, H = Y * conj(X) / (|X|^2 + eps), regularised outside the band of the sweep
+		const int fftOrder = getFftOrder(numRecordSmpls);
+		const int fftSize = 1 << fftOrder;
+		juce::dsp::FFT fft(fftOrder);
+
+		std::vector<float> sweep((size_t)(2 * fftSize), 0.0f);
+		float* sweepChnls[] = { sweep.data() };
+		generate(juce::dsp::AudioBlock<float>(sweepChnls, 1, (size_t)numSweepSmpls), 0);
+		fft.performRealOnlyForwardTransform(sweep.data());
+
+		double maxPower = 0.0;
+		for (int k = 0; k <= fftSize / 2; ++k)
+			maxPower = std::max(maxPower, (double)std::norm(std::complex<float>(sweep[(size_t)(2 * k)], sweep[(size_t)(2 * k + 1)])));
+
+		const double eps = 1.0e-6 * maxPower;
+
+		std::vector<float> response((size_t)(2 * fftSize));
+
+		for (int c = 0; c < settings.numChnls; ++c)
+		{
+			std::fill(response.begin(), response.end(), 0.0f);
+			std::copy(recording.getReadPointer(c), recording.getReadPointer(c) + numRecordSmpls, response.begin());
+			fft.performRealOnlyForwardTransform(response.data());
+
+			for (int k = 0; k <= fftSize / 2; ++k)
+			{
+				const std::complex<double> x(sweep[(size_t)(2 * k)], sweep[(size_t)(2 * k + 1)]);
+				const std::complex<double> y(response[(size_t)(2 * k)], response[(size_t)(2 * k + 1)]);
+				const auto h = y * std::conj(x) / (std::norm(x) + eps);
+
+				response[(size_t)(2 * k)] = (float)h.real();
+				response[(size_t)(2 * k + 1)] = (float)h.imag();
+			}
+
+			/* the upper half mirrors the lower one, filled in so the result does not depend on the FFT engine */
+			for (int k = fftSize / 2 + 1; k < fftSize; ++k)
+			{
+				response[(size_t)(2 * k)] = response[(size_t)(2 * (fftSize - k))];
+				response[(size_t)(2 * k + 1)] = -response[(size_t)(2 * (fftSize - k) + 1)];
+			}
+
+			fft.performRealOnlyInverseTransform(response.data());
+			std::copy(response.begin(), response.begin() + numTailSmpls, impulseResponses[(size_t)c].begin());
+		}
+
+		return impulseResponses;
+	}
+
+	/** Times processing a block of noise, the block is processed in place over and over like in the benchmarks. */
+	static MrBenchmark::Result measureCpu(IJuceFxChainWrapper& wrapper, const Settings& settings)
+	{
+		juce::AudioBuffer<float> buffer(settings.numChnls, settings.blockSize);
+		juce::dsp::AudioBlock<float> block(buffer);
+		MrSignal::whiteNoise(block, settings.stimulusLevel);
+
+		juce::ScopedNoDenormals noDenormals;
+
+		return MrBenchmark::run([&]
+			{
+				wrapper.process(juce::dsp::ProcessContextReplacing<float>(block));
+			}, settings.numCpuRuns);
+	}
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cmath>
+#include <JuceHeader.h>
+#include "MrChainAnalyser.h"
+#include "JuceFxChainWrapperMock.h"
+
+class MrChainAnalyserTests : public juce::UnitTest
+{
+public:
+
+    MrChainAnalyserTests() : juce::UnitTest("MrChainAnalyser testing") {}
+
+    void runTest() override
+    {
+        beginTest("When analysing a chain passing the signal unchanged then the response is flat without latency.");
+        {
+            /// prepare...
+            JuceFxChainWrapperMock chain;
+            auto settings = createSettings(MrChainAnalyser::Stimulus::impulse);
+
+            /// execute...
+            auto report = MrChainAnalyser::analyse(chain, settings);
+
+            /// evaluate...
+            expectEquals((int)report.channels.size(), settings.numChnls);
+            expectEquals(report.latencyReportedInSmpls, 0);
+            expectEquals(report.latencyMeasuredInSmpls, 0);
+
+            for (auto& channel : report.channels)
+            {
+                expectEquals(channel.peakInSmpls, 0);
+                expectEquals(channel.tailLengthInSmpls, 1);
+                expect(!channel.isTailTruncated);
+
+                for (size_t p = 0; p < channel.frequenciesInHz.size(); ++p)
+                {
+                    expect(std::abs(channel.magnitudesInDb[p]) < 0.01);
+                    expect(std::abs(channel.groupDelaysInMs[p]) < 0.001);
+                }
+            }
+        }
+
+        beginTest("When analysing a chain delaying the signal then the latency and group delay are measured.");
+        {
+            for (auto stimulus : { MrChainAnalyser::Stimulus::impulse, MrChainAnalyser::Stimulus::logSweep })
+            {
+                /// prepare...
+                const int delayInSmpls = 37;
+                DelayingChain chain(delayInSmpls);
+                auto settings = createSettings(stimulus);
+                const double groupDelayExpectedInMs = 1000.0 * delayInSmpls / settings.sampleRate;
+
+                /// execute...
+                auto report = MrChainAnalyser::analyse(chain, settings);
+
+                /// evaluate...
+                expectEquals(report.latencyReportedInSmpls, delayInSmpls);
+                expectEquals(report.latencyMeasuredInSmpls, delayInSmpls);
+
+                for (auto& channel : report.channels)
+                {
+                    expectEquals(channel.peakInSmpls, delayInSmpls);
+
+                    for (size_t p = 0; p < channel.frequenciesInHz.size(); ++p)
+                    {
+                        /* the sweep only covers part of the spectrum */
+                        if (channel.frequenciesInHz[p] < 100.0 || channel.frequenciesInHz[p] > 10000.0)
+                            continue;
+
+                        expect(std::abs(channel.magnitudesInDb[p]) < 0.5);
+                        expect(std::abs(channel.groupDelaysInMs[p] - groupDelayExpectedInMs) < 0.01);
+                    }
+                }
+            }
+        }
+
+        beginTest("When analysing an impulse response then onset, peak and tail are found.");
+        {
+            /// prepare...
+            auto settings = createSettings(MrChainAnalyser::Stimulus::impulse);
+            std::vector<float> impulseResponse(1000, 0.0f);
+
+            impulseResponse[10] = 0.01f;
+            impulseResponse[20] = -1.0f;
+            impulseResponse[500] = 0.002f;
+            impulseResponse[600] = 0.0001f;
+
+            /// execute...
+            auto report = MrChainAnalyser::analyseImpulseResponse(impulseResponse, settings);
+
+            /// evaluate...
+            expectEquals(report.onsetInSmpls, 10);
+            expectEquals(report.peakInSmpls, 20);
+            expectEquals(report.tailLengthInSmpls, 501);
+        }
+    }
+
+private:
+
+    /** Chain delaying all channels by a fixed number of samples and reporting it as latency. */
+    class DelayingChain : public JuceFxChainWrapperMock
+    {
+    public:
+
+        explicit DelayingChain(int delayInSmplsToUse) : delayInSmpls(delayInSmplsToUse) {}
+
+        void prepare(juce::dsp::ProcessSpec& spec) override
+        {
+            history.assign(spec.numChannels, std::vector<float>((size_t)delayInSmpls, 0.0f));
+            pos = 0;
+        }
+
+        void process(juce::dsp::ProcessContextReplacing<float> context) override
+        {
+            auto& block = context.getOutputBlock();
+            int posEnd = pos;
+
+            for (size_t c = 0; c < block.getNumChannels(); ++c)
+            {
+                auto* samples = block.getChannelPointer(c);
+                auto& line = history[c];
+                posEnd = pos;
+
+                for (size_t i = 0; i < block.getNumSamples(); ++i)
+                {
+                    std::swap(samples[i], line[(size_t)posEnd]);
+                    posEnd = (posEnd + 1) % delayInSmpls;
+                }
+            }
+
+            pos = posEnd;
+        }
+
+        int getLatencyInSmpls() override { return delayInSmpls; }
+
+    private:
+
+        int delayInSmpls;
+        int pos = 0;
+        std::vector<std::vector<float>> history;
+    };
+
+    static MrChainAnalyser::Settings createSettings(MrChainAnalyser::Stimulus stimulus)
+    {
+        MrChainAnalyser::Settings settings;
+        settings.stimulus = stimulus;
+        settings.blockSize = 100;
+        settings.maxTailInSeconds = 0.1;
+        settings.sweepLengthInSeconds = 0.5;
+        settings.numFrequencyPoints = 50;
+        settings.numCpuRuns = 5;
+
+        return settings;
+    }
+};
+
+static MrChainAnalyserTests chainAnalyserTests;
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "IJuceFxChainWrapper.h"
+
+/**
+	Sets up a chain outside of the plugin, for the offline tools.
+
+	Parameters are addressed by the IDs the plugin exposes to the host, so a preset can
+	be passed around as "<parameter ID>=<value>" pairs.
+*/
+class MrChainParameters
+{
+public:
+
+	/** Pairs of host parameter IDs and their values. */
+	using Values = std::vector<std::pair<juce::String, float>>;
+
+	/** Sets a parameter by its host parameter ID, returns false if the ID is unknown. */
+	static bool set(IJuceFxChainWrapper& wrapper, const juce::String& paramId, float value)
+	{
+		if (paramId == "cutOffInHz")					wrapper.setCutOffInHz(value);
+		else if (paramId == "filterMode")				wrapper.setFilterMode(juce::roundToInt(value));
+		else if (paramId == "filterSlope")				wrapper.setFilterSlope(juce::roundToInt(value));
+		else if (paramId == "resonance")				wrapper.setResonance(value);
+		else if (paramId == "filterGainInDb")			wrapper.setFilterGainInDb(value);
+		else if (paramId == "delayInMs")				wrapper.setDelayInMs(value);
+		else if (paramId == "feedback")					wrapper.setFeedback(value);
+		else if (paramId == "roomSize")					wrapper.setRoomSize(value);
+		else if (paramId == "feedbackMode")				wrapper.setFeedbackMode(juce::roundToInt(value));
+		else if (paramId == "crossFeed")				wrapper.setCrossFeed(value);
+		else if (paramId == "dampingLowPassInHz")		wrapper.setDampingLowPassInHz(value);
+		else if (paramId == "dampingHighPassInHz")		wrapper.setDampingHighPassInHz(value);
+		else if (paramId == "saturationDrive")			wrapper.setSaturationDrive(value);
+		else if (paramId == "modulationDepthInMs")		wrapper.setModulationDepthInMs(value);
+		else if (paramId == "modulationRateInHz")		wrapper.setModulationRateInHz(value);
+		else if (paramId == "modulationNumVoices")		wrapper.setModulationNumVoices(juce::roundToInt(value));
+		else if (paramId == "modulationStereoPhase")	wrapper.setModulationStereoPhase(value);
+		else if (paramId == "subBlockSize")				wrapper.setSubBlockSize(juce::roundToInt(value));
+		else if (paramId == "frameSize")				wrapper.setFrameSize(juce::roundToInt(value));
+		else if (paramId == "pipelined")				wrapper.setPipelined(value != 0.0f);
+		else if (paramId == "linearPhase")				wrapper.setLinearPhase(value != 0.0f);
+		else if (paramId == "channelMode")				wrapper.setChannelMode(juce::roundToInt(value));
+		else if (paramId == "quality")					wrapper.setQuality(juce::roundToInt(value));
+		else if (paramId == "adaptiveQuality")			wrapper.setAdaptiveQuality(value != 0.0f);
+		else if (paramId == "filterMix")				wrapper.setFilterMix(value);
+		else if (paramId == "delayMix")					wrapper.setDelayMix(value);
+		else if (paramId == "reverbMix")				wrapper.setReverbMix(value);
+		else if (paramId == "mix")						wrapper.setMix(value);
+		else if (paramId == "mixLaw")					wrapper.setMixLaw(juce::roundToInt(value));
+		else
+			return false;
+
+		return true;
+	}
+
+	/** Parses "<parameter ID>=<value>" and appends it to values, returns false if it has no '='. */
+	static bool parse(const juce::String& text, Values& values)
+	{
+		if (!text.containsChar('='))
+			return false;
+
+		values.push_back({ text.upToFirstOccurrenceOf("=", false, false),
+						   text.fromFirstOccurrenceOf("=", false, false).getFloatValue() });
+		return true;
+	}
+
+	/**
+		Prepares the chain like the plugin does for rendering offline and applies the values on
+		top of the defaults, before prepare() so those taking effect from there on, like
+		pipelined, do.
+	*/
+	static void prepare(IJuceFxChainWrapper& wrapper, juce::dsp::ProcessSpec spec, const Values& values)
+	{
+		wrapper.setNonRealtime(true);
+		wrapper.setupFilter(spec);
+		wrapper.setupDelay(spec);
+		wrapper.setupReverb();
+
+		for (auto& value : values)
+		{
+			const bool isKnown = set(wrapper, value.first, value.second);
+			jassert(isKnown);
+			juce::ignoreUnused(isKnown);
+		}
+
+		wrapper.prepare(spec);
+
+		wrapper.updateFilter();
+		wrapper.updateDelay();
+		wrapper.updateReverb();
+	}
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MrChainParameters.h"
+#include "JuceFxChainWrapperMock.h"
+
+class MrChainParametersTests : public juce::UnitTest
+{
+public:
+
+    MrChainParametersTests() : juce::UnitTest("MrChainParameters testing") {}
+
+    void runTest() override
+    {
+        beginTest("When setting parameters by their IDs then the setters are called and unknown IDs are rejected.");
+        {
+            /// prepare...
+            JuceFxChainWrapperMock chain;
+
+            /// execute...
+            auto isFeedbackKnown = MrChainParameters::set(chain, "feedback", 0.3f);
+            auto isUnknownKnown = MrChainParameters::set(chain, "unknown", 0.3f);
+
+            /// evaluate...
+            expect(isFeedbackKnown);
+            expect(!isUnknownKnown);
+            expect(chain.atLeastOneCallToFunction("setFeedback"));
+        }
+
+        beginTest("When parsing parameters then IDs and values are split at the '='.");
+        {
+            /// prepare...
+            MrChainParameters::Values values;
+
+            /// execute...
+            auto isParsed = MrChainParameters::parse("delayInMs=300.5", values);
+            auto isNotParsed = MrChainParameters::parse("delayInMs", values);
+
+            /// evaluate...
+            expect(isParsed);
+            expect(!isNotParsed);
+            expectEquals((int)values.size(), 1);
+            expect(values[0].first == "delayInMs");
+            expectEquals(values[0].second, 300.5f);
+        }
+
+        beginTest("When preparing a chain then it is set up and the values are applied.");
+        {
+            /// prepare...
+            JuceFxChainWrapperMock chain;
+            juce::dsp::ProcessSpec spec{ 48000, 512, 2 };
+
+            /// execute...
+            MrChainParameters::prepare(chain, spec, { { "roomSize", 0.7f } });
+
+            /// evaluate...
+            expect(chain.atLeastOneCallToFunction("setupReverb"));
+            expect(chain.atLeastOneCallToFunction("setRoomSize"));
+            expect(chain.atLeastOneCallToFunction("updateReverb"));
+        }
+    }
+};
+
+static MrChainParametersTests chainParametersTests;
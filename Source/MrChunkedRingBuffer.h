@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Multi channel ring buffer for long delay lines, split into chunks of CHUNK_SIZE samples.
+
+	The memory is reserved uninitialised in one block, so allocating takes the same time
+	for a second as for a minute, and on systems committing memory lazily untouched chunks
+	take no physical memory at all. Whether a chunk holds data is tracked per chunk: a chunk
+	is cleared when it is written to for the first time, until then it reads as silence.
+	Clearing the whole ring therefore only resets the chunk flags.
+*/
+template <typename SampleType>
+class MrChunkedRingBuffer
+{
+public:
+
+	static constexpr int CHUNK_SIZE = 4096;
+
+	//==============================================================================
+	/** Reserves memory for numChnls channels of up to maxSize samples, clears the ring. Not for the audio thread. */
+	void allocate(int numChnlsNew, int maxSize)
+	{
+		numChnls = numChnlsNew;
+		numChunks = (std::max(maxSize, 1) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		capacity = numChunks * CHUNK_SIZE;
+
+		memory.malloc((size_t)numChnls * (size_t)capacity);
+
+		chnlPtrs.resize((size_t)numChnls);
+		for (int c = 0; c < numChnls; ++c)
+			chnlPtrs[(size_t)c] = memory.get() + (size_t)c * (size_t)capacity;
+
+		isChunkTouched.assign((size_t)numChunks, 0);
+		size = std::min(std::max(size, 1), capacity);
+	}
+
+	/** Frees the memory. */
+	void release()
+	{
+		memory.free();
+		std::vector<SampleType*>().swap(chnlPtrs);
+		std::vector<uint8_t>().swap(isChunkTouched);
+
+		numChnls = 0;
+		numChunks = 0;
+		capacity = 0;
+		size = 1;
+	}
+
+	/** Sets the number of samples the ring wraps at, at most the capacity, and clears the ring. */
+	void setSize(int sizeNew) noexcept
+	{
+		jassert(sizeNew <= capacity);
+		size = juce::jlimit(1, std::max(capacity, 1), sizeNew);
+
+		clear();
+	}
+
+	/** Makes the whole ring silent, costs one flag per chunk. */
+	void clear() noexcept
+	{
+		std::fill(isChunkTouched.begin(), isChunkTouched.end(), (uint8_t)0);
+	}
+
+	int getSize() const noexcept { return size; }
+	int getCapacity() const noexcept { return capacity; }
+	int getNumChannels() const noexcept { return numChnls; }
+
+	//==============================================================================
+	/**
+		Calls fn(pos, offset, num) for the runs making up [pos, pos + numSamples) wrapped at
+		the ring size, each run lying within a single chunk. offset counts from the first run.
+	*/
+	template <typename Fn>
+	void forEachRun(int pos, int numSamples, Fn&& fn) const
+	{
+		int offset = 0;
+
+		while (offset < numSamples)
+		{
+			const int num = std::min({ numSamples - offset, size - pos, CHUNK_SIZE - pos % CHUNK_SIZE });
+
+			fn(pos, offset, num);
+
+			offset += num;
+			pos += num;
+
+			if (pos >= size)
+				pos = 0;
+		}
+	}
+
+	/** Returns true if the chunk holding pos has not been written to since the last clear. */
+	bool isSilent(int pos) const noexcept { return isChunkTouched[(size_t)(pos / CHUNK_SIZE)] == 0; }
+
+	/** Clears the chunk holding pos in all channels if it is written to for the first time. */
+	void touch(int pos) noexcept
+	{
+		const int idx = pos / CHUNK_SIZE;
+
+		if (isChunkTouched[(size_t)idx] != 0)
+			return;
+
+		for (auto* chnl : chnlPtrs)
+			std::fill_n(chnl + idx * CHUNK_SIZE, CHUNK_SIZE, SampleType(0));
+
+		isChunkTouched[(size_t)idx] = 1;
+	}
+
+	/** Copies one channel into another up to the ring size, chunks not written to stay silent in both. */
+	void copyChannel(int chnlFrom, int chnlTo) noexcept
+	{
+		jassert(chnlFrom < numChnls && chnlTo < numChnls);
+
+		forEachRun(0, size, [&](int pos, int, int num)
+			{
+				if (!isSilent(pos))
+					std::copy_n(chnlPtrs[(size_t)chnlFrom] + pos, num, chnlPtrs[(size_t)chnlTo] + pos);
+			});
+	}
+
+	/** Returns the channel pointers, valid until the next allocate() or release(). */
+	SampleType* const* getArrayOfChannels() const noexcept { return chnlPtrs.data(); }
+
+	const SampleType* getReadPointer(int chnl, int pos) const noexcept { return chnlPtrs[(size_t)chnl] + pos; }
+
+	/** Returns a write pointer, call touch() for the chunk before writing. */
+	SampleType* getWritePointer(int chnl, int pos) noexcept { return chnlPtrs[(size_t)chnl] + pos; }
+
+	//==============================================================================
+	/** Returns the memory reserved in bytes. */
+	size_t getNumBytesAllocated() const noexcept { return (size_t)numChnls * (size_t)capacity * sizeof(SampleType); }
+
+	/** Returns the memory written to since the last clear in bytes. */
+	size_t getNumBytesTouched() const noexcept
+	{
+		const auto numTouched = (size_t)std::count(isChunkTouched.begin(), isChunkTouched.end(), (uint8_t)1);
+		return numTouched * (size_t)numChnls * (size_t)CHUNK_SIZE * sizeof(SampleType);
+	}
+
+private:
+
+	juce::HeapBlock<SampleType> memory;
+	std::vector<SampleType*> chnlPtrs;
+	std::vector<uint8_t> isChunkTouched;
+
+	int numChnls{ 0 };
+	int numChunks{ 0 };
+	int capacity{ 0 };
+	int size{ 1 };
+};
@@ -12,12 +12,35 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 
 #include <JuceHeader.h>
+#include "MrCacheLine.h"
+#include "MrChunkedRingBuffer.h"
+#include "MrDryWet.h"
+#include "MrFeedbackShaper.h"
+#include "MrLfo.h"
+#include "MrQuality.h"
+#include "MrSampleFormat.h"
 
 /**
 	Applies a simple delay to AudioBlocks.
 
+	The delay buffer is a chunked ring buffer reserved for the maximum delay, so preparing
+	takes the same time for any maximum delay and changing the delay below the maximum
+	neither allocates nor clears memory.
+
+	With a modulation depth set, the delayed signal is read by up to MAX_MODULATION_VOICES
+	taps swept by an LFO between the delay time and the delay time plus the depth, which
+	gives chorus (long delay, several voices) and flanger (short delay, feedback) effects.
+	The taps read between the samples with the interpolation set, the quality tiers pick
+	nearest (eco), linear (normal) or cubic (high).
+
+	The output is the input plus the delayed signal, at the default mix of 0.5 with the
+	balance law both at full level. Another mix is applied within the loops that add the
+	two, which then also leave their plain sum in a buffer for the feedback, so the mix
+	never changes what is fed back.
+
 	The code is meant to follow the JUCE coding standard
 	https://juce.com/discover/stories/coding-standards
 */
@@ -28,7 +51,44 @@ public:
 	const FloatType SAMPLERATE_DEFAULT = 48000;
 	const FloatType FEEDBACK_DEFAULT = 0.5f;
 
-	MrDelay() noexcept = default;
+	/** Maximum number of channels taking part in the feedback matrix, further channels feed back into themselves. */
+	static constexpr size_t MAX_MATRIX_CHNLS = 8;
+
+	/** Describes how the channels are fed back into the delay buffer. */
+	enum class FeedbackMode
+	{
+		parallel,	/**< every channel feeds back into itself only */
+		pingPong,	/**< every channel feeds back into the next one, i.e. L -> R -> L */
+		crossFeed,	/**< every channel feeds back into itself and, by the cross feed amount, into all others */
+		rotation	/**< channel pairs are rotated by the cross feed amount times 90 degrees */
+	};
+
+	/** Describes how the samples are stored in the delay buffer. */
+	enum class StorageFormat
+	{
+		float32,	/**< full precision */
+		fixed16,	/**< 16 bit fixed point with TPDF dither and 12 dB headroom, half the memory */
+		half16		/**< IEEE 754 half float, half the memory */
+	};
+
+	/** Describes how the modulated taps read between the samples of the delay buffer. */
+	enum class Interpolation
+	{
+		nearest,	/**< the closest sample, cheapest but zippers with deep or slow sweeps */
+		linear,		/**< between the two neighbouring samples, dulls the highs a little */
+		cubic		/**< 4 point Hermite through the four neighbouring samples */
+	};
+
+	/** Compact formats are converted through a scratch buffer of at least this many samples. */
+	static constexpr int COMPACT_SCRATCH_SIZE_MIN = 256;
+
+	static constexpr int MAX_MODULATION_VOICES = 8;
+	static constexpr float MAX_MODULATION_DEPTH_IN_MS = 20.0f;
+
+	/** Modulated reads are processed in slices of at most this many samples. */
+	static constexpr int MODULATION_SLICE_SIZE = 64;
+
+	MrDelay() noexcept { updateFeedbackMatrix(); }
 
 	//==============================================================================
 	/* Applies a new feedback value to delay. */
@@ -40,18 +100,197 @@ public:
 	/* Returns the current feedback value. */
 	FloatType getFeedback() { return feedback.getTargetValue(); }
 
-	/** Applies new delay as number of samples. */
+	/** Selects how the channels are mixed in the feedback path. */
+	void setFeedbackMode(FeedbackMode feedbackModeNew) noexcept
+	{
+		feedbackMode = feedbackModeNew;
+
+		updateFeedbackMatrix();
+	}
+
+	/** Returns the current feedback mode. */
+	FeedbackMode getFeedbackMode() const noexcept { return feedbackMode; }
+
+	/** Applies the amount of cross feed (0..1) used by the crossFeed and rotation modes. */
+	void setCrossFeed(FloatType crossFeedNew) noexcept
+	{
+		crossFeed = juce::jlimit(FloatType(0), FloatType(1), crossFeedNew);
+
+		updateFeedbackMatrix();
+	}
+
+	/** Returns the current amount of cross feed. */
+	FloatType getCrossFeed() const noexcept { return crossFeed; }
+
+	/** Sets the cut off of the low pass damping inside the feedback path, 0 disables it. */
+	void setDampingLowPassInHz(FloatType lowPassInHz) noexcept { shaper.setLowPassInHz(lowPassInHz); }
+
+	/** Returns the cut off of the low pass damping inside the feedback path. */
+	FloatType getDampingLowPassInHz() const noexcept { return shaper.getLowPassInHz(); }
+
+	/** Sets the cut off of the high pass damping inside the feedback path, 0 disables it. */
+	void setDampingHighPassInHz(FloatType highPassInHz) noexcept { shaper.setHighPassInHz(highPassInHz); }
+
+	/** Returns the cut off of the high pass damping inside the feedback path. */
+	FloatType getDampingHighPassInHz() const noexcept { return shaper.getHighPassInHz(); }
+
+	/** Sets the drive of the soft saturation inside the feedback path, 0 disables it. */
+	void setSaturationDrive(FloatType drive) noexcept { shaper.setDrive(drive); }
+
+	/** Returns the drive of the soft saturation inside the feedback path. */
+	FloatType getSaturationDrive() const noexcept { return shaper.getDrive(); }
+
+	/** Returns the coefficient by which channel chnlIn is fed back into channel chnlOut. */
+	FloatType getFeedbackMatrixCoef(size_t chnlOut, size_t chnlIn) const noexcept
+	{
+		if (chnlOut >= MAX_MATRIX_CHNLS || chnlIn >= MAX_MATRIX_CHNLS)
+			return (chnlOut == chnlIn) ? FloatType(1) : FloatType(0);
+
+		return feedbackMatrix[chnlOut * MAX_MATRIX_CHNLS + chnlIn];
+	}
+
+	/** Sets the sweep range of the modulated taps beyond the delay time, 0 disables the modulation. */
+	void setModulationDepthInMs(FloatType depthInMs) noexcept
+	{
+		modulationDepthInMs = juce::jlimit(FloatType(0), FloatType(MAX_MODULATION_DEPTH_IN_MS), depthInMs);
+	}
+
+	/** Returns the sweep range of the modulated taps. */
+	FloatType getModulationDepthInMs() const noexcept { return modulationDepthInMs; }
+
+	/** Sets the rate of the LFO sweeping the taps. */
+	void setModulationRateInHz(FloatType rateInHz) noexcept { modulationRateInHz = std::max(FloatType(0), rateInHz); }
+
+	/** Returns the rate of the LFO sweeping the taps. */
+	FloatType getModulationRateInHz() const noexcept { return modulationRateInHz; }
+
+	/** Sets the number of taps per channel, their LFO phases are spread evenly over one cycle. */
+	void setModulationNumVoices(int numVoices) noexcept { modulationNumVoices = juce::jlimit(1, MAX_MODULATION_VOICES, numVoices); }
+
+	/** Returns the number of taps per channel. */
+	int getModulationNumVoices() const noexcept { return modulationNumVoices; }
+
+	/** Sets the LFO phase offset between neighbouring channels in cycles (0..1). */
+	void setModulationStereoPhase(FloatType phaseInCycles) noexcept { modulationStereoPhase = juce::jlimit(FloatType(0), FloatType(1), phaseInCycles); }
+
+	/** Returns the LFO phase offset between neighbouring channels. */
+	FloatType getModulationStereoPhase() const noexcept { return modulationStereoPhase; }
+
+	/** Selects the LFO shape. */
+	void setModulationShape(MrLfo::Shape shape) noexcept { modulationShape = shape; }
+
+	/** Returns the LFO shape. */
+	MrLfo::Shape getModulationShape() const noexcept { return modulationShape; }
+
+	/**
+		Selects how the modulated taps interpolate. The taps of the old and the new
+		interpolation are crossfaded over the next modulated slice.
+	*/
+	void setInterpolation(Interpolation interpolationNew) noexcept { interpolation = interpolationNew; }
+
+	/** Returns how the modulated taps interpolate. */
+	Interpolation getInterpolation() const noexcept { return interpolation; }
+
+	/** Selects the interpolation of the quality tier, nearest for eco, linear for normal and cubic for high. */
+	void setQuality(MrQuality::Tier tier) noexcept
+	{
+		setInterpolation((tier == MrQuality::Tier::eco) ? Interpolation::nearest
+			: (tier == MrQuality::Tier::high) ? Interpolation::cubic
+			: Interpolation::linear);
+	}
+
+	/** Sets the mix of input and delayed signal, see MrDryWet. */
+	void setMix(float mix) noexcept { dryWet.setMix(mix); }
+
+	float getMix() const noexcept { return dryWet.getMix(); }
+
+	void setMixLaw(MrDryWet::Law law) noexcept { dryWet.setLaw(law); }
+
+	MrDryWet::Law getMixLaw() const noexcept { return dryWet.getLaw(); }
+
+	/** Returns true if the taps are modulated. */
+	bool isModulated() const noexcept { return modulationDepthInMs > 0; }
+
+	/**
+		Returns true if the same input on all channels gives the same output on all channels,
+		which is the case if the feedback does not mix the channels and all taps move alike.
+	*/
+	bool isChannelSymmetric() const noexcept
+	{
+		return feedbackMode == FeedbackMode::parallel && (!isModulated() || modulationStereoPhase == 0);
+	}
+
+	/**
+		Copies the delay buffer and the feedback path state of one channel into another. Brings
+		a channel up to date that was left out of processing while its input equalled the input
+		of the other, costs a copy of the delay plus the modulation headroom.
+	*/
+	void copyChannel(int chnlFrom, int chnlTo) noexcept
+	{
+		if (storageFormat == StorageFormat::float32)
+			floatRing.copyChannel(chnlFrom, chnlTo);
+		else
+			compactRing.copyChannel(chnlFrom, chnlTo);
+
+		shaper.copyChannel((size_t)chnlFrom, (size_t)chnlTo);
+	}
+
+	/** Selects the storage format of the delay buffer, clears the buffer. Not for the audio thread. */
+	void setStorageFormat(StorageFormat storageFormatNew)
+	{
+		storageFormat = storageFormatNew;
+
+		updateStorage();
+		reset();
+	}
+
+	/** Returns the current storage format. */
+	StorageFormat getStorageFormat() const noexcept { return storageFormat; }
+
+	/** Returns the memory reserved for the delay buffer in bytes. */
+	size_t getDelayBufferSizeInBytes() const noexcept
+	{
+		return floatRing.getNumBytesAllocated() + compactRing.getNumBytesAllocated();
+	}
+
+	/** Returns the memory of the delay buffer written to since the last reset in bytes. */
+	size_t getDelayBufferTouchedInBytes() const noexcept
+	{
+		return floatRing.getNumBytesTouched() + compactRing.getNumBytesTouched();
+	}
+
+	/** Reserves the delay buffer for delays up to the given time, shorter delays then never allocate. Not for the audio thread. */
+	void setMaxDelayInMs(FloatType maxDelayInMsNew)
+	{
+		maxDelayInMs = std::max(FloatType(0), maxDelayInMsNew);
+
+		updateStorage();
+		reset();
+	}
+
+	/** Returns the time the delay buffer is reserved for. */
+	FloatType getMaxDelayInMs() const noexcept { return maxDelayInMs; }
+
+	/** Applies new delay as number of samples, allocates only if it exceeds the maximum delay. */
 	void setDelayInSmpls(size_t delayInSmplsNew) noexcept
 	{
 		delayInSmpls = delayInSmplsNew;
 
+		updateStorage();
 		reset();
 	}
 
+	/** Clears the delay buffer, costs one flag per chunk of the buffer. */
 	void reset() {
 
-		dlyBufs.setSize(numChnls, delayInSmpls + 1);
-		dlyBufs.clear();
+		floatRing.clear();
+		compactRing.clear();
+		ditherPos = 0;
+
+		shaper.reset();
+
+		modulationPhase = 0.0;
+		interpolationFadingOut = interpolation;
 
 		posR = 0;
 		posW = delayInSmpls;
@@ -83,7 +322,13 @@ public:
 
 		sampleRate = spec.sampleRate;
 		numChnls = spec.numChannels;
+		maxBlockSize = (int)spec.maximumBlockSize;
 
+		dryWet.prepare(sampleRate);
+		shaper.prepare(sampleRate, (size_t)numChnls);
+		feedbackBufs.setSize(numChnls, juce::jmax(maxBlockSize, COMPACT_SCRATCH_SIZE_MIN), false, false, true);
+
+		updateFeedbackMatrix();
 		setDelayInSmpls(delayInSmplsNew);
 	}
 
@@ -106,47 +351,78 @@ public:
 			return;
 		}
 
-		posR = writeToOutput(inBlock,
-			dlyBufs,
-			outBlock,
-			posR);
+		const int numSamples = (int)inBlock.getNumSamples();
 
-		const FloatType feedbackVal = feedback.getNextValue();
-		posW = writeToDelayBuffer(inBlock, dlyBufs, posW, feedbackVal);
-	}
+		const bool isMixed = !dryWet.isUnity();
+		const auto ramp = dryWet.advance(numSamples);
 
-	static int writeToOutput(
-		const juce::dsp::AudioBlock<const float>& in,
-		juce::AudioBuffer<float>& dly,
-		juce::dsp::AudioBlock<float>& out,
-		int pos)
-	{
-		int bufSizeDly = (int)dly.getNumSamples();
-		int bufSizeIn = (int)in.getNumSamples();
+		if (isModulated())
+		{
+			/* as below, slices never exceed the delay, the cubic taps read one sample ahead */
+			const bool isCubic = (interpolation == Interpolation::cubic || interpolationFadingOut == Interpolation::cubic);
+			const int sliceSize = juce::jmin(MODULATION_SLICE_SIZE, std::max(1, delayInSmpls - (isCubic ? 1 : 0)));
 
-		int numSamplesFromEnd = std::min((int)(bufSizeDly - pos), bufSizeIn);
-		int numSamplesFromFront = bufSizeIn - numSamplesFromEnd;
+			for (int start = 0; start < numSamples; start += sliceSize)
+			{
+				const int num = std::min(sliceSize, numSamples - start);
 
-		if (numSamplesFromEnd > 0)
+				auto outSlice = outBlock.getSubBlock((size_t)start, (size_t)num);
+				processModulated(inBlock.getSubBlock((size_t)start, (size_t)num), outSlice, isMixed, ramp.getSlice(start));
+			}
+
+			return;
+		}
+
+		interpolationFadingOut = interpolation;
+
+		if (storageFormat != StorageFormat::float32)
 		{
-			auto in1 = in.getSubBlock(0, numSamplesFromEnd);
-			const juce::dsp::AudioBlock<const float> dly1(dly, pos);
-			auto out1 = out.getSubBlock(0, numSamplesFromEnd);
-			out1.replaceWithSumOf(in1, dly1);
+			/* slices never exceed the delay, so every sample read has been written before */
+			const int sliceSize = std::min(scratchBufs.getNumSamples(), std::max(1, delayInSmpls));
+
+			for (int start = 0; start < numSamples; start += sliceSize)
+			{
+				const int num = std::min(sliceSize, numSamples - start);
+
+				auto outSlice = outBlock.getSubBlock((size_t)start, (size_t)num);
+				processCompact(inBlock.getSubBlock((size_t)start, (size_t)num), outSlice, isMixed, ramp.getSlice(start));
+			}
+
+			return;
 		}
 
-		if (numSamplesFromFront > 0)
+		if (isMixed)
 		{
-			auto in2 = in.getSubBlock(numSamplesFromEnd, numSamplesFromFront);
-			const juce::dsp::AudioBlock<const float> dly2(dly, 0);
-			auto out2 = out.getSubBlock(numSamplesFromEnd, numSamplesFromFront);
-			out2.replaceWithSumOf(in2, dly2);
+			/* slices never exceed the feedback buffer, the host blocks fit in one */
+			const int sliceSize = feedbackBufs.getNumSamples();
+
+			for (int start = 0; start < numSamples; start += sliceSize)
+			{
+				const int num = std::min(sliceSize, numSamples - start);
+
+				auto outSlice = outBlock.getSubBlock((size_t)start, (size_t)num);
+				processFloatMixed(inBlock.getSubBlock((size_t)start, (size_t)num), outSlice, ramp.getSlice(start));
+			}
+
+			return;
 		}
 
-		pos += bufSizeIn;
-		pos %= bufSizeDly;
+		auto* const* dlyChnls = floatRing.getArrayOfChannels();
 
-		return pos;
+		floatRing.forEachRun(posR, numSamples, [&](int pos, int offset, int num)
+			{
+				auto inRun = inBlock.getSubBlock((size_t)offset, (size_t)num);
+				auto outRun = outBlock.getSubBlock((size_t)offset, (size_t)num);
+
+				if (!floatRing.isSilent(pos))
+					outRun.replaceWithSumOf(inRun, juce::dsp::AudioBlock<float>(dlyChnls, (size_t)numChnls, (size_t)pos, (size_t)num));
+				else if (context.usesSeparateInputAndOutputBlocks())
+					outRun.copyFrom(inRun);
+			});
+
+		posR = (posR + numSamples) % floatRing.getSize();
+
+		writeToFloatRing(inBlock, feedback.getNextValue());
 	}
 
 	static int writeToDelayBuffer(
@@ -176,17 +452,578 @@ public:
 		return pos;
 	}
 
+	/**
+		Writes the input into the delay buffer, each channel being the mix of all input channels
+		weighted by the given row major MAX_MATRIX_CHNLS x MAX_MATRIX_CHNLS matrix and the feedback value.
+		Works on whole channel segments using the vectorised FloatVectorOperations.
+	*/
+	static int writeToDelayBufferMatrix(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::AudioBuffer<float>& dly,
+		int pos,
+		const FloatType feedbackVal,
+		const std::array<FloatType, MAX_MATRIX_CHNLS * MAX_MATRIX_CHNLS>& matrix)
+	{
+		int bufSizeDly = dly.getNumSamples();
+		int bufSizeIn = (int)in.getNumSamples();
+
+		int numSamplesToEnd = std::min((int)(bufSizeDly - pos), (int)bufSizeIn);
+		int numSamplesToFront = bufSizeIn - numSamplesToEnd;
+
+		size_t numChannels = std::min(in.getNumChannels(), (size_t)dly.getNumChannels());
+		size_t numChannelsMatrix = juce::jmin(numChannels, MAX_MATRIX_CHNLS);
+
+		for (size_t c = 0; c < numChannels; ++c)
+		{
+			auto* dlyEnd = dly.getWritePointer((int)c, pos);
+			auto* dlyFront = dly.getWritePointer((int)c);
+
+			if (c >= numChannelsMatrix)
+			{
+				juce::FloatVectorOperations::copyWithMultiply(dlyEnd, in.getChannelPointer(c), (float)feedbackVal, numSamplesToEnd);
+				juce::FloatVectorOperations::copyWithMultiply(dlyFront, in.getChannelPointer(c) + numSamplesToEnd, (float)feedbackVal, numSamplesToFront);
+				continue;
+			}
+
+			bool isFirstContribution = true;
+			for (size_t cIn = 0; cIn < numChannelsMatrix; ++cIn)
+			{
+				const float coef = (float)(matrix[c * MAX_MATRIX_CHNLS + cIn] * feedbackVal);
+
+				if (coef == 0.0f)
+					continue;
+
+				auto* inData = in.getChannelPointer(cIn);
+
+				if (isFirstContribution)
+				{
+					juce::FloatVectorOperations::copyWithMultiply(dlyEnd, inData, coef, numSamplesToEnd);
+					juce::FloatVectorOperations::copyWithMultiply(dlyFront, inData + numSamplesToEnd, coef, numSamplesToFront);
+					isFirstContribution = false;
+				}
+				else
+				{
+					juce::FloatVectorOperations::addWithMultiply(dlyEnd, inData, coef, numSamplesToEnd);
+					juce::FloatVectorOperations::addWithMultiply(dlyFront, inData + numSamplesToEnd, coef, numSamplesToFront);
+				}
+			}
+
+			if (isFirstContribution)
+			{
+				juce::FloatVectorOperations::clear(dlyEnd, numSamplesToEnd);
+				juce::FloatVectorOperations::clear(dlyFront, numSamplesToFront);
+			}
+		}
+
+		pos += bufSizeIn;
+		pos %= bufSizeDly;
+
+		return pos;
+	}
+
 private:
 
 	//==============================================================================
+	/**
+		Writes the input into the delay buffer passing it through the damping and saturation
+		of the shaper within the same pass. In matrix modes the shaper runs in place over the
+		segments just written by the matrix kernel, while they are still in cache.
+	*/
+	int writeToDelayBufferShaped(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::AudioBuffer<float>& dly,
+		int pos,
+		const FloatType feedbackVal) noexcept
+	{
+		const bool isParallel = (feedbackMode == FeedbackMode::parallel);
+
+		int bufSizeDly = dly.getNumSamples();
+		int bufSizeIn = (int)in.getNumSamples();
+
+		int numSamplesToEnd = std::min((int)(bufSizeDly - pos), (int)bufSizeIn);
+		int numSamplesToFront = bufSizeIn - numSamplesToEnd;
+
+		if (!isParallel)
+			writeToDelayBufferMatrix(in, dly, pos, feedbackVal, feedbackMatrix);
+
+		size_t numChannels = std::min(in.getNumChannels(), (size_t)dly.getNumChannels());
+		for (size_t c = 0; c < numChannels; ++c)
+		{
+			auto* dlyEnd = dly.getWritePointer((int)c, pos);
+			auto* dlyFront = dly.getWritePointer((int)c);
+
+			if (isParallel)
+			{
+				auto* inData = in.getChannelPointer(c);
+
+				shaper.processInto(dlyEnd, inData, feedbackVal, numSamplesToEnd, c);
+				shaper.processInto(dlyFront, inData + numSamplesToEnd, feedbackVal, numSamplesToFront, c);
+			}
+			else
+			{
+				shaper.processInto(dlyEnd, dlyEnd, FloatType(1), numSamplesToEnd, c);
+				shaper.processInto(dlyFront, dlyFront, FloatType(1), numSamplesToFront, c);
+			}
+		}
+
+		pos += bufSizeIn;
+		pos %= bufSizeDly;
+
+		return pos;
+	}
+
+	//==============================================================================
+	/** Writes the input scaled by the feedback into dly from its start, through the matrix and the shaper if enabled. */
+	void writeFeedback(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::AudioBuffer<float>& dly,
+		const FloatType feedbackVal) noexcept
+	{
+		if (shaper.isActive())
+			writeToDelayBufferShaped(in, dly, 0, feedbackVal);
+		else if (feedbackMode == FeedbackMode::parallel)
+			writeToDelayBuffer(in, dly, 0, feedbackVal);
+		else
+			writeToDelayBufferMatrix(in, dly, 0, feedbackVal, feedbackMatrix);
+	}
+
+	/**
+		Reserves the ring buffer of the current storage format for the larger of the delay and
+		the maximum delay, only allocating if it does not fit yet, and sets its size to the delay.
+		Both include the headroom for the modulated taps.
+	*/
+	void updateStorage()
+	{
+		const int headroom = getModulationHeadroom();
+		const int capacityNeeded = (int)std::max((size_t)delayInSmpls, msToSmpls(maxDelayInMs)) + 1 + headroom;
+
+		if (storageFormat == StorageFormat::float32)
+		{
+			if (floatRing.getNumChannels() != numChnls || floatRing.getCapacity() < capacityNeeded)
+				floatRing.allocate(numChnls, capacityNeeded);
+
+			floatRing.setSize(delayInSmpls + 1 + headroom);
+
+			compactRing.release();
+			scratchBufs.setSize(0, 0);
+		}
+		else
+		{
+			if (compactRing.getNumChannels() != numChnls || compactRing.getCapacity() < capacityNeeded)
+				compactRing.allocate(numChnls, capacityNeeded);
+
+			compactRing.setSize(delayInSmpls + 1 + headroom);
+
+			floatRing.release();
+			scratchBufs.setSize(numChnls, juce::jmax(maxBlockSize, COMPACT_SCRATCH_SIZE_MIN), false, false, true);
+		}
+	}
+
+	/**
+		Processes a slice of at most the feedback buffer size with float storage and a mix,
+		which is applied to the delayed samples straight from the ring buffer.
+	*/
+	void processFloatMixed(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::dsp::AudioBlock<float>& out,
+		const MrDryWet::Ramp& ramp) noexcept
+	{
+		const int num = (int)in.getNumSamples();
+		const size_t numChannels = std::min(in.getNumChannels(), (size_t)numChnls);
+		auto* const* dlyChnls = floatRing.getArrayOfChannels();
+
+		floatRing.forEachRun(posR, num, [&](int pos, int offset, int numRun)
+			{
+				const bool isSilentRun = floatRing.isSilent(pos);
+
+				for (size_t c = 0; c < numChannels; ++c)
+					MrDryWet::mixAndSum(out.getChannelPointer(c) + offset, feedbackBufs.getWritePointer((int)c, offset), in.getChannelPointer(c) + offset,
+						isSilentRun ? nullptr : dlyChnls[c] + pos, numRun, ramp.getSlice(offset));
+			});
+
+		posR = (posR + num) % floatRing.getSize();
+
+		writeToFloatRing(getFeedbackInput(numChannels, num), feedback.getNextValue());
+	}
+
+	/** Returns the sum of input and delayed signal the mixed kernels left in the feedback buffer. */
+	juce::dsp::AudioBlock<const float> getFeedbackInput(size_t numChannels, int num) noexcept
+	{
+		return juce::dsp::AudioBlock<float>(feedbackBufs).getSubsetChannelBlock(0, numChannels).getSubBlock(0, (size_t)num);
+	}
+
+	/**
+		Processes a slice of at most the scratch buffer size with compact storage. The delayed
+		samples are converted into the scratch buffer, and the feedback is rendered into the
+		scratch buffer by the float kernels before being converted into the compact buffer.
+	*/
+	void processCompact(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::dsp::AudioBlock<float>& out,
+		bool isMixed,
+		const MrDryWet::Ramp& ramp) noexcept
+	{
+		const int num = (int)in.getNumSamples();
+		const size_t numChannels = std::min(in.getNumChannels(), (size_t)numChnls);
+
+		compactRing.forEachRun(posR, num, [&](int pos, int offset, int numRun)
+			{
+				for (size_t c = 0; c < numChannels; ++c)
+				{
+					auto* dest = scratchBufs.getWritePointer((int)c, offset);
+
+					if (compactRing.isSilent(pos))
+						juce::FloatVectorOperations::clear(dest, numRun);
+					else
+						toFloat(dest, compactRing.getReadPointer((int)c, pos), numRun);
+				}
+			});
+
+		if (isMixed)
+		{
+			for (size_t c = 0; c < numChannels; ++c)
+				MrDryWet::mixAndSum(out.getChannelPointer(c), feedbackBufs.getWritePointer((int)c), in.getChannelPointer(c),
+					scratchBufs.getReadPointer((int)c), num, ramp);
+		}
+		else
+		{
+			out.replaceWithSumOf(in, juce::dsp::AudioBlock<float>(scratchBufs).getSubBlock(0, (size_t)num));
+		}
+
+		posR = (posR + num) % compactRing.getSize();
+
+		writeToCompactRing(isMixed ? getFeedbackInput(numChannels, num) : in, feedback.getNextValue());
+	}
+
+	/** Writes the feedback of the input into the float ring buffer at the write position. */
+	void writeToFloatRing(const juce::dsp::AudioBlock<const float>& in, const FloatType feedbackVal) noexcept
+	{
+		auto* const* dlyChnls = floatRing.getArrayOfChannels();
+
+		floatRing.forEachRun(posW, (int)in.getNumSamples(), [&](int pos, int offset, int num)
+			{
+				floatRing.touch(pos);
+
+				juce::AudioBuffer<float> dlyRun(dlyChnls, numChnls, pos, num);
+				writeFeedback(in.getSubBlock((size_t)offset, (size_t)num), dlyRun, feedbackVal);
+			});
+
+		posW = (posW + (int)in.getNumSamples()) % floatRing.getSize();
+	}
+
+	/** Renders the feedback of the input into the scratch buffer and converts it into the compact ring buffer. */
+	void writeToCompactRing(const juce::dsp::AudioBlock<const float>& in, const FloatType feedbackVal) noexcept
+	{
+		const int num = (int)in.getNumSamples();
+		const size_t numChannels = std::min(in.getNumChannels(), (size_t)numChnls);
+
+		writeFeedback(in, scratchBufs, feedbackVal);
+
+		compactRing.forEachRun(posW, num, [&](int pos, int offset, int numRun)
+			{
+				compactRing.touch(pos);
+
+				for (size_t c = 0; c < numChannels; ++c)
+					fromFloat(compactRing.getWritePointer((int)c, pos), scratchBufs.getReadPointer((int)c, offset), numRun);
+			});
+
+		posW = (posW + num) % compactRing.getSize();
+	}
+
+	//==============================================================================
+	/**
+		Processes a slice of at most MODULATION_SLICE_SIZE samples with modulated taps. Each tap
+		reads at the delay plus depth times its LFO value, interpolating between the neighbouring
+		samples. Unless the taps wrap around the ring end the interpolation loop has no branches
+		and vectorises on targets with gather instructions. After a change of the interpolation
+		the slice crossfades from the taps of the old to those of the new one.
+	*/
+	void processModulated(
+		const juce::dsp::AudioBlock<const float>& in,
+		juce::dsp::AudioBlock<float>& out,
+		bool isMixed,
+		const MrDryWet::Ramp& ramp) noexcept
+	{
+		const int num = (int)in.getNumSamples();
+		const size_t numChannels = std::min(in.getNumChannels(), (size_t)numChnls);
+		const bool isFloat = (storageFormat == StorageFormat::float32);
+		const int size = isFloat ? floatRing.getSize() : compactRing.getSize();
+
+		const float depthInSmpls = std::min((float)(modulationDepthInMs * sampleRate / 1000), (float)getModulationHeadroom() - 2.0f);
+		const double phaseInc = (double)modulationRateInHz / (double)sampleRate;
+		const float voiceGain = 1.0f / (float)modulationNumVoices;
+
+		/* the taps read behind the unmodulated read position and the cubic ones one sample ahead, chunks not written yet have to read as silence */
+		const int numBehind = (int)std::ceil(depthInSmpls) + 2;
+		const int numSpan = numBehind + num + 1;
+		const int posSpan = (posR - numBehind + size) % size;
+
+		if (isFloat)
+			floatRing.forEachRun(posSpan, numSpan, [this](int pos, int, int) { floatRing.touch(pos); });
+		else
+			compactRing.forEachRun(posSpan, numSpan, [this](int pos, int, int) { compactRing.touch(pos); });
+
+		for (size_t c = 0; c < numChannels; ++c)
+		{
+			juce::FloatVectorOperations::clear(modulationWet.data(), num);
+
+			for (int v = 0; v < modulationNumVoices; ++v)
+			{
+				const double phase = modulationPhase + (double)v / modulationNumVoices + (double)c * modulationStereoPhase;
+				MrLfo::render(modulationLfo.data(), num, phase, phaseInc, modulationShape);
+
+				if (isFloat)
+					addTaps(modulationLfo.data(), floatRing.getReadPointer((int)c, 0), posR, size, num, depthInSmpls, voiceGain, [](float x) { return x; });
+				else if (storageFormat == StorageFormat::fixed16)
+					addTaps(modulationLfo.data(), compactRing.getReadPointer((int)c, 0), posR, size, num, depthInSmpls, voiceGain,
+						[](uint16_t x) { return (float)(int16_t)x * (MrSampleFormat::FIXED16_HEADROOM / 32767.0f); });
+				else
+					addTaps(modulationLfo.data(), compactRing.getReadPointer((int)c, 0), posR, size, num, depthInSmpls, voiceGain,
+						[](uint16_t x) { return MrSampleFormat::halfToFloat(x); });
+			}
+
+			if (isMixed)
+				MrDryWet::mixAndSum(out.getChannelPointer(c), feedbackBufs.getWritePointer((int)c), in.getChannelPointer(c), modulationWet.data(), num, ramp);
+			else
+				juce::FloatVectorOperations::add(out.getChannelPointer(c), in.getChannelPointer(c), modulationWet.data(), num);
+		}
+
+		modulationPhase = MrLfo::advance(modulationPhase, phaseInc, num);
+		posR = (posR + num) % size;
+		interpolationFadingOut = interpolation;
+
+		const auto feedbackInput = isMixed ? getFeedbackInput(numChannels, num) : in;
+
+		if (isFloat)
+			writeToFloatRing(feedbackInput, feedback.getNextValue());
+		else
+			writeToCompactRing(feedbackInput, feedback.getNextValue());
+	}
+
+	/** Adds a tap to modulationWet, crossfading from the old interpolation if it has just changed. */
+	template <typename SampleType, typename ToFloat>
+	void addTaps(const float* lfo, const SampleType* dly, int pos, int size, int num, float depthInSmpls, float gain, ToFloat&& toFloat) noexcept
+	{
+		if (interpolationFadingOut == interpolation)
+		{
+			addInterpolated(modulationWet.data(), lfo, dly, pos, size, num, depthInSmpls, interpolation, gain, gain, toFloat);
+			return;
+		}
+
+		addInterpolated(modulationWet.data(), lfo, dly, pos, size, num, depthInSmpls, interpolationFadingOut, gain, 0.0f, toFloat);
+		addInterpolated(modulationWet.data(), lfo, dly, pos, size, num, depthInSmpls, interpolation, 0.0f, gain, toFloat);
+	}
+
+	/**
+		Adds the tap of ring buffer channel dly at read position pos, swept by the LFO values in
+		lfo, to wet. The gain ramps from gainStart to gainEnd over the slice.
+	*/
+	template <typename SampleType, typename ToFloat>
+	static void addInterpolated(float* wet, const float* lfo, const SampleType* dly, int pos, int size, int num,
+		float depthInSmpls, Interpolation interp, float gainStart, float gainEnd, ToFloat&& toFloat) noexcept
+	{
+		/* unless the taps wrap, the common case, the reads need no index checks */
+		const bool isWrapping = (pos - (int)std::ceil(depthInSmpls) - 2 < 0 || pos + num >= size);
+		std::array<float, MODULATION_SLICE_SIZE> tap;
+
+		switch (interp)
+		{
+		case Interpolation::nearest:
+			isWrapping ? readTaps<Interpolation::nearest, true>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat)
+				: readTaps<Interpolation::nearest, false>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat);
+			break;
+
+		case Interpolation::cubic:
+			isWrapping ? readTaps<Interpolation::cubic, true>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat)
+				: readTaps<Interpolation::cubic, false>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat);
+			break;
+
+		case Interpolation::linear:
+		default:
+			isWrapping ? readTaps<Interpolation::linear, true>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat)
+				: readTaps<Interpolation::linear, false>(tap.data(), lfo, dly, pos, size, num, depthInSmpls, toFloat);
+			break;
+		}
+
+		if (gainStart == gainEnd)
+		{
+			juce::FloatVectorOperations::addWithMultiply(wet, tap.data(), gainStart, num);
+			return;
+		}
+
+		const float gainInc = (gainEnd - gainStart) / (float)num;
+
+		for (int i = 0; i < num; ++i)
+			wet[i] += tap[(size_t)i] * (gainStart + gainInc * (float)(i + 1));
+	}
+
+	/** Reads num taps into tap. Writing to a local keeps the loop free of aliasing. */
+	template <Interpolation interp, bool isWrapping, typename SampleType, typename ToFloat>
+	static void readTaps(float* tap, const float* lfo, const SampleType* dly, int pos, int size, int num,
+		float depthInSmpls, ToFloat&& toFloat) noexcept
+	{
+		auto at = [dly, size, &toFloat](int idx)
+		{
+			if (isWrapping)
+			{
+				idx += (idx < 0) ? size : 0;
+				idx -= (idx >= size) ? size : 0;
+			}
+
+			return toFloat(dly[idx]);
+		};
+
+		for (int i = 0; i < num; ++i)
+		{
+			const float offset = depthInSmpls * lfo[i];
+
+			if (interp == Interpolation::nearest)
+			{
+				tap[i] = at(pos + i - (int)(offset + 0.5f));
+				continue;
+			}
+
+			const int offsetInt = (int)offset;
+			const float frac = 1.0f - (offset - (float)offsetInt);
+			const int idx0 = pos + i - offsetInt - 1;
+
+			const float x0 = at(idx0);
+			const float x1 = at(idx0 + 1);
+
+			if (interp == Interpolation::linear)
+			{
+				tap[i] = x0 + frac * (x1 - x0);
+				continue;
+			}
+
+			const float xm1 = at(idx0 - 1);
+			const float x2 = at(idx0 + 2);
+
+			const float c1 = 0.5f * (x1 - xm1);
+			const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+			const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+
+			tap[i] = ((c3 * frac + c2) * frac + c1) * frac + x0;
+		}
+	}
+
+	/** Returns the samples the ring buffer holds beyond the delay for the modulated taps. */
+	int getModulationHeadroom() const noexcept
+	{
+		return (int)std::ceil(MAX_MODULATION_DEPTH_IN_MS * sampleRate / 1000) + 2;
+	}
+
+	void toFloat(float* dest, const uint16_t* src, int num) const noexcept
+	{
+		if (storageFormat == StorageFormat::fixed16)
+			MrSampleFormat::fixed16ToFloat(dest, src, num);
+		else
+			MrSampleFormat::halfToFloat(dest, src, num);
+	}
+
+	void fromFloat(uint16_t* dest, const float* src, int num) noexcept
+	{
+		if (storageFormat == StorageFormat::fixed16)
+			MrSampleFormat::floatToFixed16(dest, src, num, ditherPos);
+		else
+			MrSampleFormat::floatToHalf(dest, src, num);
+	}
+
+	//==============================================================================
+	/** Recomputes the feedback matrix in place for the current mode, cross feed and number of channels. */
+	void updateFeedbackMatrix() noexcept
+	{
+		feedbackMatrix.fill(FloatType(0));
+
+		const size_t n = juce::jmin((size_t)numChnls, MAX_MATRIX_CHNLS);
+
+		for (size_t c = 0; c < MAX_MATRIX_CHNLS; ++c)
+			feedbackMatrix[c * MAX_MATRIX_CHNLS + c] = FloatType(1);
+
+		if (n < 2)
+			return;
+
+		switch (feedbackMode)
+		{
+		case FeedbackMode::pingPong:
+			for (size_t c = 0; c < n; ++c)
+			{
+				feedbackMatrix[c * MAX_MATRIX_CHNLS + c] = FloatType(0);
+				feedbackMatrix[((c + 1) % n) * MAX_MATRIX_CHNLS + c] = FloatType(1);
+			}
+			break;
+
+		case FeedbackMode::crossFeed:
+			for (size_t cOut = 0; cOut < n; ++cOut)
+				for (size_t cIn = 0; cIn < n; ++cIn)
+					feedbackMatrix[cOut * MAX_MATRIX_CHNLS + cIn] = (cOut == cIn)
+						? FloatType(1) - crossFeed
+						: crossFeed / FloatType(n - 1);
+			break;
+
+		case FeedbackMode::rotation:
+		{
+			const FloatType angle = crossFeed * juce::MathConstants<FloatType>::halfPi;
+			const FloatType cosVal = std::cos(angle);
+			const FloatType sinVal = std::sin(angle);
+
+			for (size_t c = 0; c + 1 < n; c += 2)
+			{
+				feedbackMatrix[c * MAX_MATRIX_CHNLS + c] = cosVal;
+				feedbackMatrix[c * MAX_MATRIX_CHNLS + c + 1] = -sinVal;
+				feedbackMatrix[(c + 1) * MAX_MATRIX_CHNLS + c] = sinVal;
+				feedbackMatrix[(c + 1) * MAX_MATRIX_CHNLS + c + 1] = cosVal;
+			}
+			break;
+		}
+
+		case FeedbackMode::parallel:
+		default:
+			break;
+		}
+	}
+
+	//==============================================================================
+	/* keeps the state written every block off the cache lines of neighbouring instances */
+	MrCacheLine::Padding padBefore;
+
 	int delayInSmpls{ 0 };
 	FloatType sampleRate{ SAMPLERATE_DEFAULT };
 	juce::SmoothedValue<FloatType> feedback{ FEEDBACK_DEFAULT };
 
 	int numChnls{ 0 };
 
-	juce::AudioBuffer<float> dlyBufs;
+	FeedbackMode feedbackMode{ FeedbackMode::parallel };
+	FloatType crossFeed{ 0 };
+	std::array<FloatType, MAX_MATRIX_CHNLS * MAX_MATRIX_CHNLS> feedbackMatrix{};
+
+	MrFeedbackShaper<FloatType> shaper;
+
+	FloatType maxDelayInMs{ 0 };
+	StorageFormat storageFormat{ StorageFormat::float32 };
+	MrChunkedRingBuffer<float> floatRing;
+	MrChunkedRingBuffer<uint16_t> compactRing;
+	juce::AudioBuffer<float> scratchBufs;
+	int maxBlockSize{ 0 };
+
+	/* both at full level at the default mix, as the delay was before it had one */
+	MrDryWet dryWet{ 0.5f };
+	juce::AudioBuffer<float> feedbackBufs;
+
+	FloatType modulationDepthInMs{ 0 };
+	FloatType modulationRateInHz{ 0.5f };
+	FloatType modulationStereoPhase{ 0.25f };
+	int modulationNumVoices{ 1 };
+	MrLfo::Shape modulationShape{ MrLfo::Shape::sine };
+	Interpolation interpolation{ Interpolation::linear };
+	Interpolation interpolationFadingOut{ Interpolation::linear };
+	double modulationPhase{ 0.0 };
+	std::array<float, MODULATION_SLICE_SIZE> modulationLfo{};
+	std::array<float, MODULATION_SLICE_SIZE> modulationWet{};
+	int ditherPos{ 0 };
 
 	int posR;
 	int posW;
+
+	MrCacheLine::Padding padAfter;
 };
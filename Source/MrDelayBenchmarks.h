@@ -0,0 +1,307 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrDelay.h"
+#include "MrFixedDelay.h"
+#include "MrLoadTest.h"
+
+class MrDelayBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrDelayBenchmarks() : juce::UnitTest("MrDelay benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        using StorageFormat = MrDelay<float>::StorageFormat;
+
+        const StorageFormat storageFormats[] = { StorageFormat::float32, StorageFormat::fixed16, StorageFormat::half16 };
+
+        beginTest("Throughput and memory per storage format");
+        {
+            const int numChnls = 8;
+            const int blockSize = 512;
+            const int numRuns = 500;
+            const double sampleRate = 192000;
+            const float delayInMs = 2000.0f;
+
+            juce::AudioBuffer<float> buffer(numChnls, blockSize);
+            fillWithSine(buffer, 0);
+
+            for (auto storageFormat : storageFormats)
+            {
+                auto delay = createPreparedDelay(storageFormat, numChnls, blockSize, sampleRate);
+                delay->setDelayInMs(delayInMs);
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        juce::dsp::AudioBlock<float> block(buffer);
+                        delay->process(juce::dsp::ProcessContextReplacing<float>(block));
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(getName(storageFormat) + ", " + juce::String(numChnls) + " channels", result, blockSize)
+                    + ", buffer " + juce::String((double)delay->getDelayBufferSizeInBytes() / (1024.0 * 1024.0), 2) + " MB");
+            }
+        }
+
+        beginTest("Modulated taps, cost per voice");
+        {
+            const int numChnls = 8;
+            const int blockSize = 512;
+            const int numRuns = 500;
+            const int numVoicesPerChnl[] = { 0, 1, 2, 4, 8 };
+
+            juce::AudioBuffer<float> buffer(numChnls, blockSize);
+            fillWithSine(buffer, 0);
+
+            for (auto numVoices : numVoicesPerChnl)
+            {
+                auto delay = createPreparedDelay(StorageFormat::float32, numChnls, blockSize, 48000);
+                delay->setDelayInMs(20.0f);
+                delay->setModulationDepthInMs(numVoices > 0 ? 5.0f : 0.0f);
+                delay->setModulationNumVoices(std::max(1, numVoices));
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        juce::dsp::AudioBlock<float> block(buffer);
+                        delay->process(juce::dsp::ProcessContextReplacing<float>(block));
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(juce::String(numVoices) + " voices, " + juce::String(numChnls) + " channels", result, blockSize));
+            }
+        }
+
+        beginTest("Prepare time vs. maximum delay");
+        {
+            const int numChnls = 8;
+            const int blockSize = 512;
+            const int numRuns = 50;
+            const float maxDelaysInMs[] = { 2000.0f, 60000.0f, 300000.0f };
+
+            juce::dsp::ProcessSpec spec;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = blockSize;
+            spec.numChannels = numChnls;
+
+            for (auto maxDelayInMs : maxDelaysInMs)
+            {
+                auto result = MrBenchmark::run([&]
+                    {
+                        MrDelay<float> delay;
+                        delay.setMaxDelayInMs(maxDelayInMs);
+                        delay.prepare(spec);
+                    }, numRuns, 2);
+
+                logMessage(MrBenchmark::format("max delay " + juce::String(maxDelayInMs / 1000.0f, 0) + " s, "
+                    + juce::String(numChnls) + " channels", result, 0));
+            }
+        }
+
+        beginTest("Short delays, buffer on the heap vs. inline ring");
+        {
+            const int numChnls = 2;
+            const int numInstances = 64;
+            const int blockSize = 64;
+            const int numRuns = 500;
+            const float delaysInMs[] = { 1.0f, 10.0f, 40.0f };
+
+            // a bank of short delays, like the combs of a reverb, processing one block each per run
+            using FixedDelay = MrFixedDelay<float, 2048, numChnls>;
+
+            juce::dsp::ProcessSpec spec;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = blockSize;
+            spec.numChannels = numChnls;
+
+            juce::AudioBuffer<float> source(numChnls, blockSize), buffer(numChnls, blockSize);
+            fillWithSine(source, 0);
+
+            for (auto delayInMs : delaysInMs)
+            {
+                std::vector<std::unique_ptr<MrDelay<float>>> delays;
+                auto fixedDelays = std::make_unique<std::array<FixedDelay, numInstances>>();
+
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    delays.push_back(std::make_unique<MrDelay<float>>());
+                    delays.back()->setMaxDelayInMs(delayInMs);
+                    delays.back()->prepare(spec);
+                    delays.back()->setDelayInMs(delayInMs);
+
+                    (*fixedDelays)[(size_t)i].prepare(spec);
+                    (*fixedDelays)[(size_t)i].setDelayInMs(delayInMs);
+                }
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        for (auto& delay : delays)
+                        {
+                            juce::dsp::AudioBlock<float> block(buffer);
+                            block.copyFrom(source);
+                            delay->process(juce::dsp::ProcessContextReplacing<float>(block));
+                        }
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(juce::String(delayInMs, 0) + " ms, MrDelay", result, blockSize * numInstances));
+
+                result = MrBenchmark::run([&]
+                    {
+                        for (auto& delay : *fixedDelays)
+                        {
+                            juce::dsp::AudioBlock<float> block(buffer);
+                            block.copyFrom(source);
+                            delay.process(juce::dsp::ProcessContextReplacing<float>(block));
+                        }
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(juce::String(delayInMs, 0) + " ms, MrFixedDelay", result, blockSize * numInstances));
+            }
+        }
+
+        beginTest("Quality per storage format (SNR against float storage)");
+        {
+            const int numChnls = 2;
+            const int blockSize = 512;
+            const int numBlocks = 200;
+            const double sampleRate = 48000;
+            const size_t delayInSmpls = 4800;
+            const float feedbacks[] = { 0.5f, 0.9f };
+
+            for (auto feedback : feedbacks)
+            {
+                auto reference = createPreparedDelay(StorageFormat::float32, numChnls, blockSize, sampleRate);
+                reference->setDelayInSmpls(delayInSmpls);
+                reference->setFeedback(feedback);
+
+                for (auto storageFormat : storageFormats)
+                {
+                    if (storageFormat == StorageFormat::float32)
+                        continue;
+
+                    reference->reset();
+
+                    auto delay = createPreparedDelay(storageFormat, numChnls, blockSize, sampleRate);
+                    delay->setDelayInSmpls(delayInSmpls);
+                    delay->setFeedback(feedback);
+
+                    juce::AudioBuffer<float> expected(numChnls, blockSize);
+                    juce::AudioBuffer<float> actual(numChnls, blockSize);
+
+                    double energySignal = 0.0;
+                    double energyError = 0.0;
+
+                    for (int b = 0; b < numBlocks; ++b)
+                    {
+                        fillWithSine(expected, b * blockSize);
+                        actual.makeCopyOf(expected);
+
+                        juce::dsp::AudioBlock<float> blockExpected(expected);
+                        juce::dsp::AudioBlock<float> blockActual(actual);
+                        reference->process(juce::dsp::ProcessContextReplacing<float>(blockExpected));
+                        delay->process(juce::dsp::ProcessContextReplacing<float>(blockActual));
+
+                        for (int c = 0; c < numChnls; ++c)
+                        {
+                            for (int i = 0; i < blockSize; ++i)
+                            {
+                                const double error = actual.getSample(c, i) - expected.getSample(c, i);
+                                energySignal += expected.getSample(c, i) * expected.getSample(c, i);
+                                energyError += error * error;
+                            }
+                        }
+                    }
+
+                    logMessage(getName(storageFormat) + ", feedback " + juce::String(feedback, 1) + ": SNR "
+                        + juce::String(10.0 * std::log10(energySignal / juce::jmax(energyError, 1e-30)), 1) + " dB");
+                }
+            }
+        }
+
+        beginTest("Adjacent instances on separate threads");
+        {
+            const int numInstances = 256;
+            const int blockSize = 32;
+            const int numCallbacks = 2000;
+
+            juce::dsp::ProcessSpec spec;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = blockSize;
+            spec.numChannels = 1;
+
+            // instances next to each other in one array, so per block state of neighbours would
+            // share cache lines if it was not padded, small blocks make the state writes count
+            std::vector<MrDelay<float>> delays((size_t)numInstances);
+            std::vector<juce::AudioBuffer<float>> buffers;
+
+            for (auto& delay : delays)
+            {
+                delay.setMaxDelayInMs(100.0f);
+                delay.prepare(spec);
+                delay.setDelayInMs(10.0f);
+                delay.setFeedback(0.5f);
+
+                buffers.emplace_back(1, blockSize);
+                fillWithSine(buffers.back(), 0);
+            }
+
+            MrLoadTest::Settings settings;
+            settings.numCallbacks = numCallbacks;
+
+            auto results = MrLoadTest::runScaling(numInstances, [&](int instanceIdx)
+                {
+                    juce::dsp::AudioBlock<float> block(buffers[(size_t)instanceIdx]);
+                    delays[(size_t)instanceIdx].process(juce::dsp::ProcessContextReplacing<float>(block));
+                }, settings, MrLoadTest::getThreadCountsUpToCores());
+
+            for (auto& result : results)
+                logMessage(juce::String(result.numThreads) + " threads: " + juce::String(result.callbacksPerSecond, 0)
+                    + " callbacks/s, p99 " + juce::String(result.p99 * 1.0e6, 1) + " us, scaling efficiency "
+                    + juce::String(100.0 * result.scalingEfficiency, 0) + " %");
+        }
+    }
+
+private:
+
+    std::unique_ptr<MrDelay<float>> createPreparedDelay(MrDelay<float>::StorageFormat storageFormat, int numChnls, int blockSize, double sampleRate)
+    {
+        auto delay = std::make_unique<MrDelay<float>>();
+
+        juce::dsp::ProcessSpec spec;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = blockSize;
+        spec.numChannels = numChnls;
+
+        delay->prepare(spec);
+        delay->setStorageFormat(storageFormat);
+
+        return delay;
+    }
+
+    /** Writes a -6 dBFS sine starting at the given sample position. */
+    static void fillWithSine(juce::AudioBuffer<float>& buffer, int startSample)
+    {
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(c, i, 0.5f * std::sin(0.0131f * (float)(startSample + i) + (float)c));
+    }
+
+    static juce::String getName(MrDelay<float>::StorageFormat storageFormat)
+    {
+        switch (storageFormat)
+        {
+        case MrDelay<float>::StorageFormat::fixed16:  return "fixed16";
+        case MrDelay<float>::StorageFormat::half16:   return "half16";
+        case MrDelay<float>::StorageFormat::float32:
+        default:                                      return "float32";
+        }
+    }
+};
+
+static MrDelayBenchmarks delayBenchmarks;
@@ -189,7 +189,613 @@ public:
                 }
             }
         }
-    }       
+
+        beginTest("When feedback mode is ping pong then each channel feeds back into the other one");
+        {
+            const int numChnls = 2;
+            const int numSamplesPerBlock = 2;
+            const int numSamplesIn = 6;
+            const int numBlocks = numSamplesIn / numSamplesPerBlock;
+            const size_t delayInSmpls = 2;
+            const float feedback = 0.5f;
+
+            const std::vector<float> outExpectedL = { 1.0f, 0.0f, 0.0f, 0.0f, 0.25f, 0.0f };
+            const std::vector<float> outExpectedR = { 0.0f, 0.0f, 0.5f, 0.0f, 0.0f, 0.0f };
+            const auto deltaExpected = 0.0000001f;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamplesIn);
+            audioBuffer.clear();
+            audioBuffer.setSample(0, 0, 1.0f);
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.maximumBlockSize = numSamplesPerBlock;
+
+            delay->prepare(spec);
+            delay->setDelayInSmpls(delayInSmpls);
+            delay->setFeedback(feedback);
+            delay->setFeedbackMode(MrDelay<float>::FeedbackMode::pingPong);
+
+            juce::dsp::AudioBlock<float> block(audioBuffer);
+
+            auto offset = 0;
+            for (int i = 0; i < numBlocks; ++i, offset += numSamplesPerBlock)
+            {
+                auto subBlock = block.getSubBlock(offset, numSamplesPerBlock);
+                juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                delay->process(context);
+            }
+
+            /// evaluate...
+            for (int i = 0; i < numSamplesIn; ++i)
+            {
+                expect(abs(audioBuffer.getSample(0, i) - outExpectedL[i]) < deltaExpected);
+                expect(abs(audioBuffer.getSample(1, i) - outExpectedR[i]) < deltaExpected);
+            }
+        }
+
+        beginTest("When cross feed is set then the feedback matrix mixes the channels accordingly");
+        {
+            const auto deltaExpected = 0.000001f;
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = 2;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = 256;
+
+            delay->prepare(spec);
+            delay->setCrossFeed(0.25f);
+
+            /// evaluate...
+            delay->setFeedbackMode(MrDelay<float>::FeedbackMode::parallel);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 0) - 1.0f) < deltaExpected);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 1)) < deltaExpected);
+
+            delay->setFeedbackMode(MrDelay<float>::FeedbackMode::crossFeed);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 0) - 0.75f) < deltaExpected);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 1) - 0.25f) < deltaExpected);
+            expect(abs(delay->getFeedbackMatrixCoef(1, 0) - 0.25f) < deltaExpected);
+
+            delay->setFeedbackMode(MrDelay<float>::FeedbackMode::rotation);
+            delay->setCrossFeed(1.0f);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 0)) < deltaExpected);
+            expect(abs(delay->getFeedbackMatrixCoef(0, 1) + 1.0f) < deltaExpected);
+            expect(abs(delay->getFeedbackMatrixCoef(1, 0) - 1.0f) < deltaExpected);
+        }
+
+        beginTest("When low pass damping is set then the echoes of an impulse are damped");
+        {
+            const int numChnls = 2;
+            const int numSamples = 8;
+            const size_t delayInSmpls = 2;
+            const float feedback = 1.0f;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamples);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(audioBuffer);
+            MrSignal::impulse(audioSrcChnlInfo, 1.0f);
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = numSamples;
+
+            delay->prepare(spec);
+            delay->setDelayInSmpls(delayInSmpls);
+            delay->setFeedback(feedback);
+            delay->setDampingLowPassInHz(100.0f);
+
+            for (int i = 0; i < numSamples; i += 2)
+            {
+                juce::dsp::AudioBlock<float> block(audioBuffer);
+                auto subBlock = block.getSubBlock(i, 2);
+                juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                delay->process(context);
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                expect(audioBuffer.getSample(channel, 0) == 1.0f);
+                expect(audioBuffer.getMagnitude(channel, 1, numSamples - 1) < 0.1f);
+            }
+        }
+
+        beginTest("When saturation is set then the echoes stay within the saturation limit");
+        {
+            const int numChnls = 2;
+            const int numSamples = 8;
+            const size_t delayInSmpls = 2;
+            const float feedback = 1.0f;
+            const float ampImpulse = 4.0f;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamples);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(audioBuffer);
+            MrSignal::impulse(audioSrcChnlInfo, ampImpulse);
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = numSamples;
+
+            delay->prepare(spec);
+            delay->setDelayInSmpls(delayInSmpls);
+            delay->setFeedback(feedback);
+            delay->setSaturationDrive(1.0f);
+
+            for (int i = 0; i < numSamples; i += 2)
+            {
+                juce::dsp::AudioBlock<float> block(audioBuffer);
+                auto subBlock = block.getSubBlock(i, 2);
+                juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                delay->process(context);
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                expect(audioBuffer.getSample(channel, 0) == ampImpulse);
+                expect(audioBuffer.getMagnitude(channel, 1, numSamples - 1) <= 1.0f);
+                expect(audioBuffer.getMagnitude(channel, 1, numSamples - 1) > 0.5f);
+            }
+        }
+
+        beginTest("When the storage format is compact then the output matches float storage within the quantisation error");
+        {
+            const int numChnls = 2;
+            const int numSamples = 4096;
+            const int numSamplesPerBlock = 256;
+            const size_t delayInSmpls = 300;
+            const float feedback = 0.7f;
+            const float snrInDbMin = 60.0f;
+
+            const MrDelay<float>::StorageFormat storageFormats[] = { MrDelay<float>::StorageFormat::fixed16, MrDelay<float>::StorageFormat::half16 };
+
+            /// prepare... 
+            auto reference = processSine(MrDelay<float>::StorageFormat::float32, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback);
+
+            for (auto storageFormat : storageFormats)
+            {
+                /// execute...
+                auto actual = processSine(storageFormat, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback);
+
+                /// evaluate...
+                double energySignal = 0.0;
+                double energyError = 0.0;
+
+                for (int c = 0; c < numChnls; ++c)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const double error = actual.getSample(c, i) - reference.getSample(c, i);
+                        energySignal += reference.getSample(c, i) * reference.getSample(c, i);
+                        energyError += error * error;
+                    }
+                }
+
+                expect(10.0 * std::log10(energySignal / energyError) > snrInDbMin);
+            }
+        }
+
+        beginTest("When the mix is set then the output is the input and the echoes times their gains, and the echoes are the same at any mix");
+        {
+            const int numChnls = 2;
+            const int numSamples = 4096;
+            const int numSamplesPerBlock = 256;
+            const size_t delayInSmpls = 300;
+            const float feedback = 0.7f;
+            const float mixes[] = { 0.0f, 0.3f, 1.0f };
+            const float modulationDepthsInMs[] = { 0.0f, 2.0f };
+            const auto deltaExpected = 0.0001f;
+
+            const MrDelay<float>::StorageFormat storageFormats[] = { MrDelay<float>::StorageFormat::float32, MrDelay<float>::StorageFormat::fixed16 };
+
+            for (auto storageFormat : storageFormats)
+            {
+                for (auto modulationDepthInMs : modulationDepthsInMs)
+                {
+                    /// prepare...
+                    // at the default mix the output is the input plus the echoes
+                    auto reference = processSine(storageFormat, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback, modulationDepthInMs);
+
+                    for (auto mix : mixes)
+                    {
+                        /// execute...
+                        auto actual = processSine(storageFormat, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback, modulationDepthInMs,
+                                                  mix, MrDryWet::Law::linear);
+
+                        /// evaluate...
+                        float errorMax = 0.0f;
+                        for (int c = 0; c < numChnls; ++c)
+                        {
+                            for (int i = 0; i < numSamples; ++i)
+                            {
+                                const float input = 0.5f * std::sin(0.05f * (float)i + (float)c);
+                                const float echoes = reference.getSample(c, i) - input;
+                                const float expected = (1.0f - mix) * input + mix * echoes;
+
+                                errorMax = std::max(errorMax, std::abs(actual.getSample(c, i) - expected));
+                            }
+                        }
+
+                        expect(errorMax < deltaExpected, "mix " + juce::String(mix) + ", depth " + juce::String(modulationDepthInMs)
+                                                         + ", error " + juce::String(errorMax));
+                    }
+                }
+            }
+        }
+
+        beginTest("When the storage format is compact then the delay buffer takes half the memory");
+        {
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = 2;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = 256;
+
+            delay->prepare(spec);
+            delay->setDelayInSmpls(48000);
+            auto sizeFloat = delay->getDelayBufferSizeInBytes();
+
+            /// execute...
+            delay->setStorageFormat(MrDelay<float>::StorageFormat::half16);
+
+            /// evaluate...
+            expect(delay->getDelayBufferSizeInBytes() * 2 == sizeFloat);
+        }
+
+        beginTest("When the delay spans several chunks then an impulse returns after exactly the delay");
+        {
+            const int numChnls = 2;
+            const int numSamples = 12288;
+            const int numSamplesPerBlock = 512;
+            const size_t delayInSmpls = 5000;
+            const float feedback = 0.5f;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamples);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(audioBuffer);
+            MrSignal::impulse(audioSrcChnlInfo, 1.0f);
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = numSamplesPerBlock;
+
+            delay->setMaxDelayInMs(60000.0f);
+            delay->prepare(spec);
+            delay->setDelayInSmpls(delayInSmpls);
+            delay->setFeedback(feedback);
+
+            for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+            {
+                juce::dsp::AudioBlock<float> block(audioBuffer);
+                auto subBlock = block.getSubBlock(i, numSamplesPerBlock);
+                juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                delay->process(context);
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                expect(audioBuffer.getSample(channel, (int)delayInSmpls) == feedback);
+                expect(audioBuffer.getSample(channel, 2 * (int)delayInSmpls) == feedback * feedback);
+                expect(audioBuffer.getMagnitude(channel, 1, (int)delayInSmpls - 1) == 0.0f);
+            }
+        }
+
+        beginTest("When the maximum delay is a minute then only the chunks written to are touched");
+        {
+            const int numChnls = 2;
+            const int numSamplesPerBlock = 512;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamplesPerBlock);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(audioBuffer);
+            MrSignal::ramp(audioSrcChnlInfo);
+
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = numSamplesPerBlock;
+
+            /// execute...
+            delay->setMaxDelayInMs(60000.0f);
+            delay->prepare(spec);
+            delay->setDelayInMs(30000.0f);
+
+            juce::dsp::AudioBlock<float> block(audioBuffer);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            delay->process(context);
+
+            /// evaluate...
+            const size_t chunkInBytes = numChnls * MrChunkedRingBuffer<float>::CHUNK_SIZE * sizeof(float);
+
+            expect(delay->getDelayBufferSizeInBytes() >= (size_t)(numChnls * 60 * 48000) * sizeof(float));
+            expect(delay->getDelayBufferTouchedInBytes() <= 2 * chunkInBytes);
+
+            delay->reset();
+            expect(delay->getDelayBufferTouchedInBytes() == 0);
+        }
+
+        beginTest("When the modulation depth is set then the echo of an impulse lies between delay and delay plus depth");
+        {
+            const int numChnls = 2;
+            const int numSamples = 2048;
+            const int numSamplesPerBlock = 256;
+            const size_t delayInSmpls = 480;
+            const float depthInMs = 5.0f;
+            const int depthInSmpls = 240;
+
+            /// prepare... 
+            juce::AudioBuffer<float> audioBuffer(numChnls, numSamples);
+            juce::AudioSourceChannelInfo audioSrcChnlInfo(audioBuffer);
+            MrSignal::impulse(audioSrcChnlInfo, 1.0f);
+
+            /// execute...
+            auto delay(std::make_unique<MrDelay<float>>());
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = numChnls;
+            spec.sampleRate = 48000;
+            spec.maximumBlockSize = numSamplesPerBlock;
+
+            delay->prepare(spec);
+            delay->setDelayInSmpls(delayInSmpls);
+            delay->setFeedback(0.5f);
+            delay->setModulationDepthInMs(depthInMs);
+            delay->setModulationRateInHz(2.0f);
+            delay->setModulationNumVoices(2);
+            delay->setModulationStereoPhase(0.25f);
+
+            for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+            {
+                juce::dsp::AudioBlock<float> block(audioBuffer);
+                auto subBlock = block.getSubBlock(i, numSamplesPerBlock);
+                juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                delay->process(context);
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                expect(audioBuffer.getMagnitude(channel, 1, (int)delayInSmpls - 1) == 0.0f);
+                expect(audioBuffer.getMagnitude(channel, (int)delayInSmpls, depthInSmpls + 2) > 0.0f);
+                expect(audioBuffer.getMagnitude(channel, (int)delayInSmpls + depthInSmpls + 2, (int)delayInSmpls - depthInSmpls - 2) == 0.0f);
+            }
+
+            bool channelsDiffer = false;
+            for (int i = 0; i < numSamples; ++i)
+                channelsDiffer |= (audioBuffer.getSample(0, i) != audioBuffer.getSample(1, i));
+
+            expect(channelsDiffer);
+        }
+
+        beginTest("When the storage format is compact then the modulated output matches float storage within the quantisation error");
+        {
+            const int numChnls = 2;
+            const int numSamples = 4096;
+            const int numSamplesPerBlock = 256;
+            const size_t delayInSmpls = 300;
+            const float feedback = 0.5f;
+            const float snrInDbMin = 60.0f;
+
+            /// prepare... 
+            auto reference = processSine(MrDelay<float>::StorageFormat::float32, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback, 3.0f);
+
+            /// execute...
+            auto actual = processSine(MrDelay<float>::StorageFormat::half16, numChnls, numSamples, numSamplesPerBlock, delayInSmpls, feedback, 3.0f);
+
+            /// evaluate...
+            double energySignal = 0.0;
+            double energyError = 0.0;
+
+            for (int c = 0; c < numChnls; ++c)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const double error = actual.getSample(c, i) - reference.getSample(c, i);
+                    energySignal += reference.getSample(c, i) * reference.getSample(c, i);
+                    energyError += error * error;
+                }
+            }
+
+            expect(10.0 * std::log10(energySignal / energyError) > snrInDbMin);
+        }
+
+        beginTest("When the interpolation is raised then the modulated taps read a high sine more exactly");
+        {
+            const int numSamples = 2048;
+            const int numSamplesPerBlock = 256;
+            const size_t delayInSmpls = 400;
+            const float offsetInSmpls = 10.5f;
+            const float omega = 1.0f;
+
+            /// prepare...
+            float lfoAtStart;
+            MrLfo::render(&lfoAtStart, 1, 0.0, 0.0, MrLfo::Shape::sine);
+            const float depthInMs = offsetInSmpls / lfoAtStart / 48.0f;
+
+            /// execute...
+            double errors[3];
+            const MrDelay<float>::Interpolation interpolations[] = { MrDelay<float>::Interpolation::nearest,
+                MrDelay<float>::Interpolation::linear, MrDelay<float>::Interpolation::cubic };
+
+            for (int n = 0; n < 3; ++n)
+            {
+                juce::AudioBuffer<float> audioBuffer(1, numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                    audioBuffer.setSample(0, i, std::sin(omega * (float)i));
+
+                auto delay(std::make_unique<MrDelay<float>>());
+
+                juce::dsp::ProcessSpec spec;
+                spec.numChannels = 1;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = numSamplesPerBlock;
+
+                delay->prepare(spec);
+                delay->setDelayInSmpls(delayInSmpls);
+                delay->setFeedback(1.0f);
+                delay->setModulationDepthInMs(depthInMs);
+                delay->setModulationRateInHz(0.0f);
+                delay->setInterpolation(interpolations[n]);
+
+                for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+                {
+                    juce::dsp::AudioBlock<float> block(audioBuffer);
+                    auto subBlock = block.getSubBlock(i, numSamplesPerBlock);
+                    juce::dsp::ProcessContextReplacing<float> context(subBlock);
+                    delay->process(context);
+                }
+
+                // up to twice the delay the output holds the first echo only
+                errors[n] = 0.0;
+                for (int i = (int)delayInSmpls + 50; i < 2 * (int)delayInSmpls; ++i)
+                {
+                    const double wetExpected = std::sin(omega * ((double)i - (double)delayInSmpls - offsetInSmpls));
+                    const double wetActual = audioBuffer.getSample(0, i) - std::sin(omega * (float)i);
+                    errors[n] = std::max(errors[n], std::abs(wetActual - wetExpected));
+                }
+            }
+
+            /// evaluate...
+            expect(errors[0] > errors[1]);
+            expect(errors[1] > 2.0 * errors[2]);
+        }
+
+        beginTest("When the interpolation changes while modulated then the output crossfades to the new interpolation within one slice");
+        {
+            const int numSamples = 4096;
+            const int numSamplesPerBlock = 256;
+            const int switchAt = 2048;
+            const size_t delayInSmpls = 2000;
+            const int sliceSize = MrDelay<float>::MODULATION_SLICE_SIZE;
+            const MrDelay<float>::Interpolation interpolations[] = { MrDelay<float>::Interpolation::nearest,
+                MrDelay<float>::Interpolation::cubic, MrDelay<float>::Interpolation::nearest };
+
+            /// prepare...
+            std::vector<juce::AudioBuffer<float>> buffers;
+            std::vector<std::unique_ptr<MrDelay<float>>> delays;
+
+            for (auto interpolation : interpolations)
+            {
+                buffers.emplace_back(1, numSamples);
+                for (int i = 0; i < numSamples; ++i)
+                    buffers.back().setSample(0, i, 0.5f * std::sin(0.3f * (float)i));
+
+                juce::dsp::ProcessSpec spec;
+                spec.numChannels = 1;
+                spec.sampleRate = 48000;
+                spec.maximumBlockSize = numSamplesPerBlock;
+
+                delays.push_back(std::make_unique<MrDelay<float>>());
+                delays.back()->prepare(spec);
+                delays.back()->setDelayInSmpls(delayInSmpls);
+                delays.back()->setFeedback(0.5f);
+                delays.back()->setModulationDepthInMs(3.0f);
+                delays.back()->setModulationRateInHz(1.0f);
+                delays.back()->setInterpolation(interpolation);
+            }
+
+            /// execute...
+            for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+            {
+                if (i == switchAt)
+                    delays[2]->setQuality(MrQuality::Tier::high);
+
+                for (size_t n = 0; n < delays.size(); ++n)
+                {
+                    juce::dsp::AudioBlock<float> block(buffers[n]);
+                    auto subBlock = block.getSubBlock(i, numSamplesPerBlock);
+                    delays[n]->process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+                }
+            }
+
+            /// evaluate...
+            // up to twice the delay the output holds the first echo only, read from the same input in all three delays
+            auto& nearest = buffers[0];
+            auto& cubic = buffers[1];
+            auto& switched = buffers[2];
+
+            for (int i = (int)delayInSmpls; i < switchAt; ++i)
+                expect(switched.getSample(0, i) == nearest.getSample(0, i));
+
+            bool isMixed = false;
+            for (int i = switchAt; i < switchAt + sliceSize; ++i)
+            {
+                expect(std::abs(switched.getSample(0, i) - cubic.getSample(0, i)) <= std::abs(nearest.getSample(0, i) - cubic.getSample(0, i)) + 1.0e-6f);
+                isMixed |= (switched.getSample(0, i) != cubic.getSample(0, i) && switched.getSample(0, i) != nearest.getSample(0, i));
+            }
+
+            expect(isMixed);
+
+            for (int i = switchAt + sliceSize; i < 2 * (int)delayInSmpls; ++i)
+                expect(switched.getSample(0, i) == cubic.getSample(0, i));
+
+        }
+    }
+
+private:
+
+    /** Runs a sine through a delay with the given storage format, modulation depth and mix in blocks of numSamplesPerBlock. */
+    juce::AudioBuffer<float> processSine(MrDelay<float>::StorageFormat storageFormat, int numChnls, int numSamples,
+        int numSamplesPerBlock, size_t delayInSmpls, float feedback, float modulationDepthInMs = 0.0f,
+        float mix = 0.5f, MrDryWet::Law mixLaw = MrDryWet::Law::balance)
+    {
+        juce::AudioBuffer<float> audioBuffer(numChnls, numSamples);
+
+        for (int c = 0; c < numChnls; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                audioBuffer.setSample(c, i, 0.5f * std::sin(0.05f * (float)i + (float)c));
+
+        auto delay(std::make_unique<MrDelay<float>>());
+
+        juce::dsp::ProcessSpec spec;
+        spec.numChannels = numChnls;
+        spec.sampleRate = 48000;
+        spec.maximumBlockSize = numSamplesPerBlock;
+
+        // set before prepare, so the gains start at the mix and do not ramp
+        delay->setMix(mix);
+        delay->setMixLaw(mixLaw);
+
+        delay->prepare(spec);
+        delay->setStorageFormat(storageFormat);
+        delay->setDelayInSmpls(delayInSmpls);
+        delay->setFeedback(feedback);
+        delay->setModulationDepthInMs(modulationDepthInMs);
+
+        for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+        {
+            juce::dsp::AudioBlock<float> block(audioBuffer);
+            auto subBlock = block.getSubBlock(i, numSamplesPerBlock);
+            juce::dsp::ProcessContextReplacing<float> context(subBlock);
+            delay->process(context);
+        }
+
+        return audioBuffer;
+    }
 };
 
 static MrDelayTests delayTests;
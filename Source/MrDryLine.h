@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+
+/**
+	Keeps the dry signal of a chain processing in place, delayed by the latency of the
+	chain so it lines up with the wet signal the chain puts out.
+
+	A single ring buffer, allocated by prepare() for the latency plus the largest block,
+	holds the input. write() copies a block in before the chain processes it, mixInto()
+	mixes the dry samples lined up with it into the block the chain has put out. With no
+	latency those are the samples just written.
+*/
+class MrDryLine
+{
+public:
+
+	/** Allocates the ring buffer. Not for the audio thread. */
+	void prepare(int numChannels, int maxBlockSize, int delayInSmplsNew)
+	{
+		delayInSmpls = std::max(0, delayInSmplsNew);
+		maxBlockSizeWritten = std::max(1, maxBlockSize);
+
+		ring.setSize(numChannels, delayInSmpls + maxBlockSizeWritten, false, false, true);
+
+		clear();
+	}
+
+	/** Clears the ring buffer, so a dry signal coming back starts from silence. */
+	void clear() noexcept
+	{
+		ring.clear();
+		posW = 0;
+		numWritten = 0;
+	}
+
+	int getDelayInSmpls() const noexcept { return delayInSmpls; }
+
+	/** Copies the block into the ring buffer, at most as many samples as prepared for. */
+	void write(const juce::dsp::AudioBlock<float>& block) noexcept
+	{
+		jassert((int)block.getNumSamples() <= maxBlockSizeWritten);
+
+		const int size = ring.getNumSamples();
+		const int num = std::min((int)block.getNumSamples(), maxBlockSizeWritten);
+		const int numToEnd = std::min(num, size - posW);
+		const int numChannels = std::min((int)block.getNumChannels(), ring.getNumChannels());
+
+		for (int c = 0; c < numChannels; ++c)
+		{
+			const float* src = block.getChannelPointer((size_t)c);
+
+			ring.copyFrom(c, posW, src, numToEnd);
+			ring.copyFrom(c, 0, src + numToEnd, num - numToEnd);
+		}
+
+		posR = (posW - delayInSmpls + size) % size;
+		posW = (posW + num) % size;
+		numWritten = num;
+	}
+
+	/** Mixes the dry samples lined up with the block written last into the block, which is the wet signal. */
+	void mixInto(juce::dsp::AudioBlock<float>& block, const MrDryWet::Ramp& ramp) noexcept
+	{
+		const int size = ring.getNumSamples();
+		const int num = std::min((int)block.getNumSamples(), numWritten);
+		const int numToEnd = std::min(num, size - posR);
+		const int numChannels = std::min((int)block.getNumChannels(), ring.getNumChannels());
+
+		for (int c = 0; c < numChannels; ++c)
+		{
+			float* wet = block.getChannelPointer((size_t)c);
+
+			MrDryWet::mix(wet, ring.getReadPointer(c, posR), wet, numToEnd, ramp);
+			MrDryWet::mix(wet + numToEnd, ring.getReadPointer(c), wet + numToEnd, num - numToEnd, ramp.getSlice(numToEnd));
+		}
+	}
+
+private:
+
+	juce::AudioBuffer<float> ring;
+	int delayInSmpls{ 0 };
+	int maxBlockSizeWritten{ 1 };
+	int posW{ 0 };
+	int posR{ 0 };
+	int numWritten{ 0 };
+};
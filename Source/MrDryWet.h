@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <JuceHeader.h>
+
+/**
+	Dry/wet mix of a stage or the whole chain. The mix runs from 0, dry only, to 1, wet only,
+	and the law turns it into a gain for each signal. A new mix or law ramps the gains
+	linearly over RAMP_IN_SECONDS.
+
+	The class holds no signal of its own. The stages run mix() or mixAndSum() within their
+	output loops, on the dry samples they still hold and the wet samples they have just
+	made, so mixing costs no pass and no copy of the dry signal of its own. Stages check
+	isUnity() or isWetOnly() first and keep the output loop they had without a mix.
+*/
+class MrDryWet
+{
+public:
+
+	enum class Law
+	{
+		balance,		/**< both at full level at the centre, the other one fading out linearly towards either end */
+		linear,			/**< dry 1 - mix and wet mix, each 6 dB down at the centre */
+		equalPower		/**< dry cos and wet sin of the mix times 90 degrees, the power of uncorrelated signals stays the same */
+	};
+
+	static constexpr int NUM_LAWS = 3;
+	static constexpr double RAMP_IN_SECONDS = 0.02;
+
+	struct Gains
+	{
+		float dry = 1.0f;
+		float wet = 1.0f;
+	};
+
+	/** The gains over a block, the gain at sample i is start + inc * (i + 1). */
+	struct Ramp
+	{
+		float dryStart = 1.0f;
+		float dryInc = 0.0f;
+		float wetStart = 1.0f;
+		float wetInc = 0.0f;
+
+		float getDry(int i) const noexcept { return dryStart + dryInc * (float)(i + 1); }
+		float getWet(int i) const noexcept { return wetStart + wetInc * (float)(i + 1); }
+
+		/** Returns the ramp from sample offset on. */
+		Ramp getSlice(int offset) const noexcept
+		{
+			return { dryStart + dryInc * (float)offset, dryInc, wetStart + wetInc * (float)offset, wetInc };
+		}
+	};
+
+	//==============================================================================
+	static Law toLaw(int law) noexcept { return (Law)juce::jlimit(0, NUM_LAWS - 1, law); }
+
+	/** Returns the gains the law gives for the mix, exactly 0 and 1 at the ends. */
+	static Gains toGains(float mix, Law law) noexcept
+	{
+		mix = juce::jlimit(0.0f, 1.0f, mix);
+
+		Gains gains;
+
+		if (law == Law::balance)
+		{
+			gains.dry = std::min(1.0f, 2.0f * (1.0f - mix));
+			gains.wet = std::min(1.0f, 2.0f * mix);
+		}
+		else if (law == Law::linear)
+		{
+			gains.dry = 1.0f - mix;
+			gains.wet = mix;
+		}
+		else
+		{
+			const float angle = mix * juce::MathConstants<float>::halfPi;
+
+			gains.dry = (mix < 1.0f) ? std::cos(angle) : 0.0f;
+			gains.wet = (mix > 0.0f) ? std::sin(angle) : 0.0f;
+		}
+
+		return gains;
+	}
+
+	//==============================================================================
+	explicit MrDryWet(float mixDefault = 1.0f) noexcept
+		: mixValue(juce::jlimit(0.0f, 1.0f, mixDefault))
+	{
+		const auto gains = toGains(mixValue, law);
+		dryGain.setCurrentAndTargetValue(gains.dry);
+		wetGain.setCurrentAndTargetValue(gains.wet);
+	}
+
+	/** Sets the mix, 0 is dry only and 1 wet only. */
+	void setMix(float mixNew) noexcept
+	{
+		mixValue = juce::jlimit(0.0f, 1.0f, mixNew);
+
+		updateGains();
+	}
+
+	float getMix() const noexcept { return mixValue; }
+
+	void setLaw(Law lawNew) noexcept
+	{
+		law = lawNew;
+
+		updateGains();
+	}
+
+	Law getLaw() const noexcept { return law; }
+
+	/** Returns the gains the ramp heads for. */
+	Gains getGains() const noexcept { return { dryGain.getTargetValue(), wetGain.getTargetValue() }; }
+
+	//==============================================================================
+	/** Sets the ramp time for the sample rate and jumps to the gains of the mix. */
+	void prepare(double sampleRate) noexcept
+	{
+		dryGain.reset(sampleRate, RAMP_IN_SECONDS);
+		wetGain.reset(sampleRate, RAMP_IN_SECONDS);
+
+		reset();
+	}
+
+	void reset() noexcept
+	{
+		dryGain.setCurrentAndTargetValue(dryGain.getTargetValue());
+		wetGain.setCurrentAndTargetValue(wetGain.getTargetValue());
+	}
+
+	/** Returns true while both gains stay at 1, the stage then adds its wet signal to the dry one as it did without a mix. */
+	bool isUnity() const noexcept
+	{
+		return !isRamping() && dryGain.getCurrentValue() == 1.0f && wetGain.getCurrentValue() == 1.0f;
+	}
+
+	/** Returns true while the dry gain stays at 0 and the wet one at 1, the stage then puts out its wet signal only. */
+	bool isWetOnly() const noexcept
+	{
+		return !isRamping() && dryGain.getCurrentValue() == 0.0f && wetGain.getCurrentValue() == 1.0f;
+	}
+
+	bool isRamping() const noexcept { return dryGain.isSmoothing() || wetGain.isSmoothing(); }
+
+	/** Returns the gains over the next num samples and moves on by as many. The block a ramp ends in spreads the rest of it over the block. */
+	Ramp advance(int num) noexcept
+	{
+		Ramp ramp;
+		ramp.dryStart = dryGain.getCurrentValue();
+		ramp.wetStart = wetGain.getCurrentValue();
+
+		if (num > 0 && isRamping())
+		{
+			ramp.dryInc = (dryGain.skip(num) - ramp.dryStart) / (float)num;
+			ramp.wetInc = (wetGain.skip(num) - ramp.wetStart) / (float)num;
+		}
+
+		return ramp;
+	}
+
+	//==============================================================================
+	/** Writes the dry times its gain plus the wet times its gain to out, which may be dry or wet. No wet is silence. */
+	static void mix(float* out, const float* dry, const float* wet, int num, const Ramp& ramp) noexcept
+	{
+		if (wet == nullptr)
+		{
+			for (int i = 0; i < num; ++i)
+				out[i] = dry[i] * ramp.getDry(i);
+
+			return;
+		}
+
+		for (int i = 0; i < num; ++i)
+			out[i] = dry[i] * ramp.getDry(i) + wet[i] * ramp.getWet(i);
+	}
+
+	/** As mix(), also writing the plain sum of dry and wet to sum, for a feedback path that must not depend on the mix. */
+	static void mixAndSum(float* out, float* sum, const float* dry, const float* wet, int num, const Ramp& ramp) noexcept
+	{
+		if (wet == nullptr)
+		{
+			for (int i = 0; i < num; ++i)
+			{
+				const float x = dry[i];
+
+				sum[i] = x;
+				out[i] = x * ramp.getDry(i);
+			}
+
+			return;
+		}
+
+		for (int i = 0; i < num; ++i)
+		{
+			const float x = dry[i];
+			const float y = wet[i];
+
+			sum[i] = x + y;
+			out[i] = x * ramp.getDry(i) + y * ramp.getWet(i);
+		}
+	}
+
+private:
+
+	void updateGains() noexcept
+	{
+		const auto gains = toGains(mixValue, law);
+
+		dryGain.setTargetValue(gains.dry);
+		wetGain.setTargetValue(gains.wet);
+	}
+
+	float mixValue;
+	Law law{ Law::balance };
+
+	juce::SmoothedValue<float> dryGain, wetGain;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+
+class MrDryWetTests : public juce::UnitTest
+{
+public:
+
+    MrDryWetTests() : juce::UnitTest("MrDryWet testing") {}
+
+    void runTest() override
+    {
+        using Law = MrDryWet::Law;
+
+        beginTest("When the mix is at either end then each law gives exactly the dry or the wet signal only.");
+        {
+            for (int law = 0; law < MrDryWet::NUM_LAWS; ++law)
+            {
+                /// execute...
+                const auto gainsDry = MrDryWet::toGains(0.0f, (Law)law);
+                const auto gainsWet = MrDryWet::toGains(1.0f, (Law)law);
+
+                /// evaluate...
+                expect(gainsDry.dry == 1.0f && gainsDry.wet == 0.0f, "law " + juce::String(law));
+                expect(gainsWet.dry == 0.0f && gainsWet.wet == 1.0f, "law " + juce::String(law));
+            }
+        }
+
+        beginTest("When the mix is at the centre then balance gives both at full level, linear both at half and equal power keeps the power.");
+        {
+            const auto deltaExpected = 0.00001f;
+
+            /// execute...
+            const auto balance = MrDryWet::toGains(0.5f, Law::balance);
+            const auto linear = MrDryWet::toGains(0.5f, Law::linear);
+
+            /// evaluate...
+            expect(balance.dry == 1.0f && balance.wet == 1.0f);
+            expect(linear.dry == 0.5f && linear.wet == 0.5f);
+
+            for (float mix = 0.0f; mix <= 1.0f; mix += 0.125f)
+            {
+                const auto equalPower = MrDryWet::toGains(mix, Law::equalPower);
+                expectWithinAbsoluteError(equalPower.dry * equalPower.dry + equalPower.wet * equalPower.wet, 1.0f, deltaExpected);
+            }
+        }
+
+        beginTest("When the mix changes then the gains ramp to the new ones in steps no larger than those over the ramp time, whatever the block size.");
+        {
+            const double sampleRate = 48000;
+            const int numRampSmpls = (int)(MrDryWet::RAMP_IN_SECONDS * sampleRate);
+            const int blockSizes[] = { 64, 1, 100, 37 };
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            MrDryWet dryWet(1.0f);
+            dryWet.setLaw(Law::linear);
+            dryWet.prepare(sampleRate);
+            dryWet.setMix(0.0f);
+
+            std::vector<float> dryGains, wetGains;
+            std::vector<size_t> blockEnds;
+
+            /// execute...
+            for (int n = 0; (int)dryGains.size() < 2 * numRampSmpls; ++n)
+            {
+                const int num = blockSizes[n % 4];
+                const auto ramp = dryWet.advance(num);
+
+                for (int i = 0; i < num; ++i)
+                {
+                    dryGains.push_back(ramp.getDry(i));
+                    wetGains.push_back(ramp.getWet(i));
+                }
+
+                blockEnds.push_back(dryGains.size());
+            }
+
+            /// evaluate...
+            // within a block the gains step linearly, the block the ramp ends in spreads the rest of it over the block
+            float stepMax = 0.0f;
+            float previous = 0.0f;
+            for (size_t i = 0; i < dryGains.size(); ++i)
+            {
+                expect(dryGains[i] >= previous - deltaExpected);
+                expectWithinAbsoluteError(dryGains[i] + wetGains[i], 1.0f, deltaExpected);
+
+                stepMax = std::max(stepMax, dryGains[i] - previous);
+                previous = dryGains[i];
+            }
+
+            expect(stepMax < 1.0f / (float)numRampSmpls + deltaExpected, "step " + juce::String(stepMax));
+
+            for (auto end : blockEnds)
+                expectWithinAbsoluteError(dryGains[end - 1], std::min(1.0f, (float)end / (float)numRampSmpls), deltaExpected);
+
+            expect(!dryWet.isRamping() && !dryWet.isWetOnly() && !dryWet.isUnity());
+        }
+
+        beginTest("When mixing in place then the output is the dry and the wet times their gains, and the sum the plain sum of both.");
+        {
+            const int num = 16;
+            const MrDryWet::Ramp ramp{ 0.25f, 0.01f, 0.5f, -0.01f };
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            std::vector<float> dry((size_t)num), wet((size_t)num), out((size_t)num), sum((size_t)num);
+            for (int i = 0; i < num; ++i)
+            {
+                dry[(size_t)i] = (float)i;
+                wet[(size_t)i] = 100.0f - (float)i;
+            }
+
+            auto wetInPlace = wet;
+
+            /// execute...
+            MrDryWet::mixAndSum(out.data(), sum.data(), dry.data(), wet.data(), num, ramp);
+            MrDryWet::mix(wetInPlace.data(), dry.data(), wetInPlace.data(), num, ramp);
+
+            /// evaluate...
+            for (int i = 0; i < num; ++i)
+            {
+                const auto idx = (size_t)i;
+                const float expected = dry[idx] * ramp.getDry(i) + wet[idx] * ramp.getWet(i);
+
+                expectWithinAbsoluteError(out[idx], expected, deltaExpected);
+                expectWithinAbsoluteError(wetInPlace[idx], expected, deltaExpected);
+                expectEquals(sum[idx], dry[idx] + wet[idx]);
+            }
+        }
+    }
+};
+
+static MrDryWetTests dryWetTests;
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Process wide cache of read-only DSP tables, keyed by table type and sample rate, and
+	of FFTs, keyed by their order.
+
+	Access it through a juce::SharedResourcePointer<MrDspTableCache>, so all plugin
+	instances in the process share the same cache, tables and FFTs. Both are reference
+	counted: they live as long as at least one instance holds them.
+
+	The FFTs are what each instance would otherwise duplicate: the twiddle tables of an
+	FFT of order 12 take 64 KB, and every linear phase filter runs two of them. Tables are
+	built lazily on a background thread, started with the first table. The audio thread
+	reads a table lock free via Table::getData(), which returns nullptr until the table has
+	been built. The low pass table is not smaller than the coefficients of a filter, it
+	keeps one grid per sample rate in the process.
+*/
+class MrDspTableCache
+{
+public:
+
+	enum class TableType
+	{
+		lowPassCoefs	/**< biquad low pass coefficients (b0, b1, b2, a1, a2) over a log spaced cut off grid */
+	};
+
+	static constexpr int NUM_LOW_PASS_CUTOFFS = 2048;
+	static constexpr int NUM_BIQUAD_COEFS = 5;
+	static constexpr float LOW_PASS_MIN_IN_HZ = 20.0f;
+	static constexpr float LOW_PASS_MAX_IN_HZ = 20000.0f;
+	static constexpr float LOW_PASS_Q = 5.0f;
+
+	//==============================================================================
+	/** A table, immutable once it has been built. */
+	class Table : public juce::ReferenceCountedObject
+	{
+	public:
+
+		using Ptr = juce::ReferenceCountedObjectPtr<Table>;
+
+		Table(TableType typeNew, double sampleRateNew) : type(typeNew), sampleRate(sampleRateNew) {}
+
+		/** Returns the table data once it has been built, nullptr before. */
+		const float* getData() const noexcept { return isBuilt.load(std::memory_order_acquire) ? data.data() : nullptr; }
+
+		TableType getType() const noexcept { return type; }
+		double getSampleRate() const noexcept { return sampleRate; }
+
+	private:
+
+		friend class MrDspTableCache;
+
+		const TableType type;
+		const double sampleRate;
+
+		std::vector<float> data;
+		std::atomic<bool> isBuilt{ false };
+	};
+
+	//==============================================================================
+	/**
+		An FFT, immutable once it has been created. The transforms only read its twiddle
+		tables and keep their scratch space on the stack of the calling thread, so any
+		number of threads may run the same FFT at once.
+	*/
+	class Fft : public juce::ReferenceCountedObject,
+				public juce::dsp::FFT
+	{
+	public:
+
+		using Ptr = juce::ReferenceCountedObjectPtr<Fft>;
+
+		explicit Fft(int orderNew) : juce::dsp::FFT(orderNew), order(orderNew) {}
+
+		int getOrder() const noexcept { return order; }
+
+	private:
+
+		const int order;
+	};
+
+	//==============================================================================
+	MrDspTableCache() = default;
+
+	~MrDspTableCache()
+	{
+		if (pool != nullptr)
+			pool->removeAllJobs(true, 5000);
+	}
+
+	/**
+		Returns the table for the given type and sample rate. If it does not exist yet
+		it is created empty and built on the background thread. Not for the audio thread.
+	*/
+	Table::Ptr getTable(TableType type, double sampleRate)
+	{
+		const juce::ScopedLock sl(lock);
+
+		releaseUnusedTables();
+
+		for (auto& table : tables)
+			if (table->type == type && table->sampleRate == sampleRate)
+				return table;
+
+		Table::Ptr table = new Table(type, sampleRate);
+		tables.push_back(table);
+
+		if (pool == nullptr)
+			pool = std::make_unique<juce::ThreadPool>(1);
+
+		pool->addJob([table]
+			{
+				build(*table);
+				table->isBuilt.store(true, std::memory_order_release);
+			});
+
+		return table;
+	}
+
+	/** Returns the number of tables currently held by the cache. */
+	size_t getNumTables() const
+	{
+		const juce::ScopedLock sl(lock);
+		return tables.size();
+	}
+
+	/** Returns the FFT of the given order, created on the calling thread if it does not exist yet. Not for the audio thread. */
+	Fft::Ptr getFft(int order)
+	{
+		const juce::ScopedLock sl(lock);
+
+		releaseUnusedFfts();
+
+		for (auto& fft : ffts)
+			if (fft->getOrder() == order)
+				return fft;
+
+		Fft::Ptr fft = new Fft(order);
+		ffts.push_back(fft);
+
+		return fft;
+	}
+
+	/** Returns the number of FFTs currently held by the cache. */
+	size_t getNumFfts() const
+	{
+		const juce::ScopedLock sl(lock);
+		return ffts.size();
+	}
+
+	//==============================================================================
+	/** Returns the cut off of the given grid point of the low pass table. */
+	static float lowPassCutOffAt(int idx) noexcept
+	{
+		return LOW_PASS_MIN_IN_HZ * std::pow(LOW_PASS_MAX_IN_HZ / LOW_PASS_MIN_IN_HZ, (float)idx / (float)(NUM_LOW_PASS_CUTOFFS - 1));
+	}
+
+	/** Interpolates the biquad coefficients for a cut off from a low pass table into coefs. */
+	static void lookUpLowPassCoefs(const float* table, float cutOffInHz, float* coefs) noexcept
+	{
+		const float cutOff = juce::jlimit(LOW_PASS_MIN_IN_HZ, LOW_PASS_MAX_IN_HZ, cutOffInHz);
+		const float pos = std::log(cutOff / LOW_PASS_MIN_IN_HZ) / std::log(LOW_PASS_MAX_IN_HZ / LOW_PASS_MIN_IN_HZ)
+			* (float)(NUM_LOW_PASS_CUTOFFS - 1);
+
+		const int idx = std::min((int)pos, NUM_LOW_PASS_CUTOFFS - 2);
+		const float frac = pos - (float)idx;
+
+		const float* lower = table + idx * NUM_BIQUAD_COEFS;
+		const float* upper = lower + NUM_BIQUAD_COEFS;
+
+		for (int i = 0; i < NUM_BIQUAD_COEFS; ++i)
+			coefs[i] = lower[i] + frac * (upper[i] - lower[i]);
+	}
+
+private:
+
+	static void build(Table& table)
+	{
+		switch (table.type)
+		{
+		case TableType::lowPassCoefs:
+			buildLowPassCoefs(table);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	static void buildLowPassCoefs(Table& table)
+	{
+		table.data.resize((size_t)(NUM_LOW_PASS_CUTOFFS * NUM_BIQUAD_COEFS));
+
+		const float cutOffMax = (float)(table.sampleRate * 0.49);
+
+		for (int i = 0; i < NUM_LOW_PASS_CUTOFFS; ++i)
+		{
+			auto coefs = juce::dsp::IIR::Coefficients<float>::makeLowPass(table.sampleRate, std::min(lowPassCutOffAt(i), cutOffMax), LOW_PASS_Q);
+			const float* raw = coefs->getRawCoefficients();
+
+			std::copy(raw, raw + NUM_BIQUAD_COEFS, table.data.begin() + i * NUM_BIQUAD_COEFS);
+		}
+	}
+
+	/** Drops the tables nobody but the cache refers to anymore. */
+	void releaseUnusedTables()
+	{
+		tables.erase(std::remove_if(tables.begin(), tables.end(),
+			[](const Table::Ptr& table) { return table->getReferenceCount() == 1; }),
+			tables.end());
+	}
+
+	/** Drops the FFTs nobody but the cache refers to anymore. */
+	void releaseUnusedFfts()
+	{
+		ffts.erase(std::remove_if(ffts.begin(), ffts.end(),
+			[](const Fft::Ptr& fft) { return fft->getReferenceCount() == 1; }),
+			ffts.end());
+	}
+
+	juce::CriticalSection lock;
+	std::vector<Table::Ptr> tables;
+	std::vector<Fft::Ptr> ffts;
+	std::unique_ptr<juce::ThreadPool> pool;
+
+	JUCE_DECLARE_NON_COPYABLE(MrDspTableCache)
+};
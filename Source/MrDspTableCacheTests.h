@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MrDspTableCache.h"
+
+class MrDspTableCacheTests : public juce::UnitTest
+{
+public:
+
+    MrDspTableCacheTests() : juce::UnitTest("MrDspTableCache testing") {}
+
+    void runTest() override
+    {
+        beginTest("When the same table is requested twice then both share the same table.");
+        {
+            juce::SharedResourcePointer<MrDspTableCache> cache1;
+            juce::SharedResourcePointer<MrDspTableCache> cache2;
+
+            /// execute...
+            auto table1 = cache1->getTable(MrDspTableCache::TableType::lowPassCoefs, 48000);
+            auto table2 = cache2->getTable(MrDspTableCache::TableType::lowPassCoefs, 48000);
+            auto table3 = cache2->getTable(MrDspTableCache::TableType::lowPassCoefs, 96000);
+
+            /// evaluate...
+            expect(&cache1.get() == &cache2.get());
+            expect(table1.get() == table2.get());
+            expect(table1.get() != table3.get());
+        }
+
+        beginTest("When a table is no longer used then the cache releases it.");
+        {
+            juce::SharedResourcePointer<MrDspTableCache> cache;
+
+            auto table = cache->getTable(MrDspTableCache::TableType::lowPassCoefs, 44100);
+            waitUntilBuilt(*table);
+            auto numTablesUsed = cache->getNumTables();
+
+            /// execute...
+            table = nullptr;
+            cache->getTable(MrDspTableCache::TableType::lowPassCoefs, 22050);
+
+            /// evaluate...
+            expect(cache->getNumTables() <= numTablesUsed);
+        }
+
+        beginTest("When looking up a cut off on the grid then the coefficients equal the computed ones.");
+        {
+            const double sampleRate = 48000;
+            const int idx = 1000;
+            const auto deltaExpected = 0.00001f;
+
+            juce::SharedResourcePointer<MrDspTableCache> cache;
+            auto table = cache->getTable(MrDspTableCache::TableType::lowPassCoefs, sampleRate);
+
+            /// execute...
+            expect(waitUntilBuilt(*table));
+
+            auto cutOffInHz = MrDspTableCache::lowPassCutOffAt(idx);
+            float coefsActual[MrDspTableCache::NUM_BIQUAD_COEFS];
+            MrDspTableCache::lookUpLowPassCoefs(table->getData(), cutOffInHz, coefsActual);
+
+            auto coefsExpected = juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, cutOffInHz, MrDspTableCache::LOW_PASS_Q);
+
+            /// evaluate...
+            for (int i = 0; i < MrDspTableCache::NUM_BIQUAD_COEFS; ++i)
+                expect(abs(coefsActual[i] - coefsExpected->getRawCoefficients()[i]) < deltaExpected);
+        }
+    }
+
+private:
+
+    bool waitUntilBuilt(const MrDspTableCache::Table& table)
+    {
+        for (int i = 0; i < 5000 && table.getData() == nullptr; ++i)
+            juce::Thread::sleep(1);
+
+        return table.getData() != nullptr;
+    }
+};
+
+static MrDspTableCacheTests dspTableCacheTests;
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <JuceHeader.h>
+
+/**
+	Tells whether both channels of a stereo signal carry the same signal, so the work on
+	one of them can be saved.
+
+	Bit identical blocks are recognised by comparing their memory, otherwise the largest
+	difference is found with the vectorised FloatVectorOperations. The input counts as dual
+	mono once it has been so for the hold time, and stops to once a block differs by more
+	than twice the threshold, so a signal near the threshold does not flip every block.
+*/
+class MrDualMonoDetector
+{
+public:
+
+	static constexpr float THRESHOLD_DEFAULT = 1.0e-5f;	/**< -100 dBFS */
+	static constexpr int HOLD_IN_SMPLS_DEFAULT = 4096;
+
+	/** Sets the largest difference between the channels that still counts as the same signal. */
+	void setThreshold(float thresholdNew) noexcept { threshold = std::max(0.0f, thresholdNew); }
+
+	/** Returns the largest difference that still counts as the same signal. */
+	float getThreshold() const noexcept { return threshold; }
+
+	/** Sets how long the channels must be the same before the input counts as dual mono. */
+	void setHoldInSmpls(int holdInSmplsNew) noexcept { holdInSmpls = std::max(0, holdInSmplsNew); }
+
+	/** Returns how long the channels must be the same before the input counts as dual mono. */
+	int getHoldInSmpls() const noexcept { return holdInSmpls; }
+
+	/** Starts over, the input counts as stereo. */
+	void reset() noexcept
+	{
+		numSmplsSame = 0;
+		isDualMonoNow = false;
+	}
+
+	//==============================================================================
+	/** Compares the next block of both channels, returns true if the input counts as dual mono. */
+	bool process(const float* left, const float* right, int numSamples) noexcept
+	{
+		if (!isWithin(left, right, numSamples, isDualMonoNow ? 2.0f * threshold : threshold))
+		{
+			reset();
+			return false;
+		}
+
+		numSmplsSame = std::min(numSmplsSame + numSamples, holdInSmpls);
+		isDualMonoNow = (numSmplsSame >= holdInSmpls);
+
+		return isDualMonoNow;
+	}
+
+	/** Returns true if the input counted as dual mono at the last block. */
+	bool isDualMono() const noexcept { return isDualMonoNow; }
+
+	/** Returns true if no samples of both channels differ by more than the limit. */
+	static bool isWithin(const float* left, const float* right, int numSamples, float limit) noexcept
+	{
+		if (std::memcmp(left, right, (size_t)numSamples * sizeof(float)) == 0)
+			return true;
+
+		if (limit <= 0.0f)
+			return false;
+
+		std::array<float, SLICE_SIZE> diff;
+
+		for (int start = 0; start < numSamples; start += SLICE_SIZE)
+		{
+			const int num = juce::jmin(SLICE_SIZE, numSamples - start);
+
+			juce::FloatVectorOperations::subtract(diff.data(), left + start, right + start, num);
+			auto range = juce::FloatVectorOperations::findMinAndMax(diff.data(), num);
+
+			if (range.getStart() < -limit || range.getEnd() > limit)
+				return false;
+		}
+
+		return true;
+	}
+
+private:
+
+	static constexpr int SLICE_SIZE = 256;
+
+	float threshold{ THRESHOLD_DEFAULT };
+	int holdInSmpls{ HOLD_IN_SMPLS_DEFAULT };
+
+	int numSmplsSame{ 0 };
+	bool isDualMonoNow{ false };
+};
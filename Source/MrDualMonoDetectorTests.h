@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrDualMonoDetector.h"
+
+class MrDualMonoDetectorTests : public juce::UnitTest
+{
+public:
+
+    MrDualMonoDetectorTests() : juce::UnitTest("MrDualMonoDetector testing") {}
+
+    void runTest() override
+    {
+        beginTest("When both channels are the same then the input counts as dual mono after the hold time.");
+        {
+            /// prepare...
+            const int blockSize = 256;
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+            buffer.copyFrom(1, 0, buffer, 0, 0, blockSize);
+
+            MrDualMonoDetector detector;
+            detector.setHoldInSmpls(4 * blockSize);
+
+            /// execute...
+            bool isDualMono[5];
+            for (auto& is : isDualMono)
+                is = detector.process(buffer.getReadPointer(0), buffer.getReadPointer(1), blockSize);
+
+            /// evaluate...
+            expect(!isDualMono[0] && !isDualMono[1] && !isDualMono[2]);
+            expect(isDualMono[3] && isDualMono[4]);
+        }
+
+        beginTest("When the channels differ then the input counts as stereo at once.");
+        {
+            /// prepare...
+            const int blockSize = 256;
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+            buffer.copyFrom(1, 0, buffer, 0, 0, blockSize);
+
+            MrDualMonoDetector detector;
+            detector.setHoldInSmpls(0);
+
+            /// execute...
+            const bool isDualMonoBefore = detector.process(buffer.getReadPointer(0), buffer.getReadPointer(1), blockSize);
+
+            buffer.setSample(1, blockSize - 1, buffer.getSample(1, blockSize - 1) + 0.01f);
+            const bool isDualMonoAfter = detector.process(buffer.getReadPointer(0), buffer.getReadPointer(1), blockSize);
+
+            /// evaluate...
+            expect(isDualMonoBefore);
+            expect(!isDualMonoAfter);
+            expect(!detector.isDualMono());
+        }
+
+        beginTest("When the channels differ by less than the threshold then they count as the same, with hysteresis.");
+        {
+            /// prepare...
+            const int blockSize = 100;
+            const float threshold = MrDualMonoDetector::THRESHOLD_DEFAULT;
+
+            std::vector<float> left(blockSize, 0.25f);
+            std::vector<float> rightBelow(blockSize, 0.25f + 0.5f * threshold);
+            std::vector<float> rightBetween(blockSize, 0.25f + 1.5f * threshold);
+
+            MrDualMonoDetector detector;
+            detector.setHoldInSmpls(blockSize);
+
+            /// execute...
+            const bool isBetweenFromStereo = detector.process(left.data(), rightBetween.data(), blockSize);
+            const bool isBelow = detector.process(left.data(), rightBelow.data(), blockSize);
+            const bool isBetweenFromDualMono = detector.process(left.data(), rightBetween.data(), blockSize);
+
+            /// evaluate...
+            expect(!isBetweenFromStereo);
+            expect(isBelow);
+            expect(isBetweenFromDualMono);
+        }
+    }
+};
+
+static MrDualMonoDetectorTests dualMonoDetectorTests;
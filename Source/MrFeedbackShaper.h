@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Colours the feedback path of a delay: one-pole low and high pass damping
+	followed by a tanh soft saturation.
+
+	The saturation uses first order antiderivative anti-aliasing (ADAA), so it
+	does not need to be oversampled. All stages are applied in a single pass
+	while the samples are written into the delay buffer.
+*/
+template <typename FloatType>
+class MrFeedbackShaper
+{
+public:
+
+	MrFeedbackShaper() noexcept = default;
+
+	//==============================================================================
+	/** Sets the cut off of the low pass damping, 0 disables it. */
+	void setLowPassInHz(FloatType lowPassInHzNew) noexcept
+	{
+		lowPassInHz = lowPassInHzNew;
+		updateCoefs();
+	}
+
+	/** Returns the cut off of the low pass damping. */
+	FloatType getLowPassInHz() const noexcept { return lowPassInHz; }
+
+	/** Sets the cut off of the high pass damping, 0 disables it. */
+	void setHighPassInHz(FloatType highPassInHzNew) noexcept
+	{
+		highPassInHz = highPassInHzNew;
+		updateCoefs();
+	}
+
+	/** Returns the cut off of the high pass damping. */
+	FloatType getHighPassInHz() const noexcept { return highPassInHz; }
+
+	/** Sets the drive of the saturation, 0 disables it. */
+	void setDrive(FloatType driveNew) noexcept
+	{
+		drive = std::max(FloatType(0), driveNew);
+	}
+
+	/** Returns the drive of the saturation. */
+	FloatType getDrive() const noexcept { return drive; }
+
+	/** Returns true if at least one of the stages is active. */
+	bool isActive() const noexcept { return lowPassCoef > 0 || highPassCoef > 0 || drive > 0; }
+
+	//==============================================================================
+	/** Sizes the filter states, called whenever the sample rate or number of channels changes. */
+	void prepare(double sampleRateNew, size_t numChnls)
+	{
+		sampleRate = sampleRateNew;
+
+		lowPassStates.assign(numChnls, FloatType(0));
+		highPassStates.assign(numChnls, FloatType(0));
+		satPrevIns.assign(numChnls, FloatType(0));
+
+		updateCoefs();
+	}
+
+	/** Clears the filter states without reallocating. */
+	void reset() noexcept
+	{
+		std::fill(lowPassStates.begin(), lowPassStates.end(), FloatType(0));
+		std::fill(highPassStates.begin(), highPassStates.end(), FloatType(0));
+		std::fill(satPrevIns.begin(), satPrevIns.end(), FloatType(0));
+	}
+
+	/** Copies the filter states of one channel into another. */
+	void copyChannel(size_t chnlFrom, size_t chnlTo) noexcept
+	{
+		if (chnlFrom >= lowPassStates.size() || chnlTo >= lowPassStates.size())
+			return;
+
+		lowPassStates[chnlTo] = lowPassStates[chnlFrom];
+		highPassStates[chnlTo] = highPassStates[chnlFrom];
+		satPrevIns[chnlTo] = satPrevIns[chnlFrom];
+	}
+
+	//==============================================================================
+	/**
+		Writes gain * src through all active stages into dest, src and dest may be the same.
+		Uses and updates the filter states of the given channel.
+	*/
+	void processInto(float* dest, const float* src, FloatType gain, int num, size_t chnl) noexcept
+	{
+		if (chnl >= lowPassStates.size())
+		{
+			juce::FloatVectorOperations::copyWithMultiply(dest, src, (float)gain, num);
+			return;
+		}
+
+		const bool useLowPass = lowPassCoef > 0;
+		const bool useHighPass = highPassCoef > 0;
+		const bool useSat = drive > 0;
+
+		FloatType lp = lowPassStates[chnl];
+		FloatType hp = highPassStates[chnl];
+		FloatType prev = satPrevIns[chnl];
+
+		for (int i = 0; i < num; ++i)
+		{
+			FloatType x = gain * src[i];
+
+			if (useLowPass)
+			{
+				lp += lowPassCoef * (x - lp);
+				x = lp;
+			}
+
+			if (useHighPass)
+			{
+				hp += highPassCoef * (x - hp);
+				x -= hp;
+			}
+
+			if (useSat)
+			{
+				const FloatType u = drive * x;
+				x = saturateAdaa(u, prev) / drive;
+				prev = u;
+			}
+
+			dest[i] = (float)x;
+		}
+
+		lowPassStates[chnl] = lp;
+		highPassStates[chnl] = hp;
+		satPrevIns[chnl] = prev;
+	}
+
+	//==============================================================================
+	/** First order ADAA of tanh, i.e. the difference quotient of its antiderivative log(cosh(x)). */
+	static FloatType saturateAdaa(FloatType x, FloatType xPrev) noexcept
+	{
+		const FloatType diff = x - xPrev;
+
+		if (std::abs(diff) < ADAA_EPSILON)
+			return std::tanh(FloatType(0.5) * (x + xPrev));
+
+		return (logCosh(x) - logCosh(xPrev)) / diff;
+	}
+
+	/** Numerically stable log(cosh(x)). */
+	static FloatType logCosh(FloatType x) noexcept
+	{
+		const FloatType a = std::abs(x);
+		return a + std::log1p(std::exp(FloatType(-2) * a)) - LOG_TWO;
+	}
+
+private:
+
+	static constexpr FloatType ADAA_EPSILON = FloatType(1.0e-5);
+	static constexpr FloatType LOG_TWO = FloatType(0.69314718055994530942);
+
+	/** One-pole coefficient 1 - exp(-2 pi fc / fs), 0 if the filter is disabled. */
+	FloatType onePoleCoef(FloatType cutOffInHz) const noexcept
+	{
+		if (cutOffInHz <= 0 || sampleRate <= 0 || cutOffInHz >= sampleRate * 0.5)
+			return FloatType(0);
+
+		return FloatType(1) - std::exp(-juce::MathConstants<FloatType>::twoPi * cutOffInHz / (FloatType)sampleRate);
+	}
+
+	void updateCoefs() noexcept
+	{
+		lowPassCoef = onePoleCoef(lowPassInHz);
+		highPassCoef = onePoleCoef(highPassInHz);
+	}
+
+	//==============================================================================
+	double sampleRate{ 48000 };
+
+	FloatType lowPassInHz{ 0 };
+	FloatType highPassInHz{ 0 };
+	FloatType drive{ 0 };
+
+	FloatType lowPassCoef{ 0 };
+	FloatType highPassCoef{ 0 };
+
+	std::vector<FloatType> lowPassStates;
+	std::vector<FloatType> highPassStates;
+	std::vector<FloatType> satPrevIns;
+};
@@ -0,0 +1,656 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+#include "MrQuality.h"
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+/**
+	Multi mode filter, a cascade of up to four biquads for slopes of 12 to 48 dB/oct.
+
+	Each section is designed like the juce::dsp::IIR::Coefficients of its mode. Low and
+	high pass cascade Butterworth sections, the resonance raising the Q of the last one,
+	so a Q of 0.707 is flat at every slope. Band pass and notch repeat the section, the
+	shelves split the gain over the sections. The peak always runs a single section.
+
+	The sections run as transposed direct form II. With SSE each section takes a lane of
+	its own and works one sample behind the previous one, so the whole cascade costs about
+	as much as a single section. Lanes left over pass the signal through unchanged. The
+	skew is filled and drained within each block, so the cascade adds no latency.
+
+	setParameters() may be called from another thread than process(), by one thread at a
+	time. It designs the coefficients on the calling thread and passes them through a triple
+	buffer, which process() picks up at the start of the next block. A change of mode or
+	slope crossfades from the old cascade to the new one over FADE_IN_SECONDS, the new one
+	starting from silence. The eco tier runs at most one section, which saves time only
+	without SSE, but keeps the tiers sounding alike on all platforms.
+
+	At the default mix of 1 the output is the filtered signal only. Another mix is applied
+	where the last section writes its output, while the input sample is still there.
+*/
+class MrFilter
+{
+public:
+
+	using Tier = MrQuality::Tier;
+
+	enum class Mode
+	{
+		lowPass,
+		highPass,
+		bandPass,
+		notch,
+		lowShelf,
+		highShelf,
+		peak
+	};
+
+	enum class Slope
+	{
+		db12,
+		db24,
+		db36,
+		db48
+	};
+
+	static constexpr int NUM_MODES = 7;
+	static constexpr int NUM_SLOPES = 4;
+	static constexpr int MAX_NUM_SECTIONS = 4;
+	static constexpr int NUM_BIQUAD_COEFS = 5;		/**< b0, b1, b2, a1, a2 as JUCE lays them out */
+	static constexpr float Q_DEFAULT = 5.0f;
+	static constexpr double FADE_IN_SECONDS = 0.01;
+
+	struct Parameters
+	{
+		Mode mode = Mode::lowPass;
+		Slope slope = Slope::db12;
+		float cutOffInHz = 500.0f;
+		float q = Q_DEFAULT;			/**< the resonance of low and high pass, the width of the other modes */
+		float gainInDb = 0.0f;			/**< shelves and peak only */
+	};
+
+	/** Coefficients of a cascade, each one stored for all sections side by side. */
+	struct Coefs
+	{
+		float b0[MAX_NUM_SECTIONS];
+		float b1[MAX_NUM_SECTIONS];
+		float b2[MAX_NUM_SECTIONS];
+		float a1[MAX_NUM_SECTIONS];
+		float a2[MAX_NUM_SECTIONS];
+
+		Mode mode = Mode::lowPass;
+		int numSections = 1;
+
+		/** Returns true if both cascades run the same sections, so one can take over the state of the other. */
+		bool isSameCascade(const Coefs& other) const noexcept { return mode == other.mode && numSections == other.numSections; }
+	};
+
+	//==============================================================================
+	static Mode toMode(int mode) noexcept { return (Mode)juce::jlimit(0, NUM_MODES - 1, mode); }
+	static Slope toSlope(int slope) noexcept { return (Slope)juce::jlimit(0, NUM_SLOPES - 1, slope); }
+
+	/** Returns the number of sections a design runs, at most numSectionsMax. */
+	static int getNumSections(const Parameters& params, int numSectionsMax = MAX_NUM_SECTIONS) noexcept
+	{
+		if (params.mode == Mode::peak)
+			return 1;
+
+		return juce::jlimit(1, numSectionsMax, (int)params.slope + 1);
+	}
+
+	/**
+		Designs the cascade for the parameters, running at most numSectionsMax sections. Safe
+		to call from any thread.
+	*/
+	static Coefs design(const Parameters& params, double sampleRate, int numSectionsMax = MAX_NUM_SECTIONS) noexcept
+	{
+		Coefs coefs;
+		coefs.mode = params.mode;
+		coefs.numSections = getNumSections(params, numSectionsMax);
+
+		const double cutOff = juce::jlimit(10.0, 0.49 * sampleRate, (double)params.cutOffInHz);
+		const double q = std::max(0.1, (double)params.q);
+		const double gainPerSection = juce::Decibels::decibelsToGain((double)params.gainInDb / coefs.numSections, -300.0);
+		const double omega = 2.0 * juce::MathConstants<double>::pi * cutOff / sampleRate;
+		const double tanVal = std::tan(0.5 * omega);
+
+		for (int k = 0; k < MAX_NUM_SECTIONS; ++k)
+		{
+			if (k >= coefs.numSections)
+			{
+				setSection(coefs, k, { 1.0, 0.0, 0.0, 0.0, 0.0 });
+				continue;
+			}
+
+			// Butterworth Q of the section, the last one carries the resonance
+			double qSection = 1.0 / (2.0 * std::cos(juce::MathConstants<double>::pi * (2 * k + 1) / (4.0 * coefs.numSections)));
+			if (k == coefs.numSections - 1)
+				qSection *= q * juce::MathConstants<double>::sqrt2;
+
+			switch (params.mode)
+			{
+			case Mode::lowPass:		setSection(coefs, k, makeLowPass(tanVal, qSection)); break;
+			case Mode::highPass:	setSection(coefs, k, makeHighPass(tanVal, qSection)); break;
+			case Mode::bandPass:	setSection(coefs, k, makeBandPass(tanVal, q)); break;
+			case Mode::notch:		setSection(coefs, k, makeNotch(tanVal, q)); break;
+			case Mode::lowShelf:	setSection(coefs, k, makeLowShelf(omega, qSection, gainPerSection)); break;
+			case Mode::highShelf:	setSection(coefs, k, makeHighShelf(omega, qSection, gainPerSection)); break;
+			case Mode::peak:		setSection(coefs, k, makePeak(omega, q, gainPerSection)); break;
+			default:				break;
+			}
+		}
+
+		return coefs;
+	}
+
+	/** Replaces the coefficients of a section, e.g. with ones looked up in MrDspTableCache. */
+	static void setSection(Coefs& coefs, int k, const float* raw) noexcept
+	{
+		coefs.b0[k] = raw[0];
+		coefs.b1[k] = raw[1];
+		coefs.b2[k] = raw[2];
+		coefs.a1[k] = raw[3];
+		coefs.a2[k] = raw[4];
+	}
+
+	//==============================================================================
+	/**
+		Designs the cascade for the next block. The coefficients of a single low pass section
+		may be given, as looked up in MrDspTableCache for the same Q, otherwise they are
+		computed.
+	*/
+	void setParameters(const Parameters& paramsNew, const float* lowPassCoefs = nullptr) noexcept
+	{
+		params = paramsNew;
+
+		auto& slot = designs[(size_t)designWriting];
+		slot.coefs = design(params, sampleRate);
+		slot.ecoCoefs = design(params, sampleRate, 1);
+
+		if (lowPassCoefs != nullptr && params.mode == Mode::lowPass)
+		{
+			if (slot.coefs.numSections == 1)
+				setSection(slot.coefs, 0, lowPassCoefs);
+
+			setSection(slot.ecoCoefs, 0, lowPassCoefs);
+		}
+
+		designWriting = designLatest.exchange(designWriting | NEW_DESIGN, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	const Parameters& getParameters() const noexcept { return params; }
+
+	/** Returns the coefficients the cascade runs, for the thread calling process(). */
+	const Coefs& getCoefs() const noexcept { return coefs; }
+
+	/** Selects the number of sections, eco runs one, crossfading like a change of slope. */
+	void setQuality(Tier tierNew) noexcept
+	{
+		tier = tierNew;
+	}
+
+	Tier getQuality() const noexcept { return tier; }
+
+	/** Returns true while crossfading between two cascades. */
+	bool isFading() const noexcept { return fadePos < fadeLength; }
+
+	/** Sets the mix of input and filtered signal, see MrDryWet. */
+	void setMix(float mix) noexcept { dryWet.setMix(mix); }
+
+	float getMix() const noexcept { return dryWet.getMix(); }
+
+	void setMixLaw(MrDryWet::Law law) noexcept { dryWet.setLaw(law); }
+
+	MrDryWet::Law getMixLaw() const noexcept { return dryWet.getLaw(); }
+
+	//==============================================================================
+	/** Not to be called concurrently with setParameters(), designs the parameters for the new sample rate. */
+	void prepare(const juce::dsp::ProcessSpec& spec)
+	{
+		sampleRate = spec.sampleRate;
+		chnlStates.assign((size_t)spec.numChannels, ChannelState());
+		fadeLength = std::max(1, (int)std::round(FADE_IN_SECONDS * sampleRate));
+		dryWet.prepare(sampleRate);
+
+		setParameters(params);
+		pickUpDesign();
+		coefs = getTarget();
+		fadePos = fadeLength;
+		isSilent = true;
+	}
+
+	void reset() noexcept
+	{
+		std::fill(chnlStates.begin(), chnlStates.end(), ChannelState());
+		fadePos = fadeLength;
+		isSilent = true;
+	}
+
+	/** Brings a channel left out of processing up to date with another carrying the same signal. */
+	void copyChannel(int chnlFrom, int chnlTo) noexcept
+	{
+		if ((size_t)chnlFrom < chnlStates.size() && (size_t)chnlTo < chnlStates.size())
+			chnlStates[(size_t)chnlTo] = chnlStates[(size_t)chnlFrom];
+	}
+
+	//==============================================================================
+	template <typename ProcessContext>
+	void process(const ProcessContext& context) noexcept
+	{
+		auto&& inBlock = context.getInputBlock();
+		auto&& outBlock = context.getOutputBlock();
+
+		jassert(inBlock.getNumChannels() <= chnlStates.size());
+
+		if (context.isBypassed)
+		{
+			if (context.usesSeparateInputAndOutputBlocks())
+				outBlock.copyFrom(inBlock);
+
+			return;
+		}
+
+		pickUpDesign();
+		updateCoefs();
+
+		const int numSamples = (int)inBlock.getNumSamples();
+		const size_t numChannels = std::min(inBlock.getNumChannels(), chnlStates.size());
+
+		const bool isMixed = !dryWet.isWetOnly();
+		const auto ramp = dryWet.advance(numSamples);
+
+		for (size_t c = 0; c < numChannels; ++c)
+		{
+			const auto* in = inBlock.getChannelPointer(c);
+			auto* out = outBlock.getChannelPointer(c);
+			auto& state = chnlStates[c];
+
+			if (isFading())
+				processFading(in, out, numSamples, state, isMixed, ramp);
+			else if (isMixed)
+				processCascadeMixed(in, out, numSamples, coefs, state.s1, state.s2, ramp);
+			else
+				processCascade(in, out, numSamples, coefs, state.s1, state.s2);
+		}
+
+		fadePos = std::min(fadeLength, fadePos + numSamples);
+		isSilent = false;
+	}
+
+private:
+
+	static constexpr int NEW_DESIGN = 4;
+	static constexpr int INDEX_MASK = 3;
+	static constexpr int FADE_CHUNK_SIZE = 256;
+
+	struct Design
+	{
+		Coefs coefs;
+		Coefs ecoCoefs;
+	};
+
+	struct ChannelState
+	{
+		float s1[MAX_NUM_SECTIONS]{};		/* cascade running */
+		float s2[MAX_NUM_SECTIONS]{};
+		float f1[MAX_NUM_SECTIONS]{};		/* cascade fading out */
+		float f2[MAX_NUM_SECTIONS]{};
+	};
+
+	//==============================================================================
+	/** Takes over the latest design, if there is one the audio thread has not seen yet. */
+	void pickUpDesign() noexcept
+	{
+		if ((designLatest.load(std::memory_order_relaxed) & NEW_DESIGN) == 0)
+			return;
+
+		designReading = designLatest.exchange(designReading, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	const Coefs& getTarget() const noexcept
+	{
+		const auto& slot = designs[(size_t)designReading];
+		return (tier == Tier::eco) ? slot.ecoCoefs : slot.coefs;
+	}
+
+	/**
+		New coefficients of the same cascade are taken over at once, keeping the state, as is
+		any cascade before the first block. Another cascade fades in, but not before the fade
+		running has ended.
+	*/
+	void updateCoefs() noexcept
+	{
+		const auto& target = getTarget();
+
+		if (target.isSameCascade(coefs) || isSilent)
+		{
+			coefs = target;
+			return;
+		}
+
+		if (isFading())
+			return;
+
+		coefsFadingOut = coefs;
+		coefs = target;
+
+		for (auto& state : chnlStates)
+		{
+			std::copy(std::begin(state.s1), std::end(state.s1), std::begin(state.f1));
+			std::copy(std::begin(state.s2), std::end(state.s2), std::begin(state.f2));
+			std::fill(std::begin(state.s1), std::end(state.s1), 0.0f);
+			std::fill(std::begin(state.s2), std::end(state.s2), 0.0f);
+		}
+
+		fadePos = 0;
+	}
+
+	/**
+		Runs both cascades and mixes their outputs, in chunks so the cascade fading out needs no
+		buffer of its own. Mixed, the input of the chunk is kept as well, the fade being short.
+	*/
+	void processFading(const float* in, float* out, int num, ChannelState& state, bool isMixed, const MrDryWet::Ramp& ramp) const noexcept
+	{
+		float fadingOut[FADE_CHUNK_SIZE];
+		float dry[FADE_CHUNK_SIZE];
+
+		for (int offset = 0; offset < num; offset += FADE_CHUNK_SIZE)
+		{
+			const int numChunk = juce::jmin(FADE_CHUNK_SIZE, num - offset);
+
+			if (isMixed)
+				std::copy(in + offset, in + offset + numChunk, dry);
+
+			// before the other cascade, which may overwrite the input
+			processCascade(in + offset, fadingOut, numChunk, coefsFadingOut, state.f1, state.f2);
+			processCascade(in + offset, out + offset, numChunk, coefs, state.s1, state.s2);
+
+			for (int i = 0; i < numChunk; ++i)
+			{
+				const float gain = std::min(1.0f, (float)(fadePos + offset + i) / (float)fadeLength);
+				out[offset + i] = fadingOut[i] * (1.0f - gain) + out[offset + i] * gain;
+			}
+
+			if (isMixed)
+				MrDryWet::mix(out + offset, dry, out + offset, numChunk, ramp.getSlice(offset));
+		}
+	}
+
+	//==============================================================================
+	static void processCascade(const float* in, float* out, int num, const Coefs& c, float* s1, float* s2) noexcept
+	{
+	   #if JUCE_USE_SSE_INTRINSICS
+		// even for a single section, whose samples depend on each other as much as those of the cascade
+		processCascadeSkewed<false>(in, out, num, c, s1, s2, MrDryWet::Ramp());
+	   #else
+		for (int k = 0; k < c.numSections; ++k)
+		{
+			processSection(in, out, num, c.b0[k], c.b1[k], c.b2[k], c.a1[k], c.a2[k], s1[k], s2[k]);
+			in = out;
+		}
+	   #endif
+	}
+
+	/** As processCascade(), the output being the input and the filtered signal mixed by the ramp. */
+	static void processCascadeMixed(const float* in, float* out, int num, const Coefs& c, float* s1, float* s2, const MrDryWet::Ramp& ramp) noexcept
+	{
+	   #if JUCE_USE_SSE_INTRINSICS
+		processCascadeSkewed<true>(in, out, num, c, s1, s2, ramp);
+	   #else
+		// all but the last section run into a chunk on the stack, so the input is still there for the last one
+		float cascaded[FADE_CHUNK_SIZE];
+
+		for (int offset = 0; offset < num; offset += FADE_CHUNK_SIZE)
+		{
+			const int numChunk = juce::jmin(FADE_CHUNK_SIZE, num - offset);
+			const float* x = in + offset;
+
+			for (int k = 0; k < c.numSections - 1; ++k)
+			{
+				processSection(x, cascaded, numChunk, c.b0[k], c.b1[k], c.b2[k], c.a1[k], c.a2[k], s1[k], s2[k]);
+				x = cascaded;
+			}
+
+			const int k = c.numSections - 1;
+			processSectionMixed(x, in + offset, out + offset, numChunk, c.b0[k], c.b1[k], c.b2[k], c.a1[k], c.a2[k], s1[k], s2[k], ramp.getSlice(offset));
+		}
+	   #endif
+	}
+
+   #if ! JUCE_USE_SSE_INTRINSICS
+	/** The state is kept in locals, so writing the output does not force it through memory. */
+	static void processSection(const float* in, float* out, int num, float b0, float b1, float b2, float a1, float a2, float& s1, float& s2) noexcept
+	{
+		float z1 = s1, z2 = s2;
+
+		for (int i = 0; i < num; ++i)
+		{
+			const float x = in[i];
+			const float y = b0 * x + z1;
+
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b2 * x - a2 * y;
+			out[i] = y;
+		}
+
+		s1 = z1;
+		s2 = z2;
+	}
+
+	/** As processSection(), writing the output mixed with dry, which may be the same as in or out. */
+	static void processSectionMixed(const float* in, const float* dry, float* out, int num, float b0, float b1, float b2, float a1, float a2,
+		float& s1, float& s2, const MrDryWet::Ramp& ramp) noexcept
+	{
+		float z1 = s1, z2 = s2;
+
+		for (int i = 0; i < num; ++i)
+		{
+			const float x = in[i];
+			const float y = b0 * x + z1;
+
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b2 * x - a2 * y;
+			out[i] = dry[i] * ramp.getDry(i) + y * ramp.getWet(i);
+		}
+
+		s1 = z1;
+		s2 = z2;
+	}
+   #else
+	/**
+		Step t runs section k on sample t - k, taking the output section k - 1 produced the step
+		before. The first and last MAX_NUM_SECTIONS - 1 steps, where some sections have no
+		sample of this block to work on, leave the state of those sections untouched.
+		Mixed, the input sample is read again as the last section writes its output, which is
+		the first time that sample is written to when processing in place.
+	*/
+	template <bool isMixed>
+	static void processCascadeSkewed(const float* in, float* out, int num, const Coefs& c, float* s1, float* s2, const MrDryWet::Ramp& ramp) noexcept
+	{
+		const int numSteps = num + MAX_NUM_SECTIONS - 1;
+		const int lastLane = MAX_NUM_SECTIONS - 1;
+
+		const __m128 b0 = _mm_loadu_ps(c.b0);
+		const __m128 b1 = _mm_loadu_ps(c.b1);
+		const __m128 b2 = _mm_loadu_ps(c.b2);
+		const __m128 a1 = _mm_loadu_ps(c.a1);
+		const __m128 a2 = _mm_loadu_ps(c.a2);
+		const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const __m128 numV = _mm_set1_ps((float)num);
+
+		__m128 s1V = _mm_loadu_ps(s1);
+		__m128 s2V = _mm_loadu_ps(s2);
+		__m128 y = _mm_setzero_ps();
+
+		for (int t = 0; t < numSteps; ++t)
+		{
+			// the outputs of the step before move up a section, the input enters the first one
+			__m128 x = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 4));
+			x = _mm_move_ss(x, _mm_set_ss(t < num ? in[t] : 0.0f));
+
+			y = _mm_add_ps(_mm_mul_ps(b0, x), s1V);
+			const __m128 s1New = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2V);
+			const __m128 s2New = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+			if (t >= lastLane && t < num)
+			{
+				s1V = s1New;
+				s2V = s2New;
+			}
+			else
+			{
+				const __m128 pos = _mm_sub_ps(_mm_set1_ps((float)t), lanes);
+				const __m128 isActive = _mm_and_ps(_mm_cmpge_ps(pos, _mm_setzero_ps()), _mm_cmplt_ps(pos, numV));
+
+				s1V = _mm_or_ps(_mm_and_ps(isActive, s1New), _mm_andnot_ps(isActive, s1V));
+				s2V = _mm_or_ps(_mm_and_ps(isActive, s2New), _mm_andnot_ps(isActive, s2V));
+			}
+
+			if (t >= lastLane)
+			{
+				const int i = t - lastLane;
+				const float wet = _mm_cvtss_f32(_mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3)));
+
+				out[i] = isMixed ? in[i] * ramp.getDry(i) + wet * ramp.getWet(i) : wet;
+			}
+		}
+
+		_mm_storeu_ps(s1, s1V);
+		_mm_storeu_ps(s2, s2V);
+	}
+   #endif
+
+	//==============================================================================
+	using Raw = std::array<double, NUM_BIQUAD_COEFS>;
+
+	static void setSection(Coefs& coefs, int k, const Raw& raw) noexcept
+	{
+		coefs.b0[k] = (float)raw[0];
+		coefs.b1[k] = (float)raw[1];
+		coefs.b2[k] = (float)raw[2];
+		coefs.a1[k] = (float)raw[3];
+		coefs.a2[k] = (float)raw[4];
+	}
+
+	/* the sections as juce::dsp::IIR::Coefficients designs them, normalised to a0 */
+
+	static Raw makeLowPass(double tanVal, double q) noexcept
+	{
+		const double n = 1.0 / tanVal;
+		const double n2 = n * n;
+		const double c1 = 1.0 / (1.0 + n / q + n2);
+
+		return { c1, c1 * 2.0, c1, c1 * 2.0 * (1.0 - n2), c1 * (1.0 - n / q + n2) };
+	}
+
+	static Raw makeHighPass(double tanVal, double q) noexcept
+	{
+		const double n = tanVal;
+		const double n2 = n * n;
+		const double c1 = 1.0 / (1.0 + n / q + n2);
+
+		return { c1, c1 * -2.0, c1, c1 * 2.0 * (n2 - 1.0), c1 * (1.0 - n / q + n2) };
+	}
+
+	static Raw makeBandPass(double tanVal, double q) noexcept
+	{
+		const double n = 1.0 / tanVal;
+		const double n2 = n * n;
+		const double c1 = 1.0 / (1.0 + n / q + n2);
+
+		return { c1 * n / q, 0.0, -c1 * n / q, c1 * 2.0 * (1.0 - n2), c1 * (1.0 - n / q + n2) };
+	}
+
+	static Raw makeNotch(double tanVal, double q) noexcept
+	{
+		const double n = 1.0 / tanVal;
+		const double n2 = n * n;
+		const double c1 = 1.0 / (1.0 + n / q + n2);
+
+		return { c1 * (1.0 + n2), c1 * 2.0 * (1.0 - n2), c1 * (1.0 + n2), c1 * 2.0 * (1.0 - n2), c1 * (1.0 - n / q + n2) };
+	}
+
+	static Raw makeLowShelf(double omega, double q, double gain) noexcept
+	{
+		const double a = std::sqrt(gain);
+		const double aMinus1 = a - 1.0;
+		const double aPlus1 = a + 1.0;
+		const double cosVal = std::cos(omega);
+		const double beta = std::sin(omega) * std::sqrt(a) / q;
+		const double aMinus1TimesCos = aMinus1 * cosVal;
+		const double a0 = aPlus1 + aMinus1TimesCos + beta;
+
+		return { a * (aPlus1 - aMinus1TimesCos + beta) / a0,
+				 a * 2.0 * (aMinus1 - aPlus1 * cosVal) / a0,
+				 a * (aPlus1 - aMinus1TimesCos - beta) / a0,
+				 -2.0 * (aMinus1 + aPlus1 * cosVal) / a0,
+				 (aPlus1 + aMinus1TimesCos - beta) / a0 };
+	}
+
+	static Raw makeHighShelf(double omega, double q, double gain) noexcept
+	{
+		const double a = std::sqrt(gain);
+		const double aMinus1 = a - 1.0;
+		const double aPlus1 = a + 1.0;
+		const double cosVal = std::cos(omega);
+		const double beta = std::sin(omega) * std::sqrt(a) / q;
+		const double aMinus1TimesCos = aMinus1 * cosVal;
+		const double a0 = aPlus1 - aMinus1TimesCos + beta;
+
+		return { a * (aPlus1 + aMinus1TimesCos + beta) / a0,
+				 a * -2.0 * (aMinus1 + aPlus1 * cosVal) / a0,
+				 a * (aPlus1 + aMinus1TimesCos - beta) / a0,
+				 2.0 * (aMinus1 - aPlus1 * cosVal) / a0,
+				 (aPlus1 - aMinus1TimesCos - beta) / a0 };
+	}
+
+	static Raw makePeak(double omega, double q, double gain) noexcept
+	{
+		const double a = std::sqrt(gain);
+		const double alpha = std::sin(omega) / (q * 2.0);
+		const double c2 = -2.0 * std::cos(omega);
+		const double a0 = 1.0 + alpha / a;
+
+		return { (1.0 + alpha * a) / a0, c2 / a0, (1.0 - alpha * a) / a0, c2 / a0, (1.0 - alpha / a) / a0 };
+	}
+
+	//==============================================================================
+	double sampleRate{ 48000 };
+	Parameters params;
+
+	/* a triple buffer, the writer owns one slot, the audio thread one and the third is swapped between them */
+	std::array<Design, 3> designs{};
+	std::atomic<int> designLatest{ 0 };
+	int designWriting{ 1 };
+	int designReading{ 2 };
+
+	Coefs coefs{};
+	Coefs coefsFadingOut{};
+	std::vector<ChannelState> chnlStates;
+
+	Tier tier{ Tier::normal };
+	MrDryWet dryWet;
+	int fadeLength{ 1 };
+	int fadePos{ 1 };
+	bool isSilent{ true };		/* no block since the state was cleared, nothing to fade from */
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrFilter.h"
+#include "MrSignal.h"
+
+class MrFilterBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrFilterBenchmarks() : juce::UnitTest("MrFilter benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        beginTest("Cost per slope, cascade vs. JUCE biquads one after the other");
+        {
+            const int numChnls = 2;
+            const int blockSize = 512;
+            const int numRuns = 2000;
+            const double sampleRate = 48000;
+
+            juce::AudioBuffer<float> buffer(numChnls, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = (juce::uint32)numChnls;
+            spec.sampleRate = sampleRate;
+            spec.maximumBlockSize = (juce::uint32)blockSize;
+
+            for (int slope = 0; slope < MrFilter::NUM_SLOPES; ++slope)
+            {
+                MrFilter::Parameters params;
+                params.slope = (MrFilter::Slope)slope;
+                params.cutOffInHz = 2000.0f;
+                params.q = 0.7071f;
+
+                MrFilter filter;
+                filter.prepare(spec);
+                filter.setParameters(params);
+
+                auto result = MrBenchmark::run([&] { filter.process(juce::dsp::ProcessContextReplacing<float>(block)); }, numRuns);
+                logMessage(MrBenchmark::format("cascade, " + juce::String(12 * (slope + 1)) + " dB/oct", result, blockSize));
+
+                // the same sections as JUCE filters, each one run over the block before the next
+                const auto coefs = MrFilter::design(params, sampleRate);
+                std::vector<juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>> sections((size_t)coefs.numSections);
+
+                for (int k = 0; k < coefs.numSections; ++k)
+                {
+                    auto& section = sections[(size_t)k];
+                    *section.state = juce::dsp::IIR::Coefficients<float>(coefs.b0[k], coefs.b1[k], coefs.b2[k], 1.0f, coefs.a1[k], coefs.a2[k]);
+                    section.prepare(spec);
+                }
+
+                result = MrBenchmark::run([&]
+                    {
+                        for (auto& section : sections)
+                            section.process(juce::dsp::ProcessContextReplacing<float>(block));
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format("JUCE biquads, " + juce::String(12 * (slope + 1)) + " dB/oct", result, blockSize));
+            }
+        }
+    }
+};
+
+static MrFilterBenchmarks filterBenchmarks;
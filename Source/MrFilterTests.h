@@ -0,0 +1,392 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrFilter.h"
+
+class MrFilterTests : public juce::UnitTest
+{
+public:
+
+    MrFilterTests() : juce::UnitTest("MrFilter testing") {}
+
+    void runTest() override
+    {
+        using Mode = MrFilter::Mode;
+        using Slope = MrFilter::Slope;
+        using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+        beginTest("When the slope is 12 dB/oct then each mode equals the JUCE biquad of the mode.");
+        {
+            const int numSamples = 4096;
+            const double sampleRate = 48000;
+            const float cutOffInHz = 1000.0f;
+            const float q = 2.0f;
+            const float gainInDb = 6.0f;
+            const float gain = juce::Decibels::decibelsToGain(gainInDb);
+            const auto deltaExpected = 0.0001f;
+
+            const Coefficients::Ptr coefsExpected[] =
+            {
+                Coefficients::makeLowPass(sampleRate, cutOffInHz, q),
+                Coefficients::makeHighPass(sampleRate, cutOffInHz, q),
+                Coefficients::makeBandPass(sampleRate, cutOffInHz, q),
+                Coefficients::makeNotch(sampleRate, cutOffInHz, q),
+                Coefficients::makeLowShelf(sampleRate, cutOffInHz, q, gain),
+                Coefficients::makeHighShelf(sampleRate, cutOffInHz, q, gain),
+                Coefficients::makePeakFilter(sampleRate, cutOffInHz, q, gain)
+            };
+
+            for (int mode = 0; mode < MrFilter::NUM_MODES; ++mode)
+            {
+                /// prepare...
+                juce::AudioBuffer<float> bufferActual(1, numSamples);
+                juce::dsp::AudioBlock<float> blockActual(bufferActual);
+                MrSignal::whiteNoise(blockActual, 0.5f);
+
+                juce::AudioBuffer<float> bufferExpected;
+                bufferExpected.makeCopyOf(bufferActual);
+
+                juce::dsp::IIR::Filter<float> filterExpected(coefsExpected[mode]);
+                filterExpected.prepare(createSpec(1, numSamples, sampleRate));
+
+                MrFilter filter;
+                filter.prepare(createSpec(1, numSamples, sampleRate));
+                filter.setParameters(createParameters((Mode)mode, Slope::db12, cutOffInHz, q, gainInDb));
+
+                /// execute...
+                filter.process(juce::dsp::ProcessContextReplacing<float>(blockActual));
+
+                for (int i = 0; i < numSamples; ++i)
+                    bufferExpected.setSample(0, i, filterExpected.processSample(bufferExpected.getSample(0, i)));
+
+                /// evaluate...
+                float errorMax = 0.0f;
+                for (int i = 0; i < numSamples; ++i)
+                    errorMax = std::max(errorMax, std::abs(bufferActual.getSample(0, i) - bufferExpected.getSample(0, i)));
+
+                expect(errorMax < deltaExpected, "mode " + juce::String(mode) + ", error " + juce::String(errorMax));
+            }
+        }
+
+        beginTest("When the slope is steeper then the output equals the sections run one after the other, whatever the block size.");
+        {
+            const int numSamples = 4096;
+            const double sampleRate = 48000;
+            const int blockSizes[] = { 1, 2, 3, 5, 64, 511 };
+            const auto deltaExpected = 0.0001f;
+
+            for (int slope = 1; slope < MrFilter::NUM_SLOPES; ++slope)
+            {
+                /// prepare...
+                const auto params = createParameters(Mode::lowPass, (Slope)slope, 2000.0f, 2.0f, 0.0f);
+                const auto coefs = MrFilter::design(params, sampleRate);
+
+                juce::AudioBuffer<float> bufferActual(1, numSamples);
+                juce::dsp::AudioBlock<float> blockActual(bufferActual);
+                MrSignal::whiteNoise(blockActual, 0.5f);
+
+                juce::AudioBuffer<float> bufferExpected;
+                bufferExpected.makeCopyOf(bufferActual);
+
+                MrFilter filter;
+                filter.prepare(createSpec(1, 512, sampleRate));
+                filter.setParameters(params);
+
+                /// execute...
+                for (int i = 0, n = 0; i < numSamples; ++n)
+                {
+                    const int num = std::min(blockSizes[n % 6], numSamples - i);
+                    auto subBlock = blockActual.getSubBlock((size_t)i, (size_t)num);
+                    filter.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+                    i += num;
+                }
+
+                for (int k = 0; k < coefs.numSections; ++k)
+                {
+                    juce::dsp::IIR::Filter<float> section(Coefficients::Ptr(new Coefficients(coefs.b0[k], coefs.b1[k], coefs.b2[k], 1.0f, coefs.a1[k], coefs.a2[k])));
+                    section.prepare(createSpec(1, numSamples, sampleRate));
+
+                    for (int i = 0; i < numSamples; ++i)
+                        bufferExpected.setSample(0, i, section.processSample(bufferExpected.getSample(0, i)));
+                }
+
+                /// evaluate...
+                float errorMax = 0.0f;
+                for (int i = 0; i < numSamples; ++i)
+                    errorMax = std::max(errorMax, std::abs(bufferActual.getSample(0, i) - bufferExpected.getSample(0, i)));
+
+                expect(coefs.numSections == slope + 1);
+                expect(errorMax < deltaExpected, "slope " + juce::String(slope) + ", error " + juce::String(errorMax));
+            }
+        }
+
+        beginTest("When the slope is raised then the stop band falls by at least 12 dB per section.");
+        {
+            const int numSamples = 8192;
+            const double sampleRate = 48000;
+
+            /// prepare...
+            float magnitudes[MrFilter::NUM_SLOPES];
+
+            /// execute...
+            for (int slope = 0; slope < MrFilter::NUM_SLOPES; ++slope)
+            {
+                juce::AudioBuffer<float> buffer(1, numSamples);
+                // in double, the phase error of a float sine would be a noise floor above the stop band
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample(0, i, (float)std::sin(2.0 * juce::MathConstants<double>::pi * 8000.0 * i / sampleRate));
+
+                MrFilter filter;
+                filter.prepare(createSpec(1, numSamples, sampleRate));
+                filter.setParameters(createParameters(Mode::lowPass, (Slope)slope, 1000.0f, 0.7071f, 0.0f));
+
+                juce::dsp::AudioBlock<float> block(buffer);
+                filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+                magnitudes[slope] = buffer.getMagnitude(0, numSamples / 2, numSamples / 2);
+            }
+
+            /// evaluate...
+            for (int slope = 1; slope < MrFilter::NUM_SLOPES; ++slope)
+                expect(magnitudes[slope - 1] > 4.0f * magnitudes[slope]);
+        }
+
+        beginTest("When the mode, the slope or the tier changes while playing then the output has no step.");
+        {
+            const int numSamples = 9600;
+            const int blockSize = 240;
+            const double sampleRate = 48000;
+            const float omega = 2.0f * juce::MathConstants<float>::pi * 200.0f / (float)sampleRate;
+
+            /// prepare...
+            juce::AudioBuffer<float> buffer(1, numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample(0, i, std::sin(omega * (float)i));
+
+            MrFilter filter;
+            filter.prepare(createSpec(1, blockSize, sampleRate));
+            filter.setParameters(createParameters(Mode::lowPass, Slope::db12, 1000.0f, 0.7071f, 0.0f));
+
+            /// execute...
+            juce::dsp::AudioBlock<float> block(buffer);
+            const Mode modes[] = { Mode::lowPass, Mode::highPass, Mode::lowShelf, Mode::peak };
+            const Slope slopes[] = { Slope::db48, Slope::db12, Slope::db24 };
+            const MrQuality::Tier tiers[] = { MrQuality::Tier::normal, MrQuality::Tier::eco };
+
+            for (int i = 0, n = 0; i < numSamples; i += blockSize, ++n)
+            {
+                filter.setParameters(createParameters(modes[(n / 2) % 4], slopes[(n / 3) % 3], 1000.0f, 0.7071f, 12.0f));
+                filter.setQuality(tiers[(n / 5) % 2]);
+
+                auto subBlock = block.getSubBlock((size_t)i, (size_t)blockSize);
+                filter.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+            }
+
+            /// evaluate...
+            // high pass and low shelf differ by about the amplitude at 200 Hz, switching hard would step by that
+            float stepMax = 0.0f;
+            for (int i = blockSize; i < numSamples; ++i)
+                stepMax = std::max(stepMax, std::abs(buffer.getSample(0, i) - buffer.getSample(0, i - 1)));
+
+            expect(stepMax < 4.0f * 2.0f * omega, "step " + juce::String(stepMax));
+        }
+
+        beginTest("When at the eco tier then a single section runs.");
+        {
+            const int numSamples = 2048;
+            const double sampleRate = 48000;
+
+            /// prepare...
+            MrFilter filter;
+            filter.setQuality(MrQuality::Tier::eco);
+            filter.prepare(createSpec(1, numSamples, sampleRate));
+            filter.setParameters(createParameters(Mode::lowPass, Slope::db48, 1000.0f, 5.0f, 0.0f));
+
+            juce::AudioBuffer<float> bufferActual(1, numSamples);
+            juce::dsp::AudioBlock<float> blockActual(bufferActual);
+            MrSignal::whiteNoise(blockActual, 0.5f);
+
+            juce::AudioBuffer<float> bufferExpected;
+            bufferExpected.makeCopyOf(bufferActual);
+
+            juce::dsp::IIR::Filter<float> filterExpected(Coefficients::makeLowPass(sampleRate, 1000.0f, 5.0f));
+            filterExpected.prepare(createSpec(1, numSamples, sampleRate));
+
+            /// execute...
+            filter.process(juce::dsp::ProcessContextReplacing<float>(blockActual));
+
+            for (int i = 0; i < numSamples; ++i)
+                bufferExpected.setSample(0, i, filterExpected.processSample(bufferExpected.getSample(0, i)));
+
+            /// evaluate...
+            expect(filter.getCoefs().numSections == 1);
+            expect(!filter.isFading());
+
+            for (int i = 0; i < numSamples; ++i)
+                expect(std::abs(bufferActual.getSample(0, i) - bufferExpected.getSample(0, i)) < 0.0001f);
+        }
+
+        beginTest("When the parameters are set from another thread then every block runs a complete design.");
+        {
+            const int blockSize = 64;
+            const int numBlocks = 20000;
+            const double sampleRate = 48000;
+
+            /// prepare...
+            const auto paramsA = createParameters(Mode::lowPass, Slope::db48, 500.0f, 0.7071f, 0.0f);
+            const auto paramsB = createParameters(Mode::lowPass, Slope::db48, 5000.0f, 3.0f, 0.0f);
+            const auto coefsA = MrFilter::design(paramsA, sampleRate);
+            const auto coefsB = MrFilter::design(paramsB, sampleRate);
+
+            MrFilter filter;
+            filter.prepare(createSpec(1, blockSize, sampleRate));
+            filter.setParameters(paramsA);
+
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            std::atomic<bool> isDone{ false };
+
+            /// execute...
+            std::thread writer([&]
+                {
+                    for (int n = 0; !isDone.load(); ++n)
+                        filter.setParameters((n % 2 == 0) ? paramsB : paramsA);
+                });
+
+            int numTorn = 0;
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                MrSignal::whiteNoise(block, 0.5f, n);
+                filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+                const auto& coefs = filter.getCoefs();
+                if (!isSameCoefs(coefs, coefsA) && !isSameCoefs(coefs, coefsB))
+                    ++numTorn;
+            }
+
+            isDone = true;
+            writer.join();
+
+            /// evaluate...
+            expectEquals(numTorn, 0);
+        }
+
+        beginTest("When the mix is set then the output is the input and the filtered signal times their gains, whatever the slope.");
+        {
+            const int numSamples = 1024;
+            const float mix = 0.3f;
+            const auto deltaExpected = 0.0001f;
+
+            const Slope slopes[] = { Slope::db12, Slope::db48 };
+
+            for (auto slope : slopes)
+            {
+                /// prepare...
+                juce::AudioBuffer<float> bufferInput(2, numSamples);
+                juce::dsp::AudioBlock<float> blockInput(bufferInput);
+                MrSignal::whiteNoise(blockInput, 0.5f);
+
+                juce::AudioBuffer<float> bufferWet, bufferActual;
+                bufferWet.makeCopyOf(bufferInput);
+                bufferActual.makeCopyOf(bufferInput);
+                juce::dsp::AudioBlock<float> blockWet(bufferWet), blockActual(bufferActual);
+
+                const auto params = createParameters(Mode::lowPass, slope, 2000.0f, 1.0f, 0.0f);
+
+                MrFilter filterWet;
+                filterWet.prepare(createSpec(2, numSamples, 48000));
+                filterWet.setParameters(params);
+
+                // set before prepare, so the gains start at the mix and do not ramp
+                MrFilter filterMixed;
+                filterMixed.setMix(mix);
+                filterMixed.setMixLaw(MrDryWet::Law::linear);
+                filterMixed.prepare(createSpec(2, numSamples, 48000));
+                filterMixed.setParameters(params);
+
+                /// execute...
+                filterWet.process(juce::dsp::ProcessContextReplacing<float>(blockWet));
+                filterMixed.process(juce::dsp::ProcessContextReplacing<float>(blockActual));
+
+                /// evaluate...
+                float errorMax = 0.0f;
+                for (int c = 0; c < 2; ++c)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const float expected = (1.0f - mix) * bufferInput.getSample(c, i) + mix * bufferWet.getSample(c, i);
+                        errorMax = std::max(errorMax, std::abs(bufferActual.getSample(c, i) - expected));
+                    }
+                }
+
+                expect(errorMax < deltaExpected, "slope " + juce::String((int)slope) + ", error " + juce::String(errorMax));
+            }
+        }
+
+        beginTest("When a channel is copied then it continues like the channel copied from.");
+        {
+            const int numSamples = 1024;
+
+            /// prepare...
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+
+            MrFilter filter;
+            filter.prepare(createSpec(2, numSamples, 48000));
+            filter.setParameters(createParameters(Mode::lowPass, Slope::db24, 2000.0f, 1.0f, 0.0f));
+
+            auto first = block.getSubBlock(0, numSamples / 2);
+            auto firstLeft = first.getSingleChannelBlock(0);
+            filter.process(juce::dsp::ProcessContextReplacing<float>(firstLeft));
+
+            /// execute...
+            filter.copyChannel(0, 1);
+
+            auto second = block.getSubBlock(numSamples / 2, numSamples / 2);
+            second.getSingleChannelBlock(1).copyFrom(second.getSingleChannelBlock(0));
+            filter.process(juce::dsp::ProcessContextReplacing<float>(second));
+
+            /// evaluate...
+            for (int i = numSamples / 2; i < numSamples; ++i)
+                expect(buffer.getSample(0, i) == buffer.getSample(1, i));
+        }
+    }
+
+private:
+
+    static MrFilter::Parameters createParameters(MrFilter::Mode mode, MrFilter::Slope slope, float cutOffInHz, float q, float gainInDb)
+    {
+        MrFilter::Parameters params;
+        params.mode = mode;
+        params.slope = slope;
+        params.cutOffInHz = cutOffInHz;
+        params.q = q;
+        params.gainInDb = gainInDb;
+        return params;
+    }
+
+    static bool isSameCoefs(const MrFilter::Coefs& a, const MrFilter::Coefs& b)
+    {
+        return std::memcmp(a.b0, b.b0, sizeof(a.b0)) == 0 && std::memcmp(a.b1, b.b1, sizeof(a.b1)) == 0
+            && std::memcmp(a.b2, b.b2, sizeof(a.b2)) == 0 && std::memcmp(a.a1, b.a1, sizeof(a.a1)) == 0
+            && std::memcmp(a.a2, b.a2, sizeof(a.a2)) == 0;
+    }
+
+    static juce::dsp::ProcessSpec createSpec(int numChnls, int blockSize, double sampleRate)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.numChannels = (juce::uint32)numChnls;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = (juce::uint32)blockSize;
+        return spec;
+    }
+};
+
+static MrFilterTests filterTests;
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+
+/**
+	A delay for short times, slapback, Haas, comb filters or a pre-delay, with the delay
+	buffer inside the object.
+
+	MrDelay keeps its delay buffer on the heap, reserved for any delay up to a minute, which
+	costs an indirection and cache misses that are out of proportion for a few milliseconds.
+	Here the maximum delay and the number of channels are template arguments, the ring
+	buffer is an array of the next power of two samples per channel, and positions wrap by
+	masking instead of a modulo.
+
+	Takes the prepare() and process() of MrDelay, and its delay, feedback and mix setters.
+	The feedback is parallel only, without damping, saturation, modulation or compact
+	storage. The output is the input plus the delayed signal at the default mix, as for
+	MrDelay, and the sum of both is fed back, so it equals MrDelay with the same settings.
+
+	The delay is at least one sample and any block size works. Blocks are processed in runs
+	no longer than the delay and not wrapping around the ring end, so within a run no sample
+	read has been written in the run and the loops vectorise.
+*/
+template <typename FloatType, int MaxDelayInSmpls, int NumChannels>
+class MrFixedDelay
+{
+public:
+	static_assert(MaxDelayInSmpls > 0, "the delay has to be at least one sample");
+	static_assert(NumChannels > 0, "at least one channel");
+
+	const FloatType SAMPLERATE_DEFAULT = 48000;
+	const FloatType FEEDBACK_DEFAULT = 0.5f;
+
+	static constexpr int MAX_DELAY_IN_SMPLS = MaxDelayInSmpls;
+	static constexpr int NUM_CHANNELS = NumChannels;
+
+	/** Returns the ring size per channel, the smallest power of two not below the maximum delay. */
+	static constexpr int getRingSize() noexcept
+	{
+		int size = 1;
+		while (size < MaxDelayInSmpls)
+			size *= 2;
+
+		return size;
+	}
+
+	static constexpr int RING_SIZE = getRingSize();
+	static constexpr int RING_MASK = RING_SIZE - 1;
+
+	//==============================================================================
+	/* Applies a new feedback value to delay. */
+	void setFeedback(FloatType feedbackNew) noexcept { feedback = feedbackNew; }
+
+	/* Returns the current feedback value. */
+	FloatType getFeedback() const noexcept { return feedback; }
+
+	/** Applies new delay as number of samples, limited to 1..MAX_DELAY_IN_SMPLS, and clears the ring buffer. */
+	void setDelayInSmpls(size_t delayInSmplsNew) noexcept
+	{
+		delayInSmpls = juce::jlimit(1, MAX_DELAY_IN_SMPLS, (int)std::min(delayInSmplsNew, (size_t)MAX_DELAY_IN_SMPLS));
+
+		reset();
+	}
+
+	/** Returns the current delay in a number of samples. */
+	size_t getDelayInSmpls() const noexcept { return (size_t)delayInSmpls; }
+
+	/** Applies new delay as a millisecond value. */
+	void setDelayInMs(FloatType delayInMs) noexcept { setDelayInSmpls(msToSmpls(delayInMs)); }
+
+	/** Returns the current delay as a millisecond value. */
+	FloatType getDelayInMs() const noexcept { return (FloatType)delayInSmpls * 1000 / sampleRate; }
+
+	/** Converts time in ms to samples */
+	size_t msToSmpls(FloatType ms) const noexcept { return (size_t)(std::round(ms * sampleRate) / 1000.0f); }
+
+	/** Sets the mix of input and delayed signal, see MrDryWet. */
+	void setMix(float mix) noexcept { dryWet.setMix(mix); }
+
+	float getMix() const noexcept { return dryWet.getMix(); }
+
+	void setMixLaw(MrDryWet::Law law) noexcept { dryWet.setLaw(law); }
+
+	MrDryWet::Law getMixLaw() const noexcept { return dryWet.getLaw(); }
+
+	/** Clears the ring buffer. */
+	void reset() noexcept
+	{
+		ring.fill(0.0f);
+		posW = 0;
+	}
+
+	//==============================================================================
+	/** Called before processing starts, keeps the delay time for the new sample rate. Allocates nothing. */
+	void prepare(const juce::dsp::ProcessSpec& spec) noexcept
+	{
+		jassert((int)spec.numChannels <= NUM_CHANNELS);
+
+		const auto delayInSmplsNew = (size_t)std::round((FloatType)delayInSmpls * (FloatType)spec.sampleRate / sampleRate);
+
+		sampleRate = (FloatType)spec.sampleRate;
+		numChnls = juce::jmin((int)spec.numChannels, NUM_CHANNELS);
+
+		dryWet.prepare(spec.sampleRate);
+		setDelayInSmpls(delayInSmplsNew);
+	}
+
+	/** Processes the input and output buffers supplied in the processing context, channels beyond NUM_CHANNELS pass. */
+	template <typename ProcessContext>
+	void process(const ProcessContext& context) noexcept
+	{
+		auto&& inBlock = context.getInputBlock();
+		auto&& outBlock = context.getOutputBlock();
+
+		jassert(inBlock.getNumChannels() == outBlock.getNumChannels());
+		jassert(inBlock.getNumSamples() == outBlock.getNumSamples());
+
+		if (context.usesSeparateInputAndOutputBlocks())
+			outBlock.copyFrom(inBlock);
+
+		if (context.isBypassed)
+			return;
+
+		const int numSamples = (int)inBlock.getNumSamples();
+		const int numChannels = std::min((int)outBlock.getNumChannels(), numChnls);
+
+		const bool isMixed = !dryWet.isUnity();
+		const auto ramp = dryWet.advance(numSamples);
+		const float fb = (float)feedback;
+
+		int pos = posW;
+
+		for (int start = 0; start < numSamples; )
+		{
+			const int posRead = (pos - delayInSmpls) & RING_MASK;
+			const int num = std::min({ numSamples - start, delayInSmpls, RING_SIZE - pos, RING_SIZE - posRead });
+
+			for (int c = 0; c < numChannels; ++c)
+			{
+				float* out = outBlock.getChannelPointer((size_t)c) + start;
+				float* dlyChnl = ring.data() + (size_t)c * RING_SIZE;
+				const float* dly = dlyChnl + posRead;
+				float* fbOut = dlyChnl + pos;
+
+				if (isMixed)
+				{
+					const auto rampRun = ramp.getSlice(start);
+
+					for (int i = 0; i < num; ++i)
+					{
+						const float x = out[i];
+						const float y = dly[i];
+
+						fbOut[i] = (x + y) * fb;
+						out[i] = x * rampRun.getDry(i) + y * rampRun.getWet(i);
+					}
+				}
+				else
+				{
+					for (int i = 0; i < num; ++i)
+					{
+						const float sum = out[i] + dly[i];
+
+						fbOut[i] = sum * fb;
+						out[i] = sum;
+					}
+				}
+			}
+
+			pos = (pos + num) & RING_MASK;
+			start += num;
+		}
+
+		posW = pos;
+	}
+
+private:
+
+	int delayInSmpls{ 1 };
+	FloatType sampleRate{ SAMPLERATE_DEFAULT };
+	FloatType feedback{ FEEDBACK_DEFAULT };
+	int numChnls{ NUM_CHANNELS };
+
+	/* both at full level at the default mix, as for MrDelay */
+	MrDryWet dryWet{ 0.5f };
+
+	int posW{ 0 };
+
+	/* channel after channel, RING_SIZE samples each */
+	std::array<float, (size_t)RING_SIZE * NUM_CHANNELS> ring{};
+};
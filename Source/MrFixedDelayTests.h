@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cmath>
+#include <JuceHeader.h>
+#include "MrDelay.h"
+#include "MrFixedDelay.h"
+
+class MrFixedDelayTests : public juce::UnitTest
+{
+public:
+
+    MrFixedDelayTests() : juce::UnitTest("MrFixedDelay testing") {}
+
+    void runTest() override
+    {
+        beginTest("When the delay is at least the block size then the output equals MrDelay with the same settings.");
+        {
+            const int numChnls = 2;
+            const int numSamples = 4096;
+            const int numSamplesPerBlock = 64;
+            const float feedback = 0.7f;
+            const int delaysInSmpls[] = { 64, 300, 1000 };
+            const float mixes[] = { 0.5f, 0.3f };
+            const auto deltaExpected = 0.0001f;
+
+            for (auto delayInSmpls : delaysInSmpls)
+            {
+                for (auto mix : mixes)
+                {
+                    /// prepare...
+                    juce::AudioBuffer<float> bufferExpected(numChnls, numSamples);
+                    fillWithSine(bufferExpected);
+
+                    juce::AudioBuffer<float> bufferActual;
+                    bufferActual.makeCopyOf(bufferExpected);
+
+                    const auto spec = createSpec(numChnls, numSamplesPerBlock);
+
+                    MrDelay<float> delayExpected;
+                    delayExpected.setMix(mix);
+                    delayExpected.setMixLaw(MrDryWet::Law::linear);
+                    delayExpected.prepare(spec);
+                    delayExpected.setDelayInSmpls((size_t)delayInSmpls);
+                    delayExpected.setFeedback(feedback);
+
+                    auto delayActual = std::make_unique<MrFixedDelay<float, 1000, numChnls>>();
+                    delayActual->setMix(mix);
+                    delayActual->setMixLaw(MrDryWet::Law::linear);
+                    delayActual->prepare(spec);
+                    delayActual->setDelayInSmpls((size_t)delayInSmpls);
+                    delayActual->setFeedback(feedback);
+
+                    /// execute...
+                    for (int i = 0; i < numSamples; i += numSamplesPerBlock)
+                    {
+                        auto blockExpected = juce::dsp::AudioBlock<float>(bufferExpected).getSubBlock((size_t)i, (size_t)numSamplesPerBlock);
+                        delayExpected.process(juce::dsp::ProcessContextReplacing<float>(blockExpected));
+
+                        auto blockActual = juce::dsp::AudioBlock<float>(bufferActual).getSubBlock((size_t)i, (size_t)numSamplesPerBlock);
+                        delayActual->process(juce::dsp::ProcessContextReplacing<float>(blockActual));
+                    }
+
+                    /// evaluate...
+                    float errorMax = 0.0f;
+                    for (int c = 0; c < numChnls; ++c)
+                        for (int i = 0; i < numSamples; ++i)
+                            errorMax = std::max(errorMax, std::abs(bufferActual.getSample(c, i) - bufferExpected.getSample(c, i)));
+
+                    expect(errorMax < deltaExpected, "delay " + juce::String(delayInSmpls) + ", mix " + juce::String(mix)
+                                                     + ", error " + juce::String(errorMax));
+                }
+            }
+        }
+
+        beginTest("When the delay is shorter than the block then an impulse returns every delay, scaled by the feedback each time.");
+        {
+            const int numSamples = 200;
+            const float feedback = 0.5f;
+            const int delaysInSmpls[] = { 5, 16 };
+            const auto deltaExpected = 0.000001f;
+
+            for (auto delayInSmpls : delaysInSmpls)
+            {
+                /// prepare...
+                juce::AudioBuffer<float> buffer(1, numSamples);
+                buffer.clear();
+                buffer.setSample(0, 0, 1.0f);
+
+                // a delay of 16 spans the whole ring
+                MrFixedDelay<float, 16, 1> delay;
+                delay.prepare(createSpec(1, numSamples));
+                delay.setDelayInSmpls((size_t)delayInSmpls);
+                delay.setFeedback(feedback);
+
+                /// execute...
+                juce::dsp::AudioBlock<float> block(buffer);
+                delay.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+                /// evaluate...
+                float errorMax = 0.0f;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float expected = (i % delayInSmpls == 0) ? std::pow(feedback, (float)(i / delayInSmpls)) : 0.0f;
+                    errorMax = std::max(errorMax, std::abs(buffer.getSample(0, i) - expected));
+                }
+
+                expect(errorMax < deltaExpected, "delay " + juce::String(delayInSmpls) + ", error " + juce::String(errorMax));
+            }
+        }
+
+        beginTest("When the delay exceeds the maximum then it is limited to the maximum, and the ring is the next power of two.");
+        {
+            /// prepare...
+            MrFixedDelay<float, 1000, 2> delay;
+            delay.prepare(createSpec(2, 64));
+
+            /// execute...
+            delay.setDelayInSmpls(5000);
+
+            /// evaluate...
+            expectEquals((int)delay.getDelayInSmpls(), 1000);
+            expectEquals(MrFixedDelay<float, 1000, 2>::RING_SIZE, 1024);
+            expectEquals(MrFixedDelay<float, 1024, 2>::RING_SIZE, 1024);
+            expectEquals(MrFixedDelay<float, 1025, 2>::RING_SIZE, 2048);
+            expectEquals(MrFixedDelay<float, 1, 1>::RING_SIZE, 1);
+            expect(sizeof(delay) >= 1024 * 2 * sizeof(float));
+        }
+    }
+
+private:
+
+    static juce::dsp::ProcessSpec createSpec(int numChnls, int blockSize)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.numChannels = (juce::uint32)numChnls;
+        spec.sampleRate = 48000;
+        spec.maximumBlockSize = (juce::uint32)blockSize;
+        return spec;
+    }
+
+    static void fillWithSine(juce::AudioBuffer<float>& buffer)
+    {
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(c, i, 0.5f * std::sin(0.05f * (float)i + (float)c));
+    }
+};
+
+static MrFixedDelayTests fixedDelayTests;
@@ -0,0 +1,477 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Process wide cache of impulse responses prepared for partitioned convolution.
+
+	An impulse response is resampled to the session sample rate, cut into partitions of
+	partitionSize samples, each zero padded to twice its size and transformed, keeping the
+	partitionSize + 1 non-negative bins. The spectra are written once to a cache file and
+	from then on memory mapped read-only, so later loads, and other plugin instances
+	sharing the cache through a juce::SharedResourcePointer<MrIrCache>, neither decode nor
+	resample nor transform anything.
+
+	A cache file is a 64 byte Header followed by the spectra as floats in native byte order:
+	channel by channel, partition by partition, bin by bin as interleaved re, im. The header
+	carries the key of the impulse response and a checksum of the spectra, files that do not
+	match are rebuilt.
+*/
+class MrIrCache
+{
+public:
+
+	static constexpr int PARTITION_SIZE_DEFAULT = 512;
+	static constexpr int PARTITION_SIZE_MIN = 32;
+	static constexpr int PARTITION_SIZE_MAX = 16384;
+	static constexpr juce::uint32 FILE_MAGIC = 0x5249524d;	/**< "MRIR" */
+	static constexpr juce::uint32 FILE_VERSION = 1;
+	static constexpr int RESAMPLER_ZERO_CROSSINGS = 16;
+	static constexpr int RESAMPLER_NUM_PHASES = 512;
+
+	enum class Origin
+	{
+		built,		/**< computed now, held in memory because the cache file could not be written */
+		mapped		/**< memory mapped from the cache file */
+	};
+
+	/** The layout of the head of a cache file. */
+	struct Header
+	{
+		juce::uint32 magic;
+		juce::uint32 version;
+		juce::uint32 headerSize;
+		juce::int32 numChannels;
+		juce::int32 numPartitions;
+		juce::int32 partitionSize;
+		juce::int32 lengthInSmpls;
+		juce::uint32 reserved;
+		double sampleRate;
+		juce::uint64 key;
+		juce::uint64 payloadSize;	/**< in bytes */
+		juce::uint64 checksum;		/**< of the payload, see checksum() */
+	};
+
+	static_assert(sizeof(Header) == 64, "the header is part of the file format");
+
+	//==============================================================================
+	/** The transformed partitions of an impulse response, immutable. */
+	class Ir : public juce::ReferenceCountedObject
+	{
+	public:
+
+		using Ptr = juce::ReferenceCountedObjectPtr<Ir>;
+
+		int getNumChannels() const noexcept { return header.numChannels; }
+		int getNumPartitions() const noexcept { return header.numPartitions; }
+		int getPartitionSize() const noexcept { return header.partitionSize; }
+		int getNumBins() const noexcept { return header.partitionSize + 1; }
+		int getLengthInSmpls() const noexcept { return header.lengthInSmpls; }
+		double getSampleRate() const noexcept { return header.sampleRate; }
+		juce::uint64 getKey() const noexcept { return header.key; }
+		Origin getOrigin() const noexcept { return (mapped != nullptr) ? Origin::mapped : Origin::built; }
+
+		/** Returns the getNumBins() bins of a partition as interleaved re, im. Real time safe. */
+		const float* getPartition(int channel, int partition) const noexcept
+		{
+			jassert(channel < getNumChannels() && partition < getNumPartitions());
+			return spectra + ((size_t)channel * (size_t)header.numPartitions + (size_t)partition) * (size_t)(2 * getNumBins());
+		}
+
+	private:
+
+		friend class MrIrCache;
+
+		Header header{};
+		const float* spectra{ nullptr };
+		std::vector<float> storage;
+		std::unique_ptr<juce::MemoryMappedFile> mapped;
+	};
+
+	//==============================================================================
+	MrIrCache() : directory(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("mrJuceFxChainPlus IR cache")) {}
+
+	/** Where the cache files go. Must be set before the first load. */
+	void setDirectory(const juce::File& directoryNew)
+	{
+		const juce::ScopedLock sl(lock);
+		directory = directoryNew;
+	}
+
+	juce::File getDirectory() const
+	{
+		const juce::ScopedLock sl(lock);
+		return directory;
+	}
+
+	/**
+		Returns the impulse response of an audio file prepared for the given sample rate, or
+		nullptr if the file cannot be read. The file is only decoded if its path, size or
+		modification time are not in the cache yet. Not for the audio thread.
+	*/
+	Ir::Ptr getIr(const juce::File& irFile, double sampleRate, int partitionSize = PARTITION_SIZE_DEFAULT)
+	{
+		partitionSize = toPartitionSize(partitionSize);
+
+		const auto path = irFile.getFullPathName();
+		const juce::int64 keyFields[] = { irFile.getSize(), irFile.getLastModificationTime().toMilliseconds(), (juce::int64)partitionSize };
+
+		auto key = hash(path.toRawUTF8(), path.getNumBytesAsUTF8());
+		key = hash(keyFields, sizeof(keyFields), key);
+		key = hash(&sampleRate, sizeof(sampleRate), key);
+
+		return getIr(key, [&]() -> Ir::Ptr
+			{
+				juce::AudioFormatManager formatManager;
+				formatManager.registerBasicFormats();
+
+				std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(irFile));
+
+				if (reader == nullptr || reader->lengthInSamples > (juce::int64)std::numeric_limits<int>::max())
+					return nullptr;
+
+				juce::AudioBuffer<float> ir((int)reader->numChannels, (int)reader->lengthInSamples);
+				reader->read(&ir, 0, ir.getNumSamples(), 0, true, true);
+
+				return build(ir, reader->sampleRate, sampleRate, partitionSize, key);
+			});
+	}
+
+	/** Returns an impulse response held in memory prepared for the given sample rate, keyed by its samples. Not for the audio thread. */
+	Ir::Ptr getIr(const juce::AudioBuffer<float>& ir, double irSampleRate, double sampleRate, int partitionSize = PARTITION_SIZE_DEFAULT)
+	{
+		partitionSize = toPartitionSize(partitionSize);
+
+		const juce::int64 keyFields[] = { (juce::int64)ir.getNumChannels(), (juce::int64)ir.getNumSamples(), (juce::int64)partitionSize };
+		const double rates[] = { irSampleRate, sampleRate };
+
+		auto key = hash(keyFields, sizeof(keyFields));
+		key = hash(rates, sizeof(rates), key);
+
+		for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+			key = hash(key, checksum(ir.getReadPointer(channel), (size_t)ir.getNumSamples() * sizeof(float)));
+
+		return getIr(key, [&]() -> Ir::Ptr
+			{
+				return build(ir, irSampleRate, sampleRate, partitionSize, key);
+			});
+	}
+
+	/** Returns the number of impulse responses currently held by the cache. */
+	size_t getNumIrs() const
+	{
+		const juce::ScopedLock sl(lock);
+		return irs.size();
+	}
+
+	/** Returns the cache file of a key. */
+	juce::File getCacheFile(juce::uint64 key) const
+	{
+		const juce::ScopedLock sl(lock);
+		return directory.getChildFile(juce::String::toHexString((juce::int64)key) + ".mrir");
+	}
+
+	//==============================================================================
+	/** Rounds up to the next power of two. */
+	static int toPartitionSize(int partitionSize) noexcept
+	{
+		return juce::nextPowerOfTwo(juce::jlimit(PARTITION_SIZE_MIN, PARTITION_SIZE_MAX, partitionSize));
+	}
+
+	/**
+		Resamples with a windowed sinc interpolated from a table of phases, low passed below
+		the lower of both Nyquists. The samples are scaled by the inverse of the ratio, so the
+		impulse response keeps its gain.
+	*/
+	static juce::AudioBuffer<float> resample(const juce::AudioBuffer<float>& input, double sampleRateIn, double sampleRateOut)
+	{
+		if (sampleRateIn == sampleRateOut || sampleRateIn <= 0.0 || sampleRateOut <= 0.0)
+			return input;
+
+		const double ratio = sampleRateOut / sampleRateIn;
+		const double cutOff = std::min(1.0, ratio);
+		const int halfLength = (int)std::ceil(RESAMPLER_ZERO_CROSSINGS / cutOff);
+		const int numTaps = 2 * halfLength;
+
+		// phase p holds the taps for the input samples at -halfLength + 1 ... halfLength around a position p / RESAMPLER_NUM_PHASES past one
+		std::vector<float> table((size_t)((RESAMPLER_NUM_PHASES + 1) * numTaps));
+		for (int p = 0; p <= RESAMPLER_NUM_PHASES; ++p)
+		{
+			for (int k = 0; k < numTaps; ++k)
+			{
+				const double x = (double)(k - halfLength + 1) - (double)p / RESAMPLER_NUM_PHASES;
+				const double arg = juce::MathConstants<double>::pi * cutOff * x;
+				const double sinc = (std::abs(arg) < 1.0e-9) ? 1.0 : std::sin(arg) / arg;
+				const double w = x / halfLength;
+				const double window = (std::abs(w) >= 1.0) ? 0.0 : 0.42 + 0.5 * std::cos(juce::MathConstants<double>::pi * w) + 0.08 * std::cos(2.0 * juce::MathConstants<double>::pi * w);
+
+				table[(size_t)(p * numTaps + k)] = (float)(sinc * window);
+			}
+		}
+
+		const int numSamplesIn = input.getNumSamples();
+		const int numSamplesOut = (int)std::ceil(numSamplesIn * ratio);
+		const float gain = (float)(cutOff / ratio);
+
+		juce::AudioBuffer<float> output(input.getNumChannels(), numSamplesOut);
+
+		for (int channel = 0; channel < input.getNumChannels(); ++channel)
+		{
+			const float* in = input.getReadPointer(channel);
+			float* out = output.getWritePointer(channel);
+
+			for (int n = 0; n < numSamplesOut; ++n)
+			{
+				const double pos = n / ratio;
+				const int idx = (int)pos;
+				const double phase = (pos - idx) * RESAMPLER_NUM_PHASES;
+				const int p = std::min((int)phase, RESAMPLER_NUM_PHASES - 1);
+				const float frac = (float)(phase - p);
+
+				const float* taps0 = table.data() + p * numTaps;
+				const float* taps1 = taps0 + numTaps;
+
+				const int kFrom = std::max(0, halfLength - 1 - idx);
+				const int kTo = std::min(numTaps, numSamplesIn - idx + halfLength - 1);
+
+				float sum = 0.0f;
+				for (int k = kFrom; k < kTo; ++k)
+					sum += in[idx + k - halfLength + 1] * (taps0[k] + frac * (taps1[k] - taps0[k]));
+
+				out[n] = gain * sum;
+			}
+		}
+
+		return output;
+	}
+
+	/** A 64 bit FNV-1a hash over the given bytes. */
+	static juce::uint64 hash(const void* data, size_t numBytes, juce::uint64 hashValue = FNV_OFFSET) noexcept
+	{
+		const auto* bytes = static_cast<const juce::uint8*>(data);
+
+		for (size_t i = 0; i < numBytes; ++i)
+			hashValue = (hashValue ^ bytes[i]) * FNV_PRIME;
+
+		return hashValue;
+	}
+
+	/** Folds a value into a hash. */
+	static juce::uint64 hash(juce::uint64 hashValue, juce::uint64 value) noexcept
+	{
+		return (hashValue ^ value) * FNV_PRIME;
+	}
+
+	/**
+		FNV-1a over 64 bit words in four interleaved lanes, so it runs at memory speed, the
+		remaining bytes hashed one by one. Any single changed bit changes the result.
+	*/
+	static juce::uint64 checksum(const void* data, size_t numBytes) noexcept
+	{
+		const auto* bytes = static_cast<const char*>(data);
+		const size_t numWords = numBytes / sizeof(juce::uint64);
+
+		juce::uint64 lanes[4] = { FNV_OFFSET, FNV_OFFSET + 1, FNV_OFFSET + 2, FNV_OFFSET + 3 };
+
+		for (size_t i = 0; i < numWords; ++i)
+		{
+			juce::uint64 word;
+			std::memcpy(&word, bytes + i * sizeof(juce::uint64), sizeof(word));
+			lanes[i & 3] = (lanes[i & 3] ^ word) * FNV_PRIME;
+		}
+
+		auto hashValue = hash(bytes + numWords * sizeof(juce::uint64), numBytes - numWords * sizeof(juce::uint64));
+
+		for (auto lane : lanes)
+			hashValue = hash(hashValue, lane);
+
+		return hashValue;
+	}
+
+private:
+
+	static constexpr juce::uint64 FNV_OFFSET = 0xcbf29ce484222325ull;
+	static constexpr juce::uint64 FNV_PRIME = 0x100000001b3ull;
+
+	/** Looks the key up in memory, then on disk, and only builds the impulse response if both miss. */
+	template <typename BuildFn>
+	Ir::Ptr getIr(juce::uint64 key, BuildFn&& buildIr)
+	{
+		const juce::ScopedLock sl(lock);
+
+		releaseUnusedIrs();
+
+		for (auto& ir : irs)
+			if (ir->header.key == key)
+				return ir;
+
+		const auto cacheFile = getCacheFile(key);
+		Ir::Ptr ir = map(cacheFile, key);
+
+		if (ir == nullptr)
+		{
+			ir = buildIr();
+
+			if (ir == nullptr)
+				return nullptr;
+
+			if (write(*ir, cacheFile))
+			{
+				if (auto irMapped = map(cacheFile, key))
+					ir = irMapped;
+			}
+		}
+
+		irs.push_back(ir);
+		return ir;
+	}
+
+	static Ir::Ptr build(const juce::AudioBuffer<float>& irInput, double irSampleRate, double sampleRate, int partitionSize, juce::uint64 key)
+	{
+		if (irInput.getNumChannels() == 0)
+			return nullptr;
+
+		const auto resampled = resample(irInput, irSampleRate, sampleRate);
+		const int numSamples = resampled.getNumSamples();
+		const int numPartitions = std::max(1, (numSamples + partitionSize - 1) / partitionSize);
+		const int numBins = partitionSize + 1;
+
+		Ir::Ptr ir = new Ir();
+		auto& header = ir->header;
+		header.magic = FILE_MAGIC;
+		header.version = FILE_VERSION;
+		header.headerSize = (juce::uint32)sizeof(Header);
+		header.numChannels = resampled.getNumChannels();
+		header.numPartitions = numPartitions;
+		header.partitionSize = partitionSize;
+		header.lengthInSmpls = numSamples;
+		header.sampleRate = sampleRate;
+		header.key = key;
+
+		ir->storage.resize((size_t)header.numChannels * (size_t)numPartitions * (size_t)(2 * numBins));
+		ir->spectra = ir->storage.data();
+
+		juce::dsp::FFT fft(juce::roundToInt(std::log2(2 * partitionSize)));
+		std::vector<float> scratch((size_t)(4 * partitionSize));
+
+		for (int channel = 0; channel < header.numChannels; ++channel)
+		{
+			for (int partition = 0; partition < numPartitions; ++partition)
+			{
+				const int offset = partition * partitionSize;
+				const int num = std::min(partitionSize, numSamples - offset);
+
+				std::fill(scratch.begin(), scratch.end(), 0.0f);
+				if (num > 0)
+					std::copy(resampled.getReadPointer(channel, offset), resampled.getReadPointer(channel, offset) + num, scratch.begin());
+
+				fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+				std::copy(scratch.begin(), scratch.begin() + 2 * numBins, ir->storage.begin() + (ir->getPartition(channel, partition) - ir->spectra));
+			}
+		}
+
+		header.payloadSize = (juce::uint64)(ir->storage.size() * sizeof(float));
+		header.checksum = checksum(ir->storage.data(), (size_t)header.payloadSize);
+
+		return ir;
+	}
+
+	/** Writes next to the cache file first and then replaces it, so no other process ever maps a file half written. */
+	static bool write(const Ir& ir, const juce::File& cacheFile)
+	{
+		if (!cacheFile.getParentDirectory().createDirectory())
+			return false;
+
+		juce::TemporaryFile tempFile(cacheFile);
+
+		{
+			juce::FileOutputStream stream(tempFile.getFile());
+
+			if (!stream.openedOk()
+				|| !stream.write(&ir.header, sizeof(Header))
+				|| !stream.write(ir.spectra, (size_t)ir.header.payloadSize))
+				return false;
+
+			stream.flush();
+		}
+
+		return tempFile.overwriteTargetFileWithTemporary();
+	}
+
+	/** Maps a cache file, nullptr if it is missing, belongs to another key or does not pass the checks. */
+	static Ir::Ptr map(const juce::File& cacheFile, juce::uint64 key)
+	{
+		if (!cacheFile.existsAsFile())
+			return nullptr;
+
+		auto mapped = std::make_unique<juce::MemoryMappedFile>(cacheFile, juce::MemoryMappedFile::readOnly);
+
+		if (mapped->getData() == nullptr || mapped->getSize() < sizeof(Header))
+			return nullptr;
+
+		Header header;
+		std::memcpy(&header, mapped->getData(), sizeof(Header));
+
+		if (!isValid(header, key, mapped->getSize()))
+			return nullptr;
+
+		const auto* payload = static_cast<const char*>(mapped->getData()) + sizeof(Header);
+
+		if (checksum(payload, (size_t)header.payloadSize) != header.checksum)
+			return nullptr;
+
+		Ir::Ptr ir = new Ir();
+		ir->header = header;
+		ir->spectra = reinterpret_cast<const float*>(payload);
+		ir->mapped = std::move(mapped);
+
+		return ir;
+	}
+
+	static bool isValid(const Header& header, juce::uint64 key, size_t fileSize) noexcept
+	{
+		if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.headerSize != sizeof(Header) || header.key != key)
+			return false;
+
+		if (header.numChannels <= 0 || header.numPartitions <= 0 || header.partitionSize != toPartitionSize(header.partitionSize))
+			return false;
+
+		const auto payloadSize = (juce::uint64)header.numChannels * (juce::uint64)header.numPartitions
+			* (juce::uint64)(2 * (header.partitionSize + 1)) * sizeof(float);
+
+		return header.payloadSize == payloadSize && (juce::uint64)fileSize == sizeof(Header) + payloadSize;
+	}
+
+	/** Drops the impulse responses nobody but the cache refers to anymore. */
+	void releaseUnusedIrs()
+	{
+		irs.erase(std::remove_if(irs.begin(), irs.end(),
+			[](const Ir::Ptr& ir) { return ir->getReferenceCount() == 1; }),
+			irs.end());
+	}
+
+	juce::CriticalSection lock;
+	juce::File directory;
+	std::vector<Ir::Ptr> irs;
+
+	JUCE_DECLARE_NON_COPYABLE(MrIrCache)
+};
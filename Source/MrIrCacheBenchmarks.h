@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrIrCache.h"
+#include "MrSignal.h"
+
+class MrIrCacheBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrIrCacheBenchmarks() : juce::UnitTest("MrIrCache benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        beginTest("Loading a 10 s stereo IR at 44.1 kHz for 48 kHz, cold vs. warm from disk vs. warm in process");
+        {
+            const double irSampleRate = 44100;
+            const double sampleRate = 48000;
+            const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("MrIrCacheBenchmarks");
+
+            juce::AudioBuffer<float> irBuffer(2, (int)(10 * irSampleRate));
+            juce::dsp::AudioBlock<float> irBlock(irBuffer);
+            MrSignal::whiteNoise(irBlock, 0.5f);
+
+            // resampling, partitioning, transforming and writing the cache file
+            auto result = MrBenchmark::run([&]
+                {
+                    directory.deleteRecursively();
+                    MrIrCache cache;
+                    cache.setDirectory(directory);
+                    cache.getIr(irBuffer, irSampleRate, sampleRate);
+                }, 5, 1);
+
+            logMessage(MrBenchmark::format("cold", result, 0));
+
+            // a new instance in a new process, hashing the samples and mapping and checking the cache file
+            result = MrBenchmark::run([&]
+                {
+                    MrIrCache cache;
+                    cache.setDirectory(directory);
+                    cache.getIr(irBuffer, irSampleRate, sampleRate);
+                }, 50);
+
+            logMessage(MrBenchmark::format("warm, mapped from disk", result, 0));
+
+            // the cache shared by the instances of one process already holding the IR, which only hashes the samples
+            MrIrCache cache;
+            cache.setDirectory(directory);
+            auto ir = cache.getIr(irBuffer, irSampleRate, sampleRate);
+
+            result = MrBenchmark::run([&]
+                {
+                    cache.getIr(irBuffer, irSampleRate, sampleRate);
+                }, 50);
+
+            logMessage(MrBenchmark::format("warm, in process", result, 0));
+
+            directory.deleteRecursively();
+        }
+    }
+};
+
+static MrIrCacheBenchmarks irCacheBenchmarks;
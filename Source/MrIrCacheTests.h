@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrIrCache.h"
+
+class MrIrCacheTests : public juce::UnitTest
+{
+public:
+
+    MrIrCacheTests() : juce::UnitTest("MrIrCache testing") {}
+
+    void runTest() override
+    {
+        const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("MrIrCacheTests");
+        directory.deleteRecursively();
+
+        beginTest("When an impulse response is prepared then its partitions are the spectra of its zero padded slices.");
+        {
+            /// prepare...
+            const int numChnls = 2;
+            const int numSamples = 1500;
+            const int partitionSize = 256;
+
+            juce::AudioBuffer<float> irBuffer(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> irBlock(irBuffer);
+            MrSignal::whiteNoise(irBlock, 0.5f);
+
+            MrIrCache cache;
+            cache.setDirectory(directory);
+
+            /// execute...
+            auto ir = cache.getIr(irBuffer, 48000, 48000, partitionSize);
+
+            /// evaluate...
+            expect(ir != nullptr);
+            expectEquals(ir->getNumChannels(), numChnls);
+            expectEquals(ir->getPartitionSize(), partitionSize);
+            expectEquals(ir->getNumPartitions(), 6);
+            expectEquals(ir->getLengthInSmpls(), numSamples);
+            expect(ir->getOrigin() == MrIrCache::Origin::mapped);
+
+            juce::dsp::FFT fft(9);
+            std::vector<float> scratch((size_t)(4 * partitionSize));
+
+            for (int channel = 0; channel < numChnls; ++channel)
+            {
+                for (int partition = 0; partition < ir->getNumPartitions(); ++partition)
+                {
+                    const int offset = partition * partitionSize;
+                    const int num = std::min(partitionSize, numSamples - offset);
+
+                    std::fill(scratch.begin(), scratch.end(), 0.0f);
+                    std::copy(irBuffer.getReadPointer(channel, offset), irBuffer.getReadPointer(channel, offset) + num, scratch.begin());
+                    fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+                    const float* bins = ir->getPartition(channel, partition);
+
+                    for (int i = 0; i < 2 * ir->getNumBins(); ++i)
+                        expectWithinAbsoluteError(bins[i], scratch[(size_t)i], 1.0e-4f);
+                }
+            }
+        }
+
+        beginTest("When resampling then the length follows the ratio, a sine keeps its frequency and the gain is kept.");
+        {
+            /// prepare...
+            const double sampleRateIn = 44100;
+            const double sampleRateOut = 48000;
+            const int numSamples = 4410;
+            const double freqInHz = 1000.0;
+
+            juce::AudioBuffer<float> input(1, numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                input.setSample(0, i, (float)std::sin(juce::MathConstants<double>::twoPi * freqInHz * i / sampleRateIn));
+
+            /// execute...
+            auto output = MrIrCache::resample(input, sampleRateIn, sampleRateOut);
+            auto outputDown = MrIrCache::resample(input, sampleRateIn, 22050);
+
+            /// evaluate...
+            expectEquals(output.getNumSamples(), 4800);
+            expectEquals(outputDown.getNumSamples(), 2205);
+
+            // away from the edges, where the sinc runs out of input
+            const float gain = (float)(sampleRateIn / sampleRateOut);
+            for (int i = 100; i < output.getNumSamples() - 100; ++i)
+                expectWithinAbsoluteError(output.getSample(0, i), gain * (float)std::sin(juce::MathConstants<double>::twoPi * freqInHz * i / sampleRateOut), 1.0e-3f);
+
+            for (int i = 100; i < outputDown.getNumSamples() - 100; ++i)
+                expectWithinAbsoluteError(outputDown.getSample(0, i), 2.0f * (float)std::sin(juce::MathConstants<double>::twoPi * freqInHz * i / 22050), 2.0e-3f);
+        }
+
+        beginTest("When the same impulse response is loaded again then it is shared in the process and mapped from disk by another cache.");
+        {
+            /// prepare...
+            juce::AudioBuffer<float> irBuffer(2, 10000);
+            juce::dsp::AudioBlock<float> irBlock(irBuffer);
+            MrSignal::whiteNoise(irBlock, 0.5f);
+
+            MrIrCache cache1;
+            MrIrCache cache2;
+            cache1.setDirectory(directory);
+            cache2.setDirectory(directory);
+
+            /// execute...
+            auto ir1 = cache1.getIr(irBuffer, 44100, 48000);
+            auto ir2 = cache1.getIr(irBuffer, 44100, 48000);
+            auto ir3 = cache2.getIr(irBuffer, 44100, 48000);
+            auto ir4 = cache2.getIr(irBuffer, 44100, 96000);
+
+            /// evaluate...
+            expect(ir1.get() == ir2.get());
+            expect(ir1.get() != ir3.get());
+            expect(ir3->getOrigin() == MrIrCache::Origin::mapped);
+            expect(ir1->getKey() == ir3->getKey());
+            expect(ir1->getKey() != ir4->getKey());
+            expectEquals(cache1.getNumIrs(), (size_t)1);
+            expectEquals(cache2.getNumIrs(), (size_t)2);
+            expect(isEqual(*ir1, *ir3));
+        }
+
+        beginTest("When the cache file is corrupted or cut short then it is rejected and rebuilt.");
+        {
+            /// prepare...
+            juce::AudioBuffer<float> irBuffer(1, 3000);
+            juce::dsp::AudioBlock<float> irBlock(irBuffer);
+            MrSignal::whiteNoise(irBlock, 0.5f);
+
+            MrIrCache cacheFirst;
+            cacheFirst.setDirectory(directory);
+            auto irFirst = cacheFirst.getIr(irBuffer, 48000, 48000);
+            const auto cacheFile = cacheFirst.getCacheFile(irFirst->getKey());
+
+            juce::MemoryBlock data;
+            cacheFile.loadFileAsData(data);
+
+            // a flipped bit in the spectra, another in the header and a truncated file
+            const size_t flips[] = { data.getSize() / 2, 20, 0 };
+
+            for (auto flip : flips)
+            {
+                juce::MemoryBlock corrupted(data);
+
+                if (flip > 0)
+                    static_cast<char*>(corrupted.getData())[flip] ^= 0x10;
+                else
+                    corrupted.setSize(data.getSize() - 8);
+
+                cacheFile.replaceWithData(corrupted.getData(), corrupted.getSize());
+
+                MrIrCache cache;
+                cache.setDirectory(directory);
+
+                /// execute...
+                auto ir = cache.getIr(irBuffer, 48000, 48000);
+
+                /// evaluate...
+                juce::MemoryBlock rebuilt;
+                cacheFile.loadFileAsData(rebuilt);
+
+                expect(ir != nullptr);
+                expect(isEqual(*ir, *irFirst));
+                expect(rebuilt.getSize() == data.getSize());
+                expect(std::memcmp(rebuilt.getData(), data.getData(), data.getSize()) == 0);
+            }
+        }
+
+        beginTest("When the cache file cannot be written then the impulse response is held in memory.");
+        {
+            /// prepare...
+            juce::AudioBuffer<float> irBuffer(1, 1000);
+            juce::dsp::AudioBlock<float> irBlock(irBuffer);
+            MrSignal::whiteNoise(irBlock, 0.5f);
+
+            // a directory below a file can never be created
+            directory.createDirectory();
+            auto blockingFile = directory.getChildFile("blocking");
+            blockingFile.replaceWithText("x");
+
+            MrIrCache cache;
+            cache.setDirectory(blockingFile.getChildFile("cache"));
+
+            /// execute...
+            auto ir = cache.getIr(irBuffer, 48000, 48000);
+
+            /// evaluate...
+            expect(ir != nullptr);
+            expect(ir->getOrigin() == MrIrCache::Origin::built);
+            expect(ir.get() == cache.getIr(irBuffer, 48000, 48000).get());
+        }
+
+        directory.deleteRecursively();
+    }
+
+private:
+
+    static bool isEqual(const MrIrCache::Ir& ir1, const MrIrCache::Ir& ir2)
+    {
+        if (ir1.getNumChannels() != ir2.getNumChannels() || ir1.getNumPartitions() != ir2.getNumPartitions() || ir1.getNumBins() != ir2.getNumBins())
+            return false;
+
+        const size_t numBytes = (size_t)(2 * ir1.getNumBins()) * sizeof(float);
+
+        for (int channel = 0; channel < ir1.getNumChannels(); ++channel)
+            for (int partition = 0; partition < ir1.getNumPartitions(); ++partition)
+                if (std::memcmp(ir1.getPartition(channel, partition), ir2.getPartition(channel, partition), numBytes) != 0)
+                    return false;
+
+        return true;
+    }
+};
+
+static MrIrCacheTests irCacheTests;
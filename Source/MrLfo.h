@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <JuceHeader.h>
+
+/**
+	Table driven low frequency oscillator.
+
+	The shapes are read from band limited wavetables with linear interpolation, built once
+	per process, so rendering needs no std::sin per sample. The oscillator keeps no state:
+	the caller owns the phase, which lets any number of voices and channels share one phase
+	accumulator with individual offsets.
+*/
+class MrLfo
+{
+public:
+
+	enum class Shape
+	{
+		sine,		/**< sine */
+		triangle	/**< triangle made of the odd harmonics up to NUM_TRIANGLE_HARMONICS */
+	};
+
+	static constexpr int TABLE_SIZE = 2048;
+	static constexpr int NUM_TRIANGLE_HARMONICS = 15;
+	static constexpr int BLOCK_SIZE = 64;
+
+	//==============================================================================
+	/**
+		Writes num values in [0, 1] to dest, starting at phase (in cycles) and advancing by
+		phaseInc per sample. num * phaseInc must stay below one cycle.
+	*/
+	static void render(float* dest, int num, double phase, double phaseInc, Shape shape) noexcept
+	{
+		jassert(num * phaseInc < 1.0);
+
+		const float* table = getTable(shape).data();
+		const float pos = (float)((phase - std::floor(phase)) * TABLE_SIZE);
+		const float inc = (float)(phaseInc * TABLE_SIZE);
+
+		/* renders into a local first, dest might alias the table as far as the compiler knows */
+		std::array<float, BLOCK_SIZE> values;
+
+		for (int start = 0; start < num; start += BLOCK_SIZE)
+		{
+			const int numBlock = juce::jmin(BLOCK_SIZE, num - start);
+
+			for (int i = 0; i < numBlock; ++i)
+			{
+				const float p = pos + inc * (float)(start + i);
+				const int idx = (int)p;
+				const float frac = p - (float)idx;
+				const int idxWrapped = idx & (TABLE_SIZE - 1);
+
+				values[(size_t)i] = table[idxWrapped] + frac * (table[idxWrapped + 1] - table[idxWrapped]);
+			}
+
+			juce::FloatVectorOperations::copy(dest + start, values.data(), numBlock);
+		}
+	}
+
+	/** Advances the phase by num samples, keeping it within one cycle. */
+	static double advance(double phase, double phaseInc, int num) noexcept
+	{
+		phase += phaseInc * num;
+		return phase - std::floor(phase);
+	}
+
+private:
+
+	/** Returns the table of a shape, TABLE_SIZE values in [0, 1] followed by a guard point. */
+	static const std::array<float, TABLE_SIZE + 1>& getTable(Shape shape) noexcept
+	{
+		static const std::array<float, TABLE_SIZE + 1> sineTable = build([](double x) { return std::sin(x); });
+
+		static const std::array<float, TABLE_SIZE + 1> triangleTable = build([](double x)
+			{
+				double sum = 0.0;
+				for (int k = 1; k <= NUM_TRIANGLE_HARMONICS; k += 2)
+					sum += (((k - 1) / 2) % 2 == 0 ? 1.0 : -1.0) * std::sin(k * x) / (double)(k * k);
+
+				return sum * 8.0 / (juce::MathConstants<double>::pi * juce::MathConstants<double>::pi);
+			});
+
+		return (shape == Shape::triangle) ? triangleTable : sineTable;
+	}
+
+	/** Samples a bipolar function over one cycle and normalises it to [0, 1]. */
+	template <typename Fn>
+	static std::array<float, TABLE_SIZE + 1> build(Fn&& fn)
+	{
+		std::array<float, TABLE_SIZE + 1> table{};
+		double maxAbs = 0.0;
+
+		for (int i = 0; i < TABLE_SIZE; ++i)
+			maxAbs = std::max(maxAbs, std::abs(fn(juce::MathConstants<double>::twoPi * i / TABLE_SIZE)));
+
+		for (int i = 0; i < TABLE_SIZE; ++i)
+			table[(size_t)i] = (float)(0.5 + 0.5 * fn(juce::MathConstants<double>::twoPi * i / TABLE_SIZE) / maxAbs);
+
+		table[TABLE_SIZE] = table[0];
+		return table;
+	}
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <JuceHeader.h>
+#include "MrLfo.h"
+
+class MrLfoTests : public juce::UnitTest
+{
+public:
+
+    MrLfoTests() : juce::UnitTest("MrLfo testing") {}
+
+    void runTest() override
+    {
+        beginTest("When rendering a sine then the values match the unipolar sine.");
+        {
+            const int numSamples = 64;
+            const double phase = 0.3;
+            const double phaseInc = 1.0 / 100.0;
+            const auto deltaExpected = 0.0001f;
+
+            float actual[numSamples];
+
+            /// execute...
+            MrLfo::render(actual, numSamples, phase, phaseInc, MrLfo::Shape::sine);
+
+            /// evaluate...
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto expected = 0.5 + 0.5 * std::sin(juce::MathConstants<double>::twoPi * (phase + i * phaseInc));
+                expect(abs(actual[i] - (float)expected) < deltaExpected);
+            }
+        }
+
+        beginTest("When rendering a triangle then the values stay within 0 and 1 and reach both ends.");
+        {
+            const int numSamples = 100;
+            const double phaseInc = 1.0 / numSamples;
+
+            float actual[numSamples];
+
+            /// execute...
+            MrLfo::render(actual, numSamples, 0.0, phaseInc * 0.99, MrLfo::Shape::triangle);
+
+            /// evaluate...
+            auto range = juce::FloatVectorOperations::findMinAndMax(actual, numSamples);
+            expect(range.getStart() >= 0.0f && range.getStart() < 0.01f);
+            expect(range.getEnd() <= 1.0f && range.getEnd() > 0.99f);
+        }
+
+        beginTest("When advancing the phase then it wraps into one cycle.");
+        {
+            /// execute...
+            auto phase = MrLfo::advance(0.9, 0.01, 20);
+
+            /// evaluate...
+            expect(abs(phase - 0.1) < 0.000001);
+        }
+    }
+};
+
+static MrLfoTests lfoTests;
@@ -0,0 +1,495 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+#include "MrDspTableCache.h"
+#include "MrFilter.h"
+#include "MrReblocker.h"
+
+/**
+	Linear phase alternative to MrFilter, an FIR with the magnitude of the MrFilter design
+	for the same parameters, in all its modes and slopes, and a delay of half its length.
+
+	The kernel is designed by frequency sampling: the magnitude of the biquad cascade is
+	taken at the bins of an FFT, transformed back to a symmetric impulse response and cut to
+	the kernel size with a Blackman window.
+
+	It runs as overlap-save FFT convolution on blocks of a fixed internal size, one more than
+	the kernel size, whatever the size of the host blocks. MrReblocker collects the samples
+	until a block is full, so the latency is one internal block plus half the kernel, see
+	getLatencyInSmpls().
+
+	setParameters() may be called from another thread than process(), by one thread at a
+	time. It only passes the parameters on, the kernel is designed on a thread of its own and
+	handed back through a triple buffer. A new kernel is crossfaded in over one internal
+	block, running the old and the new one side by side.
+
+	A mix below 1 adds the input delayed by half the kernel, so it lines up with the
+	filtered signal. The input of the block is still there as the first half of the next
+	frame, only the last half kernel of the block before is kept on top.
+*/
+class MrLinearPhaseFilter
+{
+public:
+
+	static constexpr int KERNEL_SIZE_DEFAULT = 2047;
+	static constexpr int KERNEL_SIZE_MIN = 63;
+	static constexpr int KERNEL_SIZE_MAX = 4095;		/**< the FFT keeps its scratch space on the stack of the audio thread */
+
+	MrLinearPhaseFilter() = default;
+
+	~MrLinearPhaseFilter()
+	{
+		stop();
+	}
+
+	//==============================================================================
+	/** Rounds up to one less than a power of two, so the delay is a whole number of samples. Takes effect from the next prepare(). */
+	void setKernelSize(int kernelSizeNew) noexcept
+	{
+		kernelSizeNew = juce::jlimit(KERNEL_SIZE_MIN, KERNEL_SIZE_MAX, kernelSizeNew);
+		blockSizeNext = juce::nextPowerOfTwo(kernelSizeNew + 1);
+	}
+
+	int getKernelSize() const noexcept { return blockSizeNext - 1; }
+
+	/** Returns the latency of the prepared filter, one internal block and half the kernel. */
+	int getLatencyInSmpls() const noexcept { return blockSize + (blockSize - 2) / 2; }
+
+	/** Passes the parameters on to the designer, unless they are those it already has. */
+	void setParameters(const MrFilter::Parameters& paramsNew) noexcept
+	{
+		if (isSameParameters(paramsNew, params))
+			return;
+
+		params = paramsNew;
+
+		auto& request = requests[(size_t)requestWriting];
+		request.params = params;
+		request.version = ++versionRequested;
+
+		requestWriting = requestLatest.exchange(requestWriting | NEW_SLOT, std::memory_order_acq_rel) & INDEX_MASK;
+
+		if (designer != nullptr)
+			designer->wake.signal();
+	}
+
+	const MrFilter::Parameters& getParameters() const noexcept { return params; }
+
+	/** Sets the mix of input and filtered signal, see MrDryWet. */
+	void setMix(float mix) noexcept { dryWet.setMix(mix); }
+
+	float getMix() const noexcept { return dryWet.getMix(); }
+
+	void setMixLaw(MrDryWet::Law law) noexcept { dryWet.setLaw(law); }
+
+	MrDryWet::Law getMixLaw() const noexcept { return dryWet.getLaw(); }
+
+	/** Returns true once the kernel of the last parameters set is in use, for the thread calling process(). */
+	bool isUpToDate() const noexcept { return spectra[(size_t)spectrumReading].version == versionRequested && !isFading(); }
+
+	/** Returns true while crossfading between two kernels. */
+	bool isFading() const noexcept { return isFadingFrame; }
+
+	/**
+		Designs the kernel for the parameters, numTaps long, odd. Allocates, to check the
+		kernel against others.
+	*/
+	static std::vector<float> designKernel(const MrFilter::Parameters& params, double sampleRate, int numTaps)
+	{
+		juce::SharedResourcePointer<MrDspTableCache> tableCache;
+
+		KernelDesigner kernelDesigner;
+		kernelDesigner.prepare(juce::nextPowerOfTwo(numTaps + 1), *tableCache);
+
+		std::vector<float> spectrum((size_t)kernelDesigner.frameSize + 2);
+		kernelDesigner.design(params, sampleRate, spectrum.data());
+
+		return kernelDesigner.kernel;
+	}
+
+	//==============================================================================
+	/** Not to be called concurrently with setParameters(), designs the kernel on the calling thread and starts the designer. */
+	void prepare(const juce::dsp::ProcessSpec& spec)
+	{
+		stop();
+
+		sampleRate = spec.sampleRate;
+		blockSize = blockSizeNext;
+		frameSize = 2 * blockSize;
+		fft = tableCache->getFft(juce::roundToInt(std::log2(frameSize)));
+
+		reblocker.prepare((int)spec.numChannels, blockSize);
+		chnlStates.assign((size_t)spec.numChannels, ChannelState());
+		for (auto& state : chnlStates)
+		{
+			state.previous.assign((size_t)blockSize, 0.0f);
+			state.dryTail.assign((size_t)getKernelDelayInSmpls(), 0.0f);
+		}
+
+		dryWet.prepare(sampleRate);
+
+		// the real only transforms work in place on twice the FFT size
+		frame.assign((size_t)(2 * frameSize), 0.0f);
+		frameFadingOut.assign((size_t)(2 * frameSize), 0.0f);
+		spectrumFadingOut.assign((size_t)frameSize + 2, 0.0f);
+
+		for (auto& spectrum : spectra)
+			spectrum.bins.assign((size_t)frameSize + 2, 0.0f);
+
+		requestLatest.store(0);
+		spectrumLatest.store(0);
+
+		kernelDesigner.prepare(blockSize, *tableCache);
+		kernelDesigner.design(params, sampleRate, spectra[(size_t)spectrumReading].bins.data());
+		spectra[(size_t)spectrumReading].version = versionRequested;
+
+		designer = std::make_unique<Designer>(*this);
+		designer->startThread();
+
+		reset();
+	}
+
+	void reset() noexcept
+	{
+		reblocker.reset();
+		for (auto& state : chnlStates)
+		{
+			std::fill(state.previous.begin(), state.previous.end(), 0.0f);
+			std::fill(state.dryTail.begin(), state.dryTail.end(), 0.0f);
+		}
+
+		isFadingFrame = false;
+		isSilent = true;
+	}
+
+	/** Stops the designer, kernels are then only designed by prepare(). */
+	void stop()
+	{
+		if (designer == nullptr)
+			return;
+
+		designer->signalThreadShouldExit();
+		designer->wake.signal();
+		designer->stopThread(-1);
+		designer.reset();
+	}
+
+	/** Brings a channel left out of processing up to date with another carrying the same signal. */
+	void copyChannel(int chnlFrom, int chnlTo) noexcept
+	{
+		if ((size_t)chnlFrom < chnlStates.size() && (size_t)chnlTo < chnlStates.size())
+		{
+			reblocker.copyChannel(chnlFrom, chnlTo);
+			chnlStates[(size_t)chnlTo] = chnlStates[(size_t)chnlFrom];
+		}
+	}
+
+	//==============================================================================
+	template <typename ProcessContext>
+	void process(const ProcessContext& context) noexcept
+	{
+		auto&& inBlock = context.getInputBlock();
+		auto&& outBlock = context.getOutputBlock();
+
+		jassert(inBlock.getNumChannels() <= chnlStates.size());
+
+		if (context.isBypassed)
+		{
+			if (context.usesSeparateInputAndOutputBlocks())
+				outBlock.copyFrom(inBlock);
+
+			return;
+		}
+
+		if (context.usesSeparateInputAndOutputBlocks())
+			outBlock.copyFrom(inBlock);
+
+		juce::dsp::AudioBlock<float> block(outBlock);
+		reblocker.process(block, [this](juce::dsp::AudioBlock<float>& frameBlock) { processFrame(frameBlock); });
+	}
+
+private:
+
+	static constexpr int NEW_SLOT = 4;
+	static constexpr int INDEX_MASK = 3;
+	static constexpr int WAIT_TIMEOUT_IN_MS = 100;
+
+	struct Request
+	{
+		MrFilter::Parameters params;
+		juce::uint32 version = 0;
+	};
+
+	struct Spectrum
+	{
+		std::vector<float> bins;		/* bins 0 to frameSize / 2 of the kernel, interleaved re, im */
+		juce::uint32 version = 0;
+	};
+
+	struct ChannelState
+	{
+		std::vector<float> previous;		/* the block before the one passed in, the first half of the frame */
+		std::vector<float> dryTail;			/* the last half kernel of the block before previous, the start of the dry signal lined up with the output */
+	};
+
+	/** Designs kernels on a thread of its own, with scratch space of its own, the FFT is shared. */
+	struct KernelDesigner
+	{
+		void prepare(int blockSizeToUse, MrDspTableCache& tableCache)
+		{
+			frameSize = 2 * blockSizeToUse;
+			fft = tableCache.getFft(juce::roundToInt(std::log2(frameSize)));
+			scratch.assign((size_t)(2 * frameSize), 0.0f);
+			kernel.assign((size_t)blockSizeToUse - 1, 0.0f);
+		}
+
+		/** Samples the magnitude of the cascade, makes it a windowed symmetric kernel and writes its spectrum. */
+		void design(const MrFilter::Parameters& params, double sampleRate, float* spectrum) noexcept
+		{
+			const auto coefs = MrFilter::design(params, sampleRate);
+			const int numBins = frameSize / 2 + 1;
+
+			for (int k = 0; k < numBins; ++k)
+			{
+				const double omega = 2.0 * juce::MathConstants<double>::pi * k / frameSize;
+				scratch[(size_t)(2 * k)] = (float)getMagnitude(coefs, omega);
+				scratch[(size_t)(2 * k + 1)] = 0.0f;
+			}
+
+			fft->performRealOnlyInverseTransform(scratch.data());
+
+			// the zero phase response is centred on sample 0, wrapping around
+			const int numTaps = (int)kernel.size();
+			const int centre = (numTaps - 1) / 2;
+
+			for (int i = 0; i < numTaps; ++i)
+			{
+				const double phase = 2.0 * juce::MathConstants<double>::pi * i / (numTaps - 1);
+				const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+				kernel[(size_t)i] = (float)(scratch[(size_t)((i - centre + frameSize) % frameSize)] * window);
+			}
+
+			std::fill(scratch.begin(), scratch.end(), 0.0f);
+			std::copy(kernel.begin(), kernel.end(), scratch.begin());
+
+			fft->performRealOnlyForwardTransform(scratch.data(), true);
+			std::copy(scratch.begin(), scratch.begin() + frameSize + 2, spectrum);
+		}
+
+		static double getMagnitude(const MrFilter::Coefs& coefs, double omega) noexcept
+		{
+			const std::complex<double> z1 = std::polar(1.0, -omega);
+			const std::complex<double> z2 = z1 * z1;
+			std::complex<double> h = 1.0;
+
+			for (int k = 0; k < coefs.numSections; ++k)
+				h *= ((double)coefs.b0[k] + (double)coefs.b1[k] * z1 + (double)coefs.b2[k] * z2)
+					 / (1.0 + (double)coefs.a1[k] * z1 + (double)coefs.a2[k] * z2);
+
+			return std::abs(h);
+		}
+
+		int frameSize = 0;
+		MrDspTableCache::Fft::Ptr fft;
+		std::vector<float> scratch;
+		std::vector<float> kernel;
+	};
+
+	/** Designs a kernel whenever new parameters arrive. */
+	class Designer : public juce::Thread
+	{
+	public:
+
+		explicit Designer(MrLinearPhaseFilter& filterToServe)
+			: juce::Thread("Linear phase filter designer"),
+			  filter(filterToServe)
+		{
+		}
+
+		void run() override
+		{
+			while (!threadShouldExit())
+			{
+				if ((filter.requestLatest.load(std::memory_order_relaxed) & NEW_SLOT) == 0)
+				{
+					wake.wait(WAIT_TIMEOUT_IN_MS);
+					continue;
+				}
+
+				filter.requestReading = filter.requestLatest.exchange(filter.requestReading, std::memory_order_acq_rel) & INDEX_MASK;
+				const auto& request = filter.requests[(size_t)filter.requestReading];
+
+				auto& spectrum = filter.spectra[(size_t)filter.spectrumWriting];
+				filter.kernelDesigner.design(request.params, filter.sampleRate, spectrum.bins.data());
+				spectrum.version = request.version;
+
+				filter.spectrumWriting = filter.spectrumLatest.exchange(filter.spectrumWriting | NEW_SLOT, std::memory_order_acq_rel) & INDEX_MASK;
+			}
+		}
+
+		juce::WaitableEvent wake;
+
+	private:
+
+		MrLinearPhaseFilter& filter;
+	};
+
+	//==============================================================================
+	static bool isSameParameters(const MrFilter::Parameters& a, const MrFilter::Parameters& b) noexcept
+	{
+		return a.mode == b.mode && a.slope == b.slope && a.cutOffInHz == b.cutOffInHz && a.q == b.q && a.gainInDb == b.gainInDb;
+	}
+
+	/** Takes over the latest kernel, keeping a copy of the one in use to fade from. */
+	bool pickUpSpectrum() noexcept
+	{
+		if ((spectrumLatest.load(std::memory_order_relaxed) & NEW_SLOT) == 0)
+			return false;
+
+		const auto& bins = spectra[(size_t)spectrumReading].bins;
+		std::copy(bins.begin(), bins.end(), spectrumFadingOut.begin());
+
+		spectrumReading = spectrumLatest.exchange(spectrumReading, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	/** Returns the delay of the kernel alone, half its size, by which the dry signal is delayed within a frame. */
+	int getKernelDelayInSmpls() const noexcept { return (blockSize - 2) / 2; }
+
+	/**
+		Convolves the last two blocks of each channel with the kernel, the second half of the
+		circular convolution being free of wrap around. A new kernel fades in over the block.
+	*/
+	void processFrame(juce::dsp::AudioBlock<float>& frameBlock) noexcept
+	{
+		isFadingFrame = pickUpSpectrum() && !isSilent;
+		isSilent = false;
+
+		const float* bins = spectra[(size_t)spectrumReading].bins.data();
+
+		const bool isMixed = !dryWet.isWetOnly();
+		const auto ramp = dryWet.advance(blockSize);
+		const int kernelDelay = getKernelDelayInSmpls();
+
+		for (size_t c = 0; c < frameBlock.getNumChannels(); ++c)
+		{
+			auto& state = chnlStates[c];
+			auto* samples = frameBlock.getChannelPointer(c);
+
+			// the block passed in becomes the one before
+			std::copy(state.previous.end() - kernelDelay, state.previous.end(), state.dryTail.begin());
+			std::copy(state.previous.begin(), state.previous.end(), frame.begin());
+			std::copy(samples, samples + blockSize, frame.begin() + blockSize);
+			std::copy(samples, samples + blockSize, state.previous.begin());
+
+			fft->performRealOnlyForwardTransform(frame.data(), true);
+
+			if (isFadingFrame)
+			{
+				std::copy(frame.begin(), frame.begin() + frameSize + 2, frameFadingOut.begin());
+				convolve(frameFadingOut.data(), spectrumFadingOut.data());
+			}
+
+			convolve(frame.data(), bins);
+
+			const float* wet = frame.data() + blockSize;
+			const float* wetFadingOut = frameFadingOut.data() + blockSize;
+
+			if (isFadingFrame)
+			{
+				for (int i = 0; i < blockSize; ++i)
+				{
+					const float gain = (float)(i + 1) / (float)blockSize;
+					samples[i] = wetFadingOut[i] * (1.0f - gain) + wet[i] * gain;
+				}
+
+				wet = samples;
+			}
+
+			if (isMixed)
+			{
+				// the dry signal lined up with the output, the tail of the block before and then the block passed in
+				MrDryWet::mix(samples, state.dryTail.data(), wet, kernelDelay, ramp);
+				MrDryWet::mix(samples + kernelDelay, state.previous.data(), wet + kernelDelay, blockSize - kernelDelay, ramp.getSlice(kernelDelay));
+			}
+			else if (!isFadingFrame)
+			{
+				std::copy(wet, wet + blockSize, samples);
+			}
+		}
+	}
+
+	/** Multiplies the non negative bins of a frame with those of the kernel and transforms it back. */
+	void convolve(float* bins, const float* kernelBins) const noexcept
+	{
+		const int numBins = frameSize / 2 + 1;
+
+		for (int k = 0; k < numBins; ++k)
+		{
+			const float re = bins[2 * k];
+			const float im = bins[2 * k + 1];
+			const float kernelRe = kernelBins[2 * k];
+			const float kernelIm = kernelBins[2 * k + 1];
+
+			bins[2 * k] = re * kernelRe - im * kernelIm;
+			bins[2 * k + 1] = re * kernelIm + im * kernelRe;
+		}
+
+		fft->performRealOnlyInverseTransform(bins);
+	}
+
+	//==============================================================================
+	double sampleRate{ 48000 };
+	MrFilter::Parameters params;
+	juce::uint32 versionRequested{ 0 };
+
+	int blockSizeNext{ KERNEL_SIZE_DEFAULT + 1 };
+	int blockSize{ KERNEL_SIZE_DEFAULT + 1 };
+	int frameSize{ 2 * (KERNEL_SIZE_DEFAULT + 1) };
+	juce::SharedResourcePointer<MrDspTableCache> tableCache;
+	MrDspTableCache::Fft::Ptr fft;		/* shared by all filters of the same kernel size in the process */
+
+	MrReblocker reblocker;
+	std::vector<ChannelState> chnlStates;
+	std::vector<float> frame;
+	std::vector<float> frameFadingOut;
+	std::vector<float> spectrumFadingOut;
+	bool isFadingFrame{ false };
+	bool isSilent{ true };		/* no block since the state was cleared, nothing to fade from */
+	MrDryWet dryWet;
+
+	/* triple buffers, the parameters from the caller to the designer and the kernels back */
+	std::array<Request, 3> requests{};
+	std::atomic<int> requestLatest{ 0 };
+	int requestWriting{ 1 };
+	int requestReading{ 2 };
+
+	std::array<Spectrum, 3> spectra{};
+	std::atomic<int> spectrumLatest{ 0 };
+	int spectrumWriting{ 1 };
+	int spectrumReading{ 2 };
+
+	KernelDesigner kernelDesigner;
+	std::unique_ptr<Designer> designer;
+};
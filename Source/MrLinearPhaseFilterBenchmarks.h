@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrLinearPhaseFilter.h"
+#include "MrSignal.h"
+
+class MrLinearPhaseFilterBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrLinearPhaseFilterBenchmarks() : juce::UnitTest("MrLinearPhaseFilter benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        beginTest("Cost per kernel size, FFT overlap-save vs. direct form FIR");
+        {
+            const int numChnls = 2;
+            const int blockSize = 512;
+            const int numSamples = 8192;        // a whole number of internal blocks, whose cost falls on every n-th host block
+            const int numRuns = 50;
+            const double sampleRate = 48000;
+            const int kernelSizes[] = { 63, 127, 255, 511, 1023, 2047, 4095 };
+
+            juce::AudioBuffer<float> buffer(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+
+            juce::dsp::ProcessSpec spec;
+            spec.numChannels = (juce::uint32)numChnls;
+            spec.sampleRate = sampleRate;
+            spec.maximumBlockSize = (juce::uint32)blockSize;
+
+            MrFilter::Parameters params;
+            params.cutOffInHz = 2000.0f;
+            params.q = 0.7071f;
+
+            for (auto kernelSize : kernelSizes)
+            {
+                MrLinearPhaseFilter filter;
+                filter.setKernelSize(kernelSize);
+                filter.setParameters(params);
+                filter.prepare(spec);
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        for (int offset = 0; offset < numSamples; offset += blockSize)
+                        {
+                            auto subBlock = block.getSubBlock((size_t)offset, (size_t)blockSize);
+                            filter.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+                        }
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format("overlap-save, " + juce::String(kernelSize) + " taps", result, numSamples));
+
+                DirectForm directForm(MrLinearPhaseFilter::designKernel(params, sampleRate, kernelSize), numChnls);
+
+                result = MrBenchmark::run([&]
+                    {
+                        for (int offset = 0; offset < numSamples; offset += blockSize)
+                        {
+                            auto subBlock = block.getSubBlock((size_t)offset, (size_t)blockSize);
+                            directForm.process(subBlock);
+                        }
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format("direct form, " + juce::String(kernelSize) + " taps", result, numSamples));
+            }
+        }
+    }
+
+private:
+
+    /** The same kernel as a plain FIR, the history kept twice in a row so each output is one dot product. */
+    struct DirectForm
+    {
+        DirectForm(std::vector<float> kernelToUse, int numChnls)
+            : kernel(std::move(kernelToUse)),
+              histories((size_t)numChnls, std::vector<float>(2 * kernel.size(), 0.0f))
+        {
+        }
+
+        void process(juce::dsp::AudioBlock<float>& block)
+        {
+            const int numTaps = (int)kernel.size();
+            int posChannel = pos;
+
+            for (size_t c = 0; c < block.getNumChannels(); ++c)
+            {
+                auto* samples = block.getChannelPointer(c);
+                auto* history = histories[c].data();
+                posChannel = pos;
+
+                for (size_t i = 0; i < block.getNumSamples(); ++i)
+                {
+                    posChannel = (posChannel == 0) ? numTaps - 1 : posChannel - 1;
+                    history[posChannel] = history[posChannel + numTaps] = samples[i];
+
+                    float sum = 0.0f;
+                    for (int k = 0; k < numTaps; ++k)
+                        sum += kernel[(size_t)k] * history[posChannel + k];
+
+                    samples[i] = sum;
+                }
+            }
+
+            pos = posChannel;
+        }
+
+        std::vector<float> kernel;
+        std::vector<std::vector<float>> histories;
+        int pos = 0;
+    };
+};
+
+static MrLinearPhaseFilterBenchmarks linearPhaseFilterBenchmarks;
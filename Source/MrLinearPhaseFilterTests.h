@@ -0,0 +1,419 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrLinearPhaseFilter.h"
+
+class MrLinearPhaseFilterTests : public juce::UnitTest
+{
+public:
+
+    MrLinearPhaseFilterTests() : juce::UnitTest("MrLinearPhaseFilter testing") {}
+
+    void runTest() override
+    {
+        using Mode = MrFilter::Mode;
+        using Slope = MrFilter::Slope;
+
+        beginTest("When filtering an impulse then the response is the kernel, symmetric around the latency reported.");
+        {
+            /// prepare...
+            const int kernelSize = 255;
+            const int blockSize = 100;
+            const double sampleRate = 48000;
+            const auto params = createParameters(Mode::lowPass, Slope::db24, 2000.0f);
+            const auto deltaExpected = 0.00001f;
+
+            MrLinearPhaseFilter filter;
+            filter.setKernelSize(kernelSize);
+            filter.setParameters(params);
+            filter.prepare(createSpec(1, blockSize, sampleRate));
+
+            const int latency = filter.getLatencyInSmpls();
+            const int internalBlockSize = kernelSize + 1;
+            const int numSamples = 2 * latency + blockSize;
+
+            juce::AudioBuffer<float> buffer(1, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::impulse(block, 1.0f);
+
+            /// execute...
+            process(filter, block, blockSize);
+            const auto kernel = MrLinearPhaseFilter::designKernel(params, sampleRate, kernelSize);
+
+            /// evaluate...
+            expectEquals(latency, internalBlockSize + (kernelSize - 1) / 2);
+
+            float errorMax = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int tap = i - internalBlockSize;
+                const float expected = (tap >= 0 && tap < kernelSize) ? kernel[(size_t)tap] : 0.0f;
+                errorMax = std::max(errorMax, std::abs(buffer.getSample(0, i) - expected));
+            }
+
+            expect(errorMax < deltaExpected, "error " + juce::String(errorMax));
+
+            for (int k = 1; k < kernelSize / 2; ++k)
+                expect(std::abs(buffer.getSample(0, latency - k) - buffer.getSample(0, latency + k)) < deltaExpected);
+
+            int peak = 0;
+            for (int i = 0; i < numSamples; ++i)
+                if (std::abs(buffer.getSample(0, i)) > std::abs(buffer.getSample(0, peak)))
+                    peak = i;
+
+            expectEquals(peak, latency);
+        }
+
+        beginTest("When the kernel is designed then its magnitude follows the one of MrFilter.");
+        {
+            const int kernelSize = MrLinearPhaseFilter::KERNEL_SIZE_DEFAULT;
+            const double sampleRate = 48000;
+            const double frequenciesInHz[] = { 50.0, 200.0, 500.0, 800.0, 1000.0, 1300.0, 2000.0, 5000.0, 15000.0 };
+            const auto deltaInDbExpected = 1.0;
+
+            const MrFilter::Parameters paramsToCheck[] =
+            {
+                createParameters(Mode::lowPass, Slope::db48, 1000.0f),
+                createParameters(Mode::highPass, Slope::db24, 1000.0f),
+                createParameters(Mode::peak, Slope::db12, 1000.0f, 2.0f, 9.0f)
+            };
+
+            for (auto& params : paramsToCheck)
+            {
+                /// execute...
+                const auto kernel = MrLinearPhaseFilter::designKernel(params, sampleRate, kernelSize);
+                const auto coefs = MrFilter::design(params, sampleRate);
+
+                /// evaluate...
+                for (auto frequencyInHz : frequenciesInHz)
+                {
+                    const double omega = 2.0 * juce::MathConstants<double>::pi * frequencyInHz / sampleRate;
+                    const double expectedInDb = juce::Decibels::gainToDecibels(getMagnitude(coefs, omega), -200.0);
+                    const double actualInDb = juce::Decibels::gainToDecibels(getMagnitude(kernel, omega), -200.0);
+
+                    // deep in the stop band only the attenuation counts
+                    if (expectedInDb < -40.0)
+                        expect(actualInDb < -40.0, juce::String(frequencyInHz) + " Hz, " + juce::String(actualInDb) + " dB");
+                    else
+                        expect(std::abs(actualInDb - expectedInDb) < deltaInDbExpected,
+                               juce::String(frequencyInHz) + " Hz, " + juce::String(actualInDb) + " dB vs. " + juce::String(expectedInDb) + " dB");
+                }
+            }
+        }
+
+        beginTest("When the host block size varies then the output equals the direct convolution with the kernel.");
+        {
+            const int kernelSize = 127;
+            const int numSamples = 3000;
+            const double sampleRate = 48000;
+            const int blockSizes[] = { 1, 7, 64, 128, 1000, numSamples };
+            const auto params = createParameters(Mode::bandPass, Slope::db24, 3000.0f, 2.0f);
+            const auto deltaExpected = 0.0001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferInput(2, numSamples);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+            MrSignal::whiteNoise(blockInput, 0.5f);
+
+            const auto kernel = MrLinearPhaseFilter::designKernel(params, sampleRate, kernelSize);
+            const int internalBlockSize = kernelSize + 1;
+
+            for (auto blockSize : blockSizes)
+            {
+                juce::AudioBuffer<float> buffer;
+                buffer.makeCopyOf(bufferInput);
+                juce::dsp::AudioBlock<float> block(buffer);
+
+                MrLinearPhaseFilter filter;
+                filter.setKernelSize(kernelSize);
+                filter.setParameters(params);
+                filter.prepare(createSpec(2, blockSize, sampleRate));
+
+                /// execute...
+                process(filter, block, blockSize);
+
+                /// evaluate...
+                float errorMax = 0.0f;
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        double expected = 0.0;
+                        for (int tap = 0; tap < kernelSize; ++tap)
+                        {
+                            const int j = i - internalBlockSize - tap;
+                            if (j >= 0)
+                                expected += kernel[(size_t)tap] * bufferInput.getSample(channel, j);
+                        }
+
+                        errorMax = std::max(errorMax, std::abs(buffer.getSample(channel, i) - (float)expected));
+                    }
+                }
+
+                expect(errorMax < deltaExpected, "block size " + juce::String(blockSize) + ", error " + juce::String(errorMax));
+            }
+        }
+
+        beginTest("When the parameters change then the new kernel is designed off the audio thread and faded in without a step.");
+        {
+            /// prepare...
+            const int kernelSize = 1023;
+            const int blockSize = 64;
+            const double sampleRate = 48000;
+            const double frequencyInHz = 100.0;
+            const float amplitude = 0.5f;
+            const int numBlocksSettling = 1000;
+            const int numBlocksLevel = 10;
+            const auto timeOutInMs = 5000.0;
+
+            MrLinearPhaseFilter filter;
+            filter.setKernelSize(kernelSize);
+            filter.setParameters(createParameters(Mode::lowPass, Slope::db48, 1000.0f));
+            filter.prepare(createSpec(1, blockSize, sampleRate));
+
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            juce::int64 pos = 0;
+
+            auto processSine = [&]
+            {
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(0, i, amplitude * (float)std::sin(2.0 * juce::MathConstants<double>::pi * frequencyInHz * (double)(pos + i) / sampleRate));
+
+                pos += blockSize;
+
+                juce::dsp::AudioBlock<float> block(buffer);
+                filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+            };
+
+            // over more than a period of the sine
+            float levelBefore = 0.0f;
+            for (int b = 0; b < numBlocksSettling; ++b)
+            {
+                processSine();
+                if (b >= numBlocksSettling - numBlocksLevel)
+                    levelBefore = std::max(levelBefore, buffer.getMagnitude(0, 0, blockSize));
+            }
+
+            float last = buffer.getSample(0, blockSize - 1);
+
+            /// execute...
+            filter.setParameters(createParameters(Mode::highPass, Slope::db48, 1000.0f));
+
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            float stepMax = 0.0f;
+            bool wasFading = false;
+
+            auto processAndMeasure = [&]
+            {
+                processSine();
+                wasFading = wasFading || filter.isFading();
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    stepMax = std::max(stepMax, std::abs(buffer.getSample(0, i) - last));
+                    last = buffer.getSample(0, i);
+                }
+            };
+
+            while (!filter.isUpToDate() && juce::Time::getMillisecondCounterHiRes() - start < timeOutInMs)
+            {
+                processAndMeasure();
+                juce::Thread::sleep(1);
+            }
+
+            float levelAfter = 0.0f;
+            const int numBlocksAfter = 2 * filter.getLatencyInSmpls() / blockSize + numBlocksLevel;
+            for (int b = 0; b < numBlocksAfter; ++b)
+            {
+                processAndMeasure();
+                if (b >= numBlocksAfter - numBlocksLevel)
+                    levelAfter = std::max(levelAfter, buffer.getMagnitude(0, 0, blockSize));
+            }
+
+            /// evaluate...
+            const float stepSine = amplitude * (float)(2.0 * juce::MathConstants<double>::pi * frequencyInHz / sampleRate);
+
+            expect(filter.isUpToDate());
+            expect(wasFading);
+            expect(levelBefore > 0.9f * amplitude, "before " + juce::String(levelBefore));
+            expect(levelAfter < 0.01f * amplitude, "after " + juce::String(levelAfter));
+            expect(stepMax < 2.0f * stepSine, "step " + juce::String(stepMax));
+        }
+
+        beginTest("When the mix is set then the input is delayed by the latency reported and mixed with the filtered signal.");
+        {
+            /// prepare...
+            const int kernelSize = 255;
+            const int blockSize = 100;
+            const double sampleRate = 48000;
+            const float mix = 0.3f;
+            const auto params = createParameters(Mode::lowPass, Slope::db24, 2000.0f);
+            const auto deltaExpected = 0.00001f;
+
+            // set before prepare, so the gains start at the mix and do not ramp
+            MrLinearPhaseFilter filter;
+            filter.setKernelSize(kernelSize);
+            filter.setParameters(params);
+            filter.setMix(mix);
+            filter.setMixLaw(MrDryWet::Law::linear);
+            filter.prepare(createSpec(1, blockSize, sampleRate));
+
+            const int latency = filter.getLatencyInSmpls();
+            const int internalBlockSize = kernelSize + 1;
+            const int numSamples = 2 * latency + blockSize;
+
+            juce::AudioBuffer<float> buffer(1, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::impulse(block, 1.0f);
+
+            /// execute...
+            process(filter, block, blockSize);
+            const auto kernel = MrLinearPhaseFilter::designKernel(params, sampleRate, kernelSize);
+
+            /// evaluate...
+            float errorMax = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int tap = i - internalBlockSize;
+                const float wet = (tap >= 0 && tap < kernelSize) ? kernel[(size_t)tap] : 0.0f;
+                const float dry = (i == latency) ? 1.0f : 0.0f;
+                errorMax = std::max(errorMax, std::abs(buffer.getSample(0, i) - ((1.0f - mix) * dry + mix * wet)));
+            }
+
+            expect(errorMax < deltaExpected, "error " + juce::String(errorMax));
+        }
+
+        beginTest("When copying a channel then it continues like the channel copied.");
+        {
+            /// prepare...
+            const int kernelSize = 63;
+            const int numSamples = 1000;
+            const double sampleRate = 48000;
+
+            MrLinearPhaseFilter filter;
+            filter.setKernelSize(kernelSize);
+            filter.prepare(createSpec(2, numSamples, sampleRate));
+
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block.getSingleChannelBlock(0), 0.5f);
+
+            auto first = block.getSubBlock(0, numSamples / 2).getSingleChannelBlock(0);
+            auto second = block.getSubBlock(numSamples / 2, numSamples / 2);
+            second.getSingleChannelBlock(1).copyFrom(second.getSingleChannelBlock(0));
+
+            /// execute...
+            filter.process(juce::dsp::ProcessContextReplacing<float>(first));
+            filter.copyChannel(0, 1);
+            filter.process(juce::dsp::ProcessContextReplacing<float>(second));
+
+            /// evaluate...
+            for (int i = 0; i < numSamples / 2; ++i)
+                expectEquals(second.getSample(1, i), second.getSample(0, i));
+        }
+
+        beginTest("When two filters of the same kernel size are prepared then they share one FFT and filter alike.");
+        {
+            /// prepare...
+            const int kernelSize = 511;
+            const int numSamples = 2000;
+            const double sampleRate = 48000;
+            const auto params = createParameters(Mode::highPass, Slope::db12, 300.0f);
+
+            // the FFT of twice the internal block size, held here and by the cache
+            juce::SharedResourcePointer<MrDspTableCache> tableCache;
+            auto fft = tableCache->getFft(juce::roundToInt(std::log2(2 * (kernelSize + 1))));
+            const auto numFftsBefore = tableCache->getNumFfts();
+
+            MrLinearPhaseFilter filter1;
+            MrLinearPhaseFilter filter2;
+
+            juce::AudioBuffer<float> buffer1(1, numSamples);
+            juce::dsp::AudioBlock<float> block1(buffer1);
+            MrSignal::whiteNoise(block1, 0.5f);
+
+            juce::AudioBuffer<float> buffer2(buffer1);
+            juce::dsp::AudioBlock<float> block2(buffer2);
+
+            /// execute...
+            for (auto* filter : { &filter1, &filter2 })
+            {
+                filter->setKernelSize(kernelSize);
+                filter->setParameters(params);
+                filter->prepare(createSpec(1, numSamples, sampleRate));
+            }
+
+            process(filter1, block1, numSamples);
+            process(filter2, block2, numSamples);
+
+            /// evaluate...
+            expectEquals(tableCache->getNumFfts(), numFftsBefore);
+            expectEquals(fft->getReferenceCount(), 2 + 2 * 2, "both filters and their designers hold it");
+
+            for (int i = 0; i < numSamples; ++i)
+                expectEquals(buffer2.getSample(0, i), buffer1.getSample(0, i));
+        }
+    }
+
+private:
+
+    static void process(MrLinearPhaseFilter& filter, juce::dsp::AudioBlock<float>& block, int blockSize)
+    {
+        const size_t numSamples = block.getNumSamples();
+
+        for (size_t offset = 0; offset < numSamples; offset += (size_t)blockSize)
+        {
+            auto subBlock = block.getSubBlock(offset, std::min((size_t)blockSize, numSamples - offset));
+            filter.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+        }
+    }
+
+    static double getMagnitude(const MrFilter::Coefs& coefs, double omega)
+    {
+        const std::complex<double> z1 = std::polar(1.0, -omega);
+        const std::complex<double> z2 = z1 * z1;
+        std::complex<double> h = 1.0;
+
+        for (int k = 0; k < coefs.numSections; ++k)
+            h *= ((double)coefs.b0[k] + (double)coefs.b1[k] * z1 + (double)coefs.b2[k] * z2)
+                 / (1.0 + (double)coefs.a1[k] * z1 + (double)coefs.a2[k] * z2);
+
+        return std::abs(h);
+    }
+
+    static double getMagnitude(const std::vector<float>& kernel, double omega)
+    {
+        std::complex<double> h = 0.0;
+
+        for (size_t n = 0; n < kernel.size(); ++n)
+            h += (double)kernel[n] * std::polar(1.0, -omega * (double)n);
+
+        return std::abs(h);
+    }
+
+    static MrFilter::Parameters createParameters(MrFilter::Mode mode, MrFilter::Slope slope, float cutOffInHz, float q = 0.7071f, float gainInDb = 0.0f)
+    {
+        MrFilter::Parameters params;
+        params.mode = mode;
+        params.slope = slope;
+        params.cutOffInHz = cutOffInHz;
+        params.q = q;
+        params.gainInDb = gainInDb;
+        return params;
+    }
+
+    static juce::dsp::ProcessSpec createSpec(int numChnls, int blockSize, double sampleRate)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.numChannels = (juce::uint32)numChnls;
+        spec.sampleRate = sampleRate;
+        spec.maximumBlockSize = (juce::uint32)blockSize;
+        return spec;
+    }
+};
+
+static MrLinearPhaseFilterTests linearPhaseFilterTests;
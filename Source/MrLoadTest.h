@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrCacheLine.h"
+
+/**
+	Drives many instances from several threads the way a DAW does, to measure how the
+	processing scales with the number of instances and cores.
+
+	Every callback, the instances are handed out to the threads through a shared index
+	until all are processed, and the callback ends when the last one is done. The calling
+	thread takes part like a DAW's audio thread, the others are helper threads spinning
+	for work. Callbacks follow each other without pause, so the result is the capacity of
+	the machine rather than the load at a given block rate.
+*/
+class MrLoadTest
+{
+public:
+
+	struct Settings
+	{
+		int numThreads = 0;					/**< 0 uses one thread per core */
+		int numCallbacks = 1000;
+		double secondsPerCallback = 0.0;	/**< deadline of a callback, 0 for none */
+	};
+
+	struct Result
+	{
+		int numInstances = 0;
+		int numThreads = 0;
+		int numCallbacks = 0;
+
+		double secondsTotal = 0.0;
+		double callbacksPerSecond = 0.0;
+
+		double median = 0.0;	/**< seconds per callback */
+		double p99 = 0.0;		/**< seconds per callback */
+		double p999 = 0.0;		/**< seconds per callback */
+		double max = 0.0;		/**< seconds per callback */
+		int numDeadlineMisses = 0;
+
+		double scalingEfficiency = 1.0;	/**< callbacks per second per thread, relative to one thread */
+	};
+
+	/** Processes the instance with the given index for one callback. */
+	using ProcessFn = std::function<void(int instanceIdx)>;
+
+	//==============================================================================
+	static Result run(int numInstances, const ProcessFn& process, const Settings& settings)
+	{
+		const int numThreads = std::max(1, settings.numThreads > 0 ? settings.numThreads : juce::SystemStats::getNumCpus());
+
+		Engine engine(numInstances, process);
+
+		std::vector<std::unique_ptr<Helper>> helpers;
+		for (int t = 1; t < numThreads; ++t)
+			helpers.push_back(std::make_unique<Helper>(engine));
+
+		for (auto& helper : helpers)
+			helper->startThread(juce::Thread::realtimeAudioPriority);
+
+		std::vector<double> times((size_t)std::max(1, settings.numCallbacks));
+
+		const auto start = juce::Time::getHighResolutionTicks();
+
+		for (auto& time : times)
+		{
+			const auto startCallback = juce::Time::getHighResolutionTicks();
+			engine.runCallback();
+			time = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startCallback);
+		}
+
+		Result result;
+		result.secondsTotal = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+		engine.quit();
+
+		for (auto& helper : helpers)
+			helper->stopThread(-1);
+
+		result.numInstances = numInstances;
+		result.numThreads = numThreads;
+		result.numCallbacks = (int)times.size();
+		result.callbacksPerSecond = result.numCallbacks / std::max(result.secondsTotal, 1.0e-12);
+
+		if (settings.secondsPerCallback > 0.0)
+			result.numDeadlineMisses = (int)std::count_if(times.begin(), times.end(), [&](double time) { return time > settings.secondsPerCallback; });
+
+		std::sort(times.begin(), times.end());
+
+		auto percentile = [&](size_t perMille) { return times[std::min(times.size() - 1, (times.size() * perMille) / 1000)]; };
+
+		result.median = percentile(500);
+		result.p99 = percentile(990);
+		result.p999 = percentile(999);
+		result.max = times.back();
+
+		return result;
+	}
+
+	/** Runs the load for each number of threads, the scaling efficiency is relative to the first run. */
+	static std::vector<Result> runScaling(int numInstances, const ProcessFn& process, Settings settings, const std::vector<int>& numThreadsToRun)
+	{
+		std::vector<Result> results;
+
+		for (auto numThreads : numThreadsToRun)
+		{
+			settings.numThreads = numThreads;
+			results.push_back(run(numInstances, process, settings));
+
+			auto& first = results.front();
+			auto& last = results.back();
+			last.scalingEfficiency = (last.callbacksPerSecond / last.numThreads) / (first.callbacksPerSecond / first.numThreads);
+		}
+
+		return results;
+	}
+
+	/** Returns 1, 2, 4, ... up to the number of cores, and the number of cores itself. */
+	static std::vector<int> getThreadCountsUpToCores()
+	{
+		std::vector<int> numThreads;
+		const int numCpus = juce::SystemStats::getNumCpus();
+
+		for (int n = 1; n < numCpus; n *= 2)
+			numThreads.push_back(n);
+
+		numThreads.push_back(numCpus);
+
+		return numThreads;
+	}
+
+private:
+
+	/** The state of the callback all threads share. */
+	class Engine
+	{
+	public:
+
+		Engine(int numInstancesToRun, const ProcessFn& processToRun) : numInstances(numInstancesToRun), process(processToRun) {}
+
+		/** Starts a callback, takes part in it and returns when all instances are processed. */
+		void runCallback()
+		{
+			// a helper still in the last callback may pick up an instance as soon as the index
+			// is reset, so the count of done ones has to be reset before
+			numDone.store(0);
+			nextInstance.store(0);
+			generation.fetch_add(1);
+
+			work();
+
+			while (numDone.load() < numInstances)
+				std::this_thread::yield();
+		}
+
+		/** Waits for the next callback and takes part in it, returns false once quit() was called. */
+		bool runHelper(int& generationSeen)
+		{
+			int current = generation.load();
+
+			while (current == generationSeen)
+			{
+				if (isQuitting.load())
+					return false;
+
+				std::this_thread::yield();
+				current = generation.load();
+			}
+
+			generationSeen = current;
+			work();
+
+			return true;
+		}
+
+		void quit()
+		{
+			isQuitting.store(true);
+		}
+
+	private:
+
+		void work()
+		{
+			int numProcessed = 0;
+
+			for (int idx = nextInstance.fetch_add(1); idx < numInstances; idx = nextInstance.fetch_add(1))
+			{
+				process(idx);
+				++numProcessed;
+			}
+
+			if (numProcessed > 0)
+				numDone.fetch_add(numProcessed);
+		}
+
+		const int numInstances;
+		const ProcessFn& process;
+
+		/* each on a cache line of its own, all threads hammer them */
+		alignas(MrCacheLine::SIZE) std::atomic<int> generation{ 0 };
+		alignas(MrCacheLine::SIZE) std::atomic<int> nextInstance{ 0 };
+		alignas(MrCacheLine::SIZE) std::atomic<int> numDone{ 0 };
+		alignas(MrCacheLine::SIZE) std::atomic<bool> isQuitting{ false };
+	};
+
+	class Helper : public juce::Thread
+	{
+	public:
+
+		explicit Helper(Engine& engineToHelp) : juce::Thread("Load test helper"), engine(engineToHelp) {}
+
+		void run() override
+		{
+			int generationSeen = 0;
+
+			while (!threadShouldExit() && engine.runHelper(generationSeen)) {}
+		}
+
+	private:
+
+		Engine& engine;
+	};
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrLoadTest.h"
+
+class MrLoadTestTests : public juce::UnitTest
+{
+public:
+
+    MrLoadTestTests() : juce::UnitTest("MrLoadTest testing") {}
+
+    void runTest() override
+    {
+        beginTest("When running a load then every instance is processed once per callback.");
+        {
+            /// prepare...
+            const int numInstances = 50;
+
+            MrLoadTest::Settings settings;
+            settings.numThreads = 3;
+            settings.numCallbacks = 200;
+
+            std::vector<int> numProcessed(numInstances, 0);
+            std::atomic<int> numProcessedInTotal{ 0 };
+
+            auto process = [&](int instanceIdx)
+            {
+                ++numProcessed[(size_t)instanceIdx];
+                ++numProcessedInTotal;
+            };
+
+            /// execute...
+            auto result = MrLoadTest::run(numInstances, process, settings);
+
+            /// evaluate...
+            expectEquals(result.numThreads, 3);
+            expectEquals(result.numCallbacks, settings.numCallbacks);
+            expectEquals(numProcessedInTotal.load(), numInstances * settings.numCallbacks);
+
+            for (auto n : numProcessed)
+                expectEquals(n, settings.numCallbacks);
+
+            expect(result.median <= result.p99 && result.p99 <= result.p999 && result.p999 <= result.max);
+            expectEquals(result.numDeadlineMisses, 0);
+        }
+
+        beginTest("When callbacks take longer than the deadline then they are counted as missed.");
+        {
+            /// prepare...
+            MrLoadTest::Settings settings;
+            settings.numThreads = 2;
+            settings.numCallbacks = 20;
+            settings.secondsPerCallback = 1.0e-4;
+
+            /// execute...
+            auto result = MrLoadTest::run(4, [](int) { juce::Thread::sleep(1); }, settings);
+
+            /// evaluate...
+            expectEquals(result.numDeadlineMisses, settings.numCallbacks);
+        }
+    }
+};
+
+static MrLoadTestTests loadTestTests;
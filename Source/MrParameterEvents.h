@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include <JuceHeader.h>
+
+/**
+	Fixed capacity list of parameter changes within one block, each tagged
+	with the sample at which it has to be applied, and the splitting of the
+	block at those samples. The offsets are the caller's, this only splits.
+
+	Collecting and splitting never allocates, so it is safe on the audio thread.
+*/
+class MrParameterEvents
+{
+public:
+
+	static constexpr int MAX_EVENTS = 256;
+
+	/** Sub blocks are never shorter than this, later events are moved to the next boundary. */
+	static constexpr int MIN_SUB_BLOCK_SIZE = 32;
+
+	struct Event
+	{
+		int sampleOffset;
+		int paramIdx;
+		float value;
+	};
+
+	//==============================================================================
+	/**
+		Adds an event, returns false if the list is full and the event was dropped. The list
+		is kept sorted by offset in place, an event goes after those of the same offset.
+	*/
+	bool add(int sampleOffset, int paramIdx, float value) noexcept
+	{
+		if (numEvents >= MAX_EVENTS)
+			return false;
+
+		const int offset = std::max(0, sampleOffset);
+
+		int idx = numEvents++;
+		for (; idx > 0 && events[(size_t)idx - 1].sampleOffset > offset; --idx)
+			events[(size_t)idx] = events[(size_t)idx - 1];
+
+		events[(size_t)idx] = { offset, paramIdx, value };
+		return true;
+	}
+
+	void clear() noexcept { numEvents = 0; }
+
+	int size() const noexcept { return numEvents; }
+
+	const Event& operator[](int idx) const noexcept { return events[(size_t)idx]; }
+
+	//==============================================================================
+	/**
+		Walks [0, numSamples) applying every event at its sample offset and processing the
+		samples in between, i.e. applyFn(event) and processFn(startSample, numSamplesSub).
+		Events keep their order for equal offsets. Sub blocks are at least minSubBlockSize
+		samples long (except the last one), which bounds the splitting overhead.
+		Clears the list afterwards.
+	*/
+	template <typename ApplyFn, typename ProcessFn>
+	void process(int numSamples, ApplyFn&& applyFn, ProcessFn&& processFn, int minSubBlockSize = MIN_SUB_BLOCK_SIZE)
+	{
+		int start = 0;
+		int idx = 0;
+
+		do
+		{
+			while (idx < numEvents && events[(size_t)idx].sampleOffset <= start)
+				applyFn(events[(size_t)idx++]);
+
+			int end = numSamples;
+			if (idx < numEvents)
+				end = std::min(numSamples, std::max(events[(size_t)idx].sampleOffset, start + minSubBlockSize));
+
+			if (end > start)
+				processFn(start, end - start);
+
+			start = end;
+
+		} while (start < numSamples);
+
+		while (idx < numEvents)
+			applyFn(events[(size_t)idx++]);
+
+		clear();
+	}
+
+private:
+
+	std::array<Event, MAX_EVENTS> events;
+	int numEvents{ 0 };
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrParameterEvents.h"
+
+class MrParameterEventsTests : public juce::UnitTest
+{
+public:
+
+    MrParameterEventsTests() : juce::UnitTest("MrParameterEvents testing") {}
+
+    void runTest() override
+    {
+        beginTest("When there are no events then the whole block is processed at once.");
+        {
+            std::vector<std::pair<int, int>> subBlocks;
+            MrParameterEvents events;
+
+            /// execute...
+            events.process(512,
+                [](const MrParameterEvents::Event&) {},
+                [&](int start, int num) { subBlocks.push_back({ start, num }); });
+
+            /// evaluate...
+            expect(subBlocks.size() == 1);
+            expect(subBlocks[0].first == 0 && subBlocks[0].second == 512);
+        }
+
+        beginTest("When events are added then the block is split at their sample offsets.");
+        {
+            std::vector<std::pair<int, int>> subBlocks;
+            std::vector<int> appliedAt;
+            int processed = 0;
+            MrParameterEvents events;
+
+            events.add(300, 1, 0.3f);
+            events.add(100, 0, 0.1f);
+            events.add(0, 2, 0.0f);
+
+            /// execute...
+            events.process(512,
+                [&](const MrParameterEvents::Event&) { appliedAt.push_back(processed); },
+                [&](int start, int num) { subBlocks.push_back({ start, num }); processed += num; });
+
+            /// evaluate...
+            expect(subBlocks.size() == 3);
+            expect(subBlocks[0].first == 0 && subBlocks[0].second == 100);
+            expect(subBlocks[1].first == 100 && subBlocks[1].second == 200);
+            expect(subBlocks[2].first == 300 && subBlocks[2].second == 212);
+
+            expect(appliedAt.size() == 3);
+            expect(appliedAt[0] == 0 && appliedAt[1] == 100 && appliedAt[2] == 300);
+            expect(events.size() == 0);
+        }
+
+        beginTest("When events of the same offset are added out of order then they keep the order they were added in.");
+        {
+            std::vector<float> applied;
+            MrParameterEvents events;
+
+            events.add(200, 0, 1.0f);
+            events.add(100, 1, 0.5f);
+            events.add(200, 0, 2.0f);
+            events.add(0, 2, 0.0f);
+            events.add(200, 0, 3.0f);
+
+            /// execute...
+            events.process(512,
+                [&](const MrParameterEvents::Event& event) { applied.push_back(event.value); },
+                [](int, int) {});
+
+            /// evaluate...
+            expect(applied.size() == 5);
+            expect(applied[0] == 0.0f && applied[1] == 0.5f);
+            expect(applied[2] == 1.0f && applied[3] == 2.0f && applied[4] == 3.0f);
+        }
+
+        beginTest("When events are closer than the minimum sub block size then they are applied together.");
+        {
+            std::vector<std::pair<int, int>> subBlocks;
+            std::vector<float> applied;
+            MrParameterEvents events;
+
+            events.add(10, 0, 1.0f);
+            events.add(20, 0, 2.0f);
+            events.add(30, 0, 3.0f);
+
+            /// execute...
+            events.process(128,
+                [&](const MrParameterEvents::Event& event) { applied.push_back(event.value); },
+                [&](int start, int num) { subBlocks.push_back({ start, num }); },
+                32);
+
+            /// evaluate...
+            expect(subBlocks.size() == 2);
+            expect(subBlocks[0].first == 0 && subBlocks[0].second == 32);
+            expect(subBlocks[1].first == 32 && subBlocks[1].second == 96);
+
+            expect(applied.size() == 3);
+            expect(applied[0] == 1.0f && applied[1] == 2.0f && applied[2] == 3.0f);
+        }
+
+        beginTest("When the list is full then further events are dropped.");
+        {
+            MrParameterEvents events;
+
+            for (int i = 0; i < MrParameterEvents::MAX_EVENTS; ++i)
+                expect(events.add(i, 0, 0.0f));
+
+            expect(!events.add(0, 0, 0.0f));
+            expect(events.size() == MrParameterEvents::MAX_EVENTS);
+        }
+    }
+};
+
+static MrParameterEventsTests parameterEventsTests;
@@ -0,0 +1,420 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "IJuceFxChainWrapper.h"
+#include "MrChainParameters.h"
+
+/**
+	Renders one input through the chain for every combination of a parameter grid, for
+	preset QA and sound design sweeps.
+
+	The combinations are shared out to one worker thread per core. Every combination is
+	rendered by a chain instance of its own, so no state leaks from one render into the
+	next, while all workers read from the same decoded input and each worker reuses its
+	output buffer from render to render. The input is followed by silence to let the tail
+	ring out, and every render is summarised by its peak, RMS level and tail length.
+*/
+class MrParameterGrid
+{
+public:
+
+	/** A parameter and the values it takes in the grid. */
+	struct Axis
+	{
+		juce::String paramId;
+		std::vector<float> values;
+	};
+
+	struct Settings
+	{
+		int blockSize = 512;
+		int numThreads = 0;						/**< 0 uses one thread per core */
+		double maxTailInSeconds = 10.0;			/**< silence appended to the input */
+		float tailThresholdInDb = -60.0f;		/**< relative to the peak of the render */
+		int bitsPerSample = 24;					/**< of the written renders */
+	};
+
+	/** Result of rendering one combination. */
+	struct Summary
+	{
+		int index = 0;
+		MrChainParameters::Values parameters;
+		juce::String fileName;			/**< empty if the render was not written */
+
+		float peakInDb = -100.0f;
+		float rmsInDb = -100.0f;		/**< over all channels and the full render, tail included */
+		int tailLengthInSmpls = 0;		/**< from the end of the input to the last sample above the tail threshold */
+		bool isTailTruncated = false;	/**< the render was still above the threshold when it ended */
+	};
+
+	struct Report
+	{
+		bool wasSuccessful = false;
+		juce::String errorMessage;
+		double sampleRate = 0.0;
+		int numThreads = 0;
+		double secondsTotal = 0.0;
+		std::vector<Summary> summaries;	/**< in the order of the combinations */
+	};
+
+	using ChainFactory = std::function<std::unique_ptr<IJuceFxChainWrapper>()>;
+
+	/**
+		Called by the worker threads with each finished render and the number of samples worth
+		keeping, returns the name of the file it was written to or an empty string.
+	*/
+	using RenderedFn = std::function<juce::String(int index, const juce::AudioBuffer<float>& render, int numSamples)>;
+
+	//==============================================================================
+	/** Parses "<parameter ID>=<value>,<value>,..." or "<parameter ID>=<from>:<to>:<number of steps>". */
+	static bool parseAxis(const juce::String& text, Axis& axis)
+	{
+		if (!text.containsChar('='))
+			return false;
+
+		axis.paramId = text.upToFirstOccurrenceOf("=", false, false);
+		axis.values.clear();
+
+		auto valuesText = text.fromFirstOccurrenceOf("=", false, false);
+		auto range = juce::StringArray::fromTokens(valuesText, ":", "");
+
+		if (range.size() == 3)
+		{
+			const float from = range[0].getFloatValue();
+			const float to = range[1].getFloatValue();
+			const int numSteps = range[2].getIntValue();
+
+			for (int i = 0; i < numSteps; ++i)
+				axis.values.push_back(numSteps > 1 ? from + (to - from) * (float)i / (float)(numSteps - 1) : from);
+		}
+		else
+		{
+			for (auto& value : juce::StringArray::fromTokens(valuesText, ",", ""))
+				axis.values.push_back(value.getFloatValue());
+		}
+
+		return axis.paramId.isNotEmpty() && !axis.values.empty();
+	}
+
+	/** Returns every combination of the axes, the last axis varying fastest. */
+	static std::vector<MrChainParameters::Values> expand(const std::vector<Axis>& axes)
+	{
+		std::vector<MrChainParameters::Values> combinations{ {} };
+
+		for (auto& axis : axes)
+		{
+			std::vector<MrChainParameters::Values> expanded;
+			expanded.reserve(combinations.size() * axis.values.size());
+
+			for (auto& combination : combinations)
+			{
+				for (auto value : axis.values)
+				{
+					expanded.push_back(combination);
+					expanded.back().push_back({ axis.paramId, value });
+				}
+			}
+
+			combinations = std::move(expanded);
+		}
+
+		return combinations;
+	}
+
+	//==============================================================================
+	/** Renders the input for all combinations, rendered is called for each of them as it finishes. */
+	static Report render(const juce::AudioBuffer<float>& input, double sampleRate,
+						 const std::vector<MrChainParameters::Values>& combinations,
+						 const ChainFactory& createChain, const Settings& settings, const RenderedFn& rendered = nullptr)
+	{
+		Report report;
+		report.sampleRate = sampleRate;
+		report.summaries.resize(combinations.size());
+
+		const auto start = juce::Time::getHighResolutionTicks();
+
+		Job job{ input, sampleRate, combinations, createChain, settings, rendered, report.summaries };
+
+		const int numThreads = std::min((int)combinations.size(),
+										settings.numThreads > 0 ? settings.numThreads : juce::SystemStats::getNumCpus());
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		for (int t = 0; t < numThreads; ++t)
+			workers.push_back(std::make_unique<Worker>(job));
+
+		for (auto& worker : workers)
+			worker->startThread();
+
+		for (auto& worker : workers)
+			worker->waitForThreadToExit(-1);
+
+		report.numThreads = numThreads;
+		report.secondsTotal = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+		report.wasSuccessful = true;
+
+		return report;
+	}
+
+	/**
+		Decodes the input file and renders it for all combinations. The renders are written as
+		WAV files to outputDirectory, unless it is the default File.
+	*/
+	static Report renderFile(const juce::File& inputFile, const juce::File& outputDirectory,
+							 const std::vector<MrChainParameters::Values>& combinations,
+							 const ChainFactory& createChain, const Settings& settings)
+	{
+		Report report;
+
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+
+		std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+
+		if (reader == nullptr)
+			return fail(report, "could not open " + inputFile.getFullPathName());
+
+		if (reader->lengthInSamples > (juce::int64)std::numeric_limits<int>::max())
+			return fail(report, inputFile.getFullPathName() + " is too long to be held in memory");
+
+		juce::AudioBuffer<float> input((int)reader->numChannels, (int)reader->lengthInSamples);
+		reader->read(&input, 0, input.getNumSamples(), 0, true, true);
+
+		const bool isWriting = (outputDirectory != juce::File());
+
+		if (isWriting && !outputDirectory.createDirectory())
+			return fail(report, "could not create " + outputDirectory.getFullPathName());
+
+		const auto sampleRate = reader->sampleRate;
+
+		auto write = [&](int index, const juce::AudioBuffer<float>& render, int numSamples)
+		{
+			auto file = outputDirectory.getChildFile("render_" + juce::String(index).paddedLeft('0', 4) + ".wav");
+			file.deleteFile();
+
+			juce::WavAudioFormat format;
+			auto outputStream = file.createOutputStream();
+
+			std::unique_ptr<juce::AudioFormatWriter> writer(outputStream != nullptr
+				? format.createWriterFor(outputStream.get(), sampleRate, (unsigned int)render.getNumChannels(), settings.bitsPerSample, {}, 0)
+				: nullptr);
+
+			if (writer == nullptr)
+				return juce::String();
+
+			outputStream.release();
+
+			return writer->writeFromAudioSampleBuffer(render, 0, numSamples) ? file.getFileName() : juce::String();
+		};
+
+		return render(input, sampleRate, combinations, createChain, settings, isWriting ? RenderedFn(write) : nullptr);
+	}
+
+	//==============================================================================
+	static juce::String toJson(const Report& report)
+	{
+		juce::DynamicObject::Ptr root = new juce::DynamicObject();
+		root->setProperty("sampleRate", report.sampleRate);
+		root->setProperty("numThreads", report.numThreads);
+		root->setProperty("secondsTotal", report.secondsTotal);
+
+		juce::Array<juce::var> renders;
+		for (auto& summary : report.summaries)
+		{
+			juce::DynamicObject::Ptr parameters = new juce::DynamicObject();
+			for (auto& parameter : summary.parameters)
+				parameters->setProperty(parameter.first, parameter.second);
+
+			juce::DynamicObject::Ptr object = new juce::DynamicObject();
+			object->setProperty("index", summary.index);
+			object->setProperty("file", summary.fileName);
+			object->setProperty("parameters", parameters.get());
+			object->setProperty("peakInDb", summary.peakInDb);
+			object->setProperty("rmsInDb", summary.rmsInDb);
+			object->setProperty("tailLengthInMs", 1000.0 * summary.tailLengthInSmpls / report.sampleRate);
+			object->setProperty("isTailTruncated", summary.isTailTruncated);
+			renders.add(object.get());
+		}
+		root->setProperty("renders", renders);
+
+		return juce::JSON::toString(root.get());
+	}
+
+	/** Writes one row per combination, with a column per parameter. */
+	static juce::String toCsv(const Report& report)
+	{
+		juce::String csv;
+
+		csv << "index,file";
+		if (!report.summaries.empty())
+			for (auto& parameter : report.summaries.front().parameters)
+				csv << "," << parameter.first;
+		csv << ",peakInDb,rmsInDb,tailLengthInMs,isTailTruncated\n";
+
+		for (auto& summary : report.summaries)
+		{
+			csv << summary.index << "," << summary.fileName;
+			for (auto& parameter : summary.parameters)
+				csv << "," << parameter.second;
+			csv << "," << summary.peakInDb << "," << summary.rmsInDb << ","
+				<< 1000.0 * summary.tailLengthInSmpls / report.sampleRate << "," << (summary.isTailTruncated ? 1 : 0) << "\n";
+		}
+
+		return csv;
+	}
+
+private:
+
+	static Report fail(Report& report, const juce::String& errorMessage)
+	{
+		report.wasSuccessful = false;
+		report.errorMessage = errorMessage;
+		return report;
+	}
+
+	//==============================================================================
+	/** What the workers share, all read only apart from the next index and each worker's own summaries. */
+	struct Job
+	{
+		const juce::AudioBuffer<float>& input;
+		double sampleRate;
+		const std::vector<MrChainParameters::Values>& combinations;
+		const ChainFactory& createChain;
+		const Settings& settings;
+		const RenderedFn& rendered;
+		std::vector<Summary>& summaries;
+
+		std::atomic<int> nextIndex{ 0 };
+	};
+
+	/** Takes combinations off the job until none are left, rendering them into one reused buffer. */
+	class Worker : public juce::Thread
+	{
+	public:
+
+		explicit Worker(Job& jobToRun)
+			: juce::Thread("Grid render"),
+			  job(jobToRun),
+			  output(job.input.getNumChannels(),
+					 job.input.getNumSamples() + (int)std::ceil(job.settings.maxTailInSeconds * job.sampleRate))
+		{
+		}
+
+		void run() override
+		{
+			for (int index = job.nextIndex++; index < (int)job.combinations.size(); index = job.nextIndex++)
+				renderCombination(index);
+		}
+
+	private:
+
+		void renderCombination(int index)
+		{
+			const int numChnls = output.getNumChannels();
+			const int numInputSmpls = job.input.getNumSamples();
+			const int numSmpls = output.getNumSamples();
+			const int blockSize = std::max(1, job.settings.blockSize);
+
+			auto& parameters = job.combinations[(size_t)index];
+
+			/// input followed by silence
+			for (int c = 0; c < numChnls; ++c)
+			{
+				output.copyFrom(c, 0, job.input, c, 0, numInputSmpls);
+				output.clear(c, numInputSmpls, numSmpls - numInputSmpls);
+			}
+
+			/// processed block by block as a host would
+			auto chain = job.createChain();
+
+			juce::dsp::ProcessSpec spec;
+			spec.sampleRate = job.sampleRate;
+			spec.maximumBlockSize = (juce::uint32)blockSize;
+			spec.numChannels = (juce::uint32)numChnls;
+
+			MrChainParameters::prepare(*chain, spec, parameters);
+
+			juce::dsp::AudioBlock<float> block(output);
+
+			for (int pos = 0; pos < numSmpls; pos += blockSize)
+			{
+				auto subBlock = block.getSubBlock((size_t)pos, (size_t)std::min(blockSize, numSmpls - pos));
+				chain->process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+			}
+
+			/// summary
+			auto& summary = job.summaries[(size_t)index];
+			summary.index = index;
+			summary.parameters = parameters;
+
+			const int numSmplsToKeep = summarise(summary, numInputSmpls, blockSize);
+
+			if (job.rendered != nullptr)
+				summary.fileName = job.rendered(index, output, numSmplsToKeep);
+		}
+
+		/** Fills in peak, RMS and tail, returns the length of the render up to the end of the tail. */
+		int summarise(Summary& summary, int numInputSmpls, int blockSize) const
+		{
+			const int numChnls = output.getNumChannels();
+			const int numSmpls = output.getNumSamples();
+
+			float peak = 0.0f;
+			double sumOfSquares = 0.0;
+
+			for (int c = 0; c < numChnls; ++c)
+			{
+				peak = std::max(peak, output.getMagnitude(c, 0, numSmpls));
+				const double rms = output.getRMSLevel(c, 0, numSmpls);
+				sumOfSquares += rms * rms;
+			}
+
+			summary.peakInDb = juce::Decibels::gainToDecibels(peak);
+			summary.rmsInDb = juce::Decibels::gainToDecibels((float)std::sqrt(sumOfSquares / std::max(1, numChnls)));
+
+			/// the last sample above the threshold, searched backwards
+			const float threshold = peak * juce::Decibels::decibelsToGain(job.settings.tailThresholdInDb, -1000.0f);
+			int last = -1;
+
+			for (int c = 0; c < numChnls; ++c)
+			{
+				auto* samples = output.getReadPointer(c);
+
+				for (int i = numSmpls - 1; i > last; --i)
+				{
+					if (std::abs(samples[i]) > threshold)
+					{
+						last = i;
+						break;
+					}
+				}
+			}
+
+			summary.tailLengthInSmpls = std::max(0, last + 1 - numInputSmpls);
+			summary.isTailTruncated = (peak > 0.0f && last >= numSmpls - blockSize);
+
+			return std::max(numInputSmpls, last + 1);
+		}
+
+		Job& job;
+		juce::AudioBuffer<float> output;
+	};
+};
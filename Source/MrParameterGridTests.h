@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <JuceHeader.h>
+#include "MrParameterGrid.h"
+#include "JuceFxChainWrapperMock.h"
+
+class MrParameterGridTests : public juce::UnitTest
+{
+public:
+
+    MrParameterGridTests() : juce::UnitTest("MrParameterGrid testing") {}
+
+    void runTest() override
+    {
+        beginTest("When parsing axes then value lists and ranges are both understood.");
+        {
+            /// prepare...
+            MrParameterGrid::Axis list, range, invalid;
+
+            /// execute...
+            auto isListParsed = MrParameterGrid::parseAxis("feedback=0.1,0.3,0.5", list);
+            auto isRangeParsed = MrParameterGrid::parseAxis("cutOffInHz=200:2000:4", range);
+            auto isInvalidParsed = MrParameterGrid::parseAxis("feedback", invalid);
+
+            /// evaluate...
+            expect(isListParsed);
+            expect(isRangeParsed);
+            expect(!isInvalidParsed);
+
+            expect(list.paramId == "feedback");
+            expectEquals((int)list.values.size(), 3);
+            expectEquals(list.values[1], 0.3f);
+
+            expect(range.paramId == "cutOffInHz");
+            expectEquals((int)range.values.size(), 4);
+            expectEquals(range.values[0], 200.0f);
+            expectEquals(range.values[1], 800.0f);
+            expectEquals(range.values[3], 2000.0f);
+        }
+
+        beginTest("When expanding axes then every combination is returned with the last axis varying fastest.");
+        {
+            /// prepare...
+            std::vector<MrParameterGrid::Axis> axes{ { "delayInMs", { 100.0f, 200.0f } }, { "feedback", { 0.1f, 0.2f, 0.3f } } };
+
+            /// execute...
+            auto combinations = MrParameterGrid::expand(axes);
+
+            /// evaluate...
+            expectEquals((int)combinations.size(), 6);
+
+            for (auto& combination : combinations)
+                expectEquals((int)combination.size(), 2);
+
+            expectEquals(combinations[0][0].second, 100.0f);
+            expectEquals(combinations[0][1].second, 0.1f);
+            expectEquals(combinations[1][1].second, 0.2f);
+            expectEquals(combinations[3][0].second, 200.0f);
+            expectEquals(combinations[3][1].second, 0.1f);
+        }
+
+        beginTest("When rendering a grid then every combination is rendered by a fresh chain and summarised in order.");
+        {
+            /// prepare...
+            const double sampleRate = 1000.0;
+            juce::AudioBuffer<float> input(2, 200);
+            input.clear();
+            input.setSample(0, 0, 1.0f);
+            input.setSample(1, 0, 1.0f);
+
+            auto combinations = MrParameterGrid::expand({ { "feedback", { 1.0f, 0.5f, 0.25f, 0.125f, 0.0625f } } });
+
+            MrParameterGrid::Settings settings;
+            settings.blockSize = 64;
+            settings.numThreads = 3;
+            settings.maxTailInSeconds = 0.5;
+
+            std::atomic<int> numChainsCreated{ 0 };
+            std::mutex renderedLock;
+            std::vector<int> renderedIndices;
+            std::vector<int> renderedLengths(combinations.size(), 0);
+
+            auto createChain = [&]
+            {
+                ++numChainsCreated;
+                return std::make_unique<EchoChain>();
+            };
+
+            auto rendered = [&](int index, const juce::AudioBuffer<float>&, int numSamples)
+            {
+                std::lock_guard<std::mutex> lock(renderedLock);
+                renderedIndices.push_back(index);
+                renderedLengths[(size_t)index] = numSamples;
+                return "render_" + juce::String(index);
+            };
+
+            /// execute...
+            auto report = MrParameterGrid::render(input, sampleRate, combinations, createChain, settings, rendered);
+
+            /// evaluate...
+            expect(report.wasSuccessful);
+            expectEquals(report.numThreads, 3);
+            expectEquals(numChainsCreated.load(), (int)combinations.size());
+            expectEquals((int)renderedIndices.size(), (int)combinations.size());
+            expectEquals((int)report.summaries.size(), (int)combinations.size());
+
+            for (size_t n = 0; n < report.summaries.size(); ++n)
+            {
+                auto& summary = report.summaries[n];
+                const float gain = combinations[n][0].second;
+
+                expectEquals(summary.index, (int)n);
+                expect(summary.fileName == "render_" + juce::String((int)n));
+                expectWithinAbsoluteError(summary.peakInDb, juce::Decibels::gainToDecibels(gain), 0.001f);
+
+                /* the echo rings out ECHO_IN_SMPLS after the impulse, the input is 200 samples long */
+                expectEquals(summary.tailLengthInSmpls, EchoChain::ECHO_IN_SMPLS + 1 - input.getNumSamples());
+                expect(!summary.isTailTruncated);
+                expectEquals(renderedLengths[n], EchoChain::ECHO_IN_SMPLS + 1);
+            }
+        }
+    }
+
+private:
+
+    /** Chain adding an echo of the input at a fixed delay, both scaled by the feedback parameter. */
+    class EchoChain : public JuceFxChainWrapperMock
+    {
+    public:
+
+        static constexpr int ECHO_IN_SMPLS = 300;
+
+        void setFeedback(float feedbackToUse) override { gain = feedbackToUse; }
+
+        void prepare(juce::dsp::ProcessSpec& spec) override
+        {
+            history.assign(spec.numChannels, std::vector<float>((size_t)ECHO_IN_SMPLS, 0.0f));
+            pos = 0;
+        }
+
+        void process(juce::dsp::ProcessContextReplacing<float> context) override
+        {
+            auto& block = context.getOutputBlock();
+            int posEnd = pos;
+
+            for (size_t c = 0; c < block.getNumChannels(); ++c)
+            {
+                auto* samples = block.getChannelPointer(c);
+                auto& line = history[c];
+                posEnd = pos;
+
+                for (size_t i = 0; i < block.getNumSamples(); ++i)
+                {
+                    const float in = samples[i];
+                    samples[i] = gain * (in + 0.5f * line[(size_t)posEnd]);
+                    line[(size_t)posEnd] = in;
+                    posEnd = (posEnd + 1) % ECHO_IN_SMPLS;
+                }
+            }
+
+            pos = posEnd;
+        }
+
+    private:
+
+        float gain = 1.0f;
+        int pos = 0;
+        std::vector<std::vector<float>> history;
+    };
+};
+
+static MrParameterGridTests parameterGridTests;
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+	The quality tiers the stages offer, trading sound for CPU.
+
+	Each stage crossfades from the old to the new tier when it changes, so a tier can be
+	switched while playing. During the crossfade the stage runs both tiers.
+*/
+struct MrQuality
+{
+	enum class Tier
+	{
+		eco,
+		normal,
+		high
+	};
+
+	static constexpr int NUM_TIERS = 3;
+
+	/** Clamps an int, as passed through the chain interface, to a tier. */
+	static Tier toTier(int tier) noexcept
+	{
+		return (Tier)juce::jlimit(0, NUM_TIERS - 1, tier);
+	}
+
+	static juce::String getName(Tier tier)
+	{
+		switch (tier)
+		{
+		case Tier::eco:		return "eco";
+		case Tier::high:	return "high";
+		case Tier::normal:
+		default:			return "normal";
+		}
+	}
+};
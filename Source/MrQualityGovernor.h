@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <JuceHeader.h>
+#include "MrQuality.h"
+
+/**
+	Picks the quality tier from the measured processing time of each block.
+
+	The load is the time a block took against the share of the block deadline the chain
+	may use. A single block above STEP_DOWN_LOAD steps the tier down at once, so the load
+	drops before the deadline is missed, further steps follow at most every
+	STEP_DOWN_HOLD_IN_SECONDS to let the crossfades finish. The tier steps back up, at most
+	to the tier set as the maximum, once the load has stayed below STEP_UP_LOAD for
+	STEP_UP_HOLD_IN_SECONDS. The load is held at its peaks and released slowly, so single
+	quiet blocks do not count as headroom.
+*/
+class MrQualityGovernor
+{
+public:
+
+	using Tier = MrQuality::Tier;
+
+	static constexpr double STEP_DOWN_LOAD = 0.8;
+	static constexpr double STEP_UP_LOAD = 0.5;
+	static constexpr double STEP_DOWN_HOLD_IN_SECONDS = 0.1;
+	static constexpr double STEP_UP_HOLD_IN_SECONDS = 2.0;
+	static constexpr double RELEASE_IN_SECONDS = 0.5;
+	static constexpr double BUDGET_DEFAULT = 1.0;
+
+	/** Sets the highest tier to use, the tier selected by the user. */
+	void setMaxTier(Tier maxTierNew) noexcept
+	{
+		maxTier = maxTierNew;
+
+		if ((int)tier > (int)maxTier)
+			tier = maxTier;
+	}
+
+	Tier getMaxTier() const noexcept { return maxTier; }
+
+	/** Sets the share of the block deadline the chain may use, 1 for all of it. */
+	void setBudget(double budgetNew) noexcept { budget = std::max(1.0e-3, budgetNew); }
+
+	double getBudget() const noexcept { return budget; }
+
+	/** Starts over at the maximum tier. */
+	void reset() noexcept
+	{
+		tier = maxTier;
+		load = 0.0;
+		secondsSinceStepDown = STEP_DOWN_HOLD_IN_SECONDS;
+		secondsBelow = 0.0;
+	}
+
+	//==============================================================================
+	/** Takes the time the last block took and its deadline, returns the tier for the next block. */
+	Tier process(double secondsUsed, double secondsPerBlock) noexcept
+	{
+		if (secondsPerBlock <= 0.0)
+			return tier;
+
+		const double loadNow = secondsUsed / (secondsPerBlock * budget);
+		load = std::max(loadNow, load * std::exp(-secondsPerBlock / RELEASE_IN_SECONDS));
+
+		secondsSinceStepDown += secondsPerBlock;
+		secondsBelow = (load < STEP_UP_LOAD) ? secondsBelow + secondsPerBlock : 0.0;
+
+		if (loadNow > STEP_DOWN_LOAD && tier != Tier::eco && secondsSinceStepDown >= STEP_DOWN_HOLD_IN_SECONDS)
+		{
+			tier = (Tier)((int)tier - 1);
+			secondsSinceStepDown = 0.0;
+			secondsBelow = 0.0;
+		}
+		else if (secondsBelow >= STEP_UP_HOLD_IN_SECONDS && (int)tier < (int)maxTier)
+		{
+			tier = (Tier)((int)tier + 1);
+			secondsBelow = 0.0;
+		}
+
+		return tier;
+	}
+
+	/** Returns the tier in use. */
+	Tier getTier() const noexcept { return tier; }
+
+	/** Returns the held load, 1 being the whole budget. */
+	double getLoad() const noexcept { return load; }
+
+private:
+
+	Tier maxTier{ Tier::normal };
+	Tier tier{ Tier::normal };
+	double budget{ BUDGET_DEFAULT };
+
+	double load{ 0.0 };
+	double secondsSinceStepDown{ STEP_DOWN_HOLD_IN_SECONDS };
+	double secondsBelow{ 0.0 };
+};
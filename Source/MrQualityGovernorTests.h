@@ -0,0 +1,87 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MrQualityGovernor.h"
+
+class MrQualityGovernorTests : public juce::UnitTest
+{
+public:
+
+    MrQualityGovernorTests() : juce::UnitTest("MrQualityGovernor testing") {}
+
+    void runTest() override
+    {
+        beginTest("When a block takes too long then the tier steps down at once and not again before the hold time.");
+        {
+            /// prepare...
+            const double secondsPerBlock = 0.005;
+
+            MrQualityGovernor governor;
+            governor.setMaxTier(MrQuality::Tier::high);
+            governor.reset();
+
+            /// execute...
+            const auto tierAfterSpike = governor.process(0.9 * secondsPerBlock, secondsPerBlock);
+            const auto tierAfterSecondSpike = governor.process(0.9 * secondsPerBlock, secondsPerBlock);
+
+            for (int i = 0; i < 20; ++i)
+                governor.process(0.1 * secondsPerBlock, secondsPerBlock);
+
+            const auto tierAfterHold = governor.process(0.9 * secondsPerBlock, secondsPerBlock);
+
+            /// evaluate...
+            expect(tierAfterSpike == MrQuality::Tier::normal);
+            expect(tierAfterSecondSpike == MrQuality::Tier::normal);
+            expect(tierAfterHold == MrQuality::Tier::eco);
+        }
+
+        beginTest("When the load stays low then the tier steps up after the hold time, at most to the maximum.");
+        {
+            /// prepare...
+            const double secondsPerBlock = 0.005;
+            const int numBlocksHold = (int)(MrQualityGovernor::STEP_UP_HOLD_IN_SECONDS / secondsPerBlock);
+
+            MrQualityGovernor governor;
+            governor.setMaxTier(MrQuality::Tier::normal);
+            governor.reset();
+            governor.process(0.9 * secondsPerBlock, secondsPerBlock);
+
+            /// execute...
+            for (int i = 0; i < numBlocksHold; ++i)
+                governor.process(0.1 * secondsPerBlock, secondsPerBlock);
+
+            const auto tierAfterHold = governor.getTier();
+
+            for (int i = 0; i < 4 * numBlocksHold; ++i)
+                governor.process(0.1 * secondsPerBlock, secondsPerBlock);
+
+            /// evaluate...
+            // the load held from the spike has to be released first
+            expect(tierAfterHold == MrQuality::Tier::eco);
+            expect(governor.getTier() == MrQuality::Tier::normal);
+        }
+
+        beginTest("When the budget is halved then the same time counts as twice the load.");
+        {
+            /// prepare...
+            const double secondsPerBlock = 0.005;
+
+            MrQualityGovernor governor;
+            governor.setMaxTier(MrQuality::Tier::normal);
+            governor.reset();
+
+            /// execute...
+            const auto tierFullBudget = governor.process(0.6 * secondsPerBlock, secondsPerBlock);
+
+            governor.setBudget(0.5);
+            const auto tierHalfBudget = governor.process(0.6 * secondsPerBlock, secondsPerBlock);
+
+            /// evaluate...
+            expect(tierFullBudget == MrQuality::Tier::normal);
+            expect(tierHalfBudget == MrQuality::Tier::eco);
+            expectWithinAbsoluteError(governor.getLoad(), 1.2, 1.0e-9);
+        }
+    }
+};
+
+static MrQualityGovernorTests qualityGovernorTests;
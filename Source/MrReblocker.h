@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+
+#include <JuceHeader.h>
+
+/**
+	Turns host blocks of any size into frames of a fixed power of two size, for stages that
+	need them, like those running FFTs.
+
+	Each channel has a ring of one frame. Every incoming sample takes the place of the
+	processed sample it was delayed against, which goes out. Once the ring is full it is
+	passed to the frame function and processed in place, then played while the next frame
+	fills. So the latency is exactly one frame, host blocks larger than a frame are split at
+	the frame boundaries and nothing is allocated after prepare().
+*/
+class MrReblocker
+{
+public:
+
+	static constexpr int FRAME_SIZE_MIN = 16;
+	static constexpr int FRAME_SIZE_MAX = 16384;
+
+	/** Rounds up to the next power of two. */
+	static int toFrameSize(int frameSize) noexcept
+	{
+		return juce::nextPowerOfTwo(juce::jlimit(FRAME_SIZE_MIN, FRAME_SIZE_MAX, frameSize));
+	}
+
+	/** Allocates a ring of one frame per channel. Not real time safe. */
+	void prepare(int numChnls, int frameSizeToUse)
+	{
+		frameSize = toFrameSize(frameSizeToUse);
+		rings.setSize(std::max(1, numChnls), frameSize);
+		reset();
+	}
+
+	int getFrameSize() const noexcept { return frameSize; }
+
+	int getLatencyInSmpls() const noexcept { return frameSize; }
+
+	void reset() noexcept
+	{
+		rings.clear();
+		fillPos = 0;
+	}
+
+	/** Brings a channel left out of processing up to date with another carrying the same signal. */
+	void copyChannel(int chnlFrom, int chnlTo) noexcept
+	{
+		if (chnlFrom < rings.getNumChannels() && chnlTo < rings.getNumChannels())
+			rings.copyFrom(chnlTo, 0, rings, chnlFrom, 0, frameSize);
+	}
+
+	//==============================================================================
+	/**
+		Passes the block through the rings, calling processFrame(juce::dsp::AudioBlock<float>&)
+		with the channels of the block whenever a frame is full.
+	*/
+	template <typename FrameFn>
+	void process(juce::dsp::AudioBlock<float>& block, FrameFn&& processFrame)
+	{
+		jassert(block.getNumChannels() <= (size_t)rings.getNumChannels());
+
+		const int numSamples = (int)block.getNumSamples();
+		const size_t numChannels = std::min(block.getNumChannels(), (size_t)rings.getNumChannels());
+
+		for (int offset = 0; offset < numSamples;)
+		{
+			const int num = std::min(numSamples - offset, frameSize - fillPos);
+
+			for (size_t c = 0; c < numChannels; ++c)
+			{
+				auto* samples = block.getChannelPointer(c) + offset;
+				std::swap_ranges(samples, samples + num, rings.getWritePointer((int)c, fillPos));
+			}
+
+			offset += num;
+			fillPos += num;
+
+			if (fillPos == frameSize)
+			{
+				juce::dsp::AudioBlock<float> frame(rings);
+				auto frameOfBlock = frame.getSubsetChannelBlock(0, numChannels);
+				processFrame(frameOfBlock);
+				fillPos = 0;
+			}
+		}
+	}
+
+private:
+
+	juce::AudioBuffer<float> rings;
+	int frameSize{ FRAME_SIZE_MIN };
+	int fillPos{ 0 };
+};
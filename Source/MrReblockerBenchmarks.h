@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrReblocker.h"
+#include "MrSignal.h"
+
+class MrReblockerBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrReblockerBenchmarks() : juce::UnitTest("MrReblocker benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        beginTest("Overhead per frame size, host blocks of 512 and of random sizes");
+        {
+            const int numChnls = 2;
+            const int numSamples = 8192;
+            const int numRuns = 2000;
+            const int frameSizes[] = { 64, 256, 1024, 4096 };
+
+            juce::AudioBuffer<float> buffer(numChnls, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+
+            // the same sizes for each frame size, from 1 to 2048 samples
+            std::vector<int> randomSizes;
+            auto random = getRandom();
+            for (int total = 0; total < numSamples;)
+            {
+                const int size = std::min(numSamples - total, 1 + random.nextInt(2048));
+                randomSizes.push_back(size);
+                total += size;
+            }
+
+            const std::vector<int> fixedSizes((size_t)(numSamples / 512), 512);
+            const std::vector<int>* hostBlockSizes[] = { &fixedSizes, &randomSizes };
+
+            for (auto frameSize : frameSizes)
+            {
+                MrReblocker reblocker;
+                reblocker.prepare(numChnls, frameSize);
+
+                for (auto* sizes : hostBlockSizes)
+                {
+                    auto result = MrBenchmark::run([&]
+                        {
+                            size_t offset = 0;
+                            for (auto size : *sizes)
+                            {
+                                auto subBlock = block.getSubBlock(offset, (size_t)size);
+                                reblocker.process(subBlock, [](juce::dsp::AudioBlock<float>&) {});
+                                offset += (size_t)size;
+                            }
+                        }, numRuns);
+
+                    const juce::String hostBlocks = (sizes == &fixedSizes) ? "host blocks of 512" : "random host blocks";
+                    logMessage(MrBenchmark::format("frames of " + juce::String(frameSize) + ", " + hostBlocks, result, numSamples));
+                }
+            }
+        }
+    }
+};
+
+static MrReblockerBenchmarks reblockerBenchmarks;
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrReblocker.h"
+
+class MrReblockerTests : public juce::UnitTest
+{
+public:
+
+    MrReblockerTests() : juce::UnitTest("MrReblocker testing") {}
+
+    void runTest() override
+    {
+        beginTest("When the host block sizes are random then the frames have the fixed size and the output is delayed by one frame.");
+        {
+            const int numChnls = 2;
+            const int numSamples = 20000;
+            const int frameSizes[] = { 16, 64, 500, 1024 };
+
+            for (auto frameSizeRequested : frameSizes)
+            {
+                /// prepare...
+                juce::AudioBuffer<float> bufferInput(numChnls, numSamples);
+                juce::dsp::AudioBlock<float> blockInput(bufferInput);
+                MrSignal::whiteNoise(blockInput, 0.5f);
+
+                juce::AudioBuffer<float> buffer;
+                buffer.makeCopyOf(bufferInput);
+                juce::dsp::AudioBlock<float> block(buffer);
+
+                MrReblocker reblocker;
+                reblocker.prepare(numChnls, frameSizeRequested);
+
+                const int frameSize = reblocker.getFrameSize();
+                const auto hostBlockSizes = createRandomBlockSizes(numSamples, 4 * frameSize);
+                int numFrames = 0;
+                bool isEachFrameFull = true;
+
+                /// execute...
+                size_t offset = 0;
+                for (auto hostBlockSize : hostBlockSizes)
+                {
+                    auto subBlock = block.getSubBlock(offset, (size_t)hostBlockSize);
+                    reblocker.process(subBlock, [&](juce::dsp::AudioBlock<float>& frame)
+                        {
+                            isEachFrameFull = isEachFrameFull && (int)frame.getNumSamples() == frameSize && frame.getNumChannels() == (size_t)numChnls;
+                            ++numFrames;
+                        });
+
+                    offset += (size_t)hostBlockSize;
+                }
+
+                /// evaluate...
+                expect(juce::isPowerOfTwo(frameSize) && frameSize >= frameSizeRequested);
+                expectEquals(reblocker.getLatencyInSmpls(), frameSize);
+                expectEquals(numFrames, numSamples / frameSize);
+                expect(isEachFrameFull);
+
+                for (int channel = 0; channel < numChnls; ++channel)
+                {
+                    for (int i = 0; i < frameSize; ++i)
+                        expectEquals(buffer.getSample(channel, i), 0.0f);
+
+                    for (int i = frameSize; i < numSamples; ++i)
+                        expectEquals(buffer.getSample(channel, i), bufferInput.getSample(channel, i - frameSize));
+                }
+            }
+        }
+
+        beginTest("When the frames are processed then the output is the processed frames, whatever the host block sizes.");
+        {
+            /// prepare...
+            const int numSamples = 10000;
+            const int frameSize = 256;
+
+            juce::AudioBuffer<float> bufferInput(1, numSamples);
+            juce::dsp::AudioBlock<float> blockInput(bufferInput);
+            MrSignal::ramp(blockInput);
+
+            juce::AudioBuffer<float> buffer;
+            buffer.makeCopyOf(bufferInput);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            MrReblocker reblocker;
+            reblocker.prepare(1, frameSize);
+
+            const auto hostBlockSizes = createRandomBlockSizes(numSamples, 3 * frameSize);
+            int frameIdx = 0;
+
+            // reverses each frame and adds its index, which only comes out right on whole frames
+            auto processFrame = [&frameIdx](juce::dsp::AudioBlock<float>& frame)
+            {
+                auto* samples = frame.getChannelPointer(0);
+                std::reverse(samples, samples + frame.getNumSamples());
+
+                for (size_t i = 0; i < frame.getNumSamples(); ++i)
+                    samples[i] += (float)frameIdx;
+
+                ++frameIdx;
+            };
+
+            /// execute...
+            size_t offset = 0;
+            for (auto hostBlockSize : hostBlockSizes)
+            {
+                auto subBlock = block.getSubBlock(offset, (size_t)hostBlockSize);
+                reblocker.process(subBlock, processFrame);
+                offset += (size_t)hostBlockSize;
+            }
+
+            /// evaluate...
+            for (int i = frameSize; i < numSamples; ++i)
+            {
+                const int frame = i / frameSize - 1;
+                const int posReversed = frameSize - 1 - i % frameSize;
+                const float expected = bufferInput.getSample(0, frame * frameSize + posReversed) + (float)frame;
+
+                expectEquals(buffer.getSample(0, i), expected);
+            }
+        }
+
+        beginTest("When copying a channel then it continues like the channel copied.");
+        {
+            /// prepare...
+            const int numSamples = 1000;
+            const int frameSize = 64;
+
+            MrReblocker reblocker;
+            reblocker.prepare(2, frameSize);
+
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block.getSingleChannelBlock(0), 0.5f);
+
+            auto first = block.getSubBlock(0, 100).getSingleChannelBlock(0);
+            auto second = block.getSubBlock(100, numSamples - 100);
+            second.getSingleChannelBlock(1).copyFrom(second.getSingleChannelBlock(0));
+
+            /// execute...
+            reblocker.process(first, [](juce::dsp::AudioBlock<float>&) {});
+            reblocker.copyChannel(0, 1);
+            reblocker.process(second, [](juce::dsp::AudioBlock<float>&) {});
+
+            /// evaluate...
+            for (int i = 0; i < numSamples - 100; ++i)
+                expectEquals(second.getSample(1, i), second.getSample(0, i));
+        }
+    }
+
+private:
+
+    /** Sizes from 0 up to sizeMax adding up to numSamples, many of them larger than a frame. */
+    std::vector<int> createRandomBlockSizes(int numSamples, int sizeMax)
+    {
+        auto random = getRandom();
+        std::vector<int> sizes;
+
+        for (int total = 0; total < numSamples;)
+        {
+            const int size = std::min(numSamples - total, random.nextInt(sizeMax + 1));
+            sizes.push_back(size);
+            total += size;
+        }
+
+        return sizes;
+    }
+};
+
+static MrReblockerTests reblockerTests;
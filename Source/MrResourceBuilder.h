@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <JuceHeader.h>
+
+/**
+	Builds resources too heavy for the audio thread, like a whole prepared chain, on a
+	background thread and hands them over to the audio thread read-copy-update style.
+
+	build() queues a build function, a newer request replaces one not started yet and the
+	result of a build overtaken by a newer request is dropped. A built resource is published
+	through an atomic pointer, the audio thread takes it over with swap() at the start of a
+	block, which exchanges two pointers and neither allocates, frees nor locks. The resource
+	it replaces is queued and deleted on the message thread by a timer, or by the next
+	build() or releaseRetired().
+*/
+template <typename Resource>
+class MrResourceBuilder : private juce::Timer
+{
+public:
+
+	using BuildFn = std::function<std::unique_ptr<Resource>()>;
+
+	static constexpr int NUM_RETIRED_MAX = 8;
+	static constexpr int RELEASE_INTERVAL_IN_MS = 200;
+	static constexpr int WAIT_TIMEOUT_IN_MS = 100;
+
+	MrResourceBuilder() : retiredFifo(NUM_RETIRED_MAX + 1) {}
+
+	~MrResourceBuilder()
+	{
+		stopTimer();
+
+		if (builder != nullptr)
+		{
+			builder->signalThreadShouldExit();
+			builder->wake.signal();
+			builder->stopThread(-1);
+		}
+
+		delete published.exchange(nullptr);
+		releaseRetired();
+	}
+
+	/** Builds a resource with buildFn on the background thread. Not for the audio thread. */
+	void build(BuildFn buildFn)
+	{
+		releaseRetired();
+
+		{
+			const juce::ScopedLock sl(requestLock);
+			request = std::move(buildFn);
+			versionRequested.fetch_add(1, std::memory_order_release);
+		}
+
+		if (builder == nullptr)
+		{
+			builder = std::make_unique<Builder>(*this);
+			builder->startThread();
+			startTimer(RELEASE_INTERVAL_IN_MS);
+		}
+
+		builder->wake.signal();
+	}
+
+	/**
+		Drops the request and any resource built for it but not taken over yet, waiting for a
+		build in progress to finish. Not to be called concurrently with swap().
+	*/
+	void cancel()
+	{
+		const juce::ScopedLock slBuild(buildLock);
+		const juce::ScopedLock slRequest(requestLock);
+
+		request = nullptr;
+		versionBuilt.store(versionRequested.load(std::memory_order_relaxed), std::memory_order_release);
+		delete published.exchange(nullptr, std::memory_order_acq_rel);
+	}
+
+	/**
+		If a new resource has been published, takes it over into current and retires the one
+		current held. Real time safe, returns true if current changed.
+	*/
+	bool swap(std::unique_ptr<Resource>& current) noexcept
+	{
+		if (published.load(std::memory_order_relaxed) == nullptr || retiredFifo.getFreeSpace() == 0)
+			return false;
+
+		auto* next = published.exchange(nullptr, std::memory_order_acq_rel);
+		if (next == nullptr)
+			return false;
+
+		if (auto* previous = current.release())
+		{
+			int start1, size1, start2, size2;
+			retiredFifo.prepareToWrite(1, start1, size1, start2, size2);
+			retired[(size_t)(size1 > 0 ? start1 : start2)] = previous;
+			retiredFifo.finishedWrite(1);
+		}
+
+		current.reset(next);
+		return true;
+	}
+
+	/** Returns true once the resource of the last request is built and taken over, for the thread calling swap(). */
+	bool isUpToDate() const noexcept
+	{
+		return versionBuilt.load(std::memory_order_acquire) == versionRequested.load(std::memory_order_acquire)
+			&& published.load(std::memory_order_acquire) == nullptr;
+	}
+
+	/** Deletes the resources swap() has retired. Not for the audio thread. */
+	void releaseRetired()
+	{
+		const juce::ScopedLock sl(releaseLock);
+
+		const int numReady = retiredFifo.getNumReady();
+
+		int start1, size1, start2, size2;
+		retiredFifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+		for (int i = 0; i < size1; ++i)
+			deleteRetired(start1 + i);
+
+		for (int i = 0; i < size2; ++i)
+			deleteRetired(start2 + i);
+
+		retiredFifo.finishedRead(size1 + size2);
+	}
+
+private:
+
+	/** Runs the latest request whenever there is one the result of which has not been published. */
+	class Builder : public juce::Thread
+	{
+	public:
+
+		explicit Builder(MrResourceBuilder& ownerToServe)
+			: juce::Thread("Resource builder"),
+			  owner(ownerToServe)
+		{
+		}
+
+		void run() override
+		{
+			while (!threadShouldExit())
+			{
+				if (owner.versionBuilt.load(std::memory_order_acquire) == owner.versionRequested.load(std::memory_order_acquire))
+				{
+					wake.wait(WAIT_TIMEOUT_IN_MS);
+					continue;
+				}
+
+				const juce::ScopedLock slBuild(owner.buildLock);
+
+				BuildFn buildFn;
+				juce::uint32 version;
+				{
+					const juce::ScopedLock sl(owner.requestLock);
+					buildFn = owner.request;
+					version = owner.versionRequested.load(std::memory_order_relaxed);
+				}
+
+				if (version == owner.versionBuilt.load(std::memory_order_relaxed))
+					continue;
+
+				auto resource = (buildFn != nullptr) ? buildFn() : nullptr;
+
+				{
+					const juce::ScopedLock sl(owner.requestLock);
+
+					// overtaken by a newer request, which is built next
+					if (version != owner.versionRequested.load(std::memory_order_relaxed))
+						continue;
+				}
+
+				// one published but not taken over yet is outdated and never reached the audio thread
+				delete owner.published.exchange(resource.release(), std::memory_order_acq_rel);
+				owner.versionBuilt.store(version, std::memory_order_release);
+			}
+		}
+
+		juce::WaitableEvent wake;
+
+	private:
+
+		MrResourceBuilder& owner;
+	};
+
+	void timerCallback() override
+	{
+		releaseRetired();
+	}
+
+	void deleteRetired(int idx)
+	{
+		delete retired[(size_t)idx];
+		retired[(size_t)idx] = nullptr;
+	}
+
+	juce::CriticalSection requestLock, buildLock, releaseLock;
+	BuildFn request;
+	std::atomic<juce::uint32> versionRequested{ 0 }, versionBuilt{ 0 };
+
+	std::atomic<Resource*> published{ nullptr };
+
+	/* single producer, the audio thread, single consumer, whoever releases under releaseLock */
+	juce::AbstractFifo retiredFifo;
+	std::array<Resource*, NUM_RETIRED_MAX + 1> retired{};
+
+	std::unique_ptr<Builder> builder;
+
+	JUCE_DECLARE_NON_COPYABLE(MrResourceBuilder)
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "MrResourceBuilder.h"
+
+class MrResourceBuilderTests : public juce::UnitTest
+{
+public:
+
+    MrResourceBuilderTests() : juce::UnitTest("MrResourceBuilder testing") {}
+
+    void runTest() override
+    {
+        beginTest("When a resource is built then swap takes it over and the one it replaces is only deleted when released.");
+        {
+            /// prepare...
+            std::atomic<int> numDeleted{ 0 };
+            MrResourceBuilder<Resource> builder;
+            std::unique_ptr<Resource> current;
+
+            /// execute...
+            builder.build([&numDeleted] { return std::make_unique<Resource>(1, numDeleted); });
+            const bool isFirstSwapped = swapWhenBuilt(builder, current);
+            const int valueFirst = current->value;
+
+            builder.build([&numDeleted] { return std::make_unique<Resource>(2, numDeleted); });
+            const bool isSecondSwapped = swapWhenBuilt(builder, current);
+            const int numDeletedBeforeRelease = numDeleted;
+
+            builder.releaseRetired();
+
+            /// evaluate...
+            expect(isFirstSwapped && isSecondSwapped);
+            expectEquals(valueFirst, 1);
+            expectEquals(current->value, 2);
+            expect(builder.isUpToDate());
+            expectEquals(numDeletedBeforeRelease, 0);
+            expectEquals(numDeleted.load(), 1);
+        }
+
+        beginTest("When requests come in faster than they are built then only the latest is built next and taken over.");
+        {
+            /// prepare...
+            std::atomic<int> numDeleted{ 0 };
+            std::atomic<bool> isFirstReleased{ false };
+            std::vector<int> valuesBuilt;
+            juce::WaitableEvent isFirstBuilding;
+
+            MrResourceBuilder<Resource> builder;
+            std::unique_ptr<Resource> current;
+
+            auto createBuildFn = [&](int value)
+            {
+                return [&, value]
+                {
+                    valuesBuilt.push_back(value);
+
+                    if (value == 1)
+                    {
+                        isFirstBuilding.signal();
+                        while (!isFirstReleased)
+                            juce::Thread::sleep(1);
+                    }
+
+                    return std::make_unique<Resource>(value, numDeleted);
+                };
+            };
+
+            /// execute...
+            builder.build(createBuildFn(1));
+            isFirstBuilding.wait(-1);
+
+            builder.build(createBuildFn(2));
+            builder.build(createBuildFn(3));
+            isFirstReleased = true;
+
+            const bool isSwapped = swapWhenBuilt(builder, current);
+
+            /// evaluate...
+            expect(isSwapped);
+            expectEquals(current->value, 3);
+            expect(valuesBuilt == std::vector<int>({ 1, 3 }));
+            expectEquals(numDeleted.load(), 1);
+        }
+
+        beginTest("When cancelled then nothing built for the request is taken over.");
+        {
+            /// prepare...
+            std::atomic<int> numDeleted{ 0 };
+            MrResourceBuilder<Resource> builder;
+            std::unique_ptr<Resource> current;
+
+            /// execute...
+            builder.build([&numDeleted] { return std::make_unique<Resource>(1, numDeleted); });
+            builder.cancel();
+            juce::Thread::sleep(20);
+
+            /// evaluate...
+            expect(!builder.swap(current));
+            expect(current == nullptr);
+            expect(builder.isUpToDate());
+        }
+
+        beginTest("When the next request is made then the resources retired until then are deleted.");
+        {
+            /// prepare...
+            std::atomic<int> numDeleted{ 0 };
+            MrResourceBuilder<Resource> builder;
+            std::unique_ptr<Resource> current;
+
+            builder.build([&numDeleted] { return std::make_unique<Resource>(1, numDeleted); });
+            swapWhenBuilt(builder, current);
+            builder.build([&numDeleted] { return std::make_unique<Resource>(2, numDeleted); });
+            swapWhenBuilt(builder, current);
+
+            /// execute...
+            const int numDeletedBefore = numDeleted;
+            builder.build([&numDeleted] { return std::make_unique<Resource>(3, numDeleted); });
+            const int numDeletedAfter = numDeleted;
+            swapWhenBuilt(builder, current);
+
+            /// evaluate...
+            expectEquals(numDeletedBefore, 0);
+            expectEquals(numDeletedAfter, 1);
+            expectEquals(current->value, 3);
+        }
+    }
+
+private:
+
+    /** Counts its deletions. */
+    struct Resource
+    {
+        Resource(int valueNew, std::atomic<int>& numDeletedToCount) : value(valueNew), numDeleted(numDeletedToCount) {}
+        ~Resource() { ++numDeleted; }
+
+        int value;
+        std::atomic<int>& numDeleted;
+    };
+
+    /** Keeps calling swap() like an audio thread would, until the last request is in use. */
+    static bool swapWhenBuilt(MrResourceBuilder<Resource>& builder, std::unique_ptr<Resource>& current)
+    {
+        bool isSwapped = false;
+
+        for (int i = 0; i < 5000 && !builder.isUpToDate(); ++i)
+        {
+            isSwapped = builder.swap(current) || isSwapped;
+            juce::Thread::sleep(1);
+        }
+
+        return isSwapped && builder.isUpToDate();
+    }
+};
+
+static MrResourceBuilderTests resourceBuilderTests;
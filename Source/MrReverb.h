@@ -0,0 +1,463 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrDryWet.h"
+#include "MrQuality.h"
+
+/**
+	Freeverb reverb with a number of combs and all passes per quality tier.
+
+	At the normal tier the output is the one of juce::dsp::Reverb, same tunings, same
+	parameter scaling and smoothing, the interface is the same too. eco runs every second
+	comb, with the gain raised by sqrt(2) to keep the level of the uncorrelated comb sum,
+	and the first two all passes. high is the same as normal, the full Freeverb has no
+	cheaper parts left to leave out. A tier change ramps the gains of the combs and mixes
+	the all pass outputs over FADE_IN_SECONDS, combs and all passes that join start from
+	silence.
+
+	The mix scales the dry and wet levels of the parameters by the gains of its law, which
+	at the default mix of 0.5 with the balance law are both 1. The gains ramp with the
+	smoothing the levels already have.
+*/
+class MrReverb
+{
+public:
+
+	using Tier = MrQuality::Tier;
+	using Parameters = juce::dsp::Reverb::Parameters;
+
+	static constexpr int NUM_COMBS = 8;
+	static constexpr int NUM_ALL_PASSES = 4;
+	static constexpr int NUM_ALL_PASSES_ECO = 2;
+	static constexpr double FADE_IN_SECONDS = 0.02;
+
+	MrReverb()
+	{
+		setParameters(Parameters());
+		setQualityGains(tier, combGains);
+		combGainsFadingOut = combGains;
+		updateCombsActive();
+	}
+
+	//==============================================================================
+	const Parameters& getParameters() const noexcept { return parameters; }
+
+	void setParameters(const Parameters& newParams) noexcept
+	{
+		gain = isFrozen(newParams.freezeMode) ? 0.0f : 0.015f;
+		parameters = newParams;
+		updateGains();
+		updateDamping();
+	}
+
+	/** Sets the mix of input and reverb, see MrDryWet. */
+	void setMix(float mix) noexcept
+	{
+		dryWet.setMix(mix);
+		updateGains();
+	}
+
+	float getMix() const noexcept { return dryWet.getMix(); }
+
+	void setMixLaw(MrDryWet::Law law) noexcept
+	{
+		dryWet.setLaw(law);
+		updateGains();
+	}
+
+	MrDryWet::Law getMixLaw() const noexcept { return dryWet.getLaw(); }
+
+	/** Selects the number of combs and all passes, crossfading from the current ones. */
+	void setQuality(Tier tierNew) noexcept
+	{
+		if (tierNew == tier)
+			return;
+
+		combGainsFadingOut = combGains;
+		setQualityGains(tierNew, combGains);
+
+		for (int j = 0; j < NUM_COMBS; ++j)
+			if (combGainsFadingOut[(size_t)j] == 0.0f && combGains[(size_t)j] != 0.0f)
+				for (auto& chnlCombs : combs)
+					chnlCombs[(size_t)j].clear();
+
+		numAllPassesFadingOut = getNumAllPasses(tier);
+
+		for (int j = numAllPassesFadingOut; j < getNumAllPasses(tierNew); ++j)
+			for (auto& chnlAllPasses : allPasses)
+				chnlAllPasses[(size_t)j].clear();
+
+		tier = tierNew;
+		fadePos = 0;
+		updateCombsActive();
+	}
+
+	Tier getQuality() const noexcept { return tier; }
+
+	/** Returns true while crossfading between two tiers. */
+	bool isFading() const noexcept { return fadePos < fadeLength; }
+
+	//==============================================================================
+	void prepare(const juce::dsp::ProcessSpec& spec)
+	{
+		static const short combTunings[] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
+		static const short allPassTunings[] = { 556, 441, 341, 225 };
+		const int stereoSpread = 23;
+		const int intSampleRate = (int)spec.sampleRate;
+
+		for (int j = 0; j < NUM_COMBS; ++j)
+		{
+			combs[0][(size_t)j].setSize((intSampleRate * combTunings[j]) / 44100);
+			combs[1][(size_t)j].setSize((intSampleRate * (combTunings[j] + stereoSpread)) / 44100);
+		}
+
+		for (int j = 0; j < NUM_ALL_PASSES; ++j)
+		{
+			allPasses[0][(size_t)j].setSize((intSampleRate * allPassTunings[j]) / 44100);
+			allPasses[1][(size_t)j].setSize((intSampleRate * (allPassTunings[j] + stereoSpread)) / 44100);
+		}
+
+		const double smoothTime = 0.01;
+		damping.reset(spec.sampleRate, smoothTime);
+		feedback.reset(spec.sampleRate, smoothTime);
+		dryGain.reset(spec.sampleRate, smoothTime);
+		wetGain1.reset(spec.sampleRate, smoothTime);
+		wetGain2.reset(spec.sampleRate, smoothTime);
+
+		fadeLength = std::max(1, (int)std::round(FADE_IN_SECONDS * spec.sampleRate));
+		fadePos = fadeLength;
+		updateCombsActive();
+	}
+
+	void reset() noexcept
+	{
+		for (auto& chnlCombs : combs)
+			for (auto& comb : chnlCombs)
+				comb.clear();
+
+		for (auto& chnlAllPasses : allPasses)
+			for (auto& allPass : chnlAllPasses)
+				allPass.clear();
+
+		fadePos = fadeLength;
+		updateCombsActive();
+	}
+
+	//==============================================================================
+	template <typename ProcessContext>
+	void process(const ProcessContext& context) noexcept
+	{
+		const auto& inputBlock = context.getInputBlock();
+		auto& outputBlock = context.getOutputBlock();
+		const auto numInChannels = inputBlock.getNumChannels();
+		const auto numOutChannels = outputBlock.getNumChannels();
+		const auto numSamples = (int)outputBlock.getNumSamples();
+
+		jassert(inputBlock.getNumSamples() == (size_t)numSamples);
+
+		if (context.usesSeparateInputAndOutputBlocks())
+			outputBlock.copyFrom(inputBlock);
+
+		if (context.isBypassed)
+			return;
+
+		if (numInChannels == 1 && numOutChannels == 1)
+			processMono(outputBlock.getChannelPointer(0), numSamples);
+		else if (numInChannels == 2 && numOutChannels == 2)
+			processStereo(outputBlock.getChannelPointer(0), outputBlock.getChannelPointer(1), numSamples);
+		else
+			jassertfalse;	// invalid channel configuration
+
+		fadePos = std::min(fadeLength, fadePos + numSamples);
+
+		if (!isFading())
+			updateCombsActive();
+	}
+
+private:
+
+	class CombFilter
+	{
+	public:
+
+		void setSize(int size)
+		{
+			if (size != (int)buffer.size())
+			{
+				buffer.assign((size_t)std::max(1, size), 0.0f);
+				bufferIndex = 0;
+			}
+
+			clear();
+		}
+
+		void clear() noexcept
+		{
+			last = 0.0f;
+			std::fill(buffer.begin(), buffer.end(), 0.0f);
+		}
+
+		float process(float input, float damp, float feedbackLevel) noexcept
+		{
+			const float output = buffer[(size_t)bufferIndex];
+			last = (output * (1.0f - damp)) + (last * damp);
+			JUCE_UNDENORMALISE(last);
+
+			float temp = input + (last * feedbackLevel);
+			JUCE_UNDENORMALISE(temp);
+			buffer[(size_t)bufferIndex] = temp;
+			bufferIndex = (bufferIndex + 1) % (int)buffer.size();
+
+			return output;
+		}
+
+	private:
+
+		std::vector<float> buffer{ 0.0f };
+		int bufferIndex{ 0 };
+		float last{ 0.0f };
+	};
+
+	class AllPassFilter
+	{
+	public:
+
+		void setSize(int size)
+		{
+			if (size != (int)buffer.size())
+			{
+				buffer.assign((size_t)std::max(1, size), 0.0f);
+				bufferIndex = 0;
+			}
+
+			clear();
+		}
+
+		void clear() noexcept
+		{
+			std::fill(buffer.begin(), buffer.end(), 0.0f);
+		}
+
+		float process(float input) noexcept
+		{
+			const float bufferedValue = buffer[(size_t)bufferIndex];
+			float temp = input + (bufferedValue * 0.5f);
+			JUCE_UNDENORMALISE(temp);
+			buffer[(size_t)bufferIndex] = temp;
+			bufferIndex = (bufferIndex + 1) % (int)buffer.size();
+
+			return bufferedValue - input;
+		}
+
+	private:
+
+		std::vector<float> buffer{ 0.0f };
+		int bufferIndex{ 0 };
+	};
+
+	//==============================================================================
+	void processStereo(float* left, float* right, int numSamples) noexcept
+	{
+		const bool fading = isFading();
+		const int numAllPassesNew = getNumAllPasses(tier);
+		const int numAllPassesRun = fading ? std::max(numAllPassesNew, numAllPassesFadingOut) : numAllPassesNew;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const float input = (left[i] + right[i]) * gain;
+			float outL = 0, outR = 0;
+
+			const float damp = damping.getNextValue();
+			const float feedbck = feedback.getNextValue();
+			const float fadeGain = fading ? getFadeGain(i) : 1.0f;
+
+			for (int k = 0; k < numCombsActive; ++k)
+			{
+				const auto j = (size_t)combsActive[(size_t)k];
+				const float g = fading ? combGainsFadingOut[j] + (combGains[j] - combGainsFadingOut[j]) * fadeGain : combGains[j];
+
+				outL += combs[0][j].process(input, damp, feedbck) * g;
+				outR += combs[1][j].process(input, damp, feedbck) * g;
+			}
+
+			float outLEco = outL, outREco = outR;
+
+			for (int j = 0; j < numAllPassesRun; ++j)
+			{
+				outL = allPasses[0][(size_t)j].process(outL);
+				outR = allPasses[1][(size_t)j].process(outR);
+
+				if (j + 1 == NUM_ALL_PASSES_ECO)
+				{
+					outLEco = outL;
+					outREco = outR;
+				}
+			}
+
+			if (fading)
+			{
+				outL = mixAllPassOutputs(outLEco, outL, numAllPassesNew, fadeGain);
+				outR = mixAllPassOutputs(outREco, outR, numAllPassesNew, fadeGain);
+			}
+
+			const float dry = dryGain.getNextValue();
+			const float wet1 = wetGain1.getNextValue();
+			const float wet2 = wetGain2.getNextValue();
+
+			left[i] = outL * wet1 + outR * wet2 + left[i] * dry;
+			right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
+		}
+	}
+
+	void processMono(float* samples, int numSamples) noexcept
+	{
+		const bool fading = isFading();
+		const int numAllPassesNew = getNumAllPasses(tier);
+		const int numAllPassesRun = fading ? std::max(numAllPassesNew, numAllPassesFadingOut) : numAllPassesNew;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const float input = samples[i] * gain;
+			float output = 0;
+
+			const float damp = damping.getNextValue();
+			const float feedbck = feedback.getNextValue();
+			const float fadeGain = fading ? getFadeGain(i) : 1.0f;
+
+			for (int k = 0; k < numCombsActive; ++k)
+			{
+				const auto j = (size_t)combsActive[(size_t)k];
+				const float g = fading ? combGainsFadingOut[j] + (combGains[j] - combGainsFadingOut[j]) * fadeGain : combGains[j];
+
+				output += combs[0][j].process(input, damp, feedbck) * g;
+			}
+
+			float outputEco = output;
+
+			for (int j = 0; j < numAllPassesRun; ++j)
+			{
+				output = allPasses[0][(size_t)j].process(output);
+
+				if (j + 1 == NUM_ALL_PASSES_ECO)
+					outputEco = output;
+			}
+
+			if (fading)
+				output = mixAllPassOutputs(outputEco, output, numAllPassesNew, fadeGain);
+
+			const float dry = dryGain.getNextValue();
+			const float wet1 = wetGain1.getNextValue();
+
+			samples[i] = output * wet1 + samples[i] * dry;
+		}
+	}
+
+	float getFadeGain(int i) const noexcept
+	{
+		return std::min(1.0f, (float)(fadePos + i) / (float)fadeLength);
+	}
+
+	/** Mixes the output after the all passes of the old tier into the one after those of the new tier. */
+	float mixAllPassOutputs(float outEco, float outAll, int numAllPassesNew, float fadeGain) const noexcept
+	{
+		const float outOld = (numAllPassesFadingOut == NUM_ALL_PASSES_ECO) ? outEco : outAll;
+		const float outNew = (numAllPassesNew == NUM_ALL_PASSES_ECO) ? outEco : outAll;
+
+		return outOld + (outNew - outOld) * fadeGain;
+	}
+
+	static int getNumAllPasses(Tier t) noexcept
+	{
+		return (t == Tier::eco) ? NUM_ALL_PASSES_ECO : NUM_ALL_PASSES;
+	}
+
+	static void setQualityGains(Tier t, std::array<float, NUM_COMBS>& gains) noexcept
+	{
+		for (int j = 0; j < NUM_COMBS; ++j)
+		{
+			if (t == Tier::eco)
+				gains[(size_t)j] = (j % 2 == 0) ? juce::MathConstants<float>::sqrt2 : 0.0f;
+			else
+				gains[(size_t)j] = 1.0f;
+		}
+	}
+
+	/** Lists the combs to run, those of the tier and while fading those of the old tier too. */
+	void updateCombsActive() noexcept
+	{
+		numCombsActive = 0;
+
+		for (int j = 0; j < NUM_COMBS; ++j)
+			if (combGains[(size_t)j] != 0.0f || (isFading() && combGainsFadingOut[(size_t)j] != 0.0f))
+				combsActive[(size_t)numCombsActive++] = j;
+	}
+
+	static bool isFrozen(float freezeMode) noexcept { return freezeMode >= 0.5f; }
+
+	void updateGains() noexcept
+	{
+		const float wetScaleFactor = 3.0f;
+		const float dryScaleFactor = 2.0f;
+		const auto mixGains = dryWet.getGains();
+
+		const float wet = parameters.wetLevel * wetScaleFactor * mixGains.wet;
+		dryGain.setTargetValue(parameters.dryLevel * dryScaleFactor * mixGains.dry);
+		wetGain1.setTargetValue(0.5f * wet * (1.0f + parameters.width));
+		wetGain2.setTargetValue(0.5f * wet * (1.0f - parameters.width));
+	}
+
+	void updateDamping() noexcept
+	{
+		const float roomScaleFactor = 0.28f;
+		const float roomOffset = 0.7f;
+		const float dampScaleFactor = 0.4f;
+
+		if (isFrozen(parameters.freezeMode))
+			setDamping(0.0f, 1.0f);
+		else
+			setDamping(parameters.damping * dampScaleFactor, parameters.roomSize * roomScaleFactor + roomOffset);
+	}
+
+	void setDamping(float dampingToUse, float roomSizeToUse) noexcept
+	{
+		damping.setTargetValue(dampingToUse);
+		feedback.setTargetValue(roomSizeToUse);
+	}
+
+	//==============================================================================
+	Parameters parameters;
+	float gain{ 0.015f };
+
+	/* only for the mix, law and gains, the ramps are those of the levels */
+	MrDryWet dryWet{ 0.5f };
+
+	std::array<std::array<CombFilter, NUM_COMBS>, 2> combs;
+	std::array<std::array<AllPassFilter, NUM_ALL_PASSES>, 2> allPasses;
+
+	juce::SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
+
+	Tier tier{ Tier::normal };
+	std::array<float, NUM_COMBS> combGains{};
+	std::array<float, NUM_COMBS> combGainsFadingOut{};
+	std::array<int, NUM_COMBS> combsActive{};
+	int numCombsActive{ 0 };
+	int numAllPassesFadingOut{ NUM_ALL_PASSES };
+	int fadeLength{ 1 };
+	int fadePos{ 1 };
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cmath>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrReverb.h"
+
+class MrReverbTests : public juce::UnitTest
+{
+public:
+
+    MrReverbTests() : juce::UnitTest("MrReverb testing") {}
+
+    void runTest() override
+    {
+        beginTest("When at the normal tier then the output equals the JUCE reverb.");
+        {
+            const int numSamples = 8192;
+            const int blockSize = 512;
+            const auto deltaExpected = 0.00001f;
+
+            /// prepare...
+            juce::AudioBuffer<float> bufferActual(2, numSamples);
+            juce::dsp::AudioBlock<float> blockActual(bufferActual);
+            MrSignal::whiteNoise(blockActual, 0.5f);
+            MrSignal::whiteNoise(blockActual.getSingleChannelBlock(1), 0.5f, 7);
+
+            juce::AudioBuffer<float> bufferExpected;
+            bufferExpected.makeCopyOf(bufferActual);
+            juce::dsp::AudioBlock<float> blockExpected(bufferExpected);
+
+            juce::dsp::Reverb::Parameters params;
+            params.roomSize = 0.8f;
+            params.damping = 0.3f;
+            params.width = 0.7f;
+
+            juce::dsp::Reverb reverbExpected;
+            reverbExpected.prepare(createSpec(2, blockSize));
+            reverbExpected.setParameters(params);
+
+            MrReverb reverb;
+            reverb.prepare(createSpec(2, blockSize));
+            reverb.setParameters(params);
+
+            /// execute...
+            for (int i = 0; i < numSamples; i += blockSize)
+            {
+                auto subBlockActual = blockActual.getSubBlock((size_t)i, (size_t)blockSize);
+                reverb.process(juce::dsp::ProcessContextReplacing<float>(subBlockActual));
+
+                auto subBlockExpected = blockExpected.getSubBlock((size_t)i, (size_t)blockSize);
+                reverbExpected.process(juce::dsp::ProcessContextReplacing<float>(subBlockExpected));
+            }
+
+            /// evaluate...
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    expect(std::abs(bufferActual.getSample(channel, i) - bufferExpected.getSample(channel, i)) < deltaExpected);
+        }
+
+        beginTest("When at the eco tier then the tail keeps about the level of the normal tier.");
+        {
+            const int numSamples = 48000;
+
+            /// prepare...
+            const MrQuality::Tier tiers[] = { MrQuality::Tier::eco, MrQuality::Tier::normal };
+            float rms[2];
+
+            /// execute...
+            for (int n = 0; n < 2; ++n)
+            {
+                juce::AudioBuffer<float> buffer(2, numSamples);
+                juce::dsp::AudioBlock<float> block(buffer);
+                MrSignal::impulse(block, 1.0f);
+
+                MrReverb reverb;
+                reverb.prepare(createSpec(2, numSamples));
+                reverb.setQuality(tiers[n]);
+                reverb.reset();
+
+                auto params = reverb.getParameters();
+                params.dryLevel = 0.0f;
+                reverb.setParameters(params);
+
+                reverb.process(juce::dsp::ProcessContextReplacing<float>(block));
+                rms[n] = buffer.getRMSLevel(0, 0, numSamples);
+            }
+
+            /// evaluate...
+            const float levelDiffInDb = juce::Decibels::gainToDecibels(rms[0] / rms[1]);
+            expect(std::abs(levelDiffInDb) < 3.0f);
+        }
+
+        beginTest("When the tier changes while playing then the crossfade ends and the output stays bounded.");
+        {
+            const int numSamples = 48000;
+            const int blockSize = 480;
+
+            /// prepare...
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::whiteNoise(block, 0.5f);
+
+            MrReverb reverb;
+            reverb.prepare(createSpec(2, blockSize));
+
+            /// execute...
+            bool isFadingAfterSwitch = false;
+            for (int i = 0; i < numSamples; i += blockSize)
+            {
+                const int numBlock = i / blockSize;
+                reverb.setQuality((numBlock / 10) % 2 == 0 ? MrQuality::Tier::normal : MrQuality::Tier::eco);
+
+                auto subBlock = block.getSubBlock((size_t)i, (size_t)blockSize);
+                reverb.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+
+                if (numBlock % 10 == 0 && numBlock > 0)
+                    isFadingAfterSwitch |= reverb.isFading();
+            }
+
+            /// evaluate...
+            expect(isFadingAfterSwitch);
+            expect(!reverb.isFading());
+            expect(buffer.getMagnitude(0, numSamples) < 4.0f);
+        }
+    }
+
+private:
+
+    static juce::dsp::ProcessSpec createSpec(int numChnls, int blockSize)
+    {
+        juce::dsp::ProcessSpec spec;
+        spec.numChannels = (juce::uint32)numChnls;
+        spec.sampleRate = 48000;
+        spec.maximumBlockSize = (juce::uint32)blockSize;
+        return spec;
+    }
+};
+
+static MrReverbTests reverbTests;
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <JuceHeader.h>
+
+#if defined(__F16C__)
+ #include <immintrin.h>
+#elif JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+/**
+	Conversions between float and the 16 bit sample formats used for compact storage.
+
+	Fixed point stores the samples scaled down by FIXED16_HEADROOM, so signals up to
+	+12 dBFS survive, and is quantised with TPDF dither. Half float keeps the relative
+	precision (11 bit mantissa) over the whole range and is rounded to nearest even.
+
+	Fixed point uses SSE2 where available, since the clamping keeps compilers from
+	vectorising the plain loop. Half float uses the F16C instructions when the target
+	supports them, the fallbacks are branch free bit manipulations.
+*/
+class MrSampleFormat
+{
+public:
+
+	static constexpr float FIXED16_HEADROOM = 4.0f;
+	static constexpr int DITHER_TABLE_SIZE = 4096;
+
+	//==============================================================================
+	/** Converts to 16 bit fixed point adding TPDF dither, ditherPos is advanced by num. */
+	static void floatToFixed16(uint16_t* dest, const float* src, int num, int& ditherPos) noexcept
+	{
+		const float scale = 32767.0f / FIXED16_HEADROOM;
+
+		while (num > 0)
+		{
+			/* contiguous run of the dither table, so the loop needs no gather */
+			const float* dither = getDitherTable().data() + ditherPos;
+			const int numRun = std::min(num, DITHER_TABLE_SIZE - ditherPos);
+			int i = 0;
+
+		   #if JUCE_USE_SSE_INTRINSICS
+			const __m128 scaleV = _mm_set1_ps(scale);
+			const __m128 minV = _mm_set1_ps(-32768.0f);
+			const __m128 maxV = _mm_set1_ps(32767.0f);
+
+			for (; i + 4 <= numRun; i += 4)
+			{
+				__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scaleV), _mm_loadu_ps(dither + i));
+				v = _mm_min_ps(_mm_max_ps(v, minV), maxV);
+
+				const __m128i q = _mm_cvtps_epi32(v);
+				_mm_storel_epi64((__m128i*)(dest + i), _mm_packs_epi32(q, q));
+			}
+		   #endif
+
+			for (; i < numRun; ++i)
+			{
+				float v = src[i] * scale + dither[i];
+				v = std::min(32767.0f, std::max(-32768.0f, v));
+
+				/* offset to positive so truncating rounds to nearest */
+				dest[i] = (uint16_t)((int32_t)(v + 32768.5f) - 32768);
+			}
+
+			dest += numRun;
+			src += numRun;
+			num -= numRun;
+			ditherPos = (ditherPos + numRun) & (DITHER_TABLE_SIZE - 1);
+		}
+	}
+
+	/** Converts from 16 bit fixed point. */
+	static void fixed16ToFloat(float* dest, const uint16_t* src, int num) noexcept
+	{
+		const float scale = FIXED16_HEADROOM / 32767.0f;
+
+		for (int i = 0; i < num; ++i)
+			dest[i] = (float)(int16_t)src[i] * scale;
+	}
+
+	//==============================================================================
+	/** Converts to IEEE 754 half float. */
+	static void floatToHalf(uint16_t* dest, const float* src, int num) noexcept
+	{
+		int i = 0;
+
+	   #if defined(__F16C__)
+		for (; i + 4 <= num; i += 4)
+			_mm_storel_epi64((__m128i*)(dest + i), _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+	   #endif
+
+		for (; i < num; ++i)
+			dest[i] = floatToHalf(src[i]);
+	}
+
+	/** Converts from IEEE 754 half float. */
+	static void halfToFloat(float* dest, const uint16_t* src, int num) noexcept
+	{
+		int i = 0;
+
+	   #if defined(__F16C__)
+		for (; i + 4 <= num; i += 4)
+			_mm_storeu_ps(dest + i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)(src + i))));
+	   #endif
+
+		for (; i < num; ++i)
+			dest[i] = halfToFloat(src[i]);
+	}
+
+	//==============================================================================
+	/** Rounds a float to the nearest half float, overflow becomes infinity. */
+	static uint16_t floatToHalf(float value) noexcept
+	{
+		const uint32_t f16Max = (127 + 16) << 23;
+		const uint32_t f32Infinity = 255u << 23;
+		const uint32_t denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+		uint32_t bits = toBits(value);
+		const uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint32_t half;
+
+		if (bits >= f16Max)
+		{
+			half = (bits > f32Infinity) ? 0x7e00u : 0x7c00u;
+		}
+		else if (bits < (113u << 23))
+		{
+			half = toBits(fromBits(bits) + fromBits(denormMagic)) - denormMagic;
+		}
+		else
+		{
+			const uint32_t mantissaOdd = (bits >> 13) & 1u;
+			bits += ((uint32_t)(15 - 127) << 23) + 0xfffu;
+			bits += mantissaOdd;
+			half = bits >> 13;
+		}
+
+		return (uint16_t)(half | (sign >> 16));
+	}
+
+	/** Converts a half float to float exactly. */
+	static float halfToFloat(uint16_t half) noexcept
+	{
+		const uint32_t shiftedExp = 0x7c00u << 13;
+		const float magic = fromBits(113u << 23);
+
+		uint32_t bits = ((uint32_t)half & 0x7fffu) << 13;
+		const uint32_t exp = shiftedExp & bits;
+		bits += (uint32_t)(127 - 15) << 23;
+
+		if (exp == shiftedExp)
+			bits += (uint32_t)(128 - 16) << 23;
+		else if (exp == 0)
+			bits = toBits(fromBits(bits + (1u << 23)) - magic);
+
+		return fromBits(bits | (((uint32_t)half & 0x8000u) << 16));
+	}
+
+private:
+
+	static uint32_t toBits(float value) noexcept
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	static float fromBits(uint32_t bits) noexcept
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/** Triangular dither of +-1 LSB, generated once with a fixed seed so renders are reproducible. */
+	static const std::array<float, DITHER_TABLE_SIZE>& getDitherTable() noexcept
+	{
+		static const std::array<float, DITHER_TABLE_SIZE> table = []
+		{
+			std::array<float, DITHER_TABLE_SIZE> dither{};
+			uint32_t seed = 0x12345678u;
+
+			auto nextUniform = [&seed]
+			{
+				seed = seed * 1664525u + 1013904223u;
+				return (float)(seed >> 8) / (float)(1u << 24);
+			};
+
+			for (auto& d : dither)
+				d = nextUniform() + nextUniform() - 1.0f;
+
+			return dither;
+		}();
+
+		return table;
+	}
+};
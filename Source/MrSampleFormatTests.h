@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <JuceHeader.h>
+#include "MrSampleFormat.h"
+
+class MrSampleFormatTests : public juce::UnitTest
+{
+public:
+
+    MrSampleFormatTests() : juce::UnitTest("MrSampleFormat testing") {}
+
+    void runTest() override
+    {
+        beginTest("When converting values representable in half float then the round trip is exact.");
+        {
+            const float values[] = { 0.0f, 1.0f, -2.0f, 0.5f, 0.333251953125f, 65504.0f, 6.103515625e-05f, 5.9604644775390625e-08f };
+
+            for (auto value : values)
+            {
+                /// execute...
+                auto actual = MrSampleFormat::halfToFloat(MrSampleFormat::floatToHalf(value));
+
+                /// evaluate...
+                expect(actual == value);
+            }
+        }
+
+        beginTest("When converting a block to half float then the error is within the half float precision.");
+        {
+            const int numSamples = 1000;
+            const float relativeErrorMax = 1.0f / 2048.0f;
+
+            std::vector<float> source(numSamples), actual(numSamples);
+            std::vector<uint16_t> compact(numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                source[(size_t)i] = std::sin(0.1f * (float)i) * (float)(i + 1) * 0.01f;
+
+            /// execute...
+            MrSampleFormat::floatToHalf(compact.data(), source.data(), numSamples);
+            MrSampleFormat::halfToFloat(actual.data(), compact.data(), numSamples);
+
+            /// evaluate...
+            for (int i = 0; i < numSamples; ++i)
+                expect(abs(actual[(size_t)i] - source[(size_t)i]) <= abs(source[(size_t)i]) * relativeErrorMax + 1e-7f);
+        }
+
+        beginTest("When converting a block to fixed point then the error is within one step and the headroom clips.");
+        {
+            const int numSamples = 1000;
+            const float stepSize = MrSampleFormat::FIXED16_HEADROOM / 32767.0f;
+
+            std::vector<float> source(numSamples), actual(numSamples);
+            std::vector<uint16_t> compact(numSamples);
+            int ditherPos = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+                source[(size_t)i] = std::sin(0.1f * (float)i) * 3.0f;
+
+            source[0] = 2.0f * MrSampleFormat::FIXED16_HEADROOM;
+
+            /// execute...
+            MrSampleFormat::floatToFixed16(compact.data(), source.data(), numSamples, ditherPos);
+            MrSampleFormat::fixed16ToFloat(actual.data(), compact.data(), numSamples);
+
+            /// evaluate...
+            expect(abs(actual[0] - MrSampleFormat::FIXED16_HEADROOM) < stepSize);
+
+            for (int i = 1; i < numSamples; ++i)
+                expect(abs(actual[(size_t)i] - source[(size_t)i]) <= 1.5f * stepSize);
+
+            expect(ditherPos == numSamples);
+        }
+    }
+};
+
+static MrSampleFormatTests sampleFormatTests;
@@ -3,55 +3,352 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+
 #include <JuceHeader.h>
 
+/**
+    Test signal generators writing straight into an AudioBlock (or an AudioBuffer, which
+    converts to one), without allocating.
+
+    Every generator is a pure function of the position in the stream: startSample is the
+    index of the first sample of the block within the signal. Rendering a long signal in
+    blocks therefore gives the same samples as rendering it at once, and blocks can be
+    rendered in any order or in parallel. Noise is seeded, so every run is reproducible.
+
+    The signal is computed once into the first channel in vectorisable loops and copied to
+    the other channels, all channels carry the same signal.
+*/
 class MrSignal
 {
 
 public:
 
+    static constexpr int MLS_ORDER_MIN = 2;
+    static constexpr int MLS_ORDER_MAX = 24;
+    static constexpr int NUM_PINK_ROWS = 15;
+    static constexpr uint32_t SEED = 0x2545f491u;
+
     /* creates a signal with an inital impulse followed by zeros as long as number of samples */
     static void impulse(const juce::AudioSourceChannelInfo& audioSrcChnlInfo, float ampImpulse)
     {
-        std::vector<float> signal(audioSrcChnlInfo.numSamples, 0);
-        
-        signal.at(0) = ampImpulse;
-
-        copyToChannels(audioSrcChnlInfo, signal);
+        impulse(toBlock(audioSrcChnlInfo), ampImpulse);
     }
 
     /* creates ramp i.e. (0.1, 0.2, 0.3, 0.4), would need improvment for more universal purpose */
     static void ramp(const juce::AudioSourceChannelInfo& audioSrcChnlInfo)
     {
-        auto numSampls = audioSrcChnlInfo.numSamples;
-        std::vector<float> signal(numSampls, 0);
-        
-        auto fac = 0.1f;
-        //auto x = numSampls;
-        //while (x > 10)
-        //{
-        //    fac *= fac;
-        //    x /= 10;
-        //}
+        ramp(toBlock(audioSrcChnlInfo));
+    }
+
+    //==============================================================================
+    /* writes zeros */
+    static void silence(const juce::dsp::AudioBlock<float>& block)
+    {
+        block.clear();
+    }
+
+    /* writes an impulse of the given amplitude to the first sample followed by zeros */
+    static void impulse(const juce::dsp::AudioBlock<float>& block, float ampImpulse)
+    {
+        block.clear();
+
+        if (block.getNumSamples() > 0)
+            for (size_t c = 0; c < block.getNumChannels(); ++c)
+                block.getChannelPointer(c)[0] = ampImpulse;
+    }
+
+    /* writes impulses at every sample of the stream that is a multiple of periodInSmpls */
+    static void impulseTrain(const juce::dsp::AudioBlock<float>& block, int64_t periodInSmpls, float ampImpulse, int64_t startSample = 0)
+    {
+        jassert(periodInSmpls > 0 && startSample >= 0);
+
+        block.clear();
+
+        const auto numSamples = (int64_t)block.getNumSamples();
+
+        for (auto pos = ((startSample + periodInSmpls - 1) / periodInSmpls) * periodInSmpls - startSample; pos < numSamples; pos += periodInSmpls)
+            for (size_t c = 0; c < block.getNumChannels(); ++c)
+                block.getChannelPointer(c)[pos] = ampImpulse;
+    }
+
+    /* writes the ramp 0.1, 0.2, 0.3... counted from the first sample of the stream */
+    static void ramp(const juce::dsp::AudioBlock<float>& block, int64_t startSample = 0)
+    {
+        generate(block, [startSample](float* dest, int num)
+            {
+                for (int i = 0; i < num; ++i)
+                    dest[i] = 0.1f * (float)(startSample + i + 1);
+            });
+    }
+
+    //==============================================================================
+    /* writes a sine starting at phase 0 for sample 0 of the stream */
+    static void sine(const juce::dsp::AudioBlock<float>& block, double frequencyInHz, double sampleRate, float amp = 1.0f, int64_t startSample = 0)
+    {
+        const double phaseInc = frequencyInHz / sampleRate;
 
-        int i = 1;
-        for (auto iter = signal.begin(); iter != signal.end(); ++iter, ++i)
-            *iter = fac * i;
+        generate(block, [=](float* dest, int num)
+            {
+                int start = 0;
 
-        copyToChannels(audioSrcChnlInfo, signal);
+                while (start < num)
+                {
+                    /* blocks are aligned to the stream, so every sample comes out the same however the stream is split */
+                    const int64_t blockStart = ((startSample + start) / BLOCK_SIZE) * BLOCK_SIZE;
+                    const int offset = (int)(startSample + start - blockStart);
+                    const int numBlock = std::min(num - start, BLOCK_SIZE - offset);
+
+                    /* the phase at the start of each block is computed in double precision, so the error does not grow */
+                    const double phase = (double)blockStart * phaseInc;
+                    const float phaseStart = (float)(phase - std::floor(phase));
+                    const float phaseIncFloat = (float)phaseInc;
+
+                    for (int i = 0; i < numBlock; ++i)
+                        dest[start + i] = amp * sinCycles(phaseStart + phaseIncFloat * (float)(offset + i));
+
+                    start += numBlock;
+                }
+            });
+    }
+
+    /*
+        writes an exponential (log) sweep from startFreqInHz to endFreqInHz lasting numSweepSmpls
+        samples, with phase 0 at sample 0 of the stream, and zeros after its end
+    */
+    static void logSweep(const juce::dsp::AudioBlock<float>& block, double startFreqInHz, double endFreqInHz, int64_t numSweepSmpls,
+                         double sampleRate, float amp = 1.0f, int64_t startSample = 0)
+    {
+        jassert(startFreqInHz > 0.0 && endFreqInHz > 0.0 && startFreqInHz != endFreqInHz && numSweepSmpls > 0);
+
+        /* phase in cycles: startFreq / sampleRate * k * (exp(n / k) - 1) with k = numSweepSmpls / ln(endFreq / startFreq) */
+        const double k = (double)numSweepSmpls / std::log(endFreqInHz / startFreqInHz);
+        const double phaseIncStart = startFreqInHz / sampleRate;
+
+        /* phase growth within a block relative to the rate at its start, shared by all blocks */
+        std::array<float, BLOCK_SIZE> growth;
+        for (int i = 0; i < BLOCK_SIZE; ++i)
+            growth[(size_t)i] = (float)(k * std::expm1((double)i / k));
+
+        generate(block, [&](float* dest, int num)
+            {
+                int start = 0;
+
+                while (start < num)
+                {
+                    /* blocks are aligned to the stream, see sine() */
+                    const int64_t blockStart = ((startSample + start) / BLOCK_SIZE) * BLOCK_SIZE;
+                    const int offset = (int)(startSample + start - blockStart);
+                    const int numBlock = std::min(num - start, BLOCK_SIZE - offset);
+                    const int numSweep = (int)juce::jlimit<int64_t>(0, numBlock, numSweepSmpls - (startSample + start));
+
+                    const double rate = std::exp((double)blockStart / k);
+                    const double phase = phaseIncStart * k * (rate - 1.0);
+                    const float phaseStart = (float)(phase - std::floor(phase));
+                    const float phaseIncFloat = (float)(phaseIncStart * rate);
+
+                    for (int i = 0; i < numSweep; ++i)
+                        dest[start + i] = amp * sinCycles(phaseStart + phaseIncFloat * growth[(size_t)(offset + i)]);
+
+                    std::fill(dest + start + numSweep, dest + start + numBlock, 0.0f);
+
+                    start += numBlock;
+                }
+            });
+    }
+
+    //==============================================================================
+    /* writes uniformly distributed white noise within +-amp */
+    static void whiteNoise(const juce::dsp::AudioBlock<float>& block, float amp = 1.0f, uint32_t seed = SEED, int64_t startSample = 0)
+    {
+        const uint32_t key = hash(seed);
+        const float scale = amp / 2147483648.0f;
+
+        generate(block, [=](float* dest, int num)
+            {
+                const auto pos = (uint32_t)startSample;
+
+                for (int i = 0; i < num; ++i)
+                    dest[i] = scale * (float)(int32_t)hash((pos + (uint32_t)i) ^ key);
+            });
     }
 
-    static void copyToChannels(const juce::AudioSourceChannelInfo& audioSrcChnlInfo, std::vector<float> &signal)
+    /*
+        writes pink noise within +-amp, the sum of NUM_PINK_ROWS white noise rows of which
+        row r is held for 2^r samples (Voss-McCartney), falling by 3 dB per octave down to
+        sampleRate / 2^(NUM_PINK_ROWS + 1)
+    */
+    static void pinkNoise(const juce::dsp::AudioBlock<float>& block, float amp = 1.0f, uint32_t seed = SEED, int64_t startSample = 0)
     {
-        for (int chnlNum = 0; chnlNum < audioSrcChnlInfo.buffer->getNumChannels(); ++chnlNum)
+        /* rows from NUM_FAST_ROWS on are constant within a block aligned to BLOCK_SIZE */
+        static constexpr int NUM_FAST_ROWS = 6;
+        static_assert((1 << NUM_FAST_ROWS) == BLOCK_SIZE, "the slow rows must be constant per block");
+
+        std::array<uint32_t, NUM_PINK_ROWS + 1> keys;
+        for (size_t r = 0; r < keys.size(); ++r)
+            keys[r] = hash(seed + (uint32_t)r * 0x9e3779b9u);
+
+        const float scale = amp / (2147483648.0f * (float)(NUM_PINK_ROWS + 1));
+
+        generate(block, [&](float* dest, int num)
+            {
+                int start = 0;
+
+                while (start < num)
+                {
+                    const auto pos = (uint32_t)(startSample + start);
+                    const int numBlock = std::min(num - start, BLOCK_SIZE - (int)(pos % BLOCK_SIZE));
+
+                    float slowRows = 0.0f;
+                    for (int r = NUM_FAST_ROWS; r <= NUM_PINK_ROWS; ++r)
+                        slowRows += (float)(int32_t)hash((pos >> r) ^ keys[(size_t)r]);
+
+                    for (int i = 0; i < numBlock; ++i)
+                    {
+                        const uint32_t p = pos + (uint32_t)i;
+                        float sum = slowRows;
+
+                        for (int r = 0; r < NUM_FAST_ROWS; ++r)
+                            sum += (float)(int32_t)hash((p >> r) ^ keys[(size_t)r]);
+
+                        dest[start + i] = scale * sum;
+                    }
+
+                    start += numBlock;
+                }
+            });
+    }
+
+    /*
+        writes a maximum length sequence of the given order, +-amp with a period of
+        2^order - 1 samples. Each value depends on the previous one, so this is the only
+        generator not running vectorised, it is still only a few instructions per sample.
+    */
+    static void mls(const juce::dsp::AudioBlock<float>& block, int order, float amp = 1.0f, int64_t startSample = 0)
+    {
+        jassert(order >= MLS_ORDER_MIN && order <= MLS_ORDER_MAX);
+        order = juce::jlimit(MLS_ORDER_MIN, MLS_ORDER_MAX, order);
+
+        const uint32_t poly = getMlsPolynomial(order);
+        const int64_t period = ((int64_t)1 << order) - 1;
+
+        generate(block, [&](float* dest, int num)
+            {
+                uint32_t state = getMlsState(poly, order, (uint64_t)(startSample % period));
+
+                /* branch free, the bits are random so a branch would be mispredicted half of the time */
+                for (int i = 0; i < num; ++i)
+                {
+                    const uint32_t bit = (state >> (order - 1)) & 1u;
+
+                    dest[i] = amp - 2.0f * amp * (float)bit;
+                    state = (state << 1) ^ (poly & (0u - bit));
+                }
+            });
+    }
+
+    /* returns the period of a maximum length sequence in samples */
+    static int64_t getMlsPeriod(int order)
+    {
+        return ((int64_t)1 << order) - 1;
+    }
+
+private:
+
+    static constexpr int BLOCK_SIZE = 64;
+
+    static juce::dsp::AudioBlock<float> toBlock(const juce::AudioSourceChannelInfo& audioSrcChnlInfo)
+    {
+        return juce::dsp::AudioBlock<float>(*audioSrcChnlInfo.buffer)
+            .getSubBlock((size_t)audioSrcChnlInfo.startSample, (size_t)audioSrcChnlInfo.numSamples);
+    }
+
+    /* lets fn(dest, num) write the first channel and copies it to the others */
+    template <typename Fn>
+    static void generate(const juce::dsp::AudioBlock<float>& block, Fn&& fn)
+    {
+        const auto numSamples = (int)block.getNumSamples();
+
+        if (block.getNumChannels() == 0 || numSamples == 0)
+            return;
+
+        auto* first = block.getChannelPointer(0);
+        fn(first, numSamples);
+
+        for (size_t c = 1; c < block.getNumChannels(); ++c)
+            juce::FloatVectorOperations::copy(block.getChannelPointer(c), first, numSamples);
+    }
+
+    /* sine of a phase given in cycles, phase >= 0, written without branches so loops vectorise */
+    static inline float sinCycles(float phase) noexcept
+    {
+        /* to [-0.5, 0.5] and by symmetry to [-0.25, 0.25] */
+        const float x = phase - (float)(int32_t)(phase + 0.5f);
+        const float absX = std::abs(x);
+        const float folded = std::copysign(0.25f - std::abs(0.25f - absX), x);
+
+        const float y = folded * (float)juce::MathConstants<double>::twoPi;
+        const float y2 = y * y;
+
+        /* Taylor series up to y^11, error below 4e-7 for |y| <= pi / 2 */
+        return y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f
+                 + y2 * (1.0f / 362880.0f + y2 * (-1.0f / 39916800.0f))))));
+    }
+
+    /* integer hash with good avalanche (lowbias32 by C. Wellons), vectorises as it has no state */
+    static inline uint32_t hash(uint32_t x) noexcept
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    /* primitive polynomials over GF(2), including the x^order term */
+    static uint32_t getMlsPolynomial(int order)
+    {
+        static constexpr uint32_t polys[] = {
+            0x7, 0xb, 0x13, 0x25, 0x43, 0x83, 0x11d, 0x211, 0x409, 0x805, 0x1053,
+            0x201b, 0x4443, 0x8003, 0x1100b, 0x20009, 0x40081, 0x80027, 0x100009,
+            0x200005, 0x400003, 0x800021, 0x1000087 };
+
+        static_assert(sizeof(polys) / sizeof(polys[0]) == MLS_ORDER_MAX - MLS_ORDER_MIN + 1, "one polynomial per order");
+
+        return polys[order - MLS_ORDER_MIN];
+    }
+
+    /* state of the Galois LFSR starting at 1 after numSteps steps, i.e. x^numSteps mod poly */
+    static uint32_t getMlsState(uint32_t poly, int order, uint64_t numSteps)
+    {
+        auto mulMod = [poly, order](uint32_t a, uint32_t b)
         {
-            float* const audioSmplBuf =
-                audioSrcChnlInfo.buffer->getWritePointer(chnlNum, audioSrcChnlInfo.startSample);
+            uint64_t product = 0;
+            for (int i = 0; i < order; ++i)
+                if ((b >> i) & 1u)
+                    product ^= (uint64_t)a << i;
+
+            for (int i = 2 * order - 2; i >= order; --i)
+                if ((product >> i) & 1u)
+                    product ^= (uint64_t)poly << (i - order);
 
-            int i = 0;
-            for (auto iter = signal.begin(); iter != signal.end(); ++i, ++iter) {
-                audioSmplBuf[i] = *iter;
-            }
+            return (uint32_t)product;
+        };
+
+        uint32_t result = 1;
+        uint32_t base = 2;
+
+        for (; numSteps > 0; numSteps >>= 1)
+        {
+            if (numSteps & 1u)
+                result = mulMod(result, base);
+
+            base = mulMod(base, base);
         }
+
+        return result;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "MrSignal.h"
+
+class MrSignalBenchmarks : public juce::UnitTest
+{
+public:
+
+    MrSignalBenchmarks() : juce::UnitTest("MrSignal benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        beginTest("Generation time per signal");
+        {
+            const int numChnls = 8;
+            const int blockSize = 4096;
+            const int numRuns = 500;
+            const double sampleRate = 48000;
+
+            juce::AudioBuffer<float> buffer(numChnls, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+            int64_t startSample = 0;
+
+            auto runAndLog = [&](const juce::String& name, std::function<void()> generate)
+            {
+                startSample = 0;
+
+                auto result = MrBenchmark::run([&]
+                    {
+                        generate();
+                        startSample += blockSize;
+                    }, numRuns);
+
+                logMessage(MrBenchmark::format(name + ", " + juce::String(numChnls) + " channels", result, blockSize));
+            };
+
+            runAndLog("silence", [&] { MrSignal::silence(block); });
+            runAndLog("impulse train", [&] { MrSignal::impulseTrain(block, 1000, 1.0f, startSample); });
+            runAndLog("sine", [&] { MrSignal::sine(block, 997.0, sampleRate, 1.0f, startSample); });
+            runAndLog("log sweep", [&] { MrSignal::logSweep(block, 20.0, 20000.0, 10 * (int64_t)sampleRate, sampleRate, 1.0f, startSample); });
+            runAndLog("white noise", [&] { MrSignal::whiteNoise(block, 1.0f, MrSignal::SEED, startSample); });
+            runAndLog("pink noise", [&] { MrSignal::pinkNoise(block, 1.0f, MrSignal::SEED, startSample); });
+            runAndLog("mls, order 18", [&] { MrSignal::mls(block, 18, 1.0f, startSample); });
+        }
+    }
+};
+
+static MrSignalBenchmarks signalBenchmarks;
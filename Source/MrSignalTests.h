@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cmath>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+
+class MrSignalTests : public juce::UnitTest
+{
+public:
+
+    MrSignalTests() : juce::UnitTest("MrSignal testing") {}
+
+    void runTest() override
+    {
+        beginTest("When generating a sine then it matches std::sin on all channels.");
+        {
+            /// prepare...
+            const int numSamples = 1000;
+            const double frequencyInHz = 1234.5;
+            const double sampleRate = 48000;
+            const float amp = 0.5f;
+            const auto deltaExpected = 0.0001f;
+
+            juce::AudioBuffer<float> buffer(2, numSamples);
+
+            /// execute...
+            MrSignal::sine(juce::dsp::AudioBlock<float>(buffer), frequencyInHz, sampleRate, amp);
+
+            /// evaluate...
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto expected = amp * std::sin(juce::MathConstants<double>::twoPi * frequencyInHz * i / sampleRate);
+                expect(std::abs(buffer.getSample(0, i) - (float)expected) < deltaExpected);
+                expect(buffer.getSample(1, i) == buffer.getSample(0, i));
+            }
+        }
+
+        beginTest("When generating signals in blocks then they equal the signals generated at once.");
+        {
+            /// prepare...
+            const int numSamples = 3000;
+            const int blockSize = 333;
+
+            juce::AudioBuffer<float> bufferAtOnce(1, numSamples);
+            juce::AudioBuffer<float> bufferInBlocks(1, numSamples);
+
+            /// execute...
+            for (int part = 0; part < 4; ++part)
+            {
+                juce::dsp::AudioBlock<float> atOnce(bufferAtOnce);
+                auto start = (size_t)(part * numSamples / 4);
+                auto partBlock = atOnce.getSubBlock(start, numSamples / 4);
+
+                switch (part)
+                {
+                case 0: MrSignal::whiteNoise(partBlock); break;
+                case 1: MrSignal::pinkNoise(partBlock); break;
+                case 2: MrSignal::mls(partBlock, 10); break;
+                default: MrSignal::logSweep(partBlock, 20.0, 20000.0, 48000, 48000.0); break;
+                }
+            }
+
+            juce::dsp::AudioBlock<float> inBlocks(bufferInBlocks);
+            for (int part = 0; part < 4; ++part)
+            {
+                auto partStart = part * numSamples / 4;
+
+                for (int offset = 0; offset < numSamples / 4; offset += blockSize)
+                {
+                    auto num = std::min(blockSize, numSamples / 4 - offset);
+                    auto block = inBlocks.getSubBlock((size_t)(partStart + offset), (size_t)num);
+
+                    switch (part)
+                    {
+                    case 0: MrSignal::whiteNoise(block, 1.0f, MrSignal::SEED, offset); break;
+                    case 1: MrSignal::pinkNoise(block, 1.0f, MrSignal::SEED, offset); break;
+                    case 2: MrSignal::mls(block, 10, 1.0f, offset); break;
+                    default: MrSignal::logSweep(block, 20.0, 20000.0, 48000, 48000.0, 1.0f, offset); break;
+                    }
+                }
+            }
+
+            /// evaluate...
+            for (int i = 0; i < numSamples; ++i)
+                expect(bufferInBlocks.getSample(0, i) == bufferAtOnce.getSample(0, i));
+        }
+
+        beginTest("When generating noise then it stays within the amplitude, has no offset and depends on the seed.");
+        {
+            /// prepare...
+            const int numSamples = 1 << 16;
+            const float amp = 0.25f;
+
+            juce::AudioBuffer<float> white(1, numSamples);
+            juce::AudioBuffer<float> whiteOtherSeed(1, numSamples);
+            juce::AudioBuffer<float> pink(1, numSamples);
+
+            /// execute...
+            MrSignal::whiteNoise(juce::dsp::AudioBlock<float>(white), amp);
+            MrSignal::whiteNoise(juce::dsp::AudioBlock<float>(whiteOtherSeed), amp, MrSignal::SEED + 1);
+            MrSignal::pinkNoise(juce::dsp::AudioBlock<float>(pink), amp);
+
+            /// evaluate...
+            auto range = juce::FloatVectorOperations::findMinAndMax(white.getReadPointer(0), numSamples);
+            expect(range.getStart() >= -amp && range.getEnd() <= amp);
+
+            range = juce::FloatVectorOperations::findMinAndMax(pink.getReadPointer(0), numSamples);
+            expect(range.getStart() >= -amp && range.getEnd() <= amp);
+
+            double mean = 0.0;
+            int numEqual = 0;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                mean += white.getSample(0, i);
+                numEqual += (white.getSample(0, i) == whiteOtherSeed.getSample(0, i)) ? 1 : 0;
+            }
+
+            expect(std::abs(mean / numSamples) < 0.01 * amp);
+            expect(numEqual < 10);
+        }
+
+        beginTest("When generating pink noise then it has less energy in the high frequencies than white noise.");
+        {
+            /// prepare...
+            const int numSamples = 1 << 16;
+
+            juce::AudioBuffer<float> white(1, numSamples);
+            juce::AudioBuffer<float> pink(1, numSamples);
+
+            /// execute...
+            MrSignal::whiteNoise(juce::dsp::AudioBlock<float>(white));
+            MrSignal::pinkNoise(juce::dsp::AudioBlock<float>(pink));
+
+            /// evaluate...
+            /* energy of the first difference relative to the energy, 2 for white noise */
+            auto diffRatio = [numSamples](const float* x)
+            {
+                double energy = 0.0, diffEnergy = 0.0;
+                for (int i = 1; i < numSamples; ++i)
+                {
+                    energy += x[i] * x[i];
+                    diffEnergy += (x[i] - x[i - 1]) * (x[i] - x[i - 1]);
+                }
+
+                return diffEnergy / energy;
+            };
+
+            expect(std::abs(diffRatio(white.getReadPointer(0)) - 2.0) < 0.1);
+            expect(diffRatio(pink.getReadPointer(0)) < 0.5);
+        }
+
+        beginTest("When generating a maximum length sequence then it repeats with its period and is balanced.");
+        {
+            for (int order = MrSignal::MLS_ORDER_MIN; order <= 16; ++order)
+            {
+                /// prepare...
+                const auto period = (int)MrSignal::getMlsPeriod(order);
+
+                juce::AudioBuffer<float> buffer(1, 2 * period);
+
+                /// execute...
+                MrSignal::mls(juce::dsp::AudioBlock<float>(buffer), order);
+
+                /// evaluate...
+                const float* x = buffer.getReadPointer(0);
+
+                double sum = 0.0;
+                bool isPeriodic = true;
+                for (int i = 0; i < period; ++i)
+                {
+                    sum += x[i];
+                    isPeriodic = isPeriodic && (x[i] == x[i + period]);
+                }
+
+                /* one more -1 than +1, and the circular autocorrelation is -1 at every lag */
+                double autoCorrelation = 0.0;
+                for (int i = 0; i < period; ++i)
+                    autoCorrelation += x[i] * x[(i + 1) % period];
+
+                expect(isPeriodic);
+                expectEquals((int)sum, -1);
+                expectEquals((int)autoCorrelation, -1);
+            }
+        }
+
+        beginTest("When generating an impulse train then impulses sit at the multiples of the period.");
+        {
+            /// prepare...
+            const int numSamples = 100;
+            const int64_t period = 7;
+            const int64_t startSample = 10;
+
+            juce::AudioBuffer<float> buffer(2, numSamples);
+
+            /// execute...
+            MrSignal::impulseTrain(juce::dsp::AudioBlock<float>(buffer), period, 0.5f, startSample);
+
+            /// evaluate...
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                for (int i = 0; i < numSamples; ++i)
+                    expectEquals(buffer.getSample(c, i), ((startSample + i) % period == 0) ? 0.5f : 0.0f);
+        }
+
+        beginTest("When generating a log sweep then it runs through the expected number of cycles and then stays silent.");
+        {
+            /// prepare...
+            const double sampleRate = 48000;
+            const double startFreqInHz = 100.0;
+            const double endFreqInHz = 10000.0;
+            const int numSweepSmpls = 48000;
+            const int numSamples = numSweepSmpls + 1000;
+
+            juce::AudioBuffer<float> buffer(1, numSamples);
+
+            /// execute...
+            MrSignal::logSweep(juce::dsp::AudioBlock<float>(buffer), startFreqInHz, endFreqInHz, numSweepSmpls, sampleRate);
+
+            /// evaluate...
+            const float* x = buffer.getReadPointer(0);
+
+            int numZeroCrossings = 0;
+            for (int i = 1; i < numSweepSmpls; ++i)
+                numZeroCrossings += ((x[i - 1] < 0.0f) != (x[i] < 0.0f)) ? 1 : 0;
+
+            /* the phase runs through startFreq * T * (endFreq / startFreq - 1) / ln(endFreq / startFreq) cycles */
+            const double numCycles = startFreqInHz * (numSweepSmpls / sampleRate) * (endFreqInHz / startFreqInHz - 1.0) / std::log(endFreqInHz / startFreqInHz);
+            expect(std::abs(numZeroCrossings - 2.0 * numCycles) < 4.0);
+
+            auto range = juce::FloatVectorOperations::findMinAndMax(x + numSweepSmpls, numSamples - numSweepSmpls);
+            expect(range.getStart() == 0.0f && range.getEnd() == 0.0f);
+        }
+    }
+};
+
+static MrSignalTests signalTests;
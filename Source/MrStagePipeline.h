@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <JuceHeader.h>
+
+/**
+	Runs the stages of a chain on consecutive blocks at the same time, so a chain that is
+	too heavy for one thread can still make the deadline.
+
+	The audio is cut into blocks of a fixed size. All stages but the last run on worker
+	threads of their own, the last one runs on the calling thread. While the caller fills
+	block n, the first worker processes block n - 1, the second block n - 2 and so on, each
+	stage getting a whole block period. The stages are linked by single producer, single
+	consumer queues of preallocated blocks (juce::AbstractFifo), the blocks are handed
+	on without copying or locking.
+
+	This costs a latency of numStages blocks: one to collect a block and one per worker.
+	Every block carries a Payload, e.g. the parameters of the chain, which the stages get
+	along with the audio, so changes stay in sync with the audio they were made for.
+
+	If a worker falls behind, the caller does not wait for it: the block just collected is
+	dropped and a silent one put out in place of the one the workers are not done with, so
+	the latency stays the same. These underruns are counted. In non real time, e.g. when
+	rendering offline, the caller waits instead, so no block is lost.
+*/
+template <typename Payload>
+class MrStagePipeline
+{
+public:
+
+	static constexpr int WAIT_TIMEOUT_IN_MS = 100;
+
+	using Stage = std::function<void(juce::dsp::AudioBlock<float>& block, const Payload& payload)>;
+
+	MrStagePipeline() = default;
+
+	~MrStagePipeline()
+	{
+		stop();
+	}
+
+	/**
+		Allocates the blocks and starts a worker for each stage but the last. The silent blocks
+		priming the pipeline carry payloadToStart, usually the current one, so the stages do not
+		see a default one. Not real time safe.
+	*/
+	void prepare(int numChnls, int blockSizeToUse, std::vector<Stage> stagesToRun, const Payload& payloadToStart = Payload{})
+	{
+		stop();
+
+		stages = std::move(stagesToRun);
+		blockSize = std::max(1, blockSizeToUse);
+
+		const int numStages = (int)stages.size();
+		jassert(numStages > 0);
+
+		/* the caller's filling and draining block plus the ones between the stages */
+		const int numSlots = numStages + 2;
+
+		slots.clear();
+		for (int s = 0; s < numSlots; ++s)
+			slots.push_back(std::make_unique<Slot>(numChnls, blockSize, payloadToStart));
+
+		queues.clear();
+		for (int q = 0; q < numStages; ++q)
+			queues.push_back(std::make_unique<Queue>(numSlots));
+
+		freeSlots.clear();
+		freeSlots.reserve((size_t)numSlots);
+		for (int s = 0; s < numSlots; ++s)
+			freeSlots.push_back(s);
+
+		/// prime the pipeline with silence for the latency
+		filling = takeFreeSlot();
+		draining = takeFreeSlot();
+
+		for (int n = 0; n < numStages - 1; ++n)
+			queues.back()->push(takeFreeSlot());
+
+		fillPos = 0;
+		numUnderruns = 0;
+
+		workers.clear();
+		for (int w = 0; w < numStages - 1; ++w)
+			workers.push_back(std::make_unique<Worker>(*this, w));
+
+		for (auto& worker : workers)
+			worker->startThread(juce::Thread::realtimeAudioPriority);
+	}
+
+	/** Stops the workers, blocks still in the pipeline are dropped. */
+	void stop()
+	{
+		for (auto& worker : workers)
+			worker->signalThreadShouldExit();
+
+		for (auto& worker : workers)
+		{
+			worker->wake.signal();
+			worker->stopThread(-1);
+		}
+
+		workers.clear();
+	}
+
+	bool isPrepared() const
+	{
+		return !slots.empty();
+	}
+
+	/** Lets the caller wait for the workers rather than drop blocks, for rendering offline. */
+	void setNonRealtime(bool isNonRealtimeToUse) noexcept
+	{
+		isNonRealtimeFlag = isNonRealtimeToUse;
+	}
+
+	bool isNonRealtime() const noexcept
+	{
+		return isNonRealtimeFlag;
+	}
+
+	/** Returns the number of blocks dropped since prepare() as the workers had fallen behind. */
+	int getNumUnderruns() const noexcept
+	{
+		return numUnderruns;
+	}
+
+	int getLatencyInSmpls() const
+	{
+		return (int)stages.size() * blockSize;
+	}
+
+	/**
+		Processes the block in place, delayed by the latency. The payload goes with the
+		samples of this block. Channels beyond the ones prepared are silenced.
+	*/
+	void process(const juce::dsp::AudioBlock<float>& block, const Payload& payload)
+	{
+		const auto numSamples = (int)block.getNumSamples();
+		const auto numChnls = std::min(block.getNumChannels(), (size_t)slots.front()->buffer.getNumChannels());
+
+		// they would come out unprocessed and without the latency, out of sync with the others
+		jassert(block.getNumChannels() <= numChnls);
+		for (size_t c = numChnls; c < block.getNumChannels(); ++c)
+			block.getSingleChannelBlock(c).clear();
+
+		for (int pos = 0; pos < numSamples;)
+		{
+			const int num = std::min(numSamples - pos, blockSize - fillPos);
+
+			auto& in = slots[(size_t)filling]->buffer;
+			auto& out = slots[(size_t)draining]->buffer;
+
+			for (size_t c = 0; c < numChnls; ++c)
+			{
+				auto* samples = block.getChannelPointer(c) + pos;
+				in.copyFrom((int)c, fillPos, samples, num);
+				juce::FloatVectorOperations::copy(samples, out.getReadPointer((int)c, fillPos), num);
+			}
+
+			fillPos += num;
+			pos += num;
+
+			if (fillPos == blockSize)
+				advance(payload);
+		}
+	}
+
+private:
+
+	struct Slot
+	{
+		Slot(int numChnls, int numSamples, const Payload& payloadToStart)
+			: buffer(numChnls, numSamples),
+			  payload(payloadToStart)
+		{
+			buffer.clear();
+		}
+
+		juce::AudioBuffer<float> buffer;
+		Payload payload;
+	};
+
+	/** Lock free single producer, single consumer queue of slot indices. */
+	class Queue
+	{
+	public:
+
+		explicit Queue(int capacity) : fifo(capacity + 1), indices((size_t)capacity + 1) {}
+
+		void push(int slot)
+		{
+			int start1, size1, start2, size2;
+			fifo.prepareToWrite(1, start1, size1, start2, size2);
+			jassert(size1 == 1);
+
+			indices[(size_t)start1] = slot;
+			fifo.finishedWrite(1);
+		}
+
+		/** Returns the next slot or -1 if the queue is empty. */
+		int pop()
+		{
+			int start1, size1, start2, size2;
+			fifo.prepareToRead(1, start1, size1, start2, size2);
+
+			if (size1 == 0)
+				return -1;
+
+			const int slot = indices[(size_t)start1];
+			fifo.finishedRead(1);
+
+			return slot;
+		}
+
+	private:
+
+		juce::AbstractFifo fifo;
+		std::vector<int> indices;
+	};
+
+	/** Runs one stage, taking blocks from the queue in front of it and passing them to the one behind it. */
+	class Worker : public juce::Thread
+	{
+	public:
+
+		Worker(MrStagePipeline& pipelineToServe, int stageIdxToRun)
+			: juce::Thread("Pipeline stage " + juce::String(stageIdxToRun)),
+			  pipeline(pipelineToServe),
+			  stageIdx(stageIdxToRun)
+		{
+		}
+
+		void run() override
+		{
+			auto& stage = pipeline.stages[(size_t)stageIdx];
+			auto& input = *pipeline.queues[(size_t)stageIdx];
+			auto& output = *pipeline.queues[(size_t)stageIdx + 1];
+
+			while (!threadShouldExit())
+			{
+				const int slot = input.pop();
+
+				if (slot < 0)
+				{
+					wake.wait(WAIT_TIMEOUT_IN_MS);
+					continue;
+				}
+
+				auto& s = *pipeline.slots[(size_t)slot];
+				juce::dsp::AudioBlock<float> block(s.buffer);
+				stage(block, s.payload);
+
+				output.push(slot);
+
+				if (stageIdx + 1 < (int)pipeline.workers.size())
+					pipeline.workers[(size_t)stageIdx + 1]->wake.signal();
+			}
+		}
+
+		juce::WaitableEvent wake;
+
+	private:
+
+		MrStagePipeline& pipeline;
+		const int stageIdx;
+	};
+
+	/** Hands the full block to the first stage and takes the next one to drain from the last. */
+	void advance(const Payload& payload)
+	{
+		slots[(size_t)filling]->payload = payload;
+		fillPos = 0;
+
+		/// the block the workers are done with, without workers the one just filled
+		const int slot = workers.empty() ? filling : popProcessed();
+
+		if (slot < 0)
+		{
+			// the next block put out is silence and the one just filled is filled again
+			++numUnderruns;
+			slots[(size_t)draining]->buffer.clear();
+			return;
+		}
+
+		if (!workers.empty())
+		{
+			queues.front()->push(filling);
+			workers.front()->wake.signal();
+		}
+
+		freeSlots.push_back(draining);
+		filling = takeFreeSlot();
+
+		auto& s = *slots[(size_t)slot];
+		juce::dsp::AudioBlock<float> block(s.buffer);
+		stages.back()(block, s.payload);
+
+		draining = slot;
+	}
+
+	/** Returns the next block out of the last worker or -1 if there is none, in non real time waits for it. */
+	int popProcessed()
+	{
+		int slot = queues.back()->pop();
+		while (slot < 0 && isNonRealtimeFlag)
+		{
+			std::this_thread::yield();
+			slot = queues.back()->pop();
+		}
+
+		return slot;
+	}
+
+	/** The slots start silent, later on a slot taken for filling is overwritten completely. */
+	int takeFreeSlot()
+	{
+		jassert(!freeSlots.empty());
+
+		const int slot = freeSlots.back();
+		freeSlots.pop_back();
+
+		return slot;
+	}
+
+	std::vector<Stage> stages;
+	int blockSize = 0;
+
+	std::vector<std::unique_ptr<Slot>> slots;
+	std::vector<std::unique_ptr<Queue>> queues;	/**< queue q feeds stage q, the last one feeds the caller's stage */
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	/* only touched by the caller */
+	std::vector<int> freeSlots;
+	int filling = 0;
+	int draining = 0;
+	int fillPos = 0;
+	std::atomic<int> numUnderruns { 0 };
+
+	std::atomic<bool> isNonRealtimeFlag { false };
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <vector>
+
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrStagePipeline.h"
+
+class MrStagePipelineTests : public juce::UnitTest
+{
+public:
+
+    MrStagePipelineTests() : juce::UnitTest("MrStagePipeline testing") {}
+
+    void runTest() override
+    {
+        beginTest("When blocks pass the pipeline then every stage is applied in order with the payload of the block.");
+        {
+            /// prepare...
+            const int blockSize = 64;
+            const int numBlocks = 200;
+
+            MrStagePipeline<int> pipeline;
+            pipeline.setNonRealtime(true);
+            pipeline.prepare(1, blockSize,
+                {
+                    [](juce::dsp::AudioBlock<float>& block, const int&) { block.multiplyBy(2.0f); },
+                    [](juce::dsp::AudioBlock<float>& block, const int& payload) { block.add((float)payload); },
+                    [](juce::dsp::AudioBlock<float>& block, const int&) { block.multiplyBy(3.0f); }
+                });
+
+            const int latencyInBlocks = pipeline.getLatencyInSmpls() / blockSize;
+
+            juce::AudioBuffer<float> buffer(1, blockSize * numBlocks);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::ramp(block);
+
+            /// execute...
+            for (int n = 0; n < numBlocks; ++n)
+                pipeline.process(block.getSubBlock((size_t)(n * blockSize), (size_t)blockSize), n);
+
+            /// evaluate...
+            expectEquals(latencyInBlocks, 3);
+
+            for (int n = 0; n < latencyInBlocks; ++n)
+                for (int i = 0; i < blockSize; ++i)
+                    expectEquals(buffer.getSample(0, n * blockSize + i), 0.0f);
+
+            for (int n = latencyInBlocks; n < numBlocks; ++n)
+            {
+                const int nIn = n - latencyInBlocks;
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const float in = 0.1f * (float)(nIn * blockSize + i + 1);
+                    expectWithinAbsoluteError(buffer.getSample(0, n * blockSize + i), 3.0f * (2.0f * in + (float)nIn), 0.01f);
+                }
+            }
+        }
+
+        beginTest("When the host blocks do not match the pipeline blocks then the latency stays the same.");
+        {
+            /// prepare...
+            const int blockSize = 100;
+            const int numSamples = 5000;
+            const int hostBlockSizes[] = { 64, 1, 333, 100, 17 };
+
+            MrStagePipeline<int> pipeline;
+            pipeline.setNonRealtime(true);
+            pipeline.prepare(2, blockSize,
+                {
+                    [](juce::dsp::AudioBlock<float>&, const int&) {},
+                    [](juce::dsp::AudioBlock<float>&, const int&) {}
+                });
+
+            const int latency = pipeline.getLatencyInSmpls();
+
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::ramp(block);
+
+            /// execute...
+            for (int pos = 0, n = 0; pos < numSamples; ++n)
+            {
+                const int num = std::min(numSamples - pos, hostBlockSizes[n % 5]);
+                pipeline.process(block.getSubBlock((size_t)pos, (size_t)num), 0);
+                pos += num;
+            }
+
+            /// evaluate...
+            expectEquals(latency, 2 * blockSize);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < latency; ++i)
+                    expectEquals(buffer.getSample(channel, i), 0.0f);
+
+                for (int i = latency; i < numSamples; ++i)
+                    expectEquals(buffer.getSample(channel, i), 0.1f * (float)(i - latency + 1));
+            }
+        }
+
+        beginTest("When the pipeline is primed then the silent blocks carry the payload given to prepare.");
+        {
+            /// prepare...
+            const int blockSize = 32;
+            const int numBlocks = 6;
+            const int payloadToStart = 7;
+
+            std::vector<int> payloadsLastStage;
+
+            MrStagePipeline<int> pipeline;
+            pipeline.setNonRealtime(true);
+            pipeline.prepare(1, blockSize,
+                {
+                    [](juce::dsp::AudioBlock<float>&, const int&) {},
+                    [](juce::dsp::AudioBlock<float>&, const int&) {},
+                    [&payloadsLastStage](juce::dsp::AudioBlock<float>&, const int& payload) { payloadsLastStage.push_back(payload); }
+                },
+                payloadToStart);
+
+            juce::AudioBuffer<float> buffer(1, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            /// execute...
+            for (int n = 0; n < numBlocks; ++n)
+                pipeline.process(block, 100 + n);
+
+            /// evaluate...
+            expect(payloadsLastStage == std::vector<int>({ 7, 7, 100, 101, 102, 103 }));
+        }
+
+        beginTest("When a worker falls behind in real time then the caller puts out silence and counts an underrun instead of waiting, the latency stays the same.");
+        {
+            /// prepare...
+            const int blockSize = 32;
+            const int numBlocksStalled = 8;
+            const int numBlocks = 16;
+
+            juce::WaitableEvent release;
+
+            MrStagePipeline<int> pipeline;
+            pipeline.prepare(1, blockSize,
+                {
+                    [&release](juce::dsp::AudioBlock<float>&, const int& payload) { if (payload == 0) release.wait(-1); },
+                    [](juce::dsp::AudioBlock<float>&, const int&) {}
+                });
+
+            const int latencyInBlocks = pipeline.getLatencyInSmpls() / blockSize;
+
+            juce::AudioBuffer<float> buffer(1, blockSize * numBlocks);
+            juce::dsp::AudioBlock<float> block(buffer);
+            MrSignal::ramp(block);
+
+            /// execute...
+            // the first worker holds on to block 0, the blocks after it have nowhere to go
+            for (int n = 0; n < numBlocksStalled; ++n)
+                pipeline.process(block.getSubBlock((size_t)(n * blockSize), (size_t)blockSize), n);
+
+            const int numUnderruns = pipeline.getNumUnderruns();
+
+            release.signal();
+            pipeline.setNonRealtime(true);
+
+            for (int n = numBlocksStalled; n < numBlocks; ++n)
+                pipeline.process(block.getSubBlock((size_t)(n * blockSize), (size_t)blockSize), n);
+
+            /// evaluate...
+            expectEquals(numUnderruns, numBlocksStalled - 1);
+            expectEquals(pipeline.getNumUnderruns(), numUnderruns);
+
+            for (int i = 0; i < numBlocksStalled * blockSize; ++i)
+                expectEquals(buffer.getSample(0, i), 0.0f);
+
+            // block 0 comes out once released, the blocks dropped meanwhile never do
+            for (int n = numBlocksStalled + latencyInBlocks; n < numBlocks; ++n)
+                for (int i = 0; i < blockSize; ++i)
+                    expectEquals(buffer.getSample(0, n * blockSize + i), 0.1f * (float)((n - latencyInBlocks) * blockSize + i + 1));
+        }
+    }
+};
+
+static MrStagePipelineTests stagePipelineTests;
@@ -0,0 +1,347 @@
+/*
+  ==============================================================================
+
+   This file is code written by Marcel Roth.
+
+   THE CODE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "IJuceFxChainWrapper.h"
+#include "MrChainParameters.h"
+
+/**
+	Renders audio of any length through the chain offline, in constant memory.
+
+	Reading, processing and writing run as a pipeline on three threads, so the throughput
+	is set by the slowest stage rather than the sum of all three. The stages pass a fixed
+	ring of preallocated blocks: block n lives in slot n % numBlocksInFlight, and each stage
+	publishes how many blocks it has finished in an atomic counter. A stage may work on
+	block n once the stage before it has finished n, and the reader may refill a slot once
+	the writer is done with it, so no locks are taken on the way. A stage that has to wait
+	sleeps on an event until the neighbouring stage signals progress.
+
+	renderFile() reads WAV and AIFF files memory mapped, through a window that moves
+	along the file, and falls back to a regular reader for other formats.
+*/
+class MrStreamingRenderer
+{
+public:
+
+	static constexpr juce::int64 MAP_WINDOW_IN_SMPLS = 1 << 20;
+	static constexpr int WAIT_TIMEOUT_IN_MS = 100;
+
+	struct Settings
+	{
+		int blockSize = 4096;
+		int numBlocksInFlight = 8;
+		int bitsPerSample = 24;		/**< of the output file */
+	};
+
+	struct Result
+	{
+		bool wasSuccessful = false;
+		juce::String errorMessage;
+		juce::int64 numSamples = 0;
+		bool wasMemoryMapped = false;
+
+		double secondsTotal = 0.0;
+		double secondsReading = 0.0;	/**< time the stage spent working, without waiting */
+		double secondsProcessing = 0.0;
+		double secondsWriting = 0.0;
+	};
+
+	/** Fills the first numSamples of buffer with the samples from startSample on, returns false on failure. */
+	using ReadFn = std::function<bool(juce::AudioBuffer<float>& buffer, juce::int64 startSample, int numSamples)>;
+	using ProcessFn = std::function<void(juce::dsp::AudioBlock<float>& block)>;
+	/** Consumes the first numSamples of buffer, returns false on failure. */
+	using WriteFn = std::function<bool(const juce::AudioBuffer<float>& buffer, int numSamples)>;
+
+	//==============================================================================
+	/**
+		Runs numSamples through the three stages. Reading and writing each get a thread of
+		their own, processing runs on the calling thread. The blocks are passed in order.
+	*/
+	static Result run(int numChnls, juce::int64 numSamples, const Settings& settings,
+					  const ReadFn& read, const ProcessFn& process, const WriteFn& write)
+	{
+		Pipeline pipeline(numChnls, numSamples, settings);
+
+		const auto start = juce::Time::getHighResolutionTicks();
+
+		StageThread reader("Render reader", [&] { pipeline.runReader(read); });
+		StageThread writer("Render writer", [&] { pipeline.runWriter(write); });
+
+		reader.startThread();
+		writer.startThread();
+
+		pipeline.runProcessor(process);
+
+		reader.waitForThreadToExit(-1);
+		writer.waitForThreadToExit(-1);
+
+		auto result = pipeline.getResult();
+		result.secondsTotal = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+		return result;
+	}
+
+	/** Renders a file through the chain, which is prepared for the sample rate and channels of the file. */
+	static Result renderFile(const juce::File& inputFile, const juce::File& outputFile, IJuceFxChainWrapper& chain,
+							 const MrChainParameters::Values& parameters, const Settings& settings)
+	{
+		Result result;
+
+		juce::AudioFormatManager formatManager;
+		formatManager.registerBasicFormats();
+
+		/// input, memory mapped where the format supports it
+		auto* inputFormat = formatManager.findFormatForFileExtension(inputFile.getFileExtension());
+
+		std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader(
+			inputFormat != nullptr ? inputFormat->createMemoryMappedReader(inputFile) : nullptr);
+
+		std::unique_ptr<juce::AudioFormatReader> streamReader;
+		if (mappedReader == nullptr)
+			streamReader.reset(formatManager.createReaderFor(inputFile));
+
+		juce::AudioFormatReader* reader = (mappedReader != nullptr) ? mappedReader.get() : streamReader.get();
+
+		if (reader == nullptr)
+			return fail(result, "could not open " + inputFile.getFullPathName());
+
+		const auto numChnls = (int)reader->numChannels;
+		const auto numSamples = reader->lengthInSamples;
+
+		/// output
+		auto* outputFormat = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+
+		if (outputFormat == nullptr || !outputFormat->getPossibleBitDepths().contains(settings.bitsPerSample))
+			return fail(result, "no format writing " + juce::String(settings.bitsPerSample) + " bit for " + outputFile.getFullPathName());
+
+		outputFile.deleteFile();
+		auto outputStream = outputFile.createOutputStream();
+
+		std::unique_ptr<juce::AudioFormatWriter> writer(outputStream != nullptr
+			? outputFormat->createWriterFor(outputStream.get(), reader->sampleRate, (unsigned int)numChnls, settings.bitsPerSample, {}, 0)
+			: nullptr);
+
+		if (writer == nullptr)
+			return fail(result, "could not write " + outputFile.getFullPathName());
+
+		outputStream.release();
+
+		/// chain
+		juce::dsp::ProcessSpec spec;
+		spec.sampleRate = reader->sampleRate;
+		spec.maximumBlockSize = (juce::uint32)settings.blockSize;
+		spec.numChannels = (juce::uint32)numChnls;
+
+		MrChainParameters::prepare(chain, spec, parameters);
+
+		/// the pipeline
+		auto read = [&](juce::AudioBuffer<float>& buffer, juce::int64 startSample, int num)
+		{
+			if (mappedReader != nullptr)
+			{
+				const juce::Range<juce::int64> needed(startSample, startSample + num);
+
+				if (!mappedReader->getMappedSection().contains(needed))
+				{
+					mappedReader->mapSectionOfFile({ startSample, std::min(numSamples, startSample + juce::jmax(MAP_WINDOW_IN_SMPLS, (juce::int64)num)) });
+
+					if (!mappedReader->getMappedSection().contains(needed))
+						return false;
+				}
+			}
+
+			reader->read(&buffer, 0, num, startSample, true, true);
+			return true;
+		};
+
+		auto process = [&](juce::dsp::AudioBlock<float>& block)
+		{
+			chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+		};
+
+		auto write = [&](const juce::AudioBuffer<float>& buffer, int num)
+		{
+			return writer->writeFromAudioSampleBuffer(buffer, 0, num);
+		};
+
+		result = run(numChnls, numSamples, settings, read, process, write);
+		result.wasMemoryMapped = (mappedReader != nullptr);
+
+		writer.reset();
+
+		return result;
+	}
+
+private:
+
+	static Result fail(Result& result, const juce::String& errorMessage)
+	{
+		result.wasSuccessful = false;
+		result.errorMessage = errorMessage;
+		return result;
+	}
+
+	//==============================================================================
+	/** Runs a function on its own thread. */
+	class StageThread : public juce::Thread
+	{
+	public:
+
+		StageThread(const juce::String& name, std::function<void()> fnToRun) : juce::Thread(name), fn(std::move(fnToRun)) {}
+
+		void run() override { fn(); }
+
+	private:
+
+		std::function<void()> fn;
+	};
+
+	/** The ring of blocks and the progress of each stage. */
+	class Pipeline
+	{
+	public:
+
+		Pipeline(int numChnls, juce::int64 numSamplesToRun, const Settings& settings)
+			: numSamples(numSamplesToRun),
+			  blockSize(std::max(1, settings.blockSize)),
+			  numBlocks((numSamplesToRun + blockSize - 1) / blockSize),
+			  blocks((size_t)std::max(2, settings.numBlocksInFlight), juce::AudioBuffer<float>(numChnls, blockSize))
+		{
+			result.numSamples = numSamples;
+		}
+
+		void runReader(const ReadFn& read)
+		{
+			const auto numInFlight = (juce::int64)blocks.size();
+
+			for (juce::int64 n = 0; n < numBlocks; ++n)
+			{
+				if (!waitUntil([&] { return n - numWritten.load(std::memory_order_acquire) < numInFlight; }, canRead))
+					return;
+
+				const auto start = juce::Time::getHighResolutionTicks();
+				const bool isRead = read(getBlock(n), n * blockSize, getNumSamples(n));
+				result.secondsReading += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+				if (!isRead)
+					return abort("reading failed at sample " + juce::String(n * blockSize));
+
+				numRead.store(n + 1, std::memory_order_release);
+				canProcess.signal();
+			}
+		}
+
+		void runProcessor(const ProcessFn& process)
+		{
+			for (juce::int64 n = 0; n < numBlocks; ++n)
+			{
+				if (!waitUntil([&] { return n < numRead.load(std::memory_order_acquire); }, canProcess))
+					return;
+
+				const auto start = juce::Time::getHighResolutionTicks();
+				juce::dsp::AudioBlock<float> block(getBlock(n));
+				auto subBlock = block.getSubBlock(0, (size_t)getNumSamples(n));
+				process(subBlock);
+				result.secondsProcessing += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+				numProcessed.store(n + 1, std::memory_order_release);
+				canWrite.signal();
+			}
+		}
+
+		void runWriter(const WriteFn& write)
+		{
+			for (juce::int64 n = 0; n < numBlocks; ++n)
+			{
+				if (!waitUntil([&] { return n < numProcessed.load(std::memory_order_acquire); }, canWrite))
+					return;
+
+				const auto start = juce::Time::getHighResolutionTicks();
+				const bool isWritten = write(getBlock(n), getNumSamples(n));
+				result.secondsWriting += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+				if (!isWritten)
+					return abort("writing failed at sample " + juce::String(n * blockSize));
+
+				numWritten.store(n + 1, std::memory_order_release);
+				canRead.signal();
+			}
+		}
+
+		Result getResult()
+		{
+			result.wasSuccessful = !isAborted.load() && numWritten.load() == numBlocks;
+			return result;
+		}
+
+	private:
+
+		juce::AudioBuffer<float>& getBlock(juce::int64 n) { return blocks[(size_t)(n % (juce::int64)blocks.size())]; }
+
+		int getNumSamples(juce::int64 n) const { return (int)std::min((juce::int64)blockSize, numSamples - n * blockSize); }
+
+		/** Sleeps until the condition holds, returns false if the pipeline was aborted meanwhile. */
+		template <typename Condition>
+		bool waitUntil(Condition&& condition, juce::WaitableEvent& event)
+		{
+			while (!condition())
+			{
+				if (isAborted.load(std::memory_order_acquire))
+					return false;
+
+				event.wait(WAIT_TIMEOUT_IN_MS);
+			}
+
+			return true;
+		}
+
+		void abort(const juce::String& errorMessage)
+		{
+			{
+				const juce::ScopedLock sl(errorLock);
+				if (result.errorMessage.isEmpty())
+					result.errorMessage = errorMessage;
+			}
+
+			isAborted.store(true, std::memory_order_release);
+
+			canRead.signal();
+			canProcess.signal();
+			canWrite.signal();
+		}
+
+		const juce::int64 numSamples;
+		const int blockSize;
+		const juce::int64 numBlocks;
+
+		std::vector<juce::AudioBuffer<float>> blocks;
+
+		std::atomic<juce::int64> numRead{ 0 };
+		std::atomic<juce::int64> numProcessed{ 0 };
+		std::atomic<juce::int64> numWritten{ 0 };
+		std::atomic<bool> isAborted{ false };
+
+		juce::WaitableEvent canRead;
+		juce::WaitableEvent canProcess;
+		juce::WaitableEvent canWrite;
+
+		juce::CriticalSection errorLock;
+		Result result;
+	};
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <JuceHeader.h>
+#include "MrSignal.h"
+#include "MrStreamingRenderer.h"
+
+class MrStreamingRendererTests : public juce::UnitTest
+{
+public:
+
+    MrStreamingRendererTests() : juce::UnitTest("MrStreamingRenderer testing") {}
+
+    void runTest() override
+    {
+        beginTest("When running the pipeline then all samples arrive processed and in order.");
+        {
+            /// prepare...
+            const int numChnls = 2;
+            const juce::int64 numSamples = 100000;
+            const float gain = 0.5f;
+
+            MrStreamingRenderer::Settings settings;
+            settings.blockSize = 1000;
+            settings.numBlocksInFlight = 4;
+
+            std::vector<float> output;
+            output.reserve((size_t)numSamples);
+            bool isEveryChannelEqual = true;
+
+            auto read = [](juce::AudioBuffer<float>& buffer, juce::int64 startSample, int num)
+            {
+                juce::dsp::AudioBlock<float> block(buffer);
+                MrSignal::ramp(block.getSubBlock(0, (size_t)num), startSample);
+                return true;
+            };
+
+            auto process = [gain](juce::dsp::AudioBlock<float>& block)
+            {
+                block.multiplyBy(gain);
+            };
+
+            auto write = [&](const juce::AudioBuffer<float>& buffer, int num)
+            {
+                for (int i = 0; i < num; ++i)
+                {
+                    output.push_back(buffer.getSample(0, i));
+                    isEveryChannelEqual = isEveryChannelEqual && (buffer.getSample(1, i) == buffer.getSample(0, i));
+                }
+
+                return true;
+            };
+
+            /// execute...
+            auto result = MrStreamingRenderer::run(numChnls, numSamples, settings, read, process, write);
+
+            /// evaluate...
+            expect(result.wasSuccessful);
+            expect(isEveryChannelEqual);
+            expectEquals((int)output.size(), (int)numSamples);
+
+            for (size_t i = 0; i < output.size(); ++i)
+                expectEquals(output[i], gain * 0.1f * (float)(i + 1));
+        }
+
+        beginTest("When the writer falls behind then the reader stays at most the blocks in flight ahead.");
+        {
+            /// prepare...
+            const juce::int64 numSamples = 64 * 100;
+
+            MrStreamingRenderer::Settings settings;
+            settings.blockSize = 64;
+            settings.numBlocksInFlight = 3;
+
+            std::atomic<int> numRead{ 0 };
+            std::atomic<int> numWritten{ 0 };
+            std::atomic<int> maxAhead{ 0 };
+
+            auto read = [&](juce::AudioBuffer<float>&, juce::int64, int)
+            {
+                maxAhead = std::max(maxAhead.load(), ++numRead - numWritten.load());
+                return true;
+            };
+
+            auto write = [&](const juce::AudioBuffer<float>&, int)
+            {
+                juce::Thread::sleep(numWritten % 10 == 0 ? 1 : 0);
+                ++numWritten;
+                return true;
+            };
+
+            /// execute...
+            auto result = MrStreamingRenderer::run(1, numSamples, settings, read, [](juce::dsp::AudioBlock<float>&) {}, write);
+
+            /// evaluate...
+            expect(result.wasSuccessful);
+            expectEquals(numWritten.load(), 100);
+            expect(maxAhead.load() <= settings.numBlocksInFlight);
+        }
+
+        beginTest("When a stage fails then the pipeline stops and reports the error.");
+        {
+            /// prepare...
+            const juce::int64 numSamples = 10000;
+
+            MrStreamingRenderer::Settings settings;
+            settings.blockSize = 100;
+
+            int numWritten = 0;
+
+            auto read = [](juce::AudioBuffer<float>&, juce::int64 startSample, int)
+            {
+                return startSample < 5000;
+            };
+
+            auto write = [&](const juce::AudioBuffer<float>&, int)
+            {
+                ++numWritten;
+                return true;
+            };
+
+            /// execute...
+            auto result = MrStreamingRenderer::run(1, numSamples, settings, read, [](juce::dsp::AudioBlock<float>&) {}, write);
+
+            /// evaluate...
+            expect(!result.wasSuccessful);
+            expect(result.errorMessage.contains("reading failed"));
+            expect(numWritten <= 50);
+        }
+    }
+};
+
+static MrStreamingRendererTests streamingRendererTests;
@@ -11,6 +11,29 @@
 
 /* add more test files down here*/
 #include "MrDelayTests.h"
+#include "JuceFxChainWrapperTests.h"
+#include "MrParameterEventsTests.h"
+#include "MrDspTableCacheTests.h"
+#include "MrSampleFormatTests.h"
+#include "MrLfoTests.h"
+#include "MrSignalTests.h"
+#include "MrChainParametersTests.h"
+#include "MrChainAnalyserTests.h"
+#include "MrStreamingRendererTests.h"
+#include "MrParameterGridTests.h"
+#include "MrStagePipelineTests.h"
+#include "MrLoadTestTests.h"
+#include "MrDualMonoDetectorTests.h"
+#include "MrFilterTests.h"
+#include "MrReblockerTests.h"
+#include "MrIrCacheTests.h"
+#include "MrResourceBuilderTests.h"
+#include "MrLinearPhaseFilterTests.h"
+#include "MrReverbTests.h"
+#include "MrQualityGovernorTests.h"
+#include "MrDryWetTests.h"
+#include "MrFixedDelayTests.h"
+#include "PluginProcessorTests.h"
 
 class MrUnitTestRunner : public juce::UnitTestRunner {
 
@@ -14,16 +14,17 @@ MrJuceFxChainPlusAudioProcessorEditor::MrJuceFxChainPlusAudioProcessorEditor(MrJ
 	: AudioProcessorEditor(&p), audioProcessor(p)
 {
 
-	setSize(400, 170);
+	setSize(400, 530);
 
 	createSlider(_sliderCutOffInHz, STR_CUT_OFF_IN_HZ, 100.0, 20000.0, 50.0);
 	auto cutoffInHz = audioProcessor.getCutOffInHz();
 	_sliderCutOffInHz.setValue(cutoffInHz);
 	_sliderCutOffInHz.setSkewFactorFromMidPoint(500);
 
-	createSlider(_sliderDelay, STR_DELAY, 0.0, 2000.0, 1.0);
+	createSlider(_sliderDelay, STR_DELAY, 0.0, 60000.0, 1.0);
 	auto delayInMs = audioProcessor.getDelayInMs();
 	_sliderDelay.setValue(delayInMs);
+	_sliderDelay.setSkewFactorFromMidPoint(2000);
 
 	createSlider(_sliderFeedback, STR_FEEDBACK, 0.0, 1.0, 0.01);
 	auto feedback = audioProcessor.getFeedback();
@@ -32,6 +33,82 @@ MrJuceFxChainPlusAudioProcessorEditor::MrJuceFxChainPlusAudioProcessorEditor(MrJ
 	createSlider(_sliderRoomSize, STR_ROOM_SIZE, 0.0, 1.0, 0.01);
 	auto roomsize = audioProcessor.getRoomSize();
 	_sliderRoomSize.setValue(roomsize);
+
+	_comboFeedbackMode.addItemList({ "Parallel", "Ping Pong", "Cross Feed", "Rotation" }, 1);
+	_comboFeedbackMode.setSelectedId(audioProcessor.getFeedbackMode() + 1, juce::dontSendNotification);
+	_comboFeedbackMode.onChange = [this] { audioProcessor.setFeedbackMode(_comboFeedbackMode.getSelectedId() - 1); };
+	addAndMakeVisible(&_comboFeedbackMode);
+
+	createSlider(_sliderCrossFeed, STR_CROSS_FEED, 0.0, 1.0, 0.01);
+	auto crossFeed = audioProcessor.getCrossFeed();
+	_sliderCrossFeed.setValue(crossFeed);
+
+	createSlider(_sliderDampingLowPass, STR_DAMPING_LOW_PASS, 0.0, 20000.0, 50.0);
+	_sliderDampingLowPass.setValue(audioProcessor.getDampingLowPassInHz());
+	_sliderDampingLowPass.setSkewFactorFromMidPoint(2000);
+
+	createSlider(_sliderDampingHighPass, STR_DAMPING_HIGH_PASS, 0.0, 2000.0, 10.0);
+	_sliderDampingHighPass.setValue(audioProcessor.getDampingHighPassInHz());
+	_sliderDampingHighPass.setSkewFactorFromMidPoint(200);
+
+	createSlider(_sliderSaturationDrive, STR_SATURATION_DRIVE, 0.0, 10.0, 0.1);
+	_sliderSaturationDrive.setValue(audioProcessor.getSaturationDrive());
+
+	createSlider(_sliderModulationDepth, STR_MODULATION_DEPTH, 0.0, 20.0, 0.01);
+	_sliderModulationDepth.setValue(audioProcessor.getModulationDepthInMs());
+
+	createSlider(_sliderModulationRate, STR_MODULATION_RATE, 0.01, 10.0, 0.01);
+	_sliderModulationRate.setValue(audioProcessor.getModulationRateInHz());
+	_sliderModulationRate.setSkewFactorFromMidPoint(1.0);
+
+	createSlider(_sliderModulationVoices, STR_MODULATION_VOICES, 1.0, 8.0, 1.0);
+	_sliderModulationVoices.setValue(audioProcessor.getModulationNumVoices());
+
+	createSlider(_sliderModulationStereoPhase, STR_MODULATION_STEREO_PHASE, 0.0, 1.0, 0.01);
+	_sliderModulationStereoPhase.setValue(audioProcessor.getModulationStereoPhase());
+
+	_comboQuality.addItemList({ "Eco", "Normal", "High" }, 1);
+	_comboQuality.setSelectedId(audioProcessor.getQuality() + 1, juce::dontSendNotification);
+	_comboQuality.onChange = [this] { audioProcessor.setQuality(_comboQuality.getSelectedId() - 1); };
+	addAndMakeVisible(&_comboQuality);
+
+	_toggleAdaptiveQuality.setToggleState(audioProcessor.isAdaptiveQuality(), juce::dontSendNotification);
+	_toggleAdaptiveQuality.onClick = [this] { audioProcessor.setAdaptiveQuality(_toggleAdaptiveQuality.getToggleState()); };
+	addAndMakeVisible(&_toggleAdaptiveQuality);
+
+	_comboFilterMode.addItemList({ "Low Pass", "High Pass", "Band Pass", "Notch", "Low Shelf", "High Shelf", "Peak" }, 1);
+	_comboFilterMode.setSelectedId(audioProcessor.getFilterMode() + 1, juce::dontSendNotification);
+	_comboFilterMode.onChange = [this] { audioProcessor.setFilterMode(_comboFilterMode.getSelectedId() - 1); };
+	addAndMakeVisible(&_comboFilterMode);
+
+	_comboFilterSlope.addItemList({ "12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct" }, 1);
+	_comboFilterSlope.setSelectedId(audioProcessor.getFilterSlope() + 1, juce::dontSendNotification);
+	_comboFilterSlope.onChange = [this] { audioProcessor.setFilterSlope(_comboFilterSlope.getSelectedId() - 1); };
+	addAndMakeVisible(&_comboFilterSlope);
+
+	createSlider(_sliderResonance, STR_RESONANCE, 0.1, 20.0, 0.01);
+	_sliderResonance.setValue(audioProcessor.getResonance());
+	_sliderResonance.setSkewFactorFromMidPoint(2.0);
+
+	createSlider(_sliderFilterGain, STR_FILTER_GAIN, -24.0, 24.0, 0.1);
+	_sliderFilterGain.setValue(audioProcessor.getFilterGainInDb());
+
+	createSlider(_sliderFilterMix, STR_FILTER_MIX, 0.0, 1.0, 0.01);
+	_sliderFilterMix.setValue(audioProcessor.getFilterMix());
+
+	createSlider(_sliderDelayMix, STR_DELAY_MIX, 0.0, 1.0, 0.01);
+	_sliderDelayMix.setValue(audioProcessor.getDelayMix());
+
+	createSlider(_sliderReverbMix, STR_REVERB_MIX, 0.0, 1.0, 0.01);
+	_sliderReverbMix.setValue(audioProcessor.getReverbMix());
+
+	createSlider(_sliderMix, STR_MIX, 0.0, 1.0, 0.01);
+	_sliderMix.setValue(audioProcessor.getMix());
+
+	_comboMixLaw.addItemList({ "Balance", "Linear", "Equal Power" }, 1);
+	_comboMixLaw.setSelectedId(audioProcessor.getMixLaw() + 1, juce::dontSendNotification);
+	_comboMixLaw.onChange = [this] { audioProcessor.setMixLaw(_comboMixLaw.getSelectedId() - 1); };
+	addAndMakeVisible(&_comboMixLaw);
 }
 
 MrJuceFxChainPlusAudioProcessorEditor::~MrJuceFxChainPlusAudioProcessorEditor()
@@ -61,10 +138,30 @@ void MrJuceFxChainPlusAudioProcessorEditor::paint(juce::Graphics& g)
 	g.setColour(juce::Colours::white);
 	g.setFont(15.0f);
 
-	g.drawFittedText("LP Cutoff [Hz]", 10, 10, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Cutoff [Hz]", 10, 10, 100, 20, juce::Justification::top, 1);
 	g.drawFittedText("Delay Time [ms]", 10, 30, 100, 20, juce::Justification::top, 1);
 	g.drawFittedText("Feedback [0..1]", 10, 50, 100, 20, juce::Justification::top, 1);
 	g.drawFittedText("Roomsize [0..1]", 10, 70, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Feedback Mode", 10, 90, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Cross Feed [0..1]", 10, 110, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Fb LP [Hz]", 10, 130, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Fb HP [Hz]", 10, 150, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Fb Drive", 10, 170, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mod Depth [ms]", 10, 190, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mod Rate [Hz]", 10, 210, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mod Voices", 10, 230, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mod Stereo [0..1]", 10, 250, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Quality", 10, 270, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Adaptive Quality", 10, 290, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Filter Mode", 10, 310, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Filter Slope", 10, 330, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Filter Q", 10, 350, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Filter Gain [dB]", 10, 370, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Filter Mix", 10, 390, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Delay Mix", 10, 410, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Reverb Mix", 10, 430, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mix", 10, 450, 100, 20, juce::Justification::top, 1);
+	g.drawFittedText("Mix Law", 10, 470, 100, 20, juce::Justification::top, 1);
 }
 
 void MrJuceFxChainPlusAudioProcessorEditor::resized()
@@ -73,6 +170,26 @@ void MrJuceFxChainPlusAudioProcessorEditor::resized()
 	_sliderDelay.setBounds(130, 30, getWidth() - 150, 20);
 	_sliderFeedback.setBounds(130, 50, getWidth() - 150, 20);
 	_sliderRoomSize.setBounds(130, 70, getWidth() - 150, 20);
+	_comboFeedbackMode.setBounds(130, 90, getWidth() - 150, 20);
+	_sliderCrossFeed.setBounds(130, 110, getWidth() - 150, 20);
+	_sliderDampingLowPass.setBounds(130, 130, getWidth() - 150, 20);
+	_sliderDampingHighPass.setBounds(130, 150, getWidth() - 150, 20);
+	_sliderSaturationDrive.setBounds(130, 170, getWidth() - 150, 20);
+	_sliderModulationDepth.setBounds(130, 190, getWidth() - 150, 20);
+	_sliderModulationRate.setBounds(130, 210, getWidth() - 150, 20);
+	_sliderModulationVoices.setBounds(130, 230, getWidth() - 150, 20);
+	_sliderModulationStereoPhase.setBounds(130, 250, getWidth() - 150, 20);
+	_comboQuality.setBounds(130, 270, getWidth() - 150, 20);
+	_toggleAdaptiveQuality.setBounds(130, 290, getWidth() - 150, 20);
+	_comboFilterMode.setBounds(130, 310, getWidth() - 150, 20);
+	_comboFilterSlope.setBounds(130, 330, getWidth() - 150, 20);
+	_sliderResonance.setBounds(130, 350, getWidth() - 150, 20);
+	_sliderFilterGain.setBounds(130, 370, getWidth() - 150, 20);
+	_sliderFilterMix.setBounds(130, 390, getWidth() - 150, 20);
+	_sliderDelayMix.setBounds(130, 410, getWidth() - 150, 20);
+	_sliderReverbMix.setBounds(130, 430, getWidth() - 150, 20);
+	_sliderMix.setBounds(130, 450, getWidth() - 150, 20);
+	_comboMixLaw.setBounds(130, 470, getWidth() - 150, 20);
 }
 
 void MrJuceFxChainPlusAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
@@ -87,5 +204,33 @@ void MrJuceFxChainPlusAudioProcessorEditor::sliderValueChanged(juce::Slider* sli
 		audioProcessor.setFeedback((float)slider->getValue());
 	else if (name.compare(STR_ROOM_SIZE) == 0)
 		audioProcessor.setRoomSize((float)slider->getValue());
+	else if (name.compare(STR_CROSS_FEED) == 0)
+		audioProcessor.setCrossFeed((float)slider->getValue());
+	else if (name.compare(STR_DAMPING_LOW_PASS) == 0)
+		audioProcessor.setDampingLowPassInHz((float)slider->getValue());
+	else if (name.compare(STR_DAMPING_HIGH_PASS) == 0)
+		audioProcessor.setDampingHighPassInHz((float)slider->getValue());
+	else if (name.compare(STR_SATURATION_DRIVE) == 0)
+		audioProcessor.setSaturationDrive((float)slider->getValue());
+	else if (name.compare(STR_MODULATION_DEPTH) == 0)
+		audioProcessor.setModulationDepthInMs((float)slider->getValue());
+	else if (name.compare(STR_MODULATION_RATE) == 0)
+		audioProcessor.setModulationRateInHz((float)slider->getValue());
+	else if (name.compare(STR_MODULATION_VOICES) == 0)
+		audioProcessor.setModulationNumVoices((int)slider->getValue());
+	else if (name.compare(STR_MODULATION_STEREO_PHASE) == 0)
+		audioProcessor.setModulationStereoPhase((float)slider->getValue());
+	else if (name.compare(STR_RESONANCE) == 0)
+		audioProcessor.setResonance((float)slider->getValue());
+	else if (name.compare(STR_FILTER_GAIN) == 0)
+		audioProcessor.setFilterGainInDb((float)slider->getValue());
+	else if (name.compare(STR_FILTER_MIX) == 0)
+		audioProcessor.setFilterMix((float)slider->getValue());
+	else if (name.compare(STR_DELAY_MIX) == 0)
+		audioProcessor.setDelayMix((float)slider->getValue());
+	else if (name.compare(STR_REVERB_MIX) == 0)
+		audioProcessor.setReverbMix((float)slider->getValue());
+	else if (name.compare(STR_MIX) == 0)
+		audioProcessor.setMix((float)slider->getValue());
 }
 
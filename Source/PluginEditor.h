@@ -31,6 +31,20 @@ private:
     const std::string STR_FEEDBACK = "Feedback";
     const std::string STR_CUT_OFF_IN_HZ = "CutOffInHz";
     const std::string STR_ROOM_SIZE = "RoomSize";
+    const std::string STR_CROSS_FEED = "CrossFeed";
+    const std::string STR_DAMPING_LOW_PASS = "DampingLowPassInHz";
+    const std::string STR_DAMPING_HIGH_PASS = "DampingHighPassInHz";
+    const std::string STR_SATURATION_DRIVE = "SaturationDrive";
+    const std::string STR_MODULATION_DEPTH = "ModulationDepthInMs";
+    const std::string STR_MODULATION_RATE = "ModulationRateInHz";
+    const std::string STR_MODULATION_VOICES = "ModulationNumVoices";
+    const std::string STR_MODULATION_STEREO_PHASE = "ModulationStereoPhase";
+    const std::string STR_RESONANCE = "Resonance";
+    const std::string STR_FILTER_GAIN = "FilterGainInDb";
+    const std::string STR_FILTER_MIX = "FilterMix";
+    const std::string STR_DELAY_MIX = "DelayMix";
+    const std::string STR_REVERB_MIX = "ReverbMix";
+    const std::string STR_MIX = "Mix";
 
     void createSlider(juce::Slider& slider, const std::string& name, double min, double max, double step);
     void sliderValueChanged(juce::Slider* slider) override;
@@ -43,6 +57,27 @@ private:
     juce::Slider _sliderFeedback;
     juce::Slider _sliderCutOffInHz;
     juce::Slider _sliderRoomSize;
+    juce::Slider _sliderCrossFeed;
+    juce::Slider _sliderDampingLowPass;
+    juce::Slider _sliderDampingHighPass;
+    juce::Slider _sliderSaturationDrive;
+    juce::Slider _sliderModulationDepth;
+    juce::Slider _sliderModulationRate;
+    juce::Slider _sliderModulationVoices;
+    juce::Slider _sliderModulationStereoPhase;
+    juce::Slider _sliderResonance;
+    juce::Slider _sliderFilterGain;
+    juce::Slider _sliderFilterMix;
+    juce::Slider _sliderDelayMix;
+    juce::Slider _sliderReverbMix;
+    juce::Slider _sliderMix;
+
+    juce::ComboBox _comboFeedbackMode;
+    juce::ComboBox _comboQuality;
+    juce::ToggleButton _toggleAdaptiveQuality;
+    juce::ComboBox _comboFilterMode;
+    juce::ComboBox _comboFilterSlope;
+    juce::ComboBox _comboMixLaw;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MrJuceFxChainPlusAudioProcessorEditor)
 };
@@ -8,19 +8,59 @@
 
 #pragma once
 
+#include <array>
+
 #include <JuceHeader.h>
 #include "IJuceFxChainWrapper.h"
+#include "JuceFxChainWrapper.h"
+#include "MrCacheLine.h"
+#include "MrParameterEvents.h"
 
 //==============================================================================
 /**
+    The processor, a template on the chain wrapper it holds by value, so the calls into the
+    chain on every block are direct calls on a member and not virtual calls through a
+    separately allocated object. The plugin and the console run MrJuceFxChainPlusAudioProcessor,
+    the processor on JuceFxChainWrapper, the tests one on JuceFxChainWrapperMock.
 */
-class MrJuceFxChainPlusAudioProcessor  : public juce::AudioProcessor
+template <typename ChainWrapper>
+class MrChainAudioProcessor  : public juce::AudioProcessor
 {
 public:
+    /** Indices of the parameters exposed to the host. */
+    enum ParamIdx
+    {
+        paramCutOffInHz,
+        paramDelayInMs,
+        paramFeedback,
+        paramRoomSize,
+        paramFeedbackMode,
+        paramCrossFeed,
+        paramDampingLowPassInHz,
+        paramDampingHighPassInHz,
+        paramSaturationDrive,
+        paramModulationDepthInMs,
+        paramModulationRateInHz,
+        paramModulationNumVoices,
+        paramModulationStereoPhase,
+        paramQuality,
+        paramAdaptiveQuality,
+        paramFilterMode,
+        paramFilterSlope,
+        paramResonance,
+        paramFilterGainInDb,
+        paramFilterMix,
+        paramDelayMix,
+        paramReverbMix,
+        paramMix,
+        paramMixLaw,
+        numParams
+    };
+
     //==============================================================================
-    MrJuceFxChainPlusAudioProcessor();
-    MrJuceFxChainPlusAudioProcessor(std::shared_ptr<IJuceFxChainWrapper> juceFxChainWrapper);
-    ~MrJuceFxChainPlusAudioProcessor() override;
+    /** Allocates nothing for the chain, prepareToPlay() does, as hosts create instances just to query them. */
+    MrChainAudioProcessor();
+    ~MrChainAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -32,6 +72,9 @@ public:
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    /** Passed on to the chain, which in non real time waits for its pipeline rather than drop blocks. */
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -61,16 +104,149 @@ public:
     void setFeedback(float feedback);
     float getFeedback();
 
+    void setFeedbackMode(int feedbackMode);
+    int getFeedbackMode();
+
+    void setCrossFeed(float crossFeed);
+    float getCrossFeed();
+
+    void setDampingLowPassInHz(float dampingLowPassInHz);
+    float getDampingLowPassInHz();
+
+    void setDampingHighPassInHz(float dampingHighPassInHz);
+    float getDampingHighPassInHz();
+
+    void setSaturationDrive(float saturationDrive);
+    float getSaturationDrive();
+
+    void setModulationDepthInMs(float modulationDepthInMs);
+    float getModulationDepthInMs();
+
+    void setModulationRateInHz(float modulationRateInHz);
+    float getModulationRateInHz();
+
+    void setModulationNumVoices(int modulationNumVoices);
+    int getModulationNumVoices();
+
+    void setModulationStereoPhase(float modulationStereoPhase);
+    float getModulationStereoPhase();
+
     void setCutOffInHz(float cutOffInHz);
     float getCutOffInHz();
 
+    /** Selects the filter response and slope, see MrFilter. */
+    void setFilterMode(int filterMode);
+    int getFilterMode();
+
+    void setFilterSlope(int filterSlope);
+    int getFilterSlope();
+
+    void setResonance(float resonance);
+    float getResonance();
+
+    void setFilterGainInDb(float filterGainInDb);
+    float getFilterGainInDb();
+
     void setRoomSize(float roomSize);
     float getRoomSize();
 
+    /** Sets the dry/wet mix of a stage, see JuceFxChainWrapper::setFilterMix() and the like. */
+    void setFilterMix(float filterMix);
+    float getFilterMix();
+
+    void setDelayMix(float delayMix);
+    float getDelayMix();
+
+    void setReverbMix(float reverbMix);
+    float getReverbMix();
+
+    /** Sets the dry/wet mix of the whole chain, see JuceFxChainWrapper::setMix(). */
+    void setMix(float mix);
+    float getMix();
+
+    /** Selects the law of all mixes, see JuceFxChainWrapper::setMixLaw(). */
+    void setMixLaw(int mixLaw);
+    int getMixLaw();
+
+    void setSubBlockSize(int subBlockSize);
+    int getSubBlockSize();
+
+    /** Passes the chain frames of a fixed size from the next prepareToPlay() on, see JuceFxChainWrapper::setFrameSize(). */
+    void setFrameSize(int frameSize);
+    int getFrameSize();
+
+    /** Runs the chain stages on threads of their own from the next prepareToPlay() on, see JuceFxChainWrapper::setPipelined(). */
+    void setPipelined(bool isPipelined);
+    bool isPipelined();
+
+    /** Runs the linear phase filter in place of the filter from the next prepareToPlay() on, see JuceFxChainWrapper::setLinearPhase(). */
+    void setLinearPhase(bool isLinearPhase);
+    bool isLinearPhase();
+
+    /** Builds and prepares the chain on a background thread from the next prepareToPlay() on, see JuceFxChainWrapper::setAsyncPrepare(). */
+    void setAsyncPrepare(bool isAsyncPrepare);
+    bool isAsyncPrepare();
+
+    /** Runs the filter and the delay once for dual mono input or on the mid signal only, see JuceFxChainWrapper::setChannelMode(). */
+    void setChannelMode(int channelMode);
+    int getChannelMode();
+
+    /** Selects the quality tier of all stages, see JuceFxChainWrapper::setQuality(). */
+    void setQuality(int quality);
+    int getQuality();
+
+    /** Lets the measured load lower the tier, see JuceFxChainWrapper::setAdaptiveQuality(). */
+    void setAdaptiveQuality(bool isAdaptiveQuality);
+    bool isAdaptiveQuality();
+
+    /** Returns the tier the stages run at. */
+    int getQualityInUse();
+
+    /**
+        Queues a parameter change for the next block, which is split at the given sample so
+        the change applies from there on. Has to be called from the audio thread before
+        processBlock, returns false if the queue is full. This is the only way to a sample
+        offset: the host parameters are polled once per block and their changes apply at
+        sample 0, so host automation stays block granular.
+    */
+    bool addParameterChangeEvent(int paramIdx, int sampleOffset, float value);
+
+    /** Returns the chain wrapper the processor holds, for the tests to check the calls on the mock. */
+    ChainWrapper& getChainWrapper() noexcept { return _juceFxChainWrapper; }
+
 private:
+
+    /** Tag of the state the host stores, the parameter values are its attributes. */
+    static constexpr const char* STATE_TAG = "MrJuceFxChainPlusState";
+
+    /** Only the processor on JuceFxChainWrapper has an editor. */
+    static juce::AudioProcessorEditor* createEditorFor(MrChainAudioProcessor<JuceFxChainWrapper>& processor);
+
+    template <typename OtherChainWrapper>
+    static juce::AudioProcessorEditor* createEditorFor(MrChainAudioProcessor<OtherChainWrapper>&) { return nullptr; }
+
+    void addParameters();
+    void setParameterValue(int paramIdx, float value);
+    float getParameterValue(int paramIdx) const;
+
+    /** Queues the host parameters changed since the last block at sample 0, JUCE passes no offsets for them. */
+    void collectParameterChanges();
+    void applyParameterChange(const MrParameterEvents::Event& event);
     
-    std::shared_ptr<IJuceFxChainWrapper> _juceFxChainWrapper;
+    ChainWrapper _juceFxChainWrapper;
+
+    std::array<juce::RangedAudioParameter*, numParams> _params {};
+    std::array<float, numParams> _paramValuesPolled {};
+    MrParameterEvents _paramEvents;
+
+    /* the events and polled values are written every block, keeps them off the next instance */
+    MrCacheLine::Padding _padAfter;
 
     //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MrJuceFxChainPlusAudioProcessor)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MrChainAudioProcessor)
 };
+
+using MrJuceFxChainPlusAudioProcessor = MrChainAudioProcessor<JuceFxChainWrapper>;
+
+/* defined in PluginProcessorImpl.h, instantiated in PluginProcessor.cpp */
+extern template class MrChainAudioProcessor<JuceFxChainWrapper>;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+
+#include <JuceHeader.h>
+#include "MrBenchmark.h"
+#include "PluginProcessor.h"
+
+class PluginProcessorBenchmarks : public juce::UnitTest
+{
+public:
+
+    PluginProcessorBenchmarks() : juce::UnitTest("PluginProcessor benchmarks", MrBenchmark::BENCHMARK_CATEGORY) {}
+
+    void runTest() override
+    {
+        beginTest("Instantiation, created and destroyed like in a plugin scan vs. prepared and run for a block");
+        {
+            const double sampleRate = 48000;
+            const int blockSize = 512;
+            const int numRuns = 200;
+
+            // what a host asks for when scanning, before it throws the instance away
+            auto result = MrBenchmark::run([&]
+                {
+                    auto processor = std::make_unique<MrJuceFxChainPlusAudioProcessor>();
+                    queryLikeAHost(*processor);
+                }, numRuns);
+
+            logInstancesPerSecond("scan, created, queried and destroyed", result);
+
+            // the same with another instance alive, which keeps the shared table cache in the process
+            MrJuceFxChainPlusAudioProcessor instanceAlive;
+            instanceAlive.prepareToPlay(sampleRate, blockSize);
+
+            result = MrBenchmark::run([&]
+                {
+                    auto processor = std::make_unique<MrJuceFxChainPlusAudioProcessor>();
+                    queryLikeAHost(*processor);
+                }, numRuns);
+
+            logInstancesPerSecond("scan next to a prepared instance", result);
+
+            // loaded into a track, which is where the chain allocates
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midiBuffer;
+
+            result = MrBenchmark::run([&]
+                {
+                    auto processor = std::make_unique<MrJuceFxChainPlusAudioProcessor>();
+                    processor->prepareToPlay(sampleRate, blockSize);
+
+                    buffer.clear();
+                    processor->processBlock(buffer, midiBuffer);
+                }, numRuns / 4, 2);
+
+            logInstancesPerSecond("created, prepared, run for a block and destroyed", result);
+        }
+    }
+
+private:
+
+    static void queryLikeAHost(juce::AudioProcessor& processor)
+    {
+        processor.getName();
+        processor.getTotalNumInputChannels();
+        processor.getTotalNumOutputChannels();
+        processor.acceptsMidi();
+        processor.getTailLengthSeconds();
+        processor.hasEditor();
+
+        for (auto* parameter : processor.getParameters())
+            parameter->getName(64);
+    }
+
+    void logInstancesPerSecond(const juce::String& name, const MrBenchmark::Result& result)
+    {
+        logMessage(MrBenchmark::format(name, result, 0) + ", " + juce::String(juce::roundToInt(1.0 / result.median)) + " instances/s");
+    }
+};
+
+static PluginProcessorBenchmarks pluginProcessorBenchmarks;
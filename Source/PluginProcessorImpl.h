@@ -0,0 +1,770 @@
+/*
+  ==============================================================================
+
+    The definitions of MrChainAudioProcessor. PluginProcessor.cpp instantiates the
+    processor on JuceFxChainWrapper for the plugin, the tests include this file to
+    instantiate it on JuceFxChainWrapperMock, which the plugin never sees.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <limits>
+#include <type_traits>
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+template <typename ChainWrapper>
+MrChainAudioProcessor<ChainWrapper>::MrChainAudioProcessor() :
+#ifndef JucePlugin_PreferredChannelConfigurations
+     AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ),
+#endif
+    _juceFxChainWrapper()
+{    
+    addParameters();
+}
+
+template <typename ChainWrapper>
+MrChainAudioProcessor<ChainWrapper>::~MrChainAudioProcessor()
+{
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::addParameters()
+{
+    auto addFloat = [this](int paramIdx, const char* paramId, const char* name, juce::NormalisableRange<float> range, float defaultValue)
+    {
+        auto* param = new juce::AudioParameterFloat(paramId, name, range, defaultValue);
+        addParameter(param);
+        _params[paramIdx] = param;
+    };
+
+    juce::NormalisableRange<float> rangeCutOffInHz(100.0f, 20000.0f, 1.0f);
+    rangeCutOffInHz.setSkewForCentre(500.0f);
+
+    juce::NormalisableRange<float> rangeDelayInMs(0.0f, 60000.0f, 1.0f);
+    rangeDelayInMs.setSkewForCentre(2000.0f);
+
+    juce::NormalisableRange<float> rangeDampingLowPassInHz(0.0f, 20000.0f, 1.0f);
+    rangeDampingLowPassInHz.setSkewForCentre(2000.0f);
+
+    addFloat(paramCutOffInHz, "cutOffInHz", "Filter Cutoff [Hz]", rangeCutOffInHz, 500.0f);
+    addFloat(paramDelayInMs, "delayInMs", "Delay Time [ms]", rangeDelayInMs, 750.0f);
+    addFloat(paramFeedback, "feedback", "Feedback", { 0.0f, 1.0f }, 0.5f);
+    addFloat(paramRoomSize, "roomSize", "Roomsize", { 0.0f, 1.0f }, 0.3f);
+
+    auto* feedbackMode = new juce::AudioParameterChoice("feedbackMode", "Feedback Mode",
+                                                        { "Parallel", "Ping Pong", "Cross Feed", "Rotation" }, 0);
+    addParameter(feedbackMode);
+    _params[paramFeedbackMode] = feedbackMode;
+
+    addFloat(paramCrossFeed, "crossFeed", "Cross Feed", { 0.0f, 1.0f }, 0.0f);
+    addFloat(paramDampingLowPassInHz, "dampingLowPassInHz", "Fb LP [Hz]", rangeDampingLowPassInHz, 0.0f);
+    addFloat(paramDampingHighPassInHz, "dampingHighPassInHz", "Fb HP [Hz]", { 0.0f, 2000.0f, 1.0f }, 0.0f);
+    addFloat(paramSaturationDrive, "saturationDrive", "Fb Drive", { 0.0f, 10.0f }, 0.0f);
+    addFloat(paramModulationDepthInMs, "modulationDepthInMs", "Mod Depth [ms]", { 0.0f, 20.0f, 0.01f }, 0.0f);
+    addFloat(paramModulationRateInHz, "modulationRateInHz", "Mod Rate [Hz]", { 0.01f, 10.0f, 0.01f }, 0.5f);
+
+    auto* modulationNumVoices = new juce::AudioParameterInt("modulationNumVoices", "Mod Voices", 1, 8, 1);
+    addParameter(modulationNumVoices);
+    _params[paramModulationNumVoices] = modulationNumVoices;
+
+    addFloat(paramModulationStereoPhase, "modulationStereoPhase", "Mod Stereo Phase", { 0.0f, 1.0f }, 0.25f);
+
+    auto* quality = new juce::AudioParameterChoice("quality", "Quality", { "Eco", "Normal", "High" }, 1);
+    addParameter(quality);
+    _params[paramQuality] = quality;
+
+    auto* adaptiveQuality = new juce::AudioParameterBool("adaptiveQuality", "Adaptive Quality", false);
+    addParameter(adaptiveQuality);
+    _params[paramAdaptiveQuality] = adaptiveQuality;
+
+    auto* filterMode = new juce::AudioParameterChoice("filterMode", "Filter Mode",
+                                                      { "Low Pass", "High Pass", "Band Pass", "Notch", "Low Shelf", "High Shelf", "Peak" }, 0);
+    addParameter(filterMode);
+    _params[paramFilterMode] = filterMode;
+
+    auto* filterSlope = new juce::AudioParameterChoice("filterSlope", "Filter Slope",
+                                                       { "12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct" }, 0);
+    addParameter(filterSlope);
+    _params[paramFilterSlope] = filterSlope;
+
+    juce::NormalisableRange<float> rangeResonance(0.1f, 20.0f, 0.01f);
+    rangeResonance.setSkewForCentre(2.0f);
+
+    addFloat(paramResonance, "resonance", "Filter Q", rangeResonance, 5.0f);
+    addFloat(paramFilterGainInDb, "filterGainInDb", "Filter Gain [dB]", { -24.0f, 24.0f, 0.1f }, 0.0f);
+
+    addFloat(paramFilterMix, "filterMix", "Filter Mix", { 0.0f, 1.0f }, 1.0f);
+    addFloat(paramDelayMix, "delayMix", "Delay Mix", { 0.0f, 1.0f }, 0.5f);
+    addFloat(paramReverbMix, "reverbMix", "Reverb Mix", { 0.0f, 1.0f }, 0.5f);
+    addFloat(paramMix, "mix", "Mix", { 0.0f, 1.0f }, 1.0f);
+
+    auto* mixLaw = new juce::AudioParameterChoice("mixLaw", "Mix Law", { "Balance", "Linear", "Equal Power" }, 0);
+    addParameter(mixLaw);
+    _params[paramMixLaw] = mixLaw;
+
+    _paramValuesPolled.fill(std::numeric_limits<float>::quiet_NaN());
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setParameterValue(int paramIdx, float value)
+{
+    auto* param = _params[(size_t)paramIdx];
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getParameterValue(int paramIdx) const
+{
+    auto* param = _params[(size_t)paramIdx];
+    return param->convertFrom0to1(param->getValue());
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::addParameterChangeEvent(int paramIdx, int sampleOffset, float value)
+{
+    if (paramIdx < 0 || paramIdx >= numParams)
+        return false;
+
+    return _paramEvents.add(sampleOffset, paramIdx, value);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::collectParameterChanges()
+{
+    for (int i = 0; i < numParams; ++i)
+    {
+        auto value = getParameterValue(i);
+
+        if (value == _paramValuesPolled[(size_t)i])
+            continue;
+
+        _paramValuesPolled[(size_t)i] = value;
+        _paramEvents.add(0, i, value);
+    }
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::applyParameterChange(const MrParameterEvents::Event& event)
+{
+    switch (event.paramIdx)
+    {
+    case paramCutOffInHz:           _juceFxChainWrapper.setCutOffInHz(event.value); break;
+    case paramDelayInMs:            _juceFxChainWrapper.setDelayInMs(event.value); break;
+    case paramFeedback:             _juceFxChainWrapper.setFeedback(event.value); break;
+    case paramRoomSize:             _juceFxChainWrapper.setRoomSize(event.value); break;
+    case paramFeedbackMode:         _juceFxChainWrapper.setFeedbackMode(juce::roundToInt(event.value)); break;
+    case paramCrossFeed:            _juceFxChainWrapper.setCrossFeed(event.value); break;
+    case paramDampingLowPassInHz:   _juceFxChainWrapper.setDampingLowPassInHz(event.value); break;
+    case paramDampingHighPassInHz:  _juceFxChainWrapper.setDampingHighPassInHz(event.value); break;
+    case paramSaturationDrive:      _juceFxChainWrapper.setSaturationDrive(event.value); break;
+    case paramModulationDepthInMs:  _juceFxChainWrapper.setModulationDepthInMs(event.value); break;
+    case paramModulationRateInHz:   _juceFxChainWrapper.setModulationRateInHz(event.value); break;
+    case paramModulationNumVoices:  _juceFxChainWrapper.setModulationNumVoices(juce::roundToInt(event.value)); break;
+    case paramModulationStereoPhase: _juceFxChainWrapper.setModulationStereoPhase(event.value); break;
+    case paramQuality:              _juceFxChainWrapper.setQuality(juce::roundToInt(event.value)); break;
+    case paramAdaptiveQuality:      _juceFxChainWrapper.setAdaptiveQuality(event.value >= 0.5f); break;
+    case paramFilterMode:           _juceFxChainWrapper.setFilterMode(juce::roundToInt(event.value)); break;
+    case paramFilterSlope:          _juceFxChainWrapper.setFilterSlope(juce::roundToInt(event.value)); break;
+    case paramResonance:            _juceFxChainWrapper.setResonance(event.value); break;
+    case paramFilterGainInDb:       _juceFxChainWrapper.setFilterGainInDb(event.value); break;
+    case paramFilterMix:            _juceFxChainWrapper.setFilterMix(event.value); break;
+    case paramDelayMix:             _juceFxChainWrapper.setDelayMix(event.value); break;
+    case paramReverbMix:            _juceFxChainWrapper.setReverbMix(event.value); break;
+    case paramMix:                  _juceFxChainWrapper.setMix(event.value); break;
+    case paramMixLaw:               _juceFxChainWrapper.setMixLaw(juce::roundToInt(event.value)); break;
+    default: break;
+    }
+}
+
+//==============================================================================
+template <typename ChainWrapper>
+const juce::String MrChainAudioProcessor<ChainWrapper>::getName() const
+{
+    return JucePlugin_Name;
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+template <typename ChainWrapper>
+double MrChainAudioProcessor<ChainWrapper>::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                // so this should be at least 1, even if you're not really implementing programs.
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getCurrentProgram()
+{
+    return 0;
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setCurrentProgram ([[maybe_unused]]int index)
+{
+}
+
+template <typename ChainWrapper>
+const juce::String MrChainAudioProcessor<ChainWrapper>::getProgramName ([[maybe_unused]] int index)
+{
+    return {};
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::changeProgramName ([[maybe_unused]] int index, [[maybe_unused]] const juce::String& newName)
+{
+}
+
+//==============================================================================
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = samplesPerBlock;
+    spec.numChannels = getTotalNumOutputChannels();
+
+    _juceFxChainWrapper.setNonRealtime(isNonRealtime());
+    _juceFxChainWrapper.setupFilter(spec);
+    _juceFxChainWrapper.setupDelay(spec);
+    _juceFxChainWrapper.setupReverb();
+
+    _juceFxChainWrapper.prepare(spec);
+    setLatencySamples(_juceFxChainWrapper.getLatencyInSmpls());
+
+    // the setup above restores the defaults, so the first block applies all parameters again
+    _paramValuesPolled.fill(std::numeric_limits<float>::quiet_NaN());
+    _paramEvents.clear();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // This is the place where you check if the layout is supported.
+    // In this template code we only support mono or stereo.
+    // Some plugin hosts, such as certain GarageBand versions, will only
+    // load plugins that support stereo bus layouts.
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
+     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_unused]] juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    collectParameterChanges();
+
+    juce::dsp::AudioBlock<float> block(buffer);
+
+    auto processSubBlock = [this, &block](int startSample, int numSamples)
+    {
+        _juceFxChainWrapper.updateFilter();
+        _juceFxChainWrapper.updateReverb();
+        _juceFxChainWrapper.updateDelay();
+
+        auto subBlock = block.getSubBlock((size_t)startSample, (size_t)numSamples);
+        juce::dsp::ProcessContextReplacing<float> context(subBlock);
+        _juceFxChainWrapper.process(context);
+    };
+
+    if (_paramEvents.size() == 0)
+    {
+        processSubBlock(0, buffer.getNumSamples());
+        return;
+    }
+
+    // splits the block at the queued changes, only those from addParameterChangeEvent() have offsets other than 0
+    _paramEvents.process(buffer.getNumSamples(),
+        [this](const MrParameterEvents::Event& event) { applyParameterChange(event); },
+        processSubBlock);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setNonRealtime (bool isNonRealtime) noexcept
+{
+    juce::AudioProcessor::setNonRealtime(isNonRealtime);
+    _juceFxChainWrapper.setNonRealtime(isNonRealtime);
+}
+
+//==============================================================================
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::hasEditor() const
+{
+    return std::is_same<ChainWrapper, JuceFxChainWrapper>::value; // the editor is made for the chain of the plugin
+}
+
+template <typename ChainWrapper>
+juce::AudioProcessorEditor* MrChainAudioProcessor<ChainWrapper>::createEditor()
+{
+    return createEditorFor (*this);
+}
+
+//==============================================================================
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::getStateInformation (juce::MemoryBlock& destData)
+{
+    // the values in their own units by parameter ID, so a state stays valid if the ranges or the order change
+    juce::XmlElement state(STATE_TAG);
+
+    for (int paramIdx = 0; paramIdx < numParams; ++paramIdx)
+        state.setAttribute(_params[(size_t)paramIdx]->getParameterID(), getParameterValue(paramIdx));
+
+    copyXmlToBinary(state, destData);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setStateInformation (const void* data, int sizeInBytes)
+{
+    auto state = getXmlFromBinary(data, sizeInBytes);
+    if (state == nullptr || !state->hasTagName(STATE_TAG))
+        return;
+
+    // parameters missing in an older state keep their values, the next block applies the rest
+    for (int paramIdx = 0; paramIdx < numParams; ++paramIdx)
+    {
+        const auto paramId = _params[(size_t)paramIdx]->getParameterID();
+
+        if (state->hasAttribute(paramId))
+            setParameterValue(paramIdx, (float)state->getDoubleAttribute(paramId));
+    }
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setDelayInMs(double delayInMs)
+{
+    setParameterValue(paramDelayInMs, (float)delayInMs);
+}
+
+template <typename ChainWrapper>
+double MrChainAudioProcessor<ChainWrapper>::getDelayInMs()
+{
+    return (double)getParameterValue(paramDelayInMs);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFeedback(float feedback)
+{
+    setParameterValue(paramFeedback, (float)feedback);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getFeedback()
+{
+    return getParameterValue(paramFeedback);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFeedbackMode(int feedbackMode)
+{
+    setParameterValue(paramFeedbackMode, (float)feedbackMode);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getFeedbackMode()
+{
+    return juce::roundToInt(getParameterValue(paramFeedbackMode));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setCrossFeed(float crossFeed)
+{
+    setParameterValue(paramCrossFeed, (float)crossFeed);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getCrossFeed()
+{
+    return getParameterValue(paramCrossFeed);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setDampingLowPassInHz(float dampingLowPassInHz)
+{
+    setParameterValue(paramDampingLowPassInHz, (float)dampingLowPassInHz);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getDampingLowPassInHz()
+{
+    return getParameterValue(paramDampingLowPassInHz);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setDampingHighPassInHz(float dampingHighPassInHz)
+{
+    setParameterValue(paramDampingHighPassInHz, (float)dampingHighPassInHz);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getDampingHighPassInHz()
+{
+    return getParameterValue(paramDampingHighPassInHz);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setSaturationDrive(float saturationDrive)
+{
+    setParameterValue(paramSaturationDrive, (float)saturationDrive);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getSaturationDrive()
+{
+    return getParameterValue(paramSaturationDrive);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setModulationDepthInMs(float modulationDepthInMs)
+{
+    setParameterValue(paramModulationDepthInMs, modulationDepthInMs);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getModulationDepthInMs()
+{
+    return getParameterValue(paramModulationDepthInMs);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setModulationRateInHz(float modulationRateInHz)
+{
+    setParameterValue(paramModulationRateInHz, modulationRateInHz);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getModulationRateInHz()
+{
+    return getParameterValue(paramModulationRateInHz);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setModulationNumVoices(int modulationNumVoices)
+{
+    setParameterValue(paramModulationNumVoices, (float)modulationNumVoices);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getModulationNumVoices()
+{
+    return juce::roundToInt(getParameterValue(paramModulationNumVoices));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setModulationStereoPhase(float modulationStereoPhase)
+{
+    setParameterValue(paramModulationStereoPhase, modulationStereoPhase);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getModulationStereoPhase()
+{
+    return getParameterValue(paramModulationStereoPhase);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setCutOffInHz(float cutOffInHz)
+{
+    setParameterValue(paramCutOffInHz, (float)cutOffInHz);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getCutOffInHz()
+{
+    return getParameterValue(paramCutOffInHz);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFilterMode(int filterMode)
+{
+    setParameterValue(paramFilterMode, (float)filterMode);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getFilterMode()
+{
+    return juce::roundToInt(getParameterValue(paramFilterMode));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFilterSlope(int filterSlope)
+{
+    setParameterValue(paramFilterSlope, (float)filterSlope);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getFilterSlope()
+{
+    return juce::roundToInt(getParameterValue(paramFilterSlope));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setResonance(float resonance)
+{
+    setParameterValue(paramResonance, resonance);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getResonance()
+{
+    return getParameterValue(paramResonance);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFilterGainInDb(float filterGainInDb)
+{
+    setParameterValue(paramFilterGainInDb, filterGainInDb);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getFilterGainInDb()
+{
+    return getParameterValue(paramFilterGainInDb);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setRoomSize(float roomSize)
+{
+    setParameterValue(paramRoomSize, (float)roomSize);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getRoomSize()
+{
+    return getParameterValue(paramRoomSize);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFilterMix(float filterMix)
+{
+    setParameterValue(paramFilterMix, filterMix);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getFilterMix()
+{
+    return getParameterValue(paramFilterMix);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setDelayMix(float delayMix)
+{
+    setParameterValue(paramDelayMix, delayMix);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getDelayMix()
+{
+    return getParameterValue(paramDelayMix);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setReverbMix(float reverbMix)
+{
+    setParameterValue(paramReverbMix, reverbMix);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getReverbMix()
+{
+    return getParameterValue(paramReverbMix);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setMix(float mix)
+{
+    setParameterValue(paramMix, mix);
+}
+
+template <typename ChainWrapper>
+float MrChainAudioProcessor<ChainWrapper>::getMix()
+{
+    return getParameterValue(paramMix);
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setMixLaw(int mixLaw)
+{
+    setParameterValue(paramMixLaw, (float)mixLaw);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getMixLaw()
+{
+    return juce::roundToInt(getParameterValue(paramMixLaw));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setSubBlockSize(int subBlockSize)
+{
+    _juceFxChainWrapper.setSubBlockSize(subBlockSize);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getSubBlockSize()
+{
+    return _juceFxChainWrapper.getSubBlockSize();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setFrameSize(int frameSize)
+{
+    _juceFxChainWrapper.setFrameSize(frameSize);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getFrameSize()
+{
+    return _juceFxChainWrapper.getFrameSize();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setPipelined(bool isPipelined)
+{
+    _juceFxChainWrapper.setPipelined(isPipelined);
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isPipelined()
+{
+    return _juceFxChainWrapper.isPipelined();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setLinearPhase(bool isLinearPhase)
+{
+    _juceFxChainWrapper.setLinearPhase(isLinearPhase);
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isLinearPhase()
+{
+    return _juceFxChainWrapper.isLinearPhase();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setAsyncPrepare(bool isAsyncPrepare)
+{
+    _juceFxChainWrapper.setAsyncPrepare(isAsyncPrepare);
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isAsyncPrepare()
+{
+    return _juceFxChainWrapper.isAsyncPrepare();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setChannelMode(int channelMode)
+{
+    _juceFxChainWrapper.setChannelMode(channelMode);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getChannelMode()
+{
+    return _juceFxChainWrapper.getChannelMode();
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setQuality(int quality)
+{
+    setParameterValue(paramQuality, (float)quality);
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getQuality()
+{
+    return juce::roundToInt(getParameterValue(paramQuality));
+}
+
+template <typename ChainWrapper>
+void MrChainAudioProcessor<ChainWrapper>::setAdaptiveQuality(bool isAdaptiveQuality)
+{
+    setParameterValue(paramAdaptiveQuality, isAdaptiveQuality ? 1.0f : 0.0f);
+}
+
+template <typename ChainWrapper>
+bool MrChainAudioProcessor<ChainWrapper>::isAdaptiveQuality()
+{
+    return getParameterValue(paramAdaptiveQuality) >= 0.5f;
+}
+
+template <typename ChainWrapper>
+int MrChainAudioProcessor<ChainWrapper>::getQualityInUse()
+{
+    return _juceFxChainWrapper.getQualityInUse();
+}
@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "PluginProcessorImpl.h"
 #include "JuceFxChainWrapperMock.h"
 
 class PluginProcessorTests : public juce::UnitTest
@@ -12,13 +13,25 @@ public:
 
     void runTest() override
     {
-        beginTest("When prepareToPlay is called then all functions to setup the chain are being called.");
+        beginTest("When the processor is created then the chain is neither set up nor prepared before prepareToPlay is called.");
         {
             /// prepare
-            std::shared_ptr<IJuceFxChainWrapper> juceFxChainWrapper =
-                std::shared_ptr<IJuceFxChainWrapper>(new JuceFxChainWrapperMock());
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessor;
+
+            /// exercise
+            auto& mock = pluginProcessor.getChainWrapper();
 
-            MrJuceFxChainPlusAudioProcessor pluginProcessor(juceFxChainWrapper);
+            /// evaluate
+            expect(!mock.atLeastOneCallToFunction("setupFilter"));
+            expect(!mock.atLeastOneCallToFunction("setupDelay"));
+            expect(!mock.atLeastOneCallToFunction("setupReverb"));
+            expect(!mock.atLeastOneCallToFunction("prepare"));
+        }
+
+        beginTest("When prepareToPlay is called then all functions to setup the chain are being called.");
+        {
+            /// prepare
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessor;
 
             /// exercise
             double sampleRate = 48000;
@@ -26,33 +39,75 @@ public:
             pluginProcessor.prepareToPlay(sampleRate, samplesPerBlock);
 
             /// evaluate
-            std::shared_ptr<JuceFxChainWrapperMock> mock =
-                std::static_pointer_cast<JuceFxChainWrapperMock>(juceFxChainWrapper);
+            auto& mock = pluginProcessor.getChainWrapper();
 
-            expect(mock->atLeastOneCallToFunction("setupDelay"));
-            expect(mock->atLeastOneCallToFunction("setupFilter"));
-            expect(mock->atLeastOneCallToFunction("setupReverb"));
-            expect(mock->atLeastOneCallToFunction("prepare"));
+            expect(mock.atLeastOneCallToFunction("setupDelay"));
+            expect(mock.atLeastOneCallToFunction("setupFilter"));
+            expect(mock.atLeastOneCallToFunction("setupReverb"));
+            expect(mock.atLeastOneCallToFunction("prepare"));
+            expect(mock.atLeastOneCallToFunction("getLatencyInSmpls"));
         }
 
         beginTest("When processesBlock is called then process of the chain is called.");
         {
             /// prepare
-            std::shared_ptr<IJuceFxChainWrapper> juceFxChainWrapper =
-                std::shared_ptr<IJuceFxChainWrapper>(new JuceFxChainWrapperMock());
-
-            MrJuceFxChainPlusAudioProcessor pluginProcessor(juceFxChainWrapper);
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessor;
 
             /// exercise            
-            juce::AudioSampleBuffer audioSampleBuffer;
+            juce::AudioSampleBuffer audioSampleBuffer(2, 64);
+            audioSampleBuffer.clear();
             juce::MidiBuffer midiBuffer;
             pluginProcessor.processBlock(audioSampleBuffer, midiBuffer);
             
             /// evaluate
-            std::shared_ptr<JuceFxChainWrapperMock> mock =
-                std::static_pointer_cast<JuceFxChainWrapperMock>(juceFxChainWrapper);
+            auto& mock = pluginProcessor.getChainWrapper();
+
+            expect(mock.atLeastOneCallToFunction("process"));
+        }
+
+        beginTest("When the state is stored and restored into another processor then it has the same parameter values.");
+        {
+            /// prepare
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessorStored;
+            pluginProcessorStored.setDelayInMs(1234.0);
+            pluginProcessorStored.setFeedbackMode(2);
+            pluginProcessorStored.setModulationNumVoices(5);
+            pluginProcessorStored.setAdaptiveQuality(true);
+            pluginProcessorStored.setMix(0.25f);
 
-            expect(mock->atLeastOneCallToFunction("process"));
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessorRestored;
+
+            /// exercise
+            juce::MemoryBlock state;
+            pluginProcessorStored.getStateInformation(state);
+            pluginProcessorRestored.setStateInformation(state.getData(), (int)state.getSize());
+
+            /// evaluate
+            expectWithinAbsoluteError(pluginProcessorRestored.getDelayInMs(), 1234.0, 0.5);
+            expectEquals(pluginProcessorRestored.getFeedbackMode(), 2);
+            expectEquals(pluginProcessorRestored.getModulationNumVoices(), 5);
+            expect(pluginProcessorRestored.isAdaptiveQuality());
+            expectWithinAbsoluteError(pluginProcessorRestored.getMix(), 0.25f, 0.0001f);
+
+            for (int i = 0; i < pluginProcessorStored.getParameters().size(); ++i)
+                expectWithinAbsoluteError(pluginProcessorRestored.getParameters()[i]->getValue(),
+                                          pluginProcessorStored.getParameters()[i]->getValue(), 0.0001f);
+        }
+
+        beginTest("When the state is not one the processor stored then the parameters keep their values.");
+        {
+            /// prepare
+            MrChainAudioProcessor<JuceFxChainWrapperMock> pluginProcessor;
+            pluginProcessor.setDelayInMs(1234.0);
+
+            const char data[] = "no state";
+
+            /// exercise
+            pluginProcessor.setStateInformation(data, (int)sizeof(data));
+            pluginProcessor.setStateInformation(nullptr, 0);
+
+            /// evaluate
+            expectWithinAbsoluteError(pluginProcessor.getDelayInMs(), 1234.0, 0.5);
         }
     }
 };